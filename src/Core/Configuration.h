@@ -46,6 +46,12 @@ namespace degate
          */
         static uint_fast64_t get_max_tile_cache_size();
 
+        /**
+         * Get the cache size for gate template images in MB.
+         * @return Returns the maximum cache size (in Mb) from the preferences.
+         */
+        static uint_fast64_t get_max_template_image_cache_size();
+
         /**
          * Get the maximum number of threads allowed to run concurrently.
          */
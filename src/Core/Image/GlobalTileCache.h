@@ -25,8 +25,12 @@
 #include "Core/Image/TileCacheBase.h"
 #include "Core/Primitive/SingletonBase.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <map>
+#include <mutex>
 #include <utility>
+#include <vector>
 #include <iostream>
 #include <iomanip>
 
@@ -38,6 +42,10 @@ namespace degate
      * 
      * This can ask for every single tile cache to release memory if needed.
      * 
+     * This class is thread safe. A tile cache must not hold its own lock when requesting
+     * memory: the global lock is always taken after the lock of a tile cache, and tile
+     * caches are only tried (never waited for) when memory must be released.
+     * 
      * @warning This is a singleton, only one instance can exists.
      */
     template <class PixelPolicy>
@@ -54,6 +62,9 @@ namespace degate
 
         cache_t cache;
 
+        // Recursive: releasing a tile (remove_oldest) updates the memory counters.
+        mutable std::recursive_mutex mutex;
+
     private:
 
         /**
@@ -69,42 +80,45 @@ namespace degate
 
         /**
          * Search for the oldest cache that requested memory and make it release memory.
+         * Caches in use (locked by another thread) are skipped.
+         *
+         * @return Returns false if no cache could release memory.
          */
-        void remove_oldest()
+        bool remove_oldest()
         {
-            struct timespec now;
-            GET_CLOCK(now);
-
-            TileCacheBase* oldest = nullptr;
-
-            // Search for oldest cache
+            // Caches sorted by last access (oldest first).
+            std::vector<std::pair<struct timespec, TileCacheBase*>> candidates;
+            candidates.reserve(cache.size());
             for (auto iter = cache.begin(); iter != cache.end(); ++iter)
-            {
-                cache_entry_t& entry = iter->second;
-                if (entry.first < now)
-                {
-                    now.tv_sec = entry.first.tv_sec;
-                    now.tv_nsec = entry.first.tv_nsec;
-                    oldest = iter->first;
-                }
-            }
+                candidates.emplace_back(iter->second.first, iter->first);
+
+            std::sort(candidates.begin(), candidates.end(),
+                      [](std::pair<struct timespec, TileCacheBase*> const& a, std::pair<struct timespec, TileCacheBase*> const& b)
+                      {
+                          return a.first < b.first;
+                      });
 
-            if (oldest != nullptr)
+            for (auto const& candidate : candidates)
             {
 #ifdef TILECACHE_DEBUG
-                debug(TM, "Will call cleanup on %p", oldest);
+                debug(TM, "Will call cleanup on %p", candidate.second);
 #endif
 
                 // If found, make the oldest release memory
-                oldest->cleanup_cache();
+                uint_fast64_t released = candidate.second->release_oldest_tile();
+                if (released > 0)
+                {
+                    release_cache_memory(candidate.second, released);
+                    return true;
+                }
             }
-            else
-            {
+
 #ifdef TILECACHE_DEBUG
-                debug(TM, "there is nothing to free.");
-                print_table();
+            debug(TM, "there is nothing to free.");
+            print_table();
 #endif
-            }
+
+            return false;
         }
 
     public:
@@ -114,6 +128,8 @@ namespace degate
          */
         void print_table() const
         {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
             std::cout << "Global Image Tile Cache:\n"
                       << "Used memory : " << allocated_memory << " bytes\n"
                       << "Max memory  : " << max_cache_memory << " bytes\n\n"
@@ -139,49 +155,53 @@ namespace degate
          * Request memory from the cache (this is virtual).
          * 
          * If too less memory remaining, then will call remove_oldest().
+         * The requestor must not hold its own lock (it can be asked to release memory).
+         *
+         * @return Returns false if not enough memory could be released (all caches are
+         *    in use). The memory is counted anyway, it will be released on next requests.
          */
         bool request_cache_memory(TileCacheBase* requestor, uint_fast64_t amount)
         {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
 #ifdef TILECACHE_DEBUG
             debug(TM, "Local cache %p requests %d bytes.", requestor, amount);
 #endif
+            bool ok = true;
             while (allocated_memory + amount > max_cache_memory)
             {
 #ifdef TILECACHE_DEBUG
                 debug(TM, "Try to free memory");
 #endif
-                remove_oldest();
-            }
-
-            if (allocated_memory + amount <= max_cache_memory)
-            {
-                struct timespec now{};
-                GET_CLOCK(now);
-
-                auto found = cache.find(requestor);
-                if (found == cache.end())
-                {
-                    cache[requestor] = std::make_pair(now, amount);
-                }
-                else
+                if (!remove_oldest())
                 {
-                    cache_entry_t& entry = found->second;
-                    entry.first.tv_sec = now.tv_sec;
-                    entry.first.tv_nsec = now.tv_nsec;
-                    entry.second += amount;
+                    debug(TM, "Can't free memory.");
+                    ok = false;
+                    break;
                 }
-
-                allocated_memory += amount;
-#ifdef TILECACHE_DEBUG
-                print_table();
-#endif
-                return true;
             }
 
-            debug(TM, "Can't free memory.");
+            struct timespec now{};
+            GET_CLOCK(now);
+
+            auto found = cache.find(requestor);
+            if (found == cache.end())
+            {
+                cache[requestor] = std::make_pair(now, amount);
+            }
+            else
+            {
+                cache_entry_t& entry = found->second;
+                entry.first.tv_sec = now.tv_sec;
+                entry.first.tv_nsec = now.tv_nsec;
+                entry.second += amount;
+            }
 
+            allocated_memory += amount;
+#ifdef TILECACHE_DEBUG
             print_table();
-            return false;
+#endif
+            return ok;
         }
 
         /**
@@ -189,6 +209,8 @@ namespace degate
          */
         void release_cache_memory(TileCacheBase* requestor, uint_fast64_t amount)
         {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
 #ifdef TILECACHE_DEBUG
             debug(TM, "Local cache %p releases %d bytes.", requestor, amount);
 #endif
@@ -241,11 +263,15 @@ namespace degate
 
         inline uint_fast64_t get_allocated_memory() const
         {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
             return allocated_memory;
         }
 
         inline bool is_full(uint_fast64_t amount) const
         {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
             return allocated_memory + amount > max_cache_memory;
         }
     };
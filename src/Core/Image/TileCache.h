@@ -141,25 +141,28 @@ namespace degate
          */
         inline ~TileCache()
         {
-            std::lock_guard<std::mutex> lock(mtx);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
 
-            // Delete and clear watchers
-            for (auto* watcher : watchers)
-                delete watcher;
-            watchers.clear();
+                // Delete and clear watchers
+                for (auto* watcher : watchers)
+                    delete watcher;
+                watchers.clear();
+            }
 
             // Release memory
             release_memory();
         }
 
         /**
-         * Cleanup the cache by removing the oldest entry.
+         * Cleanup the cache by removing the oldest entry (@see TileCacheBase::release_oldest_tile).
+         * The global tile cache is updated by the caller.
          */
-        inline void cleanup_cache() override
+        inline uint_fast64_t release_oldest_tile() override
         {
-            if (cache.size() == 0) return;
-
-            std::lock_guard<std::mutex> lock(mtx);
+            std::unique_lock<std::mutex> lock(mtx, std::try_to_lock);
+            if (!lock.owns_lock() || cache.size() == 0)
+                return 0;
 
             // Initialize a clock to store the oldest
             struct timespec oldest_clock_val;
@@ -192,9 +195,7 @@ namespace degate
             debug(TM, "local cache: %d entries after remove\n", cache.size());
 #endif
 
-            // Update the global tile cache (release the virtual memory)
-            GlobalTileCache<PixelPolicy>& gtc = GlobalTileCache<PixelPolicy>::get_instance();
-            gtc.release_cache_memory(this, get_image_size());
+            return get_image_size();
         }
 
         /**
@@ -202,10 +203,10 @@ namespace degate
          */
         inline void release_memory()
         {
+            std::lock_guard<std::mutex> lock(mtx);
+
             if (cache.size() > 0)
             {
-                std::lock_guard<std::mutex> lock(mtx);
-
                 // Release the global tile cache (by removing all the used virtual memory by this)
                 GlobalTileCache<PixelPolicy>& gtc = GlobalTileCache<PixelPolicy>::get_instance();
                 gtc.release_cache_memory(this, cache.size() * get_image_size());
@@ -309,6 +310,62 @@ namespace degate
             return current_tile;
         }
 
+        /**
+         * Get a tile without changing the working tile (@see get_tile). Unlike get_tile(),
+         * this can be called from a worker thread, but only with sync loading (an async
+         * loading must be started from the GUI thread, @see is_async).
+         *
+         * @param x Absolut pixel coordinate.
+         * @param y Absolut pixel coordinate.
+         * @return Returns a shared pointer to a MemoryMap object, or nullptr if the tile
+         *    was removed from the cache meanwhile.
+         */
+        std::shared_ptr<MemoryMap<typename PixelPolicy::pixel_type>>
+        inline fetch_tile(unsigned int x, unsigned int y)
+        {
+            assert(!is_async());
+
+            unsigned int tile_num_x = x >> tile_width_exp;
+            unsigned int tile_num_y = y >> tile_width_exp;
+
+            load_tile(tile_num_x, tile_num_y);
+
+            std::lock_guard<std::mutex> lock(mtx);
+
+            if (!is_included(tile_num_x, tile_num_y))
+                return loading_tile;
+
+            auto iter = cache.find(QString("%1_%2.dat").arg(tile_num_x).arg(tile_num_y).toStdString());
+            if (iter == cache.end())
+                return nullptr;
+
+            return iter->second.first;
+        }
+
+        /**
+         * Check if tiles are loaded asynchronously (@see TileLoadingType).
+         */
+        inline bool is_async() const
+        {
+            return loading_type == TileLoadingType::Async && !degate_image_format;
+        }
+
+        /**
+         * Check if a tile is still loading (async loading). Tiles outside of the image are
+         * never loading, even if get_tile() returns the temporary loading tile for them.
+         *
+         * @param x Absolut pixel coordinate.
+         * @param y Absolut pixel coordinate.
+         * @return Returns true if get_tile() returns a temporary tile for now.
+         */
+        inline bool is_tile_loading(unsigned int x, unsigned int y)
+        {
+            if (get_tile(x, y) != loading_tile)
+                return false;
+
+            return is_included(x >> tile_width_exp, y >> tile_width_exp);
+        }
+
         /**
          * Load a new tile and update the cache.
          * 
@@ -318,7 +375,7 @@ namespace degate
          */
         inline void load_tile(unsigned int x, unsigned int y, bool update_current = false)
         {
-            std::lock_guard<std::mutex> lock(mtx);
+            std::unique_lock<std::mutex> lock(mtx);
 
             // Check if tile is included in the base image
             // Otherwise return loading tile
@@ -350,11 +407,18 @@ namespace degate
             {
                 GlobalTileCache<PixelPolicy>& gtc = GlobalTileCache<PixelPolicy>::get_instance();
 
-                // Allocate memory (global tile cache)
-                bool ok = gtc.request_cache_memory(this, get_image_size());
-                assert(ok == true);
+                // Allocate memory (global tile cache). This can release tiles of any cache
+                // (including this one), therefore the lock is not held meanwhile.
+                lock.unlock();
+                gtc.request_cache_memory(this, get_image_size());
+                lock.lock();
 
-                if (degate_image_format == false)
+                if (cache.find(filename) != cache.end())
+                {
+                    // Loaded by another thread meanwhile.
+                    gtc.release_cache_memory(this, get_image_size());
+                }
+                else if (degate_image_format == false)
                 {
                     // Check loading type
                     if (loading_type == TileLoadingType::Async)
@@ -592,7 +656,10 @@ namespace degate
                 auto data = std::make_pair(temp, now);
 
                 // Register the new entry and send notifications (if this lambda was called, then this is valid/not destroyed)
-                cache[filename] = data;
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    cache[filename] = data;
+                }
                 notify();
 
                 // Remove and delete watcher
@@ -23,6 +23,7 @@
 #define __TILECACHEBASE_H__
 
 #include <chrono>
+#include <cstdint>
 #include <utility>
 
 /**
@@ -66,7 +67,14 @@ namespace degate
     class TileCacheBase
     {
     public:
-        virtual void cleanup_cache() = 0;
+        /**
+         * Release the oldest tile of the cache. Called by the global tile cache, this
+         * must not wait for the cache lock (the global tile cache lock is held).
+         *
+         * @return Returns the amount of memory released, 0 if the cache is empty or in use.
+         */
+        virtual uint_fast64_t release_oldest_tile() = 0;
+
         virtual void print() const = 0;
     };
 }
@@ -196,6 +196,41 @@ namespace degate
             return tile_cache->get_tile(src_x, src_y)->data();
         }
 
+        /**
+         * Copy the raw data from an image tile that has its upper left corner at x,y into a buffer,
+         * without changing the working tile of the cache. With sync loading (@see is_async), this
+         * can be called from a worker thread.
+         *
+         * @return Returns false if the tile is not available (the buffer is unchanged).
+         */
+        bool fetch_raw_copy(void* dst_buf, unsigned int src_x, unsigned int src_y) const
+        {
+            MemoryMap_shptr mem = tile_cache->fetch_tile(src_x, src_y);
+            if (mem == nullptr)
+                return false;
+
+            mem->raw_copy(dst_buf);
+            return true;
+        }
+
+        /**
+         * Check if tiles are loaded asynchronously. In this case, data() returns a
+         * temporary tile until the real one is loaded (@see is_loaded).
+         */
+        bool is_async() const
+        {
+            return tile_cache->is_async();
+        }
+
+        /**
+         * Check if the image tile that has its upper left corner at x,y is loaded. With async
+         * loading, data() returns a temporary tile until the real one is loaded.
+         */
+        bool is_loaded(unsigned int src_x, unsigned int src_y)
+        {
+            return !tile_cache->is_tile_loading(src_x, src_y);
+        }
+
         /**
          * Cache the tile around a rectangle.
          *
@@ -226,6 +226,11 @@ bool Gate::has_orientation() const
 }
 
 std::string Gate::get_orienation_type_as_string() const
+{
+    return get_orienation_type_as_string(orientation);
+}
+
+std::string Gate::get_orienation_type_as_string(ORIENTATION orientation)
 {
     switch (orientation)
     {
@@ -215,6 +215,11 @@ namespace degate
         */
         virtual std::string get_orienation_type_as_string() const;
 
+        /**
+        * Get an orientation as a human readable string.
+        */
+        static std::string get_orienation_type_as_string(ORIENTATION orientation);
+
 
         /**
          * Get the number of ports for this gate.
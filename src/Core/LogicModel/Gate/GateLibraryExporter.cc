@@ -25,6 +25,8 @@
 #include "Core/Utils/DegateHelper.h"
 #include "Core/LogicModel/Gate/GateTemplate.h"
 
+#include <QFile>
+
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -45,50 +47,97 @@ void GateLibraryExporter::export_data(std::string const& filename, GateLibrary_s
 {
     if (gate_lib == nullptr) throw InvalidPointerException("Gate library pointer is nullptr.");
 
-    std::string directory = get_basedir(filename);
-
     try
     {
-        QDomDocument doc;
+        write(filename, *prepare(gate_lib));
+    }
+    catch (const std::exception& ex)
+    {
+        std::cout << "Exception caught: " << ex.what() << std::endl;
+        throw;
+    }
+}
 
-        QDomProcessingInstruction head = doc.createProcessingInstruction("xml", XML_ENCODING);
-        doc.appendChild(head);
+GateLibraryExporter::ExportData_shptr GateLibraryExporter::prepare(GateLibrary_shptr gate_lib)
+{
+    if (gate_lib == nullptr) throw InvalidPointerException("Gate library pointer is nullptr.");
+
+    auto data = std::make_shared<ExportData>();
+
+    QDomDocument doc;
+
+    QDomProcessingInstruction head = doc.createProcessingInstruction("xml", XML_ENCODING);
+    doc.appendChild(head);
 
-        QDomElement root_elem = doc.createElement("gate-library");
-        assert(!root_elem.isNull());
+    QDomElement root_elem = doc.createElement("gate-library");
+    assert(!root_elem.isNull());
 
-        QDomElement templates_elem = doc.createElement("gate-templates");
-        if (templates_elem.isNull()) throw(std::runtime_error("Failed to create node."));
+    QDomElement templates_elem = doc.createElement("gate-templates");
+    if (templates_elem.isNull()) throw(std::runtime_error("Failed to create node."));
 
-        add_gates(doc, templates_elem, gate_lib, directory);
+    add_gates(doc, templates_elem, gate_lib, *data);
 
-        root_elem.appendChild(templates_elem);
+    root_elem.appendChild(templates_elem);
 
-        doc.appendChild(root_elem);
+    doc.appendChild(root_elem);
 
-        QFile file(QString::fromStdString(filename));
-        if (!file.open(QIODevice::WriteOnly))
+    data->document = doc.toByteArray();
+
+    return data;
+}
+
+void GateLibraryExporter::write(std::string const& filename, ExportData const& data)
+{
+    std::string directory = get_basedir(filename);
+
+    // Images are written to temporary files first. A crash while writing never leaves
+    // a truncated image behind and, with rewritten IDs, no stored file is replaced
+    // before it was copied.
+    std::vector<std::pair<ExportData::Image const*, std::string>> written_images;
+
+    for (auto const& image : data.images)
+    {
+        std::string path = join_pathes(directory, image.filename);
+
+        if (image.stored_file == path && file_exists(path))
+            continue;
+
+        std::string temp_path = path + ".tmp";
+
+        if (image.image != nullptr)
         {
-            throw InvalidPathException("Can't create export file.");
+            save_image<GateTemplateImage>(temp_path, image.image);
+        }
+        else
+        {
+            // Unmodified image stored elsewhere, there is no need to load it.
+            remove_file(temp_path);
+            if (!QFile::copy(QString::fromStdString(image.stored_file), QString::fromStdString(temp_path)))
+                throw InvalidPathException("Can't copy the template image " + image.stored_file + ".");
         }
 
-        QTextStream stream(&file);
-        stream.setEncoding(QStringConverter::Utf8);
-        stream << doc.toString();
-
-        file.close();
+        written_images.emplace_back(&image, path);
     }
-    catch (const std::exception& ex)
+
+    for (auto const& written_image : written_images)
     {
-        std::cout << "Exception caught: " << ex.what() << std::endl;
-        throw;
+        ExportData::Image const& image = *written_image.first;
+
+        move_file(written_image.second + ".tmp", written_image.second);
+        image.gate_template->set_image_stored(image.layer_type, image.version, written_image.second);
     }
+
+    for (auto const& implementation : data.implementations)
+        write_string_to_file(join_pathes(directory, implementation.first), implementation.second);
+
+    // written last, so that it never references a missing file
+    write_file(filename, data.document);
 }
 
 void GateLibraryExporter::add_gates(QDomDocument& doc,
                                     QDomElement& templates_elem,
                                     GateLibrary_shptr gate_lib,
-                                    std::string const& directory)
+                                    ExportData& data)
 {
     for (GateLibrary::template_iterator iter = gate_lib->begin();
          iter != gate_lib->end(); ++iter)
@@ -111,9 +160,9 @@ void GateLibraryExporter::add_gates(QDomDocument& doc,
         gate_elem.setAttribute(
             "height", QString::fromStdString(number_to_string<float>(gate_tmpl->get_height())));
 
-        add_images(doc, gate_elem, gate_tmpl, directory);
+        add_images(doc, gate_elem, gate_tmpl, data);
         add_ports(doc, gate_elem, gate_tmpl);
-        add_implementations(doc, gate_elem, gate_tmpl, directory);
+        add_implementations(doc, gate_elem, gate_tmpl, data);
 
         templates_elem.appendChild(gate_elem);
     }
@@ -123,20 +172,15 @@ void GateLibraryExporter::add_gates(QDomDocument& doc,
 void GateLibraryExporter::add_images(QDomDocument& doc,
                                      QDomElement& gate_elem,
                                      GateTemplate_shptr gate_tmpl,
-                                     std::string const& directory)
+                                     ExportData& data)
 {
     // export images
 
     QDomElement images_elem = doc.createElement("images");
     if (images_elem.isNull()) throw(std::runtime_error("Failed to create node."));
 
-    for (GateTemplate::image_iterator img_iter = gate_tmpl->images_begin();
-         img_iter != gate_tmpl->images_end(); ++img_iter)
+    for (Layer::LAYER_TYPE layer_type : gate_tmpl->get_image_layer_types())
     {
-        Layer::LAYER_TYPE layer_type = (*img_iter).first;
-        GateTemplateImage_shptr img = (*img_iter).second;
-        assert(img != nullptr);
-
         QDomElement img_elem = doc.createElement("image");
         if (img_elem.isNull()) throw(std::runtime_error("Failed to create node."));
 
@@ -150,7 +194,18 @@ void GateLibraryExporter::add_images(QDomDocument& doc,
 
         img_elem.setAttribute("image", QString::fromStdString(filename));
 
-        save_image<GateTemplateImage>(join_pathes(directory, filename), img);
+        ExportData::Image image;
+        image.filename = filename;
+        image.gate_template = gate_tmpl;
+        image.layer_type = layer_type;
+        image.version = gate_tmpl->get_image_version(layer_type);
+        image.stored_file = gate_tmpl->get_image_file(layer_type);
+
+        // Images that are stored in a file are not loaded.
+        if (image.stored_file.empty())
+            image.image = gate_tmpl->get_image(layer_type);
+
+        data.images.push_back(image);
 
         images_elem.appendChild(img_elem);
     }
@@ -199,7 +254,7 @@ void GateLibraryExporter::add_ports(QDomDocument& doc,
 void GateLibraryExporter::add_implementations(QDomDocument& doc,
                                               QDomElement& gate_elem,
                                               GateTemplate_shptr gate_tmpl,
-                                              std::string const& directory)
+                                              ExportData& data)
 {
     QDomElement implementations_elem = doc.createElement("implementations");
     if (implementations_elem.isNull()) throw(std::runtime_error("Failed to create node."));
@@ -234,7 +289,7 @@ void GateLibraryExporter::add_implementations(QDomDocument& doc,
             }
             std::string filename(fmter.str());
 
-            write_string_to_file(join_pathes(directory, filename), code);
+            data.implementations.emplace_back(filename, code);
 
             impl_elem.setAttribute("type", QString::fromStdString(GateTemplate::get_impl_type_as_string(t)));
             impl_elem.setAttribute("file", QString::fromStdString(filename));
@@ -24,10 +24,15 @@
 
 #include "Globals.h"
 #include "GateLibrary.h"
+#include "Core/LogicModel/Layer.h"
 #include "Core/XML/XMLExporter.h"
 #include "Core/Utils/ObjectIDRewriter.h"
 
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace degate
 {
@@ -37,22 +42,55 @@ namespace degate
      */
     class GateLibraryExporter : public XMLExporter
     {
+    public:
+
+        /**
+         * A serialized gate library: the content of the gate library file and the
+         * files it references. File names are relative to the gate library directory.
+         */
+        struct ExportData
+        {
+            /**
+             * A template image and the file it is exported to.
+             */
+            struct Image
+            {
+                std::string filename;
+                GateTemplate_shptr gate_template;
+                Layer::LAYER_TYPE layer_type;
+                unsigned int version;
+
+                // The file in which the image is stored already, empty if it was modified.
+                std::string stored_file;
+
+                // Only set for modified images.
+                GateTemplateImage_shptr image;
+            };
+
+            QByteArray document;
+            std::vector<Image> images;
+            std::vector<std::pair<std::string, std::string>> implementations;
+        };
+
+        typedef std::shared_ptr<const ExportData> ExportData_shptr;
+
     private:
 
         void add_gates(QDomDocument& doc, QDomElement& templates_elem, GateLibrary_shptr gate_lib,
-                       std::string const& directory);
+                       ExportData& data);
 
         void add_images(QDomDocument& doc, QDomElement& gate_elem, GateTemplate_shptr gate_tmpl,
-                        std::string const& directory);
+                        ExportData& data);
 
         void add_implementations(QDomDocument& doc, QDomElement& gate_elem, GateTemplate_shptr gate_tmpl,
-                                 std::string const& directory);
+                                 ExportData& data);
 
         void add_ports(QDomDocument& doc, QDomElement& gate_elem, GateTemplate_shptr gate_tmpl);
 
         ObjectIDRewriter_shptr oid_rewriter;
 
     public:
+
         GateLibraryExporter(ObjectIDRewriter_shptr oid_rewriter) : oid_rewriter(oid_rewriter)
         {
         }
@@ -67,6 +105,23 @@ namespace degate
          * @exception std::runtime_error
          */
         void export_data(std::string const& filename, GateLibrary_shptr gate_lib);
+
+        /**
+         * Serialize a gate library without writing anything. Images are not copied,
+         * the gate templates replace their images instead of modifying them.
+         * @exception InvalidPointerException
+         */
+        ExportData_shptr prepare(GateLibrary_shptr gate_lib);
+
+        /**
+         * Write a serialized gate library. This can be called from any thread.
+         * Images that are unmodified and stored in their target file already are
+         * skipped, unmodified images stored elsewhere are copied. Other images are
+         * written to a temporary file first, that is renamed afterwards.
+         * @exception InvalidPathException
+         * @exception DegateRuntimeException
+         */
+        void write(std::string const& filename, ExportData const& data);
     };
 }
 
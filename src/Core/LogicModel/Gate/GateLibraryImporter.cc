@@ -181,10 +181,12 @@ void GateLibraryImporter::parse_template_images_element(QDomElement const templa
             const std::string image_file(image_elem.attribute("image").toStdString());
 
             Layer::LAYER_TYPE layer_type = Layer::get_layer_type_from_string(layer_type_str);
-            GateTemplateImage_shptr img = load_image<GateTemplateImage>(join_pathes(directory, image_file));
+            const std::string image_path(join_pathes(directory, image_file));
+            if (!file_exists(image_path))
+                throw InvalidPathException("The template image " + image_path + " does not exist.");
 
-            assert(img != nullptr);
-            gate_tmpl->set_image(layer_type, img);
+            // The image is loaded when it is needed.
+            gate_tmpl->set_image_file(layer_type, image_path);
         }
     }
 }
@@ -21,6 +21,8 @@
  */
 
 #include "Core/LogicModel/Gate/GateTemplate.h"
+#include "Core/LogicModel/Gate/GateTemplateImageCache.h"
+#include "Core/Image/ImageHelper.h"
 
 using namespace degate;
 
@@ -80,7 +82,10 @@ void GateTemplate::clone_deep_into(DeepCopyable_shptr dest, oldnew_t* oldnew) co
                    });
 
     // images
-    clone->images = images;
+    {
+        std::lock_guard<std::mutex> lock(images_mutex);
+        clone->images = images;
+    }
 
     ColoredObject::clone_deep_into(dest, oldnew);
     LogicModelObjectBase::clone_deep_into(dest, oldnew);
@@ -116,20 +121,108 @@ void GateTemplate::set_image(Layer::LAYER_TYPE layer_type, GateTemplateImage_shp
 {
     if (img == nullptr) throw InvalidPointerException("Invalid pointer for image.");
     debug(TM, "set image for template.");
-    images[layer_type] = img;
+
+    std::lock_guard<std::mutex> lock(images_mutex);
+
+    TemplateImage& entry = images[layer_type];
+    entry.image = img;
+    entry.loaded_image.reset();
+    entry.file.clear();
+    entry.version++;
+}
+
+void GateTemplate::set_image_file(Layer::LAYER_TYPE layer_type, std::string const& path)
+{
+    std::lock_guard<std::mutex> lock(images_mutex);
+
+    TemplateImage& entry = images[layer_type];
+    entry.image.reset();
+    entry.loaded_image.reset();
+    entry.file = path;
+    entry.version++;
+}
+
+void GateTemplate::set_image_stored(Layer::LAYER_TYPE layer_type, unsigned int version, std::string const& path)
+{
+    std::lock_guard<std::mutex> lock(images_mutex);
+
+    // The image might have been replaced after it was written.
+    auto found = images.find(layer_type);
+    if (found == images.end() || found->second.version != version)
+        return;
+
+    TemplateImage& entry = found->second;
+    entry.file = path;
+
+    // From now on, the cache decides how long the image stays in memory.
+    if (entry.image != nullptr)
+    {
+        GateTemplateImageCache::get_instance().touch(entry.image);
+        entry.loaded_image = entry.image;
+        entry.image.reset();
+    }
+}
+
+std::string GateTemplate::get_image_file(Layer::LAYER_TYPE layer_type) const
+{
+    std::lock_guard<std::mutex> lock(images_mutex);
+
+    auto found = images.find(layer_type);
+    return found == images.end() ? std::string() : found->second.file;
 }
 
+unsigned int GateTemplate::get_image_version(Layer::LAYER_TYPE layer_type) const
+{
+    std::lock_guard<std::mutex> lock(images_mutex);
+
+    auto found = images.find(layer_type);
+    if (found == images.end())
+        throw CollectionLookupException("Can't find reference image.");
+
+    return found->second.version;
+}
+
+std::vector<Layer::LAYER_TYPE> GateTemplate::get_image_layer_types() const
+{
+    std::lock_guard<std::mutex> lock(images_mutex);
+
+    std::vector<Layer::LAYER_TYPE> layer_types;
+    for (auto const& entry : images)
+        layer_types.push_back(entry.first);
+
+    return layer_types;
+}
 
 GateTemplateImage_shptr GateTemplate::get_image(Layer::LAYER_TYPE layer_type)
 {
-    image_collection::iterator found = images.find(layer_type);
+    std::lock_guard<std::mutex> lock(images_mutex);
+
+    auto found = images.find(layer_type);
     if (found == images.end())
         throw CollectionLookupException("Can't find reference image.");
-    else return (*found).second;
+
+    TemplateImage& entry = found->second;
+    if (entry.image != nullptr)
+        return entry.image;
+
+    GateTemplateImage_shptr img = entry.loaded_image.lock();
+    if (img == nullptr)
+    {
+        debug(TM, "load template image from %s.", entry.file.c_str());
+
+        img = load_image<GateTemplateImage>(entry.file);
+        entry.loaded_image = img;
+    }
+
+    GateTemplateImageCache::get_instance().touch(img);
+
+    return img;
 }
 
 bool GateTemplate::has_image(Layer::LAYER_TYPE layer_type) const
 {
+    std::lock_guard<std::mutex> lock(images_mutex);
+
     return images.find(layer_type) != images.end();
 }
 
@@ -210,16 +303,6 @@ GateTemplate::port_iterator GateTemplate::ports_end()
     return ports.end();
 }
 
-GateTemplate::image_iterator GateTemplate::images_begin()
-{
-    return images.begin();
-}
-
-GateTemplate::image_iterator GateTemplate::images_end()
-{
-    return images.end();
-}
-
 
 unsigned int GateTemplate::get_reference_counter() const
 {
@@ -261,10 +344,8 @@ void GateTemplate::print(std::ostream& os)
         << "Gate object ID        : " << get_object_id() << std::endl
         << std::endl;
 
-    for (image_iterator img_i = images_begin(); img_i != images_end(); ++img_i)
+    for (Layer::LAYER_TYPE layer_type : get_image_layer_types())
     {
-        Layer::LAYER_TYPE layer_type = (*img_i).first;
-
         os
             << "Image for layer of type  : " << Layer::get_layer_type_as_string(layer_type) << std::endl
             << std::endl;
@@ -30,6 +30,9 @@
 #include <set>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace degate
 {
@@ -58,9 +61,6 @@ namespace degate
         typedef std::map<IMPLEMENTATION_TYPE, std::string /* code */> implementation_collection;
         typedef implementation_collection::iterator implementation_iter;
 
-        typedef std::map<Layer::LAYER_TYPE, GateTemplateImage_shptr> image_collection;
-        typedef image_collection::iterator image_iterator;
-
     private:
 
         BoundingBox bounding_box;
@@ -69,7 +69,27 @@ namespace degate
         std::set<GateTemplatePort_shptr, LMOCompare> ports;
 
         implementation_collection implementations;
-        image_collection images;
+
+        /**
+         * A reference image. An image that is stored in a file is only weakly
+         * referenced, it is kept in memory by the GateTemplateImageCache and
+         * loaded again when needed.
+         */
+        struct TemplateImage
+        {
+            GateTemplateImage_shptr image;
+            std::weak_ptr<GateTemplateImage> loaded_image;
+
+            // The file in which the image is stored, empty if it was modified.
+            std::string file;
+
+            // Changed each time the image is replaced.
+            unsigned int version = 0;
+        };
+
+        // Guarded by images_mutex, images can be loaded from any thread.
+        std::map<Layer::LAYER_TYPE, TemplateImage> images;
+        mutable std::mutex images_mutex;
 
         std::string logic_class = "undefined"; // e.g. nand, xor, flipflop, buffer, oai
 
@@ -174,6 +194,45 @@ namespace degate
          */
         virtual bool has_image(Layer::LAYER_TYPE layer_type) const;
 
+        /**
+         * Set a reference image that is stored in a file. The image is loaded
+         * when it is requested with get_image().
+         * @param layer_type : the layer type of the image.
+         * @param path : the path of the file.
+         */
+        virtual void set_image_file(Layer::LAYER_TYPE layer_type, std::string const& path);
+
+        /**
+         * Record that a reference image was written to a file. Nothing is recorded
+         * if the image was replaced since, otherwise it can be released from memory
+         * and loaded again from that file. This method can be called from any thread.
+         * @param layer_type : the layer type of the image.
+         * @param version : the version of the image that was written.
+         * @param path : the path of the file.
+         * @see get_image_version()
+         */
+        virtual void set_image_stored(Layer::LAYER_TYPE layer_type, unsigned int version,
+                                      std::string const& path);
+
+        /**
+         * Get the file in which the reference image for a layer type is stored.
+         * @return Returns an empty string, if there is no image or if it was
+         *   modified since it was loaded or saved.
+         */
+        virtual std::string get_image_file(Layer::LAYER_TYPE layer_type) const;
+
+        /**
+         * Get the version of the reference image for a layer type. It changes
+         * each time the image is replaced.
+         * @exception CollectionLookupException Throws this exception, if there is no image.
+         */
+        virtual unsigned int get_image_version(Layer::LAYER_TYPE layer_type) const;
+
+        /**
+         * Get the layer types for which the template has a reference image.
+         */
+        virtual std::vector<Layer::LAYER_TYPE> get_image_layer_types() const;
+
         /**
          * Add a template port to a gate template.
          * This is an isolated function. The port is just added to the gate template.
@@ -235,16 +294,6 @@ namespace degate
         virtual port_iterator ports_end();
 
 
-        /**
-         * Get an iterator to iterate over images.
-         */
-        virtual image_iterator images_begin();
-
-        /**
-         * Get end marker for the iteration over images.
-         */
-        virtual image_iterator images_end();
-
         /**
          * Get the reference counter.
          * @return Returns how many gates reference this gate template.
@@ -0,0 +1,98 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "Core/LogicModel/Gate/GateTemplateImageCache.h"
+#include "Core/Configuration.h"
+
+using namespace degate;
+
+static std::size_t get_image_size(GateTemplateImage const& image)
+{
+    return static_cast<std::size_t>(image.get_width()) * image.get_height() * sizeof(GateTemplateImage::pixel_type);
+}
+
+GateTemplateImageCache::GateTemplateImageCache()
+    : max_size(static_cast<std::size_t>(Configuration::get_max_template_image_cache_size()) * 1024 * 1024)
+{
+}
+
+void GateTemplateImageCache::touch(GateTemplateImage_shptr const& image)
+{
+    if (image == nullptr) throw InvalidPointerException("Invalid pointer for image.");
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto found = entries.find(image.get());
+    if (found != entries.end())
+    {
+        lru.splice(lru.begin(), lru, found->second);
+        return;
+    }
+
+    lru.push_front(image);
+    entries[image.get()] = lru.begin();
+    size += get_image_size(*image);
+
+    evict();
+}
+
+void GateTemplateImageCache::set_max_size(std::size_t max_size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    this->max_size = max_size;
+    evict();
+}
+
+std::size_t GateTemplateImageCache::get_max_size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return max_size;
+}
+
+std::size_t GateTemplateImageCache::get_size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+void GateTemplateImageCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    lru.clear();
+    entries.clear();
+    size = 0;
+}
+
+void GateTemplateImageCache::evict()
+{
+    // The most recently used image is kept, even if it is larger than the budget.
+    while (size > max_size && lru.size() > 1)
+    {
+        GateTemplateImage_shptr const& image = lru.back();
+
+        size -= get_image_size(*image);
+        entries.erase(image.get());
+        lru.pop_back();
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __GATETEMPLATEIMAGECACHE_H__
+#define __GATETEMPLATEIMAGECACHE_H__
+
+#include "Globals.h"
+#include "Core/Image/Image.h"
+#include "Core/Primitive/SingletonBase.h"
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace degate
+{
+    /**
+     * @class GateTemplateImageCache
+     * @brief Keep the recently used gate template images in memory.
+     *
+     * Gate templates only keep weak references on the images they can load again
+     * from a file. This cache holds strong references on the most recently used
+     * ones, within a memory budget. Images that are evicted are released as soon
+     * as nobody else uses them.
+     *
+     * This class is thread safe.
+     *
+     * @warning This is a singleton, only one instance can exists.
+     */
+    class GateTemplateImageCache : public SingletonBase<GateTemplateImageCache>
+    {
+        friend class SingletonBase<GateTemplateImageCache>;
+
+    public:
+
+        /**
+         * Mark an image as used. It is added to the cache if needed and the least
+         * recently used images are evicted to stay within the budget.
+         */
+        void touch(GateTemplateImage_shptr const& image);
+
+        /**
+         * Set the memory budget.
+         * @param max_size : the budget in bytes.
+         */
+        void set_max_size(std::size_t max_size);
+
+        /**
+         * Get the memory budget in bytes.
+         */
+        std::size_t get_max_size() const;
+
+        /**
+         * Get the memory used by the cached images in bytes.
+         */
+        std::size_t get_size() const;
+
+        /**
+         * Release all images.
+         */
+        void clear();
+
+    private:
+
+        /**
+         * Create the cache with the budget from the configuration.
+         */
+        GateTemplateImageCache();
+
+        void evict();
+
+        typedef std::list<GateTemplateImage_shptr> lru_list_t;
+
+        mutable std::mutex mutex;
+
+        std::size_t max_size;
+        std::size_t size = 0;
+
+        // Most recently used first.
+        lru_list_t lru;
+        std::unordered_map<const GateTemplateImage*, lru_list_t::iterator> entries;
+    };
+}
+
+#endif
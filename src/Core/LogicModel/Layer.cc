@@ -24,6 +24,7 @@
 #include "Core/LogicModel/Gate/Gate.h"
 #include "Core/LogicModel/Via/Via.h"
 
+#include <algorithm>
 #include <memory>
 
 using namespace degate;
@@ -74,6 +75,9 @@ Layer::Layer(BoundingBox const& bbox, ProjectType project_type, Layer::LAYER_TYP
     layer_type(layer_type),
     layer_pos(0),
     enabled(true),
+    composited(false),
+    composition_opacity(0.5f),
+    composition_tint(0),
     layer_id(0),
     project_type(project_type)
 {
@@ -85,6 +89,9 @@ Layer::Layer(BoundingBox const& bbox, ProjectType project_type, Layer::LAYER_TYP
     layer_type(layer_type),
     layer_pos(0),
     enabled(true),
+    composited(false),
+    composition_opacity(0.5f),
+    composition_tint(0),
     layer_id(0),
     project_type(project_type)
 {
@@ -104,6 +111,9 @@ DeepCopyable_shptr Layer::clone_shallow() const
     auto clone = std::make_shared<Layer>(quadtree.get_bounding_box(), project_type, layer_type);
     clone->layer_pos = layer_pos;
     clone->enabled = enabled;
+    clone->composited = composited;
+    clone->composition_opacity = composition_opacity;
+    clone->composition_tint = composition_tint;
     clone->description = description;
     clone->layer_id = layer_id;
     clone->scaling_manager = scaling_manager;
@@ -427,6 +437,37 @@ bool Layer::is_enabled() const
 }
 
 
+void Layer::set_composited(bool state)
+{
+    composited = state;
+}
+
+bool Layer::is_composited() const
+{
+    return composited;
+}
+
+void Layer::set_composition_opacity(float opacity)
+{
+    composition_opacity = std::min(std::max(opacity, 0.0f), 1.0f);
+}
+
+float Layer::get_composition_opacity() const
+{
+    return composition_opacity;
+}
+
+void Layer::set_composition_tint(color_t tint)
+{
+    composition_tint = tint;
+}
+
+color_t Layer::get_composition_tint() const
+{
+    return composition_tint;
+}
+
+
 std::string Layer::get_description() const
 {
     return description;
@@ -79,6 +79,11 @@ namespace degate
         bool enabled;
         std::string description;
 
+        // Layer compositing (@see set_composited).
+        bool composited;
+        float composition_opacity;
+        color_t composition_tint;
+
         layer_id_t layer_id;
 
         ProjectType project_type;
@@ -371,6 +376,40 @@ namespace degate
         bool is_enabled() const;
 
 
+        /**
+         * Set if the layer is drawn over the current layer when layers are composited.
+         */
+        void set_composited(bool state = true);
+
+        /**
+         * Check if the layer is drawn over the current layer when layers are composited.
+         */
+        bool is_composited() const;
+
+        /**
+         * Set the opacity of the layer when composited.
+         *
+         * @param opacity : the opacity, clamped to [0, 1].
+         */
+        void set_composition_opacity(float opacity);
+
+        /**
+         * Get the opacity of the layer when composited.
+         */
+        float get_composition_opacity() const;
+
+        /**
+         * Set the tint of the layer when composited. The alpha channel is the
+         * strength of the tint (0 for no tint).
+         */
+        void set_composition_tint(color_t tint);
+
+        /**
+         * Get the tint of the layer when composited.
+         */
+        color_t get_composition_tint() const;
+
+
         /**
          * Get layer description.
          */
@@ -28,6 +28,7 @@
 #include "Core/LogicModel/LogicModel.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <iterator>
 #include <memory>
 
@@ -81,6 +82,40 @@ void LogicModel::print(std::ostream& os)
         Layer_shptr layer = *iter;
         layer->print(os);
     }
+
+    os
+        << endl
+        << "--------------------------------[ Memory ]--------------------------------" << endl;
+
+    print_object_pool_statistics(os);
+}
+
+std::vector<ObjectPoolStatistics> LogicModel::get_object_pool_statistics() const
+{
+    return object_pools->get_statistics();
+}
+
+void LogicModel::print_object_pool_statistics(std::ostream& os) const
+{
+    os << std::left
+       << std::setw(20) << "Object type" << " | "
+       << std::setw(10) << "Size" << " | "
+       << std::setw(10) << "Objects" << " | "
+       << std::setw(10) << "Peak" << " | "
+       << "Reserved memory" << endl
+       << "---------------------+------------+------------+------------+--------------------" << endl;
+
+    for (auto const& statistics : get_object_pool_statistics())
+    {
+        os << std::left
+           << std::setw(20) << statistics.name << " | "
+           << std::setw(10) << statistics.block_size << " | "
+           << std::setw(10) << statistics.live_objects << " | "
+           << std::setw(10) << statistics.peak_objects << " | "
+           << statistics.reserved_bytes / 1024 << " K (" << statistics.reserved_bytes << " bytes)" << endl;
+    }
+
+    os << std::right << endl;
 }
 
 bool LogicModel::exists_layer_id(layer_collection const& layers, layer_id_t lid) const
@@ -112,7 +147,8 @@ LogicModel::LogicModel(unsigned int width, unsigned int height, ProjectType proj
     bounding_box(static_cast<float>(width), static_cast<float>(height)),
     main_module(new Module("main_module", "", true)),
     object_id_counter(0),
-    project_type(project_type)
+    project_type(project_type),
+    object_pools(std::make_shared<ObjectPoolSet>())
 {
     gate_library = std::make_shared<GateLibrary>();
 
@@ -141,6 +177,8 @@ DeepCopyable_shptr LogicModel::clone_shallow() const
     clone->nets.clear();
     clone->objects.clear();
     clone->main_module.reset();
+    clone->object_pools = std::make_shared<ObjectPoolSet>();
+    clone->change_listeners.clear();
     return clone;
 }
 
@@ -234,6 +272,11 @@ PlacedLogicModelObject_shptr LogicModel::get_object(object_id_t object_id)
     }
 }
 
+bool LogicModel::exists_object(object_id_t object_id) const
+{
+    return objects.find(object_id) != objects.end();
+}
+
 void LogicModel::add_wire(int layer_pos, Wire_shptr o)
 {
     if (o == nullptr) throw InvalidPointerException();
@@ -368,6 +411,8 @@ void LogicModel::add_object(int layer_pos, PlacedLogicModelObject_shptr o)
         layer->add_object(o);
     }
     assert(objects.find(object_id) != objects.end());
+
+    record_changed_object(object_id);
 }
 
 
@@ -421,6 +466,7 @@ void LogicModel::remove_object(PlacedLogicModelObject_shptr o, bool add_to_remov
             Net_shptr net = clmo->get_net();
             clmo->remove_net();
             if (net != nullptr && net->size() == 0) remove_net(net);
+            else if (net != nullptr) record_changed_net(net->get_object_id());
         }
 
         if (Gate_shptr gate = std::dynamic_pointer_cast<Gate>(o))
@@ -447,6 +493,15 @@ void LogicModel::remove_object(PlacedLogicModelObject_shptr o, bool add_to_remov
         layer->remove_object(o);
     }
     objects.erase(o->get_object_id());
+
+    record_removed_object(o->get_object_id());
+
+    // The ports are stored with their gate.
+    if (GatePort_shptr gate_port = std::dynamic_pointer_cast<GatePort>(o))
+    {
+        if (Gate_shptr gate = gate_port->get_gate())
+            set_object_changed(gate);
+    }
 }
 
 void LogicModel::remove_object(PlacedLogicModelObject_shptr o)
@@ -564,7 +619,7 @@ void LogicModel::update_ports(Gate_shptr gate)
             {
                 debug(TM, "adding a new port to gate, because the gate has no reference to the gate port template %llu.",
                       tmpl_port->get_object_id());
-                GatePort_shptr new_gate_port(new GatePort(gate, tmpl_port, port_diameter));
+                GatePort_shptr new_gate_port = create_object<GatePort>(gate, tmpl_port, port_diameter);
                 new_gate_port->set_object_id(get_new_object_id());
                 gate->add_port(new_gate_port); // will set coordinates, too
 
@@ -798,6 +853,8 @@ void LogicModel::add_net(Net_shptr net)
         throw DegateRuntimeException(f.str());
     }
     nets[net->get_object_id()] = net;
+
+    record_changed_net(net->get_object_id());
 }
 
 
@@ -812,6 +869,11 @@ Net_shptr LogicModel::get_net(object_id_t net_id)
     return nets[net_id];
 }
 
+bool LogicModel::exists_net(object_id_t net_id) const
+{
+    return nets.find(net_id) != nets.end();
+}
+
 void LogicModel::remove_net(Net_shptr net)
 {
     if (!net->has_valid_object_id())
@@ -850,6 +912,8 @@ void LogicModel::remove_net(Net_shptr net)
         //nets[net->get_object_id()].reset();
         size_t n = nets.erase(net->get_object_id());
         assert(n == 1);
+
+        record_removed_object(net->get_object_id());
     }
 }
 
@@ -873,6 +937,26 @@ LogicModel::gate_collection::iterator LogicModel::gates_end()
     return gates.end();
 }
 
+LogicModel::wire_collection::iterator LogicModel::wires_begin()
+{
+    return wires.begin();
+}
+
+LogicModel::wire_collection::iterator LogicModel::wires_end()
+{
+    return wires.end();
+}
+
+LogicModel::emarker_collection::iterator LogicModel::emarkers_begin()
+{
+    return emarkers.begin();
+}
+
+LogicModel::emarker_collection::iterator LogicModel::emarkers_end()
+{
+    return emarkers.end();
+}
+
 LogicModel::via_collection::iterator LogicModel::vias_begin()
 {
     return vias.begin();
@@ -928,6 +1012,8 @@ void LogicModel::set_main_module(Module_shptr main_module)
 {
     this->main_module = main_module;
     main_module->set_main_module(); // set the root-node-state
+
+    record_modules_changed();
 }
 
 void LogicModel::reset_removed_remote_objetcs_list()
@@ -961,3 +1047,134 @@ void LogicModel::set_default_gate_port_diameter(diameter_t port_diameter)
 {
     this->port_diameter = port_diameter;
 }
+
+void LogicModel::set_object_changed(PlacedLogicModelObject_shptr o)
+{
+    if (o == nullptr) throw InvalidPointerException();
+
+    // A gate is stored with its ports.
+    if (GatePort_shptr gate_port = std::dynamic_pointer_cast<GatePort>(o))
+    {
+        if (Gate_shptr gate = gate_port->get_gate())
+            o = gate;
+    }
+
+    if (objects.find(o->get_object_id()) == objects.end())
+        return;
+
+    record_changed_object(o->get_object_id());
+
+    // A modified gate is replaced when the changes are applied, that drops it from its module.
+    if (std::dynamic_pointer_cast<Gate>(o) != nullptr)
+        record_modules_changed();
+}
+
+void LogicModel::set_net_changed(Net_shptr net)
+{
+    if (net == nullptr) throw InvalidPointerException();
+
+    if (nets.find(net->get_object_id()) != nets.end())
+        record_changed_net(net->get_object_id());
+}
+
+void LogicModel::set_modules_changed()
+{
+    record_modules_changed();
+}
+
+void LogicModel::set_gate_template_changed(GateTemplate_shptr gate_template)
+{
+    if (gate_template == nullptr) throw InvalidPointerException();
+
+    for (auto const& gate : gates)
+    {
+        if (gate.second->get_gate_template() == gate_template)
+            set_object_changed(gate.second);
+    }
+}
+
+void LogicModel::add_change_listener(std::shared_ptr<ChangeSet> listener)
+{
+    if (listener == nullptr) throw InvalidPointerException();
+
+    change_listeners.push_back(listener);
+}
+
+std::size_t LogicModel::get_change_listeners_count() const
+{
+    return change_listeners.size();
+}
+
+void LogicModel::record_changed_object(object_id_t object_id)
+{
+    changes.changed_objects.insert(object_id);
+
+    for (auto iter = change_listeners.begin(); iter != change_listeners.end();)
+    {
+        if (auto listener = iter->lock())
+        {
+            listener->changed_objects.insert(object_id);
+            ++iter;
+        }
+        else iter = change_listeners.erase(iter);
+    }
+}
+
+void LogicModel::record_changed_net(object_id_t net_id)
+{
+    changes.changed_nets.insert(net_id);
+
+    for (auto iter = change_listeners.begin(); iter != change_listeners.end();)
+    {
+        if (auto listener = iter->lock())
+        {
+            listener->changed_nets.insert(net_id);
+            ++iter;
+        }
+        else iter = change_listeners.erase(iter);
+    }
+}
+
+void LogicModel::record_removed_object(object_id_t object_id)
+{
+    changes.changed_objects.erase(object_id);
+    changes.changed_nets.erase(object_id);
+    changes.removed_objects.insert(object_id);
+
+    for (auto iter = change_listeners.begin(); iter != change_listeners.end();)
+    {
+        if (auto listener = iter->lock())
+        {
+            listener->changed_objects.erase(object_id);
+            listener->changed_nets.erase(object_id);
+            listener->removed_objects.insert(object_id);
+            ++iter;
+        }
+        else iter = change_listeners.erase(iter);
+    }
+}
+
+void LogicModel::record_modules_changed()
+{
+    changes.modules_changed = true;
+
+    for (auto iter = change_listeners.begin(); iter != change_listeners.end();)
+    {
+        if (auto listener = iter->lock())
+        {
+            listener->modules_changed = true;
+            ++iter;
+        }
+        else iter = change_listeners.erase(iter);
+    }
+}
+
+LogicModel::ChangeSet const& LogicModel::get_changes() const
+{
+    return changes;
+}
+
+void LogicModel::clear_changes()
+{
+    changes = ChangeSet();
+}
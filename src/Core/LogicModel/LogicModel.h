@@ -40,6 +40,7 @@
 #include "Core/LogicModel/Gate/GateLibrary.h"
 #include "Core/LogicModel/Annotation/Annotation.h"
 #include "Core/LogicModel/Module.h"
+#include "Core/Utils/ObjectPool.h"
 
 #include <memory>
 #include <set>
@@ -69,6 +70,40 @@ namespace degate
         typedef std::map<object_id_t, Wire_shptr> wire_collection;
         typedef std::map<object_id_t, EMarker_shptr> emarker_collection;
 
+        /**
+         * The changes of a logic model since the last call of clear_changes().
+         *
+         * Objects that are added or removed and nets are tracked by the logic model itself.
+         * Objects that are edited in place must be reported with set_object_changed().
+         */
+        struct ChangeSet
+        {
+            /**
+             * Placed objects that were added or modified.
+             */
+            std::set<object_id_t> changed_objects;
+
+            /**
+             * Nets that were added or whose connections changed.
+             */
+            std::set<object_id_t> changed_nets;
+
+            /**
+             * Placed objects and nets that were removed.
+             */
+            std::set<object_id_t> removed_objects;
+
+            /**
+             * The module hierarchy must be stored as a whole.
+             */
+            bool modules_changed = false;
+
+            bool empty() const
+            {
+                return changed_objects.empty() && changed_nets.empty() && removed_objects.empty() && !modules_changed;
+            }
+        };
+
     private:
 
         BoundingBox bounding_box;
@@ -114,8 +149,41 @@ namespace degate
 
         ProjectType project_type;
 
+        /**
+         * Memory pools for logic model objects, one per object type.
+         */
+        ObjectPoolSet_shptr object_pools;
+
+        ChangeSet changes;
+
+        /**
+         * Change sets of other consumers, filled like the own change set.
+         * @see add_change_listener()
+         */
+        std::list<std::weak_ptr<ChangeSet>> change_listeners;
+
     private:
 
+        /**
+         * Record changes in the own change set and in the change sets of all listeners.
+         */
+        void record_changed_object(object_id_t object_id);
+        void record_changed_net(object_id_t net_id);
+        void record_removed_object(object_id_t object_id);
+        void record_modules_changed();
+
+        /**
+         * Get the name of the object pool of an object type, for the pool statistics.
+         * The names are fixed, unlike get_object_type_name() they are not translated.
+         */
+        static const char* get_object_pool_name(Gate const*) { return "Gate"; }
+        static const char* get_object_pool_name(GatePort const*) { return "GatePort"; }
+        static const char* get_object_pool_name(Wire const*) { return "Wire"; }
+        static const char* get_object_pool_name(Via const*) { return "Via"; }
+        static const char* get_object_pool_name(EMarker const*) { return "EMarker"; }
+        static const char* get_object_pool_name(Net const*) { return "Net"; }
+        static const char* get_object_pool_name(void const*) { return "Other"; }
+
         /**
          * Get a layer. Create the layer if it doesn't exists.
          * @see get_layer
@@ -247,6 +315,38 @@ namespace degate
         object_id_t get_new_object_id();
 
 
+        /**
+         * Create a logic model object (e.g. a wire, a via, a gate, a gate port or a net).
+         * The memory is taken from a pool of this logic model, therefore objects of the
+         * same type are stored close to each other. The object is not added to the
+         * logic model.
+         * @param params The parameters passed to the constructor of T.
+         * @return Returns a shared pointer to the new object.
+         */
+        template <typename T, typename... Params>
+        std::shared_ptr<T> create_object(Params&&... params)
+        {
+            ObjectPool_shptr pool = object_pools->get_pool<T>();
+            std::shared_ptr<T> object = std::allocate_shared<T>(PoolAllocator<T>(pool),
+                                                                std::forward<Params>(params)...);
+
+            if (!pool->has_name())
+                pool->set_name(get_object_pool_name(object.get()));
+
+            return object;
+        }
+
+        /**
+         * Get the memory usage for each type of logic model object that
+         * was created with create_object().
+         */
+        std::vector<ObjectPoolStatistics> get_object_pool_statistics() const;
+
+        /**
+         * Print the memory usage for each type of logic model object.
+         */
+        void print_object_pool_statistics(std::ostream& os = std::cout) const;
+
         /**
          * Lookup an object from the logic model for a given object ID.
          * @exception CollectionLookupException Is thrown if there is
@@ -255,6 +355,11 @@ namespace degate
          */
         PlacedLogicModelObject_shptr get_object(object_id_t object_id);
 
+        /**
+         * Check if there is a placed object with a given object ID.
+         */
+        bool exists_object(object_id_t object_id) const;
+
 
         /**
          * Add a generic logic model object into the logic model. If the layer doesn't
@@ -445,6 +550,11 @@ namespace degate
          */
         Net_shptr get_net(object_id_t net_id);
 
+        /**
+         * Check if there is a net with a given object ID.
+         */
+        bool exists_net(object_id_t net_id) const;
+
         /**
          * Remove a net from the logic model.
          * @exception InvalidPointerException Is thrown, if an invalid pointer was
@@ -486,6 +596,42 @@ namespace degate
          */
         gate_collection::iterator gates_end();
 
+        /**
+         * Get the number of wires.
+         */
+        inline unsigned get_wires_count()
+        {
+            return static_cast<unsigned int>(wires.size());
+        }
+
+        /**
+         * Get a iterator to iterate over all wires.
+         */
+        wire_collection::iterator wires_begin();
+
+        /**
+         * Get an end iterator for the iteration over all wires.
+         */
+        wire_collection::iterator wires_end();
+
+        /**
+         * Get the number of emarkers.
+         */
+        inline unsigned get_emarkers_count()
+        {
+            return static_cast<unsigned int>(emarkers.size());
+        }
+
+        /**
+         * Get a iterator to iterate over all emarkers.
+         */
+        emarker_collection::iterator emarkers_begin();
+
+        /**
+         * Get an end iterator for the iteration over all emarkers.
+         */
+        emarker_collection::iterator emarkers_end();
+
         /**
          * Get the number of vias.
          */
@@ -598,6 +744,53 @@ namespace degate
          * Set default gate port diameter.
          */
         void set_default_gate_port_diameter(diameter_t port_diameter);
+
+        /**
+         * Record that a placed object was edited in place (e.g. renamed or moved).
+         * For a gate port, the gate is recorded.
+         * @see get_changes()
+         */
+        void set_object_changed(PlacedLogicModelObject_shptr o);
+
+        /**
+         * Record that the connections of a net changed.
+         */
+        void set_net_changed(Net_shptr net);
+
+        /**
+         * Record that the module hierarchy changed.
+         */
+        void set_modules_changed();
+
+        /**
+         * Record that a gate template was edited in place (e.g. a port direction
+         * changed). All gates of this template are recorded.
+         */
+        void set_gate_template_changed(GateTemplate_shptr gate_template);
+
+        /**
+         * Add a change set that receives the same changes as the own change set, from
+         * now on. It is independent of get_changes() and clear_changes(), the listener
+         * clears it itself. The logic model only keeps a weak reference, a listener is
+         * removed once its change set is released.
+         */
+        void add_change_listener(std::shared_ptr<ChangeSet> listener);
+
+        /**
+         * Get the number of registered listeners. Released listeners are only removed
+         * on the next recorded change.
+         */
+        std::size_t get_change_listeners_count() const;
+
+        /**
+         * Get the changes since the last call of clear_changes().
+         */
+        ChangeSet const& get_changes() const;
+
+        /**
+         * Forget all recorded changes, e.g. after the logic model was saved or loaded.
+         */
+        void clear_changes();
     };
 }
 
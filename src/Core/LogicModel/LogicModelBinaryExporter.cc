@@ -0,0 +1,148 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Core/LogicModel/LogicModelBinaryExporter.h"
+
+#include <QBuffer>
+#include <QSaveFile>
+
+#include <cstring>
+
+using namespace degate;
+using namespace degate::lmodel_binary;
+
+namespace
+{
+    struct PendingTable
+    {
+        uint32_t table_id;
+        uint32_t record_size;
+        const char* data;
+        uint64_t count;
+    };
+
+    template <typename T>
+    PendingTable make_table(uint32_t table_id, std::vector<T> const& records)
+    {
+        return {table_id, static_cast<uint32_t>(sizeof(T)), reinterpret_cast<const char*>(records.data()),
+                static_cast<uint64_t>(records.size())};
+    }
+
+    uint64_t align_offset(uint64_t offset)
+    {
+        return (offset + 7) / 8 * 8;
+    }
+}
+
+void LogicModelBinaryExporter::export_data(std::string const& filename, LogicModel_shptr lmodel)
+{
+    if (lmodel == nullptr) throw InvalidPointerException("Logic model pointer is nullptr.");
+
+    export_snapshot(filename, LogicModelSnapshot(lmodel, oid_rewriter));
+}
+
+void LogicModelBinaryExporter::export_snapshot(std::string const& filename, LogicModelSnapshot const& snapshot)
+{
+    // The file is replaced atomically, a reader never sees a partially written file.
+    QSaveFile file(QString::fromStdString(filename));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        throw InvalidPathException("Can't create export file.");
+    }
+
+    write(file, snapshot);
+
+    if (!file.commit())
+    {
+        throw InvalidPathException("Can't write export file.");
+    }
+}
+
+QByteArray LogicModelBinaryExporter::serialize(LogicModelSnapshot const& snapshot)
+{
+    QByteArray data;
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    write(buffer, snapshot);
+
+    return data;
+}
+
+void LogicModelBinaryExporter::write(QIODevice& device, LogicModelSnapshot const& snapshot)
+{
+    const std::vector<PendingTable> tables =
+    {
+        make_table(TABLE_STRING_OFFSETS, snapshot.string_offsets),
+        make_table(TABLE_STRING_DATA, snapshot.string_data),
+        make_table(TABLE_GATES, snapshot.gates),
+        make_table(TABLE_GATE_PORTS, snapshot.gate_ports),
+        make_table(TABLE_WIRES, snapshot.wires),
+        make_table(TABLE_VIAS, snapshot.vias),
+        make_table(TABLE_EMARKERS, snapshot.emarkers),
+        make_table(TABLE_ANNOTATIONS, snapshot.annotations),
+        make_table(TABLE_ANNOTATION_PARAMETERS, snapshot.annotation_parameters),
+        make_table(TABLE_NETS, snapshot.nets),
+        make_table(TABLE_NET_CONNECTIONS, snapshot.net_connections),
+        make_table(TABLE_MODULES, snapshot.modules),
+        make_table(TABLE_MODULE_CELLS, snapshot.module_cells),
+        make_table(TABLE_MODULE_PORTS, snapshot.module_ports),
+        make_table(TABLE_REMOVED_OBJECTS, snapshot.removed_objects)
+    };
+
+    // layout
+    std::vector<TableEntry> directory;
+    uint64_t offset = sizeof(FileHeader) + tables.size() * sizeof(TableEntry);
+
+    for (auto const& table : tables)
+    {
+        offset = align_offset(offset);
+
+        TableEntry entry = {};
+        entry.table_id = table.table_id;
+        entry.record_size = table.record_size;
+        entry.offset = offset;
+        entry.count = table.count;
+        directory.push_back(entry);
+
+        offset += table.count * table.record_size;
+    }
+
+    FileHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.table_count = static_cast<uint32_t>(tables.size());
+    header.file_size = offset;
+
+    static const char padding[8] = {0};
+
+    device.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    device.write(reinterpret_cast<const char*>(directory.data()),
+                 static_cast<qint64>(directory.size() * sizeof(TableEntry)));
+
+    for (std::size_t i = 0; i < tables.size(); i++)
+    {
+        device.write(padding, static_cast<qint64>(directory[i].offset - device.pos()));
+        device.write(tables[i].data, static_cast<qint64>(tables[i].count * tables[i].record_size));
+    }
+}
@@ -0,0 +1,85 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __LOGICMODELBINARYEXPORTER_H__
+#define __LOGICMODELBINARYEXPORTER_H__
+
+#include "Globals.h"
+#include "LogicModel.h"
+#include "LogicModelSnapshot.h"
+#include "Core/Utils/Exporter.h"
+#include "Core/Utils/ObjectIDRewriter.h"
+
+#include <QByteArray>
+#include <QIODevice>
+
+#include <string>
+
+namespace degate
+{
+    /**
+     * The LogicModelBinaryExporter writes a logic model into the binary file format
+     * (lmodel.bin). This file is a cache for lmodel.xml, that can be loaded without
+     * parsing. See LogicModelBinaryFormat.h for the file layout.
+     *
+     * Object IDs are rewritten with the same rewriter as the XML files of the project,
+     * therefore both files describe the same logic model.
+     */
+    class LogicModelBinaryExporter : public Exporter
+    {
+    private:
+
+        ObjectIDRewriter_shptr oid_rewriter;
+
+        void write(QIODevice& device, LogicModelSnapshot const& snapshot);
+
+    public:
+
+        LogicModelBinaryExporter(ObjectIDRewriter_shptr oid_rewriter) : oid_rewriter(oid_rewriter)
+        {
+        }
+
+        ~LogicModelBinaryExporter()
+        {
+        }
+
+        /**
+         * Export a logic model.
+         * @exception InvalidPathException This exception is thrown if the file can't be written.
+         * @exception InvalidPointerException This exception is thrown if the logic model is a nullptr.
+         */
+        void export_data(std::string const& filename, LogicModel_shptr lmodel);
+
+        /**
+         * Export a snapshot of a logic model. This can be called from any thread.
+         * The object IDs were already rewritten when the snapshot was taken.
+         * @exception InvalidPathException This exception is thrown if the file can't be written.
+         */
+        void export_snapshot(std::string const& filename, LogicModelSnapshot const& snapshot);
+
+        /**
+         * Get the binary representation of a snapshot, e.g. for a journal entry.
+         */
+        QByteArray serialize(LogicModelSnapshot const& snapshot);
+    };
+}
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __LOGICMODELBINARYFORMAT_H__
+#define __LOGICMODELBINARYFORMAT_H__
+
+#include <cstdint>
+
+/**
+ * Structures of the binary logic model file (lmodel.bin). The records are also
+ * used in memory by LogicModelSnapshot.
+ *
+ * The file starts with a header, followed by a table directory. Each table is a
+ * packed array of fixed size records of one kind (e.g. all wires). Tables start
+ * at offsets aligned to 8 bytes, so that the records can be used in place once
+ * the file is mapped into memory.
+ *
+ * Tables hold one record per object (row layout) rather than one array per
+ * attribute (columnar layout). Objects are always created with all their
+ * attributes at once, so a record is read with a single cache line fetch, and
+ * the journal, that only stores a few changed objects, writes each of them as one
+ * contiguous record. The records are plain fixed size structures, therefore a
+ * table is still a flat array that is used in place from the mapped file.
+ *
+ * Names and descriptions are stored once in a string table and referenced by
+ * their index. The index 0 is always the empty string.
+ *
+ * All values are stored with the byte order of the machine that wrote the file.
+ * A reader with another byte order rejects the file (and falls back to lmodel.xml).
+ *
+ * The same layout is used for the entries of the project journal (lmodel.journal),
+ * that only hold the objects that changed. The table of removed objects is only
+ * used there. See ProjectJournal.
+ */
+namespace degate
+{
+    namespace lmodel_binary
+    {
+        static const char MAGIC[8] = {'D', 'G', 'L', 'M', 'B', 'I', 'N', '\0'};
+        static const uint32_t VERSION = 1;
+        static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+        static const uint32_t NO_PARENT = 0xFFFFFFFF;
+
+        enum TABLE_ID : uint32_t
+        {
+            TABLE_STRING_OFFSETS = 1,
+            TABLE_STRING_DATA = 2,
+            TABLE_GATES = 3,
+            TABLE_GATE_PORTS = 4,
+            TABLE_WIRES = 5,
+            TABLE_VIAS = 6,
+            TABLE_EMARKERS = 7,
+            TABLE_ANNOTATIONS = 8,
+            TABLE_NETS = 9,
+            TABLE_NET_CONNECTIONS = 10,
+            TABLE_MODULES = 11,
+            TABLE_MODULE_CELLS = 12,
+            TABLE_MODULE_PORTS = 13,
+            TABLE_ANNOTATION_PARAMETERS = 14,
+            TABLE_REMOVED_OBJECTS = 15
+        };
+
+        struct FileHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order;
+            uint32_t table_count;
+            uint32_t reserved;
+            uint64_t file_size;
+        };
+
+        struct TableEntry
+        {
+            uint32_t table_id;
+            uint32_t record_size;
+            uint64_t offset;
+            uint64_t count;
+        };
+
+        struct GateRecord
+        {
+            uint64_t id;
+            uint64_t template_type_id;
+            uint32_t name;
+            uint32_t description;
+            uint32_t layer;
+            uint32_t orientation;
+            float min_x, min_y, max_x, max_y;
+            uint32_t fill_color;
+            uint32_t frame_color;
+            uint32_t first_port;
+            uint32_t port_count;
+        };
+
+        struct GatePortRecord
+        {
+            uint64_t id;
+            uint64_t template_port_type_id;
+            uint32_t name;
+            uint32_t description;
+            uint32_t diameter;
+            uint32_t padding;
+        };
+
+        struct WireRecord
+        {
+            uint64_t id;
+            uint64_t remote_id;
+            uint32_t name;
+            uint32_t description;
+            uint32_t layer;
+            uint32_t diameter;
+            float from_x, from_y, to_x, to_y;
+            uint32_t fill_color;
+            uint32_t frame_color;
+        };
+
+        struct ViaRecord
+        {
+            uint64_t id;
+            uint64_t remote_id;
+            uint32_t name;
+            uint32_t description;
+            uint32_t layer;
+            uint32_t diameter;
+            float x, y;
+            uint32_t fill_color;
+            uint32_t frame_color;
+            uint32_t direction;
+            uint32_t padding;
+        };
+
+        struct EMarkerRecord
+        {
+            uint64_t id;
+            uint64_t remote_id;
+            uint32_t name;
+            uint32_t description;
+            uint32_t layer;
+            uint32_t diameter;
+            float x, y;
+            uint32_t fill_color;
+            uint32_t frame_color;
+            uint32_t is_module_port;
+            uint32_t padding;
+        };
+
+        struct AnnotationRecord
+        {
+            uint64_t id;
+            uint32_t name;
+            uint32_t description;
+            uint32_t layer;
+            uint32_t class_id;
+            float min_x, min_y, max_x, max_y;
+            uint32_t fill_color;
+            uint32_t frame_color;
+            uint32_t first_parameter;
+            uint32_t parameter_count;
+        };
+
+        struct AnnotationParameterRecord
+        {
+            uint32_t name;
+            uint32_t value;
+        };
+
+        struct NetRecord
+        {
+            uint64_t id;
+            uint32_t first_connection;
+            uint32_t connection_count;
+        };
+
+        /**
+         * Modules are stored in pre-order, a module is always stored after its parent.
+         */
+        struct ModuleRecord
+        {
+            uint64_t id;
+            uint32_t name;
+            uint32_t entity;
+            uint32_t parent;
+            uint32_t first_cell;
+            uint32_t cell_count;
+            uint32_t first_port;
+            uint32_t port_count;
+            uint32_t padding;
+        };
+
+        struct ModulePortRecord
+        {
+            uint64_t object_id;
+            uint32_t name;
+            uint32_t padding;
+        };
+
+        static_assert(sizeof(FileHeader) == 32, "Unexpected size of the binary logic model header.");
+        static_assert(sizeof(TableEntry) == 24, "Unexpected size of the binary logic model table entry.");
+        static_assert(sizeof(GateRecord) == 64, "Unexpected size of the binary gate record.");
+        static_assert(sizeof(GatePortRecord) == 32, "Unexpected size of the binary gate port record.");
+        static_assert(sizeof(WireRecord) == 56, "Unexpected size of the binary wire record.");
+        static_assert(sizeof(ViaRecord) == 56, "Unexpected size of the binary via record.");
+        static_assert(sizeof(EMarkerRecord) == 56, "Unexpected size of the binary emarker record.");
+        static_assert(sizeof(AnnotationRecord) == 56, "Unexpected size of the binary annotation record.");
+        static_assert(sizeof(AnnotationParameterRecord) == 8, "Unexpected size of the binary annotation parameter record.");
+        static_assert(sizeof(NetRecord) == 16, "Unexpected size of the binary net record.");
+        static_assert(sizeof(ModuleRecord) == 40, "Unexpected size of the binary module record.");
+        static_assert(sizeof(ModulePortRecord) == 16, "Unexpected size of the binary module port record.");
+    }
+}
+
+#endif
@@ -0,0 +1,686 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Core/LogicModel/LogicModelBinaryImporter.h"
+#include "Core/LogicModel/Annotation/SubProjectAnnotation.h"
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/format.hpp>
+
+using namespace degate;
+using namespace degate::lmodel_binary;
+
+void LogicModelBinaryImporter::import_into(LogicModel_shptr lmodel, std::string const& filename)
+{
+    if (lmodel == nullptr) throw InvalidPointerException("Logic model pointer is nullptr.");
+
+    if (RET_IS_NOT_OK(check_file(filename)))
+    {
+        debug(TM, "Problem: file %s not found.", filename.c_str());
+        throw InvalidPathException("Can't load logic model from file.");
+    }
+
+    QFile file(QString::fromStdString(filename));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        debug(TM, "Problem: can't open the file %s.", filename.c_str());
+        throw InvalidPathException("The LogicModelBinaryImporter cannot load the logic model. Can't open the file.");
+    }
+
+    try
+    {
+        data_size = static_cast<uint64_t>(file.size());
+        data = data_size > 0 ? file.map(0, file.size()) : nullptr;
+        if (data == nullptr)
+        {
+            debug(TM, "Problem: can't map the file %s.", filename.c_str());
+            throw InvalidFileFormatException("The LogicModelBinaryImporter cannot map the logic model file.");
+        }
+
+        // Nothing is added to the logic model before the whole file is known to be valid.
+        check_data(lmodel, false);
+
+        lmodel->set_gate_library(gate_library);
+
+        load_gates(lmodel);
+        load_wires(lmodel);
+        load_vias(lmodel);
+        load_emarkers(lmodel);
+        load_annotations(lmodel);
+        load_nets(lmodel);
+        load_modules(lmodel);
+
+        // check if the ports of placed standard cell are available and create them if necessary
+        for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter)
+        {
+            lmodel->update_ports(iter->second);
+        }
+
+        // the loaded state is the saved state
+        lmodel->clear_changes();
+    }
+    catch (const std::exception& ex)
+    {
+        std::cout << "Exception caught: " << ex.what() << std::endl;
+
+        release_data();
+
+        throw;
+    }
+
+    // closing the file releases the mapping
+    file.close();
+
+    release_data();
+}
+
+void LogicModelBinaryImporter::import_changes(LogicModel_shptr lmodel, const char* entry, uint64_t entry_size)
+{
+    if (lmodel == nullptr) throw InvalidPointerException("Logic model pointer is nullptr.");
+
+    data = reinterpret_cast<const uchar*>(entry);
+    data_size = entry_size;
+
+    try
+    {
+        check_data(lmodel, true);
+
+        uint64_t count = 0;
+
+        // Changed objects and nets are replaced.
+        const GateRecord* gates = get_table<GateRecord>(TABLE_GATES, count);
+        for (uint64_t i = 0; i < count; i++)
+            remove_object_if_exists(lmodel, gates[i].id);
+
+        const WireRecord* wires = get_table<WireRecord>(TABLE_WIRES, count);
+        for (uint64_t i = 0; i < count; i++)
+            remove_object_if_exists(lmodel, wires[i].id);
+
+        const ViaRecord* vias = get_table<ViaRecord>(TABLE_VIAS, count);
+        for (uint64_t i = 0; i < count; i++)
+            remove_object_if_exists(lmodel, vias[i].id);
+
+        const EMarkerRecord* emarkers = get_table<EMarkerRecord>(TABLE_EMARKERS, count);
+        for (uint64_t i = 0; i < count; i++)
+            remove_object_if_exists(lmodel, emarkers[i].id);
+
+        const AnnotationRecord* annotations = get_table<AnnotationRecord>(TABLE_ANNOTATIONS, count);
+        for (uint64_t i = 0; i < count; i++)
+            remove_object_if_exists(lmodel, annotations[i].id);
+
+        const NetRecord* nets = get_table<NetRecord>(TABLE_NETS, count);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            if (lmodel->exists_net(nets[i].id))
+                lmodel->remove_net(lmodel->get_net(nets[i].id));
+        }
+
+        const uint64_t* removed = get_table<uint64_t>(TABLE_REMOVED_OBJECTS, count);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            if (lmodel->exists_object(removed[i]))
+            {
+                // Ports are removed with their gate, the gate is always part of the changes.
+                if (std::dynamic_pointer_cast<GatePort>(lmodel->get_object(removed[i])) == nullptr)
+                    lmodel->remove_object(lmodel->get_object(removed[i]));
+            }
+            else if (lmodel->exists_net(removed[i]))
+                lmodel->remove_net(lmodel->get_net(removed[i]));
+        }
+
+        load_gates(lmodel);
+        load_wires(lmodel);
+        load_vias(lmodel);
+        load_emarkers(lmodel);
+        load_annotations(lmodel);
+        load_nets(lmodel);
+
+        // The module hierarchy is only stored if it changed.
+        get_table<ModuleRecord>(TABLE_MODULES, count);
+        if (count > 0)
+            load_modules(lmodel);
+
+        get_table<GateRecord>(TABLE_GATES, count);
+        for (uint64_t i = 0; i < count; i++)
+            lmodel->update_ports(std::dynamic_pointer_cast<Gate>(lmodel->get_object(gates[i].id)));
+    }
+    catch (const std::exception& ex)
+    {
+        std::cout << "Exception caught: " << ex.what() << std::endl;
+
+        release_data();
+
+        throw;
+    }
+
+    release_data();
+}
+
+void LogicModelBinaryImporter::check_data(LogicModel_shptr lmodel, bool changes)
+{
+    check_header();
+
+    string_offsets = get_table<uint64_t>(TABLE_STRING_OFFSETS, string_count);
+    string_data = get_table<char>(TABLE_STRING_DATA, string_data_size);
+
+    validate(lmodel, changes);
+}
+
+void LogicModelBinaryImporter::release_data()
+{
+    data = nullptr;
+    data_size = 0;
+    string_offsets = nullptr;
+    string_data = nullptr;
+}
+
+void LogicModelBinaryImporter::remove_object_if_exists(LogicModel_shptr lmodel, object_id_t object_id)
+{
+    if (lmodel->exists_object(object_id))
+        lmodel->remove_object(lmodel->get_object(object_id));
+}
+
+LogicModel_shptr LogicModelBinaryImporter::import(std::string const& filename, ProjectType project_type)
+{
+    LogicModel_shptr lmodel(new LogicModel(width, height, project_type));
+    assert(lmodel != nullptr);
+
+    import_into(lmodel, filename);
+
+    return lmodel;
+}
+
+void LogicModelBinaryImporter::check_header() const
+{
+    if (data_size < sizeof(FileHeader))
+        throw InvalidFileFormatException("The binary logic model file is truncated.");
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw InvalidFileFormatException("The file is not a binary logic model file.");
+
+    if (header->byte_order != BYTE_ORDER_MARK)
+        throw InvalidFileFormatException("The binary logic model file was written with another byte order.");
+
+    if (header->version != VERSION)
+    {
+        boost::format f("Unsupported binary logic model file version %1%.");
+        f % header->version;
+        throw InvalidFileFormatException(f.str());
+    }
+
+    if (header->file_size != data_size ||
+        header->table_count > (data_size - sizeof(FileHeader)) / sizeof(TableEntry))
+        throw InvalidFileFormatException("The binary logic model file is truncated.");
+}
+
+template <typename T>
+const T* LogicModelBinaryImporter::get_table(TABLE_ID table_id, uint64_t& count) const
+{
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+    const TableEntry* directory = reinterpret_cast<const TableEntry*>(data + sizeof(FileHeader));
+
+    for (uint32_t i = 0; i < header->table_count; i++)
+    {
+        TableEntry const& entry = directory[i];
+        if (entry.table_id != table_id)
+            continue;
+
+        if (entry.record_size != sizeof(T) ||
+            entry.offset % alignof(T) != 0 ||
+            entry.offset > data_size ||
+            entry.count > (data_size - entry.offset) / sizeof(T))
+        {
+            boost::format f("Malformed table %1% in the binary logic model file.");
+            f % table_id;
+            throw InvalidFileFormatException(f.str());
+        }
+
+        count = entry.count;
+        return count > 0 ? reinterpret_cast<const T*>(data + entry.offset) : nullptr;
+    }
+
+    boost::format f("Missing table %1% in the binary logic model file.");
+    f % table_id;
+    throw InvalidFileFormatException(f.str());
+}
+
+void LogicModelBinaryImporter::check_string(uint32_t index) const
+{
+    if (index == 0)
+        return;
+
+    if (static_cast<uint64_t>(index) + 1 >= string_count ||
+        string_offsets[index] > string_offsets[index + 1] ||
+        string_offsets[index + 1] > string_data_size)
+        throw InvalidFileFormatException("Invalid string reference in the binary logic model file.");
+}
+
+void LogicModelBinaryImporter::validate(LogicModel_shptr lmodel, bool changes) const
+{
+    uint64_t count = 0, sub_count = 0;
+
+    // Ids of the objects stored in the data, an id can't be used twice.
+    std::unordered_set<object_id_t> object_ids;
+    auto add_object_id = [&](object_id_t id)
+    {
+        if (!object_ids.insert(id).second || (!changes && lmodel->exists_object(id)))
+            throw InvalidFileFormatException("Duplicated object in the binary logic model file.");
+    };
+
+    // Layers are created on demand, reject positions that don't exist in the project.
+    const unsigned int layer_count = lmodel->get_num_layers();
+    auto check_layer = [&](uint32_t layer)
+    {
+        if (layer_count > 0 && layer >= layer_count)
+            throw InvalidFileFormatException("Invalid layer in the binary logic model file.");
+    };
+
+    // Ids of the gate template ports of the gate library.
+    std::unordered_set<object_id_t> template_port_ids;
+    if (gate_library != nullptr)
+    {
+        for (auto iter = gate_library->begin(); iter != gate_library->end(); ++iter)
+        {
+            for (auto piter = iter->second->ports_begin(); piter != iter->second->ports_end(); ++piter)
+                template_port_ids.insert((*piter)->get_object_id());
+        }
+    }
+
+    const GateRecord* gates = get_table<GateRecord>(TABLE_GATES, count);
+    get_table<GatePortRecord>(TABLE_GATE_PORTS, sub_count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        check_string(gates[i].name);
+        check_string(gates[i].description);
+        check_range(gates[i].first_port, gates[i].port_count, sub_count);
+        check_layer(gates[i].layer);
+        add_object_id(gates[i].id);
+
+        if (gates[i].orientation > Gate::ORIENTATION_FLIPPED_BOTH)
+            throw InvalidFileFormatException("Can't parse orientation type.");
+
+        if (gate_library != nullptr && gates[i].template_type_id != 0 &&
+            !gate_library->exists_template(gates[i].template_type_id))
+            throw InvalidFileFormatException("Invalid gate template in the binary logic model file.");
+    }
+
+    const GatePortRecord* ports = get_table<GatePortRecord>(TABLE_GATE_PORTS, count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        check_string(ports[i].name);
+        check_string(ports[i].description);
+        add_object_id(ports[i].id);
+
+        if (gate_library != nullptr && template_port_ids.find(ports[i].template_port_type_id) == template_port_ids.end())
+            throw InvalidFileFormatException("Invalid gate template port in the binary logic model file.");
+    }
+
+    const WireRecord* wires = get_table<WireRecord>(TABLE_WIRES, count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        check_string(wires[i].name);
+        check_string(wires[i].description);
+        check_layer(wires[i].layer);
+        add_object_id(wires[i].id);
+    }
+
+    const ViaRecord* vias = get_table<ViaRecord>(TABLE_VIAS, count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        check_string(vias[i].name);
+        check_string(vias[i].description);
+        check_layer(vias[i].layer);
+        add_object_id(vias[i].id);
+
+        if (vias[i].direction > Via::DIRECTION_DOWN)
+            throw InvalidFileFormatException("Can't parse via direction type.");
+    }
+
+    const EMarkerRecord* emarkers = get_table<EMarkerRecord>(TABLE_EMARKERS, count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        check_string(emarkers[i].name);
+        check_string(emarkers[i].description);
+        check_layer(emarkers[i].layer);
+        add_object_id(emarkers[i].id);
+    }
+
+    const AnnotationRecord* annotations = get_table<AnnotationRecord>(TABLE_ANNOTATIONS, count);
+    const AnnotationParameterRecord* parameters =
+        get_table<AnnotationParameterRecord>(TABLE_ANNOTATION_PARAMETERS, sub_count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        check_string(annotations[i].name);
+        check_string(annotations[i].description);
+        check_range(annotations[i].first_parameter, annotations[i].parameter_count, sub_count);
+        check_layer(annotations[i].layer);
+        add_object_id(annotations[i].id);
+    }
+
+    for (uint64_t i = 0; i < sub_count; i++)
+    {
+        check_string(parameters[i].name);
+        check_string(parameters[i].value);
+    }
+
+    // With a change set, the references can also target unchanged objects of the logic model.
+    uint64_t removed_count = 0;
+    const uint64_t* removed = get_table<uint64_t>(TABLE_REMOVED_OBJECTS, removed_count);
+    std::unordered_set<object_id_t> removed_ids(removed, removed + removed_count);
+
+    auto check_object = [&](object_id_t id)
+    {
+        if (object_ids.find(id) != object_ids.end())
+            return;
+
+        if (!changes || !lmodel->exists_object(id) || removed_ids.find(id) != removed_ids.end())
+            throw InvalidFileFormatException("Invalid object reference in the binary logic model file.");
+    };
+
+    std::unordered_set<object_id_t> net_ids;
+    const NetRecord* nets = get_table<NetRecord>(TABLE_NETS, count);
+    const uint64_t* connections = get_table<uint64_t>(TABLE_NET_CONNECTIONS, sub_count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        check_range(nets[i].first_connection, nets[i].connection_count, sub_count);
+
+        if (!net_ids.insert(nets[i].id).second || (!changes && lmodel->exists_net(nets[i].id)))
+            throw InvalidFileFormatException("Duplicated net in the binary logic model file.");
+    }
+
+    for (uint64_t i = 0; i < sub_count; i++)
+        check_object(connections[i]);
+
+    uint64_t cell_count = 0, port_count = 0;
+    const ModuleRecord* modules = get_table<ModuleRecord>(TABLE_MODULES, count);
+    const uint64_t* cells = get_table<uint64_t>(TABLE_MODULE_CELLS, cell_count);
+    const ModulePortRecord* module_ports = get_table<ModulePortRecord>(TABLE_MODULE_PORTS, port_count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        check_string(modules[i].name);
+        check_string(modules[i].entity);
+        check_range(modules[i].first_cell, modules[i].cell_count, cell_count);
+        check_range(modules[i].first_port, modules[i].port_count, port_count);
+
+        // the parent of a module is stored before the module itself
+        if (modules[i].parent != NO_PARENT && modules[i].parent >= i)
+            throw InvalidFileFormatException("Invalid module in the binary logic model file.");
+    }
+
+    for (uint64_t i = 0; i < cell_count; i++)
+        check_object(cells[i]);
+
+    for (uint64_t i = 0; i < port_count; i++)
+    {
+        check_string(module_ports[i].name);
+        check_object(module_ports[i].object_id);
+    }
+}
+
+void LogicModelBinaryImporter::check_range(uint32_t first, uint32_t count, uint64_t table_size) const
+{
+    if (static_cast<uint64_t>(first) + count > table_size)
+        throw InvalidFileFormatException("Invalid reference in the binary logic model file.");
+}
+
+std::string LogicModelBinaryImporter::get_string(uint32_t index) const
+{
+    if (index == 0)
+        return std::string();
+
+    check_string(index);
+
+    return std::string(string_data + string_offsets[index], string_offsets[index + 1] - string_offsets[index]);
+}
+
+void LogicModelBinaryImporter::load_gates(LogicModel_shptr lmodel)
+{
+    uint64_t gate_count = 0, port_count = 0;
+    const GateRecord* gates = get_table<GateRecord>(TABLE_GATES, gate_count);
+    const GatePortRecord* ports = get_table<GatePortRecord>(TABLE_GATE_PORTS, port_count);
+
+    for (uint64_t i = 0; i < gate_count; i++)
+    {
+        GateRecord const& record = gates[i];
+
+        Gate_shptr gate = lmodel->create_object<Gate>(record.min_x, record.max_x, record.min_y, record.max_y,
+                                                      static_cast<Gate::ORIENTATION>(record.orientation));
+        gate->set_name(get_string(record.name));
+        gate->set_description(get_string(record.description));
+        gate->set_object_id(record.id);
+        gate->set_template_type_id(record.template_type_id);
+        gate->set_fill_color(record.fill_color);
+        gate->set_frame_color(record.frame_color);
+
+        if (gate_library != nullptr && record.template_type_id != 0)
+        {
+            GateTemplate_shptr tmpl = gate_library->get_template(record.template_type_id);
+            assert(tmpl != nullptr);
+            gate->set_gate_template(tmpl);
+        }
+
+        for (uint32_t p = record.first_port; p < record.first_port + record.port_count; p++)
+        {
+            GatePortRecord const& port_record = ports[p];
+
+            GatePort_shptr gate_port = lmodel->create_object<GatePort>(gate);
+            gate_port->set_object_id(port_record.id);
+            gate_port->set_template_port_type_id(port_record.template_port_type_id);
+            gate_port->set_diameter(port_record.diameter);
+
+            if (gate_library != nullptr)
+            {
+                GateTemplatePort_shptr tmpl_port = gate_library->get_template_port(port_record.template_port_type_id);
+                gate_port->set_template_port(tmpl_port);
+            }
+
+            gate->add_port(gate_port);
+        }
+
+        lmodel->add_object(record.layer, gate);
+    }
+}
+
+void LogicModelBinaryImporter::load_wires(LogicModel_shptr lmodel)
+{
+    uint64_t count = 0;
+    const WireRecord* wires = get_table<WireRecord>(TABLE_WIRES, count);
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        WireRecord const& record = wires[i];
+
+        Wire_shptr wire = lmodel->create_object<Wire>(record.from_x, record.from_y, record.to_x, record.to_y,
+                                                      record.diameter);
+        wire->set_name(get_string(record.name));
+        wire->set_description(get_string(record.description));
+        wire->set_object_id(record.id);
+        wire->set_fill_color(record.fill_color);
+        wire->set_frame_color(record.frame_color);
+        wire->set_remote_object_id(record.remote_id);
+
+        lmodel->add_object(record.layer, wire);
+    }
+}
+
+void LogicModelBinaryImporter::load_vias(LogicModel_shptr lmodel)
+{
+    uint64_t count = 0;
+    const ViaRecord* vias = get_table<ViaRecord>(TABLE_VIAS, count);
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        ViaRecord const& record = vias[i];
+
+        Via_shptr via = lmodel->create_object<Via>(record.x, record.y, record.diameter,
+                                                   static_cast<Via::DIRECTION>(record.direction));
+        via->set_name(get_string(record.name));
+        via->set_description(get_string(record.description));
+        via->set_object_id(record.id);
+        via->set_fill_color(record.fill_color);
+        via->set_frame_color(record.frame_color);
+        via->set_remote_object_id(record.remote_id);
+
+        lmodel->add_object(record.layer, via);
+    }
+}
+
+void LogicModelBinaryImporter::load_emarkers(LogicModel_shptr lmodel)
+{
+    uint64_t count = 0;
+    const EMarkerRecord* emarkers = get_table<EMarkerRecord>(TABLE_EMARKERS, count);
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        EMarkerRecord const& record = emarkers[i];
+
+        EMarker_shptr emarker = lmodel->create_object<EMarker>(record.x, record.y, record.diameter,
+                                                               record.is_module_port != 0);
+        emarker->set_name(get_string(record.name));
+        emarker->set_description(get_string(record.description));
+        emarker->set_object_id(record.id);
+        emarker->set_fill_color(record.fill_color);
+        emarker->set_frame_color(record.frame_color);
+        emarker->set_remote_object_id(record.remote_id);
+
+        lmodel->add_object(record.layer, emarker);
+    }
+}
+
+void LogicModelBinaryImporter::load_annotations(LogicModel_shptr lmodel)
+{
+    uint64_t count = 0, parameter_count = 0;
+    const AnnotationRecord* annotations = get_table<AnnotationRecord>(TABLE_ANNOTATIONS, count);
+    const AnnotationParameterRecord* parameters =
+        get_table<AnnotationParameterRecord>(TABLE_ANNOTATION_PARAMETERS, parameter_count);
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        AnnotationRecord const& record = annotations[i];
+
+        Annotation_shptr annotation;
+
+        if (record.class_id == Annotation::SUBPROJECT)
+        {
+            std::string path;
+            for (uint32_t p = record.first_parameter; p < record.first_parameter + record.parameter_count; p++)
+            {
+                if (get_string(parameters[p].name) == "subproject-directory")
+                    path = get_string(parameters[p].value);
+            }
+
+            annotation = std::make_shared<SubProjectAnnotation>(record.min_x, record.max_x,
+                                                                record.min_y, record.max_y,
+                                                                path);
+        }
+        else
+            annotation = std::make_shared<Annotation>(record.min_x, record.max_x,
+                                                      record.min_y, record.max_y,
+                                                      record.class_id);
+
+        annotation->set_name(get_string(record.name));
+        annotation->set_description(get_string(record.description));
+        annotation->set_object_id(record.id);
+        annotation->set_fill_color(record.fill_color);
+        annotation->set_frame_color(record.frame_color);
+
+        lmodel->add_object(record.layer, annotation);
+    }
+}
+
+void LogicModelBinaryImporter::load_nets(LogicModel_shptr lmodel)
+{
+    uint64_t net_count = 0, connection_count = 0;
+    const NetRecord* nets = get_table<NetRecord>(TABLE_NETS, net_count);
+    const uint64_t* connections = get_table<uint64_t>(TABLE_NET_CONNECTIONS, connection_count);
+
+    for (uint64_t i = 0; i < net_count; i++)
+    {
+        NetRecord const& record = nets[i];
+
+        Net_shptr net = lmodel->create_object<Net>();
+        net->set_object_id(record.id);
+
+        for (uint32_t c = record.first_connection; c < record.first_connection + record.connection_count; c++)
+        {
+            object_id_t object_id = connections[c];
+
+            PlacedLogicModelObject_shptr placed_object = lmodel->get_object(object_id);
+            ConnectedLogicModelObject_shptr o = std::dynamic_pointer_cast<ConnectedLogicModelObject>(placed_object);
+
+            if (o != nullptr)
+                o->set_net(net);
+            else
+                debug(TM, "Failed to connect logic model object %llu to net %llu.", object_id,
+                      static_cast<object_id_t>(record.id));
+        }
+
+        lmodel->add_net(net);
+    }
+}
+
+void LogicModelBinaryImporter::load_modules(LogicModel_shptr lmodel)
+{
+    uint64_t module_count = 0, cell_count = 0, port_count = 0;
+    const ModuleRecord* records = get_table<ModuleRecord>(TABLE_MODULES, module_count);
+    const uint64_t* cells = get_table<uint64_t>(TABLE_MODULE_CELLS, cell_count);
+    const ModulePortRecord* ports = get_table<ModulePortRecord>(TABLE_MODULE_PORTS, port_count);
+
+    std::vector<Module_shptr> modules;
+    modules.reserve(module_count);
+
+    for (uint64_t i = 0; i < module_count; i++)
+    {
+        ModuleRecord const& record = records[i];
+
+        Module_shptr module(new Module(get_string(record.name), get_string(record.entity)));
+        module->set_object_id(record.id);
+
+        for (uint32_t c = record.first_cell; c < record.first_cell + record.cell_count; c++)
+        {
+            // Lookup will throw an exception, if cell is not in the logic model. This is intended behaviour.
+            if (Gate_shptr gate = std::dynamic_pointer_cast<Gate>(lmodel->get_object(cells[c])))
+                module->add_gate(gate, /* autodetect module ports = */ false);
+        }
+
+        for (uint32_t p = record.first_port; p < record.first_port + record.port_count; p++)
+        {
+            // Lookup will throw an exception, if cell is not in the logic model. This is intended behaviour.
+            if (GatePort_shptr gport = std::dynamic_pointer_cast<GatePort>(lmodel->get_object(ports[p].object_id)))
+                module->add_module_port(get_string(ports[p].name), gport);
+        }
+
+        if (record.parent == NO_PARENT)
+            lmodel->set_main_module(module);
+        else
+            modules[record.parent]->add_module(module);
+
+        modules.push_back(module);
+    }
+}
@@ -0,0 +1,173 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __LOGICMODELBINARYIMPORTER_H__
+#define __LOGICMODELBINARYIMPORTER_H__
+
+#include "Globals.h"
+#include "LogicModel.h"
+#include "LogicModelBinaryFormat.h"
+#include "Core/Utils/Importer.h"
+
+#include <QFile>
+
+#include <string>
+
+namespace degate
+{
+    /**
+     * This class implements a loader for the binary logic model file (lmodel.bin).
+     *
+     * The file is mapped into memory and the records are used in place, no number
+     * has to be parsed. Strings are only copied out of the string table for objects
+     * that have a name or a description.
+     */
+    class LogicModelBinaryImporter : public Importer
+    {
+    private:
+
+        unsigned int width, height;
+        GateLibrary_shptr gate_library;
+
+        const uchar* data = nullptr;
+        uint64_t data_size = 0;
+
+        const uint64_t* string_offsets = nullptr;
+        uint64_t string_count = 0;
+        const char* string_data = nullptr;
+        uint64_t string_data_size = 0;
+
+        /**
+         * Check the header of the mapped file.
+         * @exception InvalidFileFormatException This exception is thrown if the file is not a valid
+         *   binary logic model for this machine.
+         */
+        void check_header() const;
+
+        /**
+         * Get a table of the mapped file.
+         * @param table_id The table to get.
+         * @param count Will be set to the number of records.
+         * @return Returns a pointer to the first record or nullptr if the table is empty.
+         * @exception InvalidFileFormatException This exception is thrown if the table is missing or malformed.
+         */
+        template <typename T>
+        const T* get_table(lmodel_binary::TABLE_ID table_id, uint64_t& count) const;
+
+        /**
+         * Check all records and the references between them (strings, layers, gate templates,
+         * object ids, net connections and module cells and ports), so that loading can't fail.
+         * @param lmodel The logic model the data will be loaded into.
+         * @param changes If true, the data is a change set (@see import_changes) and references
+         *   can target objects already in the logic model.
+         * @exception InvalidFileFormatException This exception is thrown if the file is malformed.
+         */
+        void validate(LogicModel_shptr lmodel, bool changes) const;
+
+        /**
+         * Check the header, load the string table and validate the data (@see validate).
+         * @exception InvalidFileFormatException This exception is thrown if the data is malformed.
+         */
+        void check_data(LogicModel_shptr lmodel, bool changes);
+
+        /**
+         * Forget the data, it is not valid anymore.
+         */
+        void release_data();
+
+        void remove_object_if_exists(LogicModel_shptr lmodel, object_id_t object_id);
+
+        void check_string(uint32_t index) const;
+
+        void check_range(uint32_t first, uint32_t count, uint64_t table_size) const;
+
+        /**
+         * Get a string from the string table.
+         */
+        std::string get_string(uint32_t index) const;
+
+        void load_gates(LogicModel_shptr lmodel);
+        void load_wires(LogicModel_shptr lmodel);
+        void load_vias(LogicModel_shptr lmodel);
+        void load_emarkers(LogicModel_shptr lmodel);
+        void load_annotations(LogicModel_shptr lmodel);
+        void load_nets(LogicModel_shptr lmodel);
+        void load_modules(LogicModel_shptr lmodel);
+
+    public:
+
+        /**
+         * Create a binary logic model importer.
+         * @param width The geometrical width of the logic model.
+         * @param height The geometrical height of the logic model.
+         * @param gate_library The gate library to resolve references to gate templates.
+         */
+        LogicModelBinaryImporter(unsigned int width, unsigned int height, GateLibrary_shptr gate_library) :
+            width(width),
+            height(height),
+            gate_library(gate_library)
+        {
+        }
+
+        /**
+         * Create a binary logic model importer. The gate library is not used to resolve references.
+         * @param width The geometrical width of the logic model.
+         * @param height The geometrical height of the logic model.
+         */
+        LogicModelBinaryImporter(unsigned int width, unsigned int height) :
+            width(width),
+            height(height)
+        {
+        }
+
+        ~LogicModelBinaryImporter()
+        {
+        }
+
+        /**
+         * Import a logic model.
+         */
+        LogicModel_shptr import(std::string const& filename, ProjectType project_type);
+
+        /**
+         * Import a logic model that is stored in a binary file into an existing logic model.
+         * The whole file is checked first, the logic model is not modified if the file is
+         * malformed, was written by another version or on a machine with another byte order.
+         * @exception InvalidPathException This exception is thrown if the file can't be opened.
+         * @exception InvalidFileFormatException This exception is thrown if the file is not valid.
+         */
+        void import_into(LogicModel_shptr lmodel, std::string const& filename);
+
+        /**
+         * Apply a change set written by LogicModelBinaryExporter::serialize() to a logic model
+         * (an entry of the project journal). Changed objects and nets replace the existing ones,
+         * removed objects are removed.
+         *
+         * The entry is checked first, the logic model is not modified if it is malformed.
+         * @param entry The entry, aligned to 8 bytes.
+         * @param entry_size The size of the entry in bytes.
+         * @exception InvalidFileFormatException This exception is thrown if the entry is not valid.
+         */
+        void import_changes(LogicModel_shptr lmodel, const char* entry, uint64_t entry_size);
+    };
+}
+
+#endif
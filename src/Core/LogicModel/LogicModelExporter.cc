@@ -21,6 +21,8 @@
 
 #include "LogicModelExporter.h"
 
+#include <QSaveFile>
+
 #include <sys/types.h>
 #include <sys/stat.h>
 //#include <unistd.h> : Linux only
@@ -40,100 +42,81 @@ void LogicModelExporter::export_data(std::string const& filename, LogicModel_shp
 {
     if (lmodel == nullptr) throw InvalidPointerException("Logic model pointer is nullptr.");
 
+    export_snapshot(filename, LogicModelSnapshot(lmodel, oid_rewriter));
+}
+
+void LogicModelExporter::export_snapshot(std::string const& filename, LogicModelSnapshot const& snapshot)
+{
     try
     {
-        QDomDocument doc;
-
-        QDomProcessingInstruction head = doc.createProcessingInstruction("xml", XML_ENCODING);
-        doc.appendChild(head);
-
-        QDomElement root_elem = doc.createElement("logic-model");
-        assert(!root_elem.isNull());
-
-        QDomElement gates_elem = doc.createElement("gates");
-        if (gates_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-        QDomElement vias_elem = doc.createElement("vias");
-        if (vias_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-        QDomElement emarkers_elem = doc.createElement("emarkers");
-        if (emarkers_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-        QDomElement wires_elem = doc.createElement("wires");
-        if (wires_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-        QDomElement nets_elem = doc.createElement("nets");
-        if (nets_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-        QDomElement annotations_elem = doc.createElement("annotations");
-        if (annotations_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-        for (auto layer_iter = lmodel->layers_begin();
-             layer_iter != lmodel->layers_end(); ++layer_iter)
+        // The file is replaced atomically, a crash while writing leaves the previous file intact.
+        QSaveFile file(QString::fromStdString(filename));
+        if (!file.open(QIODevice::WriteOnly))
         {
-            if ((*layer_iter) == nullptr || (*layer_iter)->is_empty())
-                continue;
-
-            Layer_shptr layer = *layer_iter;
+            throw InvalidPathException("Can't create export file.");
+        }
 
-            for (Layer::object_iterator iter = layer->objects_begin();
-                 iter != layer->objects_end(); ++iter)
-            {
-                layer_position_t layer_pos = layer->get_layer_pos();
+        QXmlStreamWriter writer(&file);
+        writer.setAutoFormatting(true);
+        writer.setAutoFormattingIndent(1);
 
-                PlacedLogicModelObject_shptr o = (*iter);
+        writer.writeStartDocument();
+        writer.writeStartElement("logic-model");
 
-                if (Gate_shptr gate = std::dynamic_pointer_cast<Gate>(o))
-                    add_gate(doc, gates_elem, gate, layer_pos);
+        writer.writeStartElement("gates");
+        for (auto const& gate : snapshot.gates)
+            add_gate(writer, snapshot, gate);
+        writer.writeEndElement();
 
-                else if (Via_shptr via = std::dynamic_pointer_cast<Via>(o))
-                    add_via(doc, vias_elem, via, layer_pos);
+        writer.writeStartElement("vias");
+        for (auto const& via : snapshot.vias)
+            add_via(writer, snapshot, via);
+        writer.writeEndElement();
 
-                else if (EMarker_shptr emarker = std::dynamic_pointer_cast<EMarker>(o))
-                    add_emarker(doc, emarkers_elem, emarker, layer_pos);
+        writer.writeStartElement("emarkers");
+        for (auto const& emarker : snapshot.emarkers)
+            add_emarker(writer, snapshot, emarker);
+        writer.writeEndElement();
 
-                else if (Wire_shptr wire = std::dynamic_pointer_cast<Wire>(o))
-                    add_wire(doc, wires_elem, wire, layer_pos);
+        writer.writeStartElement("wires");
+        for (auto const& wire : snapshot.wires)
+            add_wire(writer, snapshot, wire);
+        writer.writeEndElement();
 
-                else if (Annotation_shptr annotation = std::dynamic_pointer_cast<Annotation>(o))
-                    add_annotation(doc, annotations_elem, annotation, layer_pos);
-            }
-        }
+        writer.writeStartElement("annotations");
+        for (auto const& annotation : snapshot.annotations)
+            add_annotation(writer, snapshot, annotation);
+        writer.writeEndElement();
 
-        add_nets(doc, nets_elem, lmodel);
+        writer.writeStartElement("nets");
+        add_nets(writer, snapshot);
+        writer.writeEndElement();
 
         // actually we have only one main module
 
-        // First update the module ports.
-        determine_module_ports_for_root(lmodel); // Update main module itself.
-        lmodel->get_main_module()->determine_module_ports_recursive(); // Update all of main module's children.
+        // Modules are stored in pre-order with a reference to their parent.
+        std::vector<std::vector<uint32_t>> sub_modules(snapshot.modules.size());
+        std::vector<uint32_t> root_modules;
 
-        QDomElement modules_elem = doc.createElement("modules");
-        if (modules_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-        add_module(doc, modules_elem, lmodel, lmodel->get_main_module());
-
-        root_elem.appendChild(gates_elem);
-        root_elem.appendChild(vias_elem);
-        root_elem.appendChild(emarkers_elem);
-        root_elem.appendChild(wires_elem);
-        root_elem.appendChild(annotations_elem);
-        root_elem.appendChild(nets_elem);
-        root_elem.appendChild(modules_elem);
-
-        doc.appendChild(root_elem);
-
-        QFile file(QString::fromStdString(filename));
-        if (!file.open(QIODevice::WriteOnly))
+        for (uint32_t i = 0; i < snapshot.modules.size(); i++)
         {
-            throw InvalidPathException("Can't create export file.");
+            uint32_t parent = snapshot.modules[i].parent;
+            if (parent == lmodel_binary::NO_PARENT)
+                root_modules.push_back(i);
+            else
+                sub_modules[parent].push_back(i);
         }
 
-        QTextStream stream(&file);
-        stream.setEncoding(QStringConverter::Utf8);
-        stream << doc.toString();
+        writer.writeStartElement("modules");
+        for (auto module_index : root_modules)
+            add_module(writer, snapshot, module_index, sub_modules);
+        writer.writeEndElement();
+
+        writer.writeEndElement(); // logic-model
+        writer.writeEndDocument();
 
-        file.close();
+        if (writer.hasError() || !file.commit())
+            throw InvalidPathException("Can't write export file.");
     }
     catch (const std::exception& ex)
     {
@@ -142,284 +125,217 @@ void LogicModelExporter::export_data(std::string const& filename, LogicModel_shp
     }
 }
 
-void LogicModelExporter::add_nets(QDomDocument& doc, QDomElement& nets_elem, LogicModel_shptr lmodel)
+void LogicModelExporter::add_nets(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot)
 {
-    for (LogicModel::net_collection::iterator net_iter = lmodel->nets_begin();
-         net_iter != lmodel->nets_end(); ++net_iter)
+    for (auto const& net : snapshot.nets)
     {
-        QDomElement net_elem = doc.createElement("net");
-
-        Net_shptr net = net_iter->second;
-        assert(net != nullptr);
-
-        object_id_t old_net_id = net->get_object_id();
-        assert(old_net_id != 0);
-        object_id_t new_net_id = oid_rewriter->get_new_object_id(old_net_id);
+        assert(net.id != 0);
 
-        net_elem.setAttribute("id", QString::fromStdString(number_to_string<object_id_t>(new_net_id)));
+        writer.writeStartElement("net");
+        writer.writeAttribute("id", QString::number(net.id));
 
-        for (Net::connection_iterator conn_iter = net->begin();
-             conn_iter != net->end(); ++conn_iter)
+        for (uint32_t i = net.first_connection; i < net.first_connection + net.connection_count; i++)
         {
-            object_id_t oid = *conn_iter;
-
-            const ConnectedLogicModelObject_shptr conn_obj =
-                std::dynamic_pointer_cast<ConnectedLogicModelObject>(lmodel->get_object(oid));
-
-            QDomElement conn_elem = doc.createElement("connection");
-            conn_elem.setAttribute("object-id",
-                                   QString::fromStdString(
-                                       number_to_string<object_id_t>(oid_rewriter->get_new_object_id(oid))));
-            net_elem.appendChild(conn_elem);
+            writer.writeEmptyElement("connection");
+            writer.writeAttribute("object-id", QString::number(snapshot.net_connections[i]));
         }
 
-        nets_elem.appendChild(net_elem);
+        writer.writeEndElement();
     }
 }
 
-void LogicModelExporter::add_gate(QDomDocument& doc, QDomElement& gates_elem, Gate_shptr gate,
-                                  layer_position_t layer_pos)
+void LogicModelExporter::add_gate(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                                  lmodel_binary::GateRecord const& gate)
 {
-    QDomElement gate_elem = doc.createElement("gate");
-    if (gate_elem.isNull()) throw(std::runtime_error("Failed to create node."));
+    writer.writeStartElement("gate");
 
-    object_id_t new_oid = oid_rewriter->get_new_object_id(gate->get_object_id());
-    gate_elem.setAttribute("id", QString::fromStdString(number_to_string<object_id_t>(new_oid)));
-    gate_elem.setAttribute("name", QString::fromStdString(gate->get_name()));
-    gate_elem.setAttribute("description", QString::fromStdString(gate->get_description()));
-    gate_elem.setAttribute("layer", QString::fromStdString(number_to_string<layer_position_t>(layer_pos)));
-    gate_elem.setAttribute("orientation", QString::fromStdString(gate->get_orienation_type_as_string()));
+    writer.writeAttribute("id", QString::number(gate.id));
+    writer.writeAttribute("name", QString::fromStdString(snapshot.get_string(gate.name)));
+    writer.writeAttribute("description", QString::fromStdString(snapshot.get_string(gate.description)));
+    writer.writeAttribute("layer", QString::number(gate.layer));
+    writer.writeAttribute("orientation", QString::fromStdString(
+        Gate::get_orienation_type_as_string(static_cast<Gate::ORIENTATION>(gate.orientation))));
 
-    gate_elem.setAttribute("min-x", QString::fromStdString(number_to_string<float>(gate->get_min_x())));
-    gate_elem.setAttribute("min-y", QString::fromStdString(number_to_string<float>(gate->get_min_y())));
-    gate_elem.setAttribute("max-x", QString::fromStdString(number_to_string<float>(gate->get_max_x())));
-    gate_elem.setAttribute("max-y", QString::fromStdString(number_to_string<float>(gate->get_max_y())));
+    writer.writeAttribute("min-x", float_to_string(gate.min_x));
+    writer.writeAttribute("min-y", float_to_string(gate.min_y));
+    writer.writeAttribute("max-x", float_to_string(gate.max_x));
+    writer.writeAttribute("max-y", float_to_string(gate.max_y));
 
-    gate_elem.setAttribute("type-id",
-                           QString::fromStdString(number_to_string<object_id_t>(
-                               oid_rewriter->get_new_object_id(gate->get_template_type_id()))));
+    writer.writeAttribute("type-id", QString::number(gate.template_type_id));
 
-
-    for (Gate::port_iterator iter = gate->ports_begin();
-         iter != gate->ports_end(); ++iter)
+    for (uint32_t i = gate.first_port; i < gate.first_port + gate.port_count; i++)
     {
-        GatePort_shptr port = *iter;
-
-        QDomElement port_elem = doc.createElement("port");
-        if (port_elem.isNull()) throw(std::runtime_error("Failed to create node."));
+        lmodel_binary::GatePortRecord const& port = snapshot.gate_ports[i];
 
-        object_id_t new_port_id = oid_rewriter->get_new_object_id(port->get_object_id());
-        port_elem.setAttribute("id", QString::fromStdString(number_to_string<object_id_t>(new_port_id)));
+        writer.writeEmptyElement("port");
 
-        if (port->get_name().size() > 0) port_elem.setAttribute("name", QString::fromStdString(port->get_name()));
-        if (port->get_description().size() > 0) port_elem.setAttribute("description",
-                                                                       QString::fromStdString(port->get_description()));
+        writer.writeAttribute("id", QString::number(port.id));
 
-        object_id_t new_type_id = oid_rewriter->get_new_object_id(port->get_template_port_type_id());
-        port_elem.setAttribute("type-id", QString::fromStdString(number_to_string<object_id_t>(new_type_id)));
+        if (port.name != 0) writer.writeAttribute("name", QString::fromStdString(snapshot.get_string(port.name)));
+        if (port.description != 0) writer.writeAttribute("description",
+                                                         QString::fromStdString(snapshot.get_string(port.description)));
 
-        port_elem.setAttribute("diameter", QString::fromStdString(number_to_string<diameter_t>(port->get_diameter())));
+        writer.writeAttribute("type-id", QString::number(port.template_port_type_id));
 
-        gate_elem.appendChild(port_elem);
+        writer.writeAttribute("diameter", QString::number(port.diameter));
     }
 
-    gates_elem.appendChild(gate_elem);
+    writer.writeEndElement();
 }
 
-void LogicModelExporter::add_wire(QDomDocument& doc, QDomElement& wires_elem, Wire_shptr wire,
-                                  layer_position_t layer_pos)
+void LogicModelExporter::add_wire(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                                  lmodel_binary::WireRecord const& wire)
 {
-    QDomElement wire_elem = doc.createElement("wire");
-    if (wire_elem.isNull()) throw(std::runtime_error("Failed to create node."));
+    writer.writeEmptyElement("wire");
 
-    object_id_t new_oid = oid_rewriter->get_new_object_id(wire->get_object_id());
-    wire_elem.setAttribute("id", QString::fromStdString(number_to_string<object_id_t>(new_oid)));
-    wire_elem.setAttribute("name", QString::fromStdString(wire->get_name()));
-    wire_elem.setAttribute("description", QString::fromStdString(wire->get_description()));
-    wire_elem.setAttribute("layer", QString::fromStdString(number_to_string<layer_position_t>(layer_pos)));
-    wire_elem.setAttribute("diameter", QString::fromStdString(number_to_string<unsigned int>(wire->get_diameter())));
+    writer.writeAttribute("id", QString::number(wire.id));
+    writer.writeAttribute("name", QString::fromStdString(snapshot.get_string(wire.name)));
+    writer.writeAttribute("description", QString::fromStdString(snapshot.get_string(wire.description)));
+    writer.writeAttribute("layer", QString::number(wire.layer));
+    writer.writeAttribute("diameter", QString::number(wire.diameter));
 
-    wire_elem.setAttribute("from-x", QString::fromStdString(number_to_string<float>(wire->get_from_x())));
-    wire_elem.setAttribute("from-y", QString::fromStdString(number_to_string<float>(wire->get_from_y())));
-    wire_elem.setAttribute("to-x", QString::fromStdString(number_to_string<float>(wire->get_to_x())));
-    wire_elem.setAttribute("to-y", QString::fromStdString(number_to_string<float>(wire->get_to_y())));
+    writer.writeAttribute("from-x", float_to_string(wire.from_x));
+    writer.writeAttribute("from-y", float_to_string(wire.from_y));
+    writer.writeAttribute("to-x", float_to_string(wire.to_x));
+    writer.writeAttribute("to-y", float_to_string(wire.to_y));
 
-    wire_elem.setAttribute("fill-color", QString::fromStdString(to_color_string(wire->get_fill_color())));
-    wire_elem.setAttribute("frame-color", QString::fromStdString(to_color_string(wire->get_frame_color())));
+    writer.writeAttribute("fill-color", QString::fromStdString(to_color_string(wire.fill_color)));
+    writer.writeAttribute("frame-color", QString::fromStdString(to_color_string(wire.frame_color)));
 
-    wire_elem.setAttribute("remote-id",
-                           QString::fromStdString(number_to_string<object_id_t>(wire->get_remote_object_id())));
-
-    wires_elem.appendChild(wire_elem);
+    writer.writeAttribute("remote-id", QString::number(wire.remote_id));
 }
 
-void LogicModelExporter::add_via(QDomDocument& doc, QDomElement& vias_elem, Via_shptr via, layer_position_t layer_pos)
+void LogicModelExporter::add_via(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                                 lmodel_binary::ViaRecord const& via)
 {
-    QDomElement via_elem = doc.createElement("via");
-    if (via_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-    object_id_t new_oid = oid_rewriter->get_new_object_id(via->get_object_id());
-    via_elem.setAttribute("id", QString::fromStdString(number_to_string<object_id_t>(new_oid)));
-    via_elem.setAttribute("name", QString::fromStdString(via->get_name()));
-    via_elem.setAttribute("description", QString::fromStdString(via->get_description()));
-    via_elem.setAttribute("layer", QString::fromStdString(number_to_string<layer_position_t>(layer_pos)));
-    via_elem.setAttribute("diameter", QString::fromStdString(number_to_string<unsigned int>(via->get_diameter())));
+    writer.writeEmptyElement("via");
 
-    via_elem.setAttribute("x", QString::fromStdString(number_to_string<float>(via->get_x())));
-    via_elem.setAttribute("y", QString::fromStdString(number_to_string<float>(via->get_y())));
+    writer.writeAttribute("id", QString::number(via.id));
+    writer.writeAttribute("name", QString::fromStdString(snapshot.get_string(via.name)));
+    writer.writeAttribute("description", QString::fromStdString(snapshot.get_string(via.description)));
+    writer.writeAttribute("layer", QString::number(via.layer));
+    writer.writeAttribute("diameter", QString::number(via.diameter));
 
-    via_elem.setAttribute("fill-color", QString::fromStdString(to_color_string(via->get_fill_color())));
-    via_elem.setAttribute("frame-color", QString::fromStdString(to_color_string(via->get_frame_color())));
+    writer.writeAttribute("x", float_to_string(via.x));
+    writer.writeAttribute("y", float_to_string(via.y));
 
-    via_elem.setAttribute("direction", QString::fromStdString(via->get_direction_as_string()));
-    via_elem.setAttribute("remote-id",
-                          QString::fromStdString(number_to_string<object_id_t>(via->get_remote_object_id())));
+    writer.writeAttribute("fill-color", QString::fromStdString(to_color_string(via.fill_color)));
+    writer.writeAttribute("frame-color", QString::fromStdString(to_color_string(via.frame_color)));
 
-    vias_elem.appendChild(via_elem);
+    writer.writeAttribute("direction", QString::fromStdString(
+        Via::get_direction_as_string(static_cast<Via::DIRECTION>(via.direction))));
+    writer.writeAttribute("remote-id", QString::number(via.remote_id));
 }
 
-void LogicModelExporter::add_emarker(QDomDocument& doc, QDomElement& emarkers_elem, EMarker_shptr emarker,
-                                     layer_position_t layer_pos)
+void LogicModelExporter::add_emarker(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                                     lmodel_binary::EMarkerRecord const& emarker)
 {
-    QDomElement emarker_elem = doc.createElement("emarker");
-    if (emarker_elem.isNull()) throw(std::runtime_error("Failed to create node."));
+    writer.writeEmptyElement("emarker");
 
-    object_id_t new_oid = oid_rewriter->get_new_object_id(emarker->get_object_id());
-    emarker_elem.setAttribute("id", QString::fromStdString(number_to_string<object_id_t>(new_oid)));
-    emarker_elem.setAttribute("name", QString::fromStdString(emarker->get_name()));
-    emarker_elem.setAttribute("description", QString::fromStdString(emarker->get_description()));
-    emarker_elem.setAttribute("is-module-port", emarker->is_module_port());
-    emarker_elem.setAttribute("layer", QString::fromStdString(number_to_string<layer_position_t>(layer_pos)));
-    emarker_elem.setAttribute(
-        "diameter", QString::fromStdString(number_to_string<unsigned int>(emarker->get_diameter())));
+    writer.writeAttribute("id", QString::number(emarker.id));
+    writer.writeAttribute("name", QString::fromStdString(snapshot.get_string(emarker.name)));
+    writer.writeAttribute("description", QString::fromStdString(snapshot.get_string(emarker.description)));
+    writer.writeAttribute("is-module-port", QString::number(emarker.is_module_port));
+    writer.writeAttribute("layer", QString::number(emarker.layer));
+    writer.writeAttribute("diameter", QString::number(emarker.diameter));
 
-    emarker_elem.setAttribute("x", QString::fromStdString(number_to_string<float>(emarker->get_x())));
-    emarker_elem.setAttribute("y", QString::fromStdString(number_to_string<float>(emarker->get_y())));
+    writer.writeAttribute("x", float_to_string(emarker.x));
+    writer.writeAttribute("y", float_to_string(emarker.y));
 
-    emarker_elem.setAttribute("fill-color", QString::fromStdString(to_color_string(emarker->get_fill_color())));
-    emarker_elem.setAttribute("frame-color", QString::fromStdString(to_color_string(emarker->get_frame_color())));
+    writer.writeAttribute("fill-color", QString::fromStdString(to_color_string(emarker.fill_color)));
+    writer.writeAttribute("frame-color", QString::fromStdString(to_color_string(emarker.frame_color)));
 
-    emarker_elem.setAttribute("remote-id",
-                              QString::fromStdString(number_to_string<object_id_t>(emarker->get_remote_object_id())));
-
-    emarkers_elem.appendChild(emarker_elem);
+    writer.writeAttribute("remote-id", QString::number(emarker.remote_id));
 }
 
 
-void LogicModelExporter::add_annotation(QDomDocument& doc, QDomElement& annotations_elem, Annotation_shptr annotation,
-                                        layer_position_t layer_pos)
+void LogicModelExporter::add_annotation(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                                        lmodel_binary::AnnotationRecord const& annotation)
 {
-    QDomElement annotation_elem = doc.createElement("annotation");
-    if (annotation_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-    object_id_t new_oid = oid_rewriter->get_new_object_id(annotation->get_object_id());
-    annotation_elem.setAttribute("id", QString::fromStdString(number_to_string<object_id_t>(new_oid)));
-    annotation_elem.setAttribute("name", QString::fromStdString(annotation->get_name()));
-    annotation_elem.setAttribute("description", QString::fromStdString(annotation->get_description()));
-    annotation_elem.setAttribute("layer", QString::fromStdString(number_to_string<layer_position_t>(layer_pos)));
-    annotation_elem.setAttribute(
-        "class-id", QString::fromStdString(number_to_string<layer_position_t>(annotation->get_class_id())));
-
-    annotation_elem.setAttribute("min-x", QString::fromStdString(number_to_string<float>(annotation->get_min_x())));
-    annotation_elem.setAttribute("min-y", QString::fromStdString(number_to_string<float>(annotation->get_min_y())));
-    annotation_elem.setAttribute("max-x", QString::fromStdString(number_to_string<float>(annotation->get_max_x())));
-    annotation_elem.setAttribute("max-y", QString::fromStdString(number_to_string<float>(annotation->get_max_y())));
-
-    annotation_elem.setAttribute("fill-color", QString::fromStdString(to_color_string(annotation->get_fill_color())));
-    annotation_elem.setAttribute("frame-color", QString::fromStdString(to_color_string(annotation->get_frame_color())));
-
-    for (Annotation::parameter_set_type::const_iterator iter = annotation->parameters_begin();
-         iter != annotation->parameters_end(); ++iter)
+    writer.writeEmptyElement("annotation");
+
+    writer.writeAttribute("id", QString::number(annotation.id));
+    writer.writeAttribute("name", QString::fromStdString(snapshot.get_string(annotation.name)));
+    writer.writeAttribute("description", QString::fromStdString(snapshot.get_string(annotation.description)));
+    writer.writeAttribute("layer", QString::number(annotation.layer));
+    writer.writeAttribute("class-id", QString::number(annotation.class_id));
+
+    writer.writeAttribute("min-x", float_to_string(annotation.min_x));
+    writer.writeAttribute("min-y", float_to_string(annotation.min_y));
+    writer.writeAttribute("max-x", float_to_string(annotation.max_x));
+    writer.writeAttribute("max-y", float_to_string(annotation.max_y));
+
+    writer.writeAttribute("fill-color", QString::fromStdString(to_color_string(annotation.fill_color)));
+    writer.writeAttribute("frame-color", QString::fromStdString(to_color_string(annotation.frame_color)));
+
+    for (uint32_t i = annotation.first_parameter; i < annotation.first_parameter + annotation.parameter_count; i++)
     {
-        annotation_elem.setAttribute(QString::fromStdString(iter->first), QString::fromStdString(iter->second));
+        lmodel_binary::AnnotationParameterRecord const& parameter = snapshot.annotation_parameters[i];
+        writer.writeAttribute(QString::fromStdString(snapshot.get_string(parameter.name)),
+                              QString::fromStdString(snapshot.get_string(parameter.value)));
     }
-
-    annotations_elem.appendChild(annotation_elem);
 }
 
 
-void LogicModelExporter::add_module(QDomDocument& doc, QDomElement& modules_elem, LogicModel_shptr lmodel,
-                                    Module_shptr module)
+void LogicModelExporter::add_module(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                                    uint32_t module_index, std::vector<std::vector<uint32_t>> const& sub_modules)
 {
-    QDomElement this_elem = doc.createElement("module");
-    if (this_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-    QDomElement module_ports_elem = doc.createElement("module-ports");
-    QDomElement cells_elem = doc.createElement("cells");
-    QDomElement sub_modules_elem = doc.createElement("modules");
-    if (module_ports_elem.isNull() ||
-        cells_elem.isNull() ||
-        sub_modules_elem.isNull())
-        throw(std::runtime_error("Failed to create node."));
-
     /*
       <module id="42" name="ff23" entity-type="flip-flop">
-  
+
+        <modules>
+          ...
+        </modules>
+
+        <cells>
+          <cell id="9999"/>
+        </cells>
+
         <module-ports>
           <module-port name="d" object-id="666"/> -- connected with object 666
           <module-port name="q" object-id="667"/>
         </module-ports>
-  
-        <cells>
-          <cell id="9999"/>
-        </cells>
-  
-        <modules>
-          ...
-        </modules>
-  
+
       </module>
-  
-    */
 
-    // module itself
+    */
 
-    object_id_t new_mod_id = oid_rewriter->get_new_object_id(module->get_object_id());
-    this_elem.setAttribute("id", QString::fromStdString(number_to_string<object_id_t>(new_mod_id)));
-    this_elem.setAttribute("name", QString::fromStdString(module->get_name()));
-    this_elem.setAttribute("entity", QString::fromStdString(module->get_entity_name()));
+    lmodel_binary::ModuleRecord const& module = snapshot.modules[module_index];
 
-    // write module ports
-    for (Module::port_collection::const_iterator p_iter = module->ports_begin();
-         p_iter != module->ports_end(); ++p_iter)
-    {
-        QDomElement mport_elem = doc.createElement("module-port");
-        if (mport_elem.isNull()) throw(std::runtime_error("Failed to create node."));
+    writer.writeStartElement("module");
 
-        GatePort_shptr gport = p_iter->second;
+    // module itself
 
-        mport_elem.setAttribute("name", QString::fromStdString(p_iter->first));
-        new_mod_id = oid_rewriter->get_new_object_id(gport->get_object_id());
-        mport_elem.setAttribute("object-id",
-                                QString::fromStdString(number_to_string<object_id_t>(new_mod_id)));
+    writer.writeAttribute("id", QString::number(module.id));
+    writer.writeAttribute("name", QString::fromStdString(snapshot.get_string(module.name)));
+    writer.writeAttribute("entity", QString::fromStdString(snapshot.get_string(module.entity)));
 
-        module_ports_elem.appendChild(mport_elem);
+    // write sub-modules
+    writer.writeStartElement("modules");
+    for (auto sub_module_index : sub_modules[module_index])
+    {
+        add_module(writer, snapshot, sub_module_index, sub_modules);
     }
+    writer.writeEndElement();
 
     // write standard cells
-    for (Module::gate_collection::const_iterator g_iter = module->gates_begin();
-         g_iter != module->gates_end(); ++g_iter)
+    writer.writeStartElement("cells");
+    for (uint32_t i = module.first_cell; i < module.first_cell + module.cell_count; i++)
     {
-        QDomElement cell_elem = doc.createElement("cell");
-        if (cell_elem.isNull()) throw(std::runtime_error("Failed to create node."));
-
-        new_mod_id = oid_rewriter->get_new_object_id((*g_iter)->get_object_id());
-        cell_elem.setAttribute("object-id",
-                               QString::fromStdString(number_to_string<object_id_t>(new_mod_id)));
-
-        cells_elem.appendChild(cell_elem);
+        writer.writeEmptyElement("cell");
+        writer.writeAttribute("object-id", QString::number(snapshot.module_cells[i]));
     }
+    writer.writeEndElement();
 
-    // write sub-modules
-    for (Module::module_collection::const_iterator m_iter = module->modules_begin();
-         m_iter != module->modules_end(); ++m_iter)
+    // write module ports
+    writer.writeStartElement("module-ports");
+    for (uint32_t i = module.first_port; i < module.first_port + module.port_count; i++)
     {
-        add_module(doc, sub_modules_elem, lmodel, *m_iter);
+        writer.writeEmptyElement("module-port");
+        writer.writeAttribute("name", QString::fromStdString(snapshot.get_string(snapshot.module_ports[i].name)));
+        writer.writeAttribute("object-id", QString::number(snapshot.module_ports[i].object_id));
     }
+    writer.writeEndElement();
 
-    this_elem.appendChild(sub_modules_elem);
-    this_elem.appendChild(cells_elem);
-    this_elem.appendChild(module_ports_elem);
-
-    modules_elem.appendChild(this_elem);
+    writer.writeEndElement(); // module
 }
@@ -24,36 +24,43 @@
 
 #include "Globals.h"
 #include "LogicModel.h"
+#include "LogicModelSnapshot.h"
 #include "Core/XML/XMLExporter.h"
 #include "Core/Utils/ObjectIDRewriter.h"
 #include "Layer.h"
 
 #include <stdexcept>
+#include <vector>
 
 namespace degate
 {
     /**
      * The LogicModelExporter exports a logic model. That is the file lmodel.xml from your degate project.
      *
+     * The elements are written directly into the file with a XML stream writer from
+     * a snapshot of the logic model, no document tree is built.
      */
     class LogicModelExporter : public XMLExporter
     {
     private:
-        typedef std::map<object_id_t /* net id */, QDomElement&> net_element_map_type;
 
-        void add_gate(QDomDocument& doc, QDomElement& gates_elem, Gate_shptr gate, layer_position_t layer_pos);
-        void add_wire(QDomDocument& doc, QDomElement& wires_elem, Wire_shptr wire, layer_position_t layer_pos);
-        void add_via(QDomDocument& doc, QDomElement& vias_elem, Via_shptr via, layer_position_t layer_pos);
+        void add_gate(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                      lmodel_binary::GateRecord const& gate);
+        void add_wire(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                      lmodel_binary::WireRecord const& wire);
+        void add_via(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                     lmodel_binary::ViaRecord const& via);
 
-        void add_emarker(QDomDocument& doc, QDomElement& emarkers_elem, EMarker_shptr emarker,
-                         layer_position_t layer_pos);
+        void add_emarker(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                         lmodel_binary::EMarkerRecord const& emarker);
 
-        void add_nets(QDomDocument& doc, QDomElement& nets_elem, LogicModel_shptr lmodel);
+        void add_nets(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot);
 
-        void add_annotation(QDomDocument& doc, QDomElement& annotations_elem, Annotation_shptr annotation,
-                            layer_position_t layer_pos);
+        void add_annotation(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot,
+                            lmodel_binary::AnnotationRecord const& annotation);
 
-        void add_module(QDomDocument& doc, QDomElement& modules_elem, LogicModel_shptr lmodel, Module_shptr module);
+        void add_module(QXmlStreamWriter& writer, LogicModelSnapshot const& snapshot, uint32_t module_index,
+                        std::vector<std::vector<uint32_t>> const& sub_modules);
 
         ObjectIDRewriter_shptr oid_rewriter;
 
@@ -67,6 +74,13 @@ namespace degate
         }
 
         void export_data(std::string const& filename, LogicModel_shptr lmodel);
+
+        /**
+         * Export a snapshot of a logic model. This can be called from any thread.
+         * The object IDs were already rewritten when the snapshot was taken.
+         * @exception InvalidPathException This exception is thrown if the file can't be written.
+         */
+        void export_snapshot(std::string const& filename, LogicModelSnapshot const& snapshot);
     };
 }
 
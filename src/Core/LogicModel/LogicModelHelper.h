@@ -207,6 +207,7 @@ namespace degate
         // check nets: remove them from the logic model if they are not in use
         for (std::set<Net_shptr>::iterator iter = nets.begin(); iter != nets.end(); ++iter)
             if ((*iter)->size() == 0) lmodel->remove_net(*iter);
+            else lmodel->set_net_changed(*iter);
     }
 
 
@@ -280,7 +281,7 @@ namespace degate
         }
 
 
-        Net_shptr new_net(new Net());
+        Net_shptr new_net = lmodel->create_object<Net>();
 
         // set new net
         for (std::set<ConnectedLogicModelObject_shptr>::iterator iter = objects.begin();
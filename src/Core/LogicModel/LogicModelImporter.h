@@ -27,43 +27,95 @@
 #include "Core/XML/XMLImporter.h"
 
 #include <stdexcept>
+#include <list>
+#include <string>
+#include <vector>
 
 namespace degate
 {
     /**
      * This class implements a logic model loader.
+     *
+     * The logic model file is read as a XML stream. Objects are created while the file
+     * is read, no document tree is built. References between objects (nets and modules)
+     * are resolved in a final pass, once all placed objects are in the logic model.
      */
     class LogicModelImporter : public XMLImporter
     {
     private:
 
+        /**
+         * A net as read from the file. The connections are resolved after all
+         * objects are parsed.
+         */
+        struct NetRecord
+        {
+            object_id_t net_id;
+            std::vector<object_id_t> connections;
+        };
+
+        /**
+         * A module as read from the file. References to cells and ports are resolved
+         * after all objects are parsed.
+         */
+        struct ModuleRecord
+        {
+            object_id_t module_id;
+            std::string name;
+            std::string entity;
+            std::vector<object_id_t> cells;
+            std::vector<std::pair<std::string, object_id_t>> ports;
+            std::list<ModuleRecord> sub_modules;
+        };
+
         unsigned int width, height;
         GateLibrary_shptr gate_library;
 
         std::list<Gate_shptr> gates;
+        std::vector<NetRecord> nets;
+        std::list<ModuleRecord> modules;
 
-        void parse_logic_model_element(QDomElement const lm_element,
-                                       LogicModel_shptr lmodel);
+        void parse_logic_model_element(QXmlStreamReader& reader, LogicModel_shptr lmodel);
 
-        void parse_gates_element(QDomElement const gates_element, LogicModel_shptr lmodel);
+        void parse_gate_element(QXmlStreamReader& reader, LogicModel_shptr lmodel);
 
-        void parse_vias_element(QDomElement const vias_element,
-                                LogicModel_shptr lmodel);
+        void parse_via_element(QXmlStreamReader& reader, LogicModel_shptr lmodel);
 
-        void parse_emarkers_element(QDomElement const emarkers_element,
-                                    LogicModel_shptr lmodel);
+        void parse_emarker_element(QXmlStreamReader& reader, LogicModel_shptr lmodel);
 
-        void parse_wires_element(QDomElement const wires_element,
-                                 LogicModel_shptr lmodel);
+        void parse_wire_element(QXmlStreamReader& reader, LogicModel_shptr lmodel);
 
-        void parse_nets_element(QDomElement const nets_element,
-                                LogicModel_shptr lmodel);
+        void parse_net_element(QXmlStreamReader& reader);
 
-        void parse_annotations_element(QDomElement const annotations_element,
-                                       LogicModel_shptr lmodel);
+        void parse_annotation_element(QXmlStreamReader& reader, LogicModel_shptr lmodel);
 
-        std::list<Module_shptr> parse_modules_element(QDomElement const modules_element,
-                                                      LogicModel_shptr lmodel);
+        std::list<ModuleRecord> parse_modules_element(QXmlStreamReader& reader);
+
+        /**
+         * Read all child elements with a given name of the current element and call
+         * parse_element() for each of them. Other child elements are skipped.
+         */
+        template <typename Function>
+        void parse_children(QXmlStreamReader& reader, QString const& element_name, Function parse_element)
+        {
+            while (reader.readNextStartElement())
+            {
+                if (reader.name() == element_name)
+                    parse_element();
+                else
+                    reader.skipCurrentElement();
+            }
+        }
+
+        /**
+         * Connect the parsed nets with the objects of the logic model.
+         */
+        void connect_nets(LogicModel_shptr lmodel);
+
+        /**
+         * Create a module and its sub-modules from a parsed module.
+         */
+        Module_shptr create_module(ModuleRecord const& record, LogicModel_shptr lmodel);
 
     public:
 
@@ -0,0 +1,357 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Core/LogicModel/LogicModelSnapshot.h"
+
+#include <cassert>
+#include <set>
+
+using namespace degate;
+using namespace degate::lmodel_binary;
+
+LogicModelSnapshot::LogicModelSnapshot(LogicModel_shptr lmodel, ObjectIDRewriter_shptr oid_rewriter)
+    : string_offsets(2, 0), // the string with index 0 is the empty string
+      oid_rewriter(oid_rewriter)
+{
+    if (lmodel == nullptr) throw InvalidPointerException("Logic model pointer is nullptr.");
+
+    for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter)
+        if (Layer_shptr layer = iter->second->get_layer())
+            add_gate(iter->second, layer->get_layer_pos());
+
+    for (auto iter = lmodel->vias_begin(); iter != lmodel->vias_end(); ++iter)
+        if (Layer_shptr layer = iter->second->get_layer())
+            add_via(iter->second, layer->get_layer_pos());
+
+    for (auto iter = lmodel->emarkers_begin(); iter != lmodel->emarkers_end(); ++iter)
+        if (Layer_shptr layer = iter->second->get_layer())
+            add_emarker(iter->second, layer->get_layer_pos());
+
+    for (auto iter = lmodel->wires_begin(); iter != lmodel->wires_end(); ++iter)
+        if (Layer_shptr layer = iter->second->get_layer())
+            add_wire(iter->second, layer->get_layer_pos());
+
+    for (auto iter = lmodel->annotations_begin(); iter != lmodel->annotations_end(); ++iter)
+        if (Layer_shptr layer = iter->second->get_layer())
+            add_annotation(iter->second, layer->get_layer_pos());
+
+    add_nets(lmodel);
+    add_modules(lmodel);
+
+    // only needed while the snapshot is taken
+    std::unordered_map<std::string, uint32_t>().swap(string_indices);
+    this->oid_rewriter.reset();
+}
+
+LogicModelSnapshot::LogicModelSnapshot(LogicModel_shptr lmodel, LogicModel::ChangeSet const& changes)
+    : string_offsets(2, 0), // the string with index 0 is the empty string
+      oid_rewriter(std::make_shared<ObjectIDRewriter>(false))
+{
+    if (lmodel == nullptr) throw InvalidPointerException("Logic model pointer is nullptr.");
+
+    std::set<object_id_t> objects;
+    std::set<object_id_t> changed_nets = changes.changed_nets;
+
+    for (auto object_id : changes.changed_objects)
+    {
+        PlacedLogicModelObject_shptr o = lmodel->get_object(object_id);
+
+        // A gate is stored with its ports.
+        if (GatePort_shptr gate_port = std::dynamic_pointer_cast<GatePort>(o))
+        {
+            if (Gate_shptr gate = gate_port->get_gate())
+                o = gate;
+        }
+
+        if (!objects.insert(o->get_object_id()).second)
+            continue;
+
+        add_object(o);
+
+        // A changed object is replaced when the changes are applied, this disconnects it.
+        if (ConnectedLogicModelObject_shptr clmo = std::dynamic_pointer_cast<ConnectedLogicModelObject>(o))
+        {
+            if (clmo->get_net() != nullptr)
+                changed_nets.insert(clmo->get_net()->get_object_id());
+        }
+
+        if (Gate_shptr gate = std::dynamic_pointer_cast<Gate>(o))
+        {
+            for (Gate::port_iterator iter = gate->ports_begin(); iter != gate->ports_end(); ++iter)
+            {
+                if ((*iter)->get_net() != nullptr)
+                    changed_nets.insert((*iter)->get_net()->get_object_id());
+            }
+        }
+    }
+
+    for (auto net_id : changed_nets)
+        add_net(lmodel->get_net(net_id));
+
+    if (changes.modules_changed)
+        add_modules(lmodel);
+
+    removed_objects.assign(changes.removed_objects.begin(), changes.removed_objects.end());
+
+    std::unordered_map<std::string, uint32_t>().swap(string_indices);
+    this->oid_rewriter.reset();
+}
+
+std::string LogicModelSnapshot::get_string(uint32_t index) const
+{
+    assert(static_cast<std::size_t>(index) + 1 < string_offsets.size());
+
+    return std::string(string_data.data() + string_offsets[index], string_offsets[index + 1] - string_offsets[index]);
+}
+
+uint32_t LogicModelSnapshot::add_string(std::string const& str)
+{
+    if (str.empty())
+        return 0;
+
+    auto iter = string_indices.find(str);
+    if (iter != string_indices.end())
+        return iter->second;
+
+    uint32_t index = static_cast<uint32_t>(string_offsets.size() - 1);
+
+    string_data.insert(string_data.end(), str.begin(), str.end());
+    string_offsets.push_back(string_data.size());
+    string_indices[str] = index;
+
+    return index;
+}
+
+void LogicModelSnapshot::add_object(PlacedLogicModelObject_shptr o)
+{
+    Layer_shptr layer = o->get_layer();
+    if (layer == nullptr)
+        return;
+
+    if (Gate_shptr gate = std::dynamic_pointer_cast<Gate>(o))
+        add_gate(gate, layer->get_layer_pos());
+    else if (Wire_shptr wire = std::dynamic_pointer_cast<Wire>(o))
+        add_wire(wire, layer->get_layer_pos());
+    else if (Via_shptr via = std::dynamic_pointer_cast<Via>(o))
+        add_via(via, layer->get_layer_pos());
+    else if (EMarker_shptr emarker = std::dynamic_pointer_cast<EMarker>(o))
+        add_emarker(emarker, layer->get_layer_pos());
+    else if (Annotation_shptr annotation = std::dynamic_pointer_cast<Annotation>(o))
+        add_annotation(annotation, layer->get_layer_pos());
+}
+
+void LogicModelSnapshot::add_gate(Gate_shptr gate, layer_position_t layer_pos)
+{
+    GateRecord record = {};
+
+    record.id = oid_rewriter->get_new_object_id(gate->get_object_id());
+    record.template_type_id = oid_rewriter->get_new_object_id(gate->get_template_type_id());
+    record.name = add_string(gate->get_name());
+    record.description = add_string(gate->get_description());
+    record.layer = layer_pos;
+    record.orientation = static_cast<uint32_t>(gate->get_orientation());
+    record.min_x = gate->get_min_x();
+    record.min_y = gate->get_min_y();
+    record.max_x = gate->get_max_x();
+    record.max_y = gate->get_max_y();
+    record.fill_color = gate->get_fill_color();
+    record.frame_color = gate->get_frame_color();
+    record.first_port = static_cast<uint32_t>(gate_ports.size());
+
+    for (Gate::port_iterator iter = gate->ports_begin(); iter != gate->ports_end(); ++iter)
+    {
+        GatePort_shptr port = *iter;
+
+        GatePortRecord port_record = {};
+        port_record.id = oid_rewriter->get_new_object_id(port->get_object_id());
+        port_record.template_port_type_id = oid_rewriter->get_new_object_id(port->get_template_port_type_id());
+        port_record.name = add_string(port->get_name());
+        port_record.description = add_string(port->get_description());
+        port_record.diameter = port->get_diameter();
+
+        gate_ports.push_back(port_record);
+    }
+
+    record.port_count = static_cast<uint32_t>(gate_ports.size() - record.first_port);
+
+    gates.push_back(record);
+}
+
+void LogicModelSnapshot::add_wire(Wire_shptr wire, layer_position_t layer_pos)
+{
+    WireRecord record = {};
+
+    record.id = oid_rewriter->get_new_object_id(wire->get_object_id());
+    record.remote_id = wire->get_remote_object_id();
+    record.name = add_string(wire->get_name());
+    record.description = add_string(wire->get_description());
+    record.layer = layer_pos;
+    record.diameter = wire->get_diameter();
+    record.from_x = wire->get_from_x();
+    record.from_y = wire->get_from_y();
+    record.to_x = wire->get_to_x();
+    record.to_y = wire->get_to_y();
+    record.fill_color = wire->get_fill_color();
+    record.frame_color = wire->get_frame_color();
+
+    wires.push_back(record);
+}
+
+void LogicModelSnapshot::add_via(Via_shptr via, layer_position_t layer_pos)
+{
+    ViaRecord record = {};
+
+    record.id = oid_rewriter->get_new_object_id(via->get_object_id());
+    record.remote_id = via->get_remote_object_id();
+    record.name = add_string(via->get_name());
+    record.description = add_string(via->get_description());
+    record.layer = layer_pos;
+    record.diameter = via->get_diameter();
+    record.x = via->get_x();
+    record.y = via->get_y();
+    record.fill_color = via->get_fill_color();
+    record.frame_color = via->get_frame_color();
+    record.direction = static_cast<uint32_t>(via->get_direction());
+
+    vias.push_back(record);
+}
+
+void LogicModelSnapshot::add_emarker(EMarker_shptr emarker, layer_position_t layer_pos)
+{
+    EMarkerRecord record = {};
+
+    record.id = oid_rewriter->get_new_object_id(emarker->get_object_id());
+    record.remote_id = emarker->get_remote_object_id();
+    record.name = add_string(emarker->get_name());
+    record.description = add_string(emarker->get_description());
+    record.layer = layer_pos;
+    record.diameter = emarker->get_diameter();
+    record.x = emarker->get_x();
+    record.y = emarker->get_y();
+    record.fill_color = emarker->get_fill_color();
+    record.frame_color = emarker->get_frame_color();
+    record.is_module_port = emarker->is_module_port() ? 1 : 0;
+
+    emarkers.push_back(record);
+}
+
+void LogicModelSnapshot::add_annotation(Annotation_shptr annotation, layer_position_t layer_pos)
+{
+    AnnotationRecord record = {};
+
+    record.id = oid_rewriter->get_new_object_id(annotation->get_object_id());
+    record.name = add_string(annotation->get_name());
+    record.description = add_string(annotation->get_description());
+    record.layer = layer_pos;
+    record.class_id = annotation->get_class_id();
+    record.min_x = annotation->get_min_x();
+    record.min_y = annotation->get_min_y();
+    record.max_x = annotation->get_max_x();
+    record.max_y = annotation->get_max_y();
+    record.fill_color = annotation->get_fill_color();
+    record.frame_color = annotation->get_frame_color();
+
+    record.first_parameter = static_cast<uint32_t>(annotation_parameters.size());
+    for (auto iter = annotation->parameters_begin(); iter != annotation->parameters_end(); ++iter)
+    {
+        AnnotationParameterRecord parameter_record = {};
+        parameter_record.name = add_string(iter->first);
+        parameter_record.value = add_string(iter->second);
+
+        annotation_parameters.push_back(parameter_record);
+    }
+    record.parameter_count = static_cast<uint32_t>(annotation_parameters.size() - record.first_parameter);
+
+    annotations.push_back(record);
+}
+
+void LogicModelSnapshot::add_nets(LogicModel_shptr lmodel)
+{
+    for (LogicModel::net_collection::iterator net_iter = lmodel->nets_begin();
+         net_iter != lmodel->nets_end(); ++net_iter)
+    {
+        assert(net_iter->second != nullptr);
+        add_net(net_iter->second);
+    }
+}
+
+void LogicModelSnapshot::add_net(Net_shptr net)
+{
+    NetRecord record = {};
+    record.id = oid_rewriter->get_new_object_id(net->get_object_id());
+    record.first_connection = static_cast<uint32_t>(net_connections.size());
+
+    for (Net::connection_iterator conn_iter = net->begin(); conn_iter != net->end(); ++conn_iter)
+        net_connections.push_back(oid_rewriter->get_new_object_id(*conn_iter));
+
+    record.connection_count = static_cast<uint32_t>(net_connections.size() - record.first_connection);
+
+    nets.push_back(record);
+}
+
+void LogicModelSnapshot::add_modules(LogicModel_shptr lmodel)
+{
+    // First update the module ports.
+    determine_module_ports_for_root(lmodel); // Update main module itself.
+    lmodel->get_main_module()->determine_module_ports_recursive(); // Update all of main module's children.
+
+    add_module(lmodel->get_main_module(), NO_PARENT);
+}
+
+void LogicModelSnapshot::add_module(Module_shptr module, uint32_t parent)
+{
+    ModuleRecord record = {};
+
+    record.id = oid_rewriter->get_new_object_id(module->get_object_id());
+    record.name = add_string(module->get_name());
+    record.entity = add_string(module->get_entity_name());
+    record.parent = parent;
+
+    record.first_cell = static_cast<uint32_t>(module_cells.size());
+    for (Module::gate_collection::const_iterator g_iter = module->gates_begin();
+         g_iter != module->gates_end(); ++g_iter)
+    {
+        module_cells.push_back(oid_rewriter->get_new_object_id((*g_iter)->get_object_id()));
+    }
+    record.cell_count = static_cast<uint32_t>(module_cells.size() - record.first_cell);
+
+    record.first_port = static_cast<uint32_t>(module_ports.size());
+    for (Module::port_collection::const_iterator p_iter = module->ports_begin();
+         p_iter != module->ports_end(); ++p_iter)
+    {
+        ModulePortRecord port_record = {};
+        port_record.object_id = oid_rewriter->get_new_object_id(p_iter->second->get_object_id());
+        port_record.name = add_string(p_iter->first);
+
+        module_ports.push_back(port_record);
+    }
+    record.port_count = static_cast<uint32_t>(module_ports.size() - record.first_port);
+
+    uint32_t index = static_cast<uint32_t>(modules.size());
+    modules.push_back(record);
+
+    // sub-modules are stored after their parent
+    for (Module::module_collection::const_iterator m_iter = module->modules_begin();
+         m_iter != module->modules_end(); ++m_iter)
+    {
+        add_module(*m_iter, index);
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __LOGICMODELSNAPSHOT_H__
+#define __LOGICMODELSNAPSHOT_H__
+
+#include "Globals.h"
+#include "LogicModel.h"
+#include "LogicModelBinaryFormat.h"
+#include "Core/Utils/ObjectIDRewriter.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace degate
+{
+    /**
+     * An immutable copy of the persistent state of a logic model.
+     *
+     * The snapshot holds flat tables of plain records (the records of the binary
+     * logic model format) instead of a copy of the object graph. It is cheap to take,
+     * and because it does not reference any logic model object, it can be serialized
+     * from another thread while the logic model is edited.
+     *
+     * Object IDs are rewritten with the rewriter passed at creation.
+     */
+    class LogicModelSnapshot
+    {
+    public:
+
+        /**
+         * Take a snapshot of a logic model. This must be called from the thread that
+         * edits the logic model.
+         * @exception InvalidPointerException This exception is thrown if the logic model is a nullptr.
+         */
+        LogicModelSnapshot(LogicModel_shptr lmodel, ObjectIDRewriter_shptr oid_rewriter);
+
+        /**
+         * Take a snapshot of the changes of a logic model (see LogicModel::get_changes()).
+         *
+         * Only the changed objects and nets are stored, together with the nets of the
+         * changed objects. The module hierarchy is stored as a whole if it changed.
+         * Object IDs are not rewritten.
+         * @exception InvalidPointerException This exception is thrown if the logic model is a nullptr.
+         */
+        LogicModelSnapshot(LogicModel_shptr lmodel, LogicModel::ChangeSet const& changes);
+
+        LogicModelSnapshot(LogicModelSnapshot const&) = delete;
+        LogicModelSnapshot& operator=(LogicModelSnapshot const&) = delete;
+
+        /**
+         * Get a string from the string table. The index 0 is the empty string.
+         */
+        std::string get_string(uint32_t index) const;
+
+        std::vector<uint64_t> string_offsets;
+        std::vector<char> string_data;
+
+        std::vector<lmodel_binary::GateRecord> gates;
+        std::vector<lmodel_binary::GatePortRecord> gate_ports;
+        std::vector<lmodel_binary::WireRecord> wires;
+        std::vector<lmodel_binary::ViaRecord> vias;
+        std::vector<lmodel_binary::EMarkerRecord> emarkers;
+        std::vector<lmodel_binary::AnnotationRecord> annotations;
+        std::vector<lmodel_binary::AnnotationParameterRecord> annotation_parameters;
+        std::vector<lmodel_binary::NetRecord> nets;
+        std::vector<uint64_t> net_connections;
+        std::vector<lmodel_binary::ModuleRecord> modules;
+        std::vector<uint64_t> module_cells;
+        std::vector<lmodel_binary::ModulePortRecord> module_ports;
+        std::vector<uint64_t> removed_objects;
+
+    private:
+
+        ObjectIDRewriter_shptr oid_rewriter;
+        std::unordered_map<std::string, uint32_t> string_indices;
+
+        /**
+         * Get the index of a string in the string table. The string is added if necessary.
+         */
+        uint32_t add_string(std::string const& str);
+
+        /**
+         * Add a placed object of any type.
+         */
+        void add_object(PlacedLogicModelObject_shptr o);
+
+        void add_gate(Gate_shptr gate, layer_position_t layer_pos);
+        void add_wire(Wire_shptr wire, layer_position_t layer_pos);
+        void add_via(Via_shptr via, layer_position_t layer_pos);
+        void add_emarker(EMarker_shptr emarker, layer_position_t layer_pos);
+        void add_annotation(Annotation_shptr annotation, layer_position_t layer_pos);
+        void add_nets(LogicModel_shptr lmodel);
+        void add_net(Net_shptr net);
+        void add_modules(LogicModel_shptr lmodel);
+        void add_module(Module_shptr module, uint32_t parent);
+    };
+
+    typedef std::shared_ptr<const LogicModelSnapshot> LogicModelSnapshot_shptr;
+}
+
+#endif
@@ -39,6 +39,7 @@ namespace degate
     {
         friend void determine_module_ports_for_root(LogicModel_shptr lmodel);
         friend class LogicModelImporter;
+        friend class LogicModelBinaryImporter;
 
     public:
 
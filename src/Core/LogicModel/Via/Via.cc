@@ -61,6 +61,11 @@ void Via::set_direction(Via::DIRECTION dir)
 }
 
 const std::string Via::get_direction_as_string() const
+{
+    return get_direction_as_string(direction);
+}
+
+const std::string Via::get_direction_as_string(DIRECTION direction)
 {
     switch (direction)
     {
@@ -101,6 +101,11 @@ namespace degate
          */
         virtual const std::string get_direction_as_string() const;
 
+        /**
+         * Get a direction as a human readable string.
+         */
+        static const std::string get_direction_as_string(DIRECTION direction);
+
 
         /**
          * Parse a via direction string and return it as enum value.
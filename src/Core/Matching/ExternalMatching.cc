@@ -150,7 +150,7 @@ PlacedLogicModelObject_shptr ExternalMatching::parse_line(std::string const& lin
             y2 = boost::lexical_cast<int>(tokens[4]),
             diameter = boost::lexical_cast<unsigned int>(tokens[5]);
 
-        return std::make_shared<Wire>(x1, y1, x2, y2, diameter);
+        return lmodel->create_object<Wire>(x1, y1, x2, y2, diameter);
     }
     else if (tokens[0] == "via" &&
         tokens.size() >= 6
@@ -163,7 +163,7 @@ PlacedLogicModelObject_shptr ExternalMatching::parse_line(std::string const& lin
 
         Via::DIRECTION dir = tokens[4] == "up" ? Via::DIRECTION_UP : Via::DIRECTION_DOWN;
 
-        return std::make_shared<Via>(x, y, diameter, dir);
+        return lmodel->create_object<Via>(x, y, diameter, dir);
     }
 
     else
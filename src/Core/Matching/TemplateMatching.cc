@@ -32,9 +32,137 @@
 
 #include <utility>
 #include <cmath>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 using namespace degate;
 
+// Memory budget for the prepared templates kept between matching runs.
+#define PREPARED_TEMPLATE_CACHE_SIZE (256 * 1024 * 1024)
+
+namespace
+{
+    /**
+     * Least recently used prepared templates. This is thread safe.
+     */
+    template <typename PreparedTemplate>
+    class PreparedTemplateCache
+    {
+    public:
+
+        struct Key
+        {
+            const GateTemplate* gate_template;
+            Layer::LAYER_TYPE layer_type;
+            Gate::ORIENTATION orientation;
+            unsigned int scale_down;
+            unsigned int pyramid_levels;
+            unsigned int image_version;
+
+            bool operator<(Key const& other) const
+            {
+                return std::tie(gate_template, layer_type, orientation, scale_down, pyramid_levels, image_version) <
+                       std::tie(other.gate_template, other.layer_type, other.orientation, other.scale_down,
+                                other.pyramid_levels, other.image_version);
+            }
+        };
+
+        bool get(Key const& key, GateTemplate_shptr const& gate_template, PreparedTemplate& prepared)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            auto found = entries.find(key);
+            if (found == entries.end())
+                return false;
+
+            // The address might have been reused by another template.
+            if (found->second->gate_template.lock() != gate_template)
+            {
+                erase(found);
+                return false;
+            }
+
+            lru.splice(lru.begin(), lru, found->second);
+
+            prepared = found->second->prepared;
+            prepared.gate_template = gate_template;
+
+            return true;
+        }
+
+        void add(Key const& key, GateTemplate_shptr const& gate_template, PreparedTemplate const& prepared)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            auto found = entries.find(key);
+            if (found != entries.end())
+                erase(found);
+
+            Entry entry;
+            entry.key = key;
+            entry.gate_template = gate_template;
+            entry.prepared = prepared;
+
+            // Entries do not keep the gate template alive.
+            entry.prepared.gate_template = nullptr;
+
+            entry.size = prepared.tmpl_img_normal->get_width() * prepared.tmpl_img_normal->get_height() *
+                         (sizeof(gs_byte_pixel_t) + sizeof(gs_double_pixel_t)) +
+                         prepared.tmpl_img_scaled->get_width() * prepared.tmpl_img_scaled->get_height() *
+                         (sizeof(gs_byte_pixel_t) + sizeof(gs_double_pixel_t));
+
+            for (auto const& level : prepared.pyramid)
+                entry.size += level.zero_mean_template->get_width() * level.zero_mean_template->get_height() *
+                              sizeof(gs_double_pixel_t);
+
+            lru.push_front(entry);
+            entries[key] = lru.begin();
+            size += entry.size;
+
+            // The most recently used entry is kept, even if it is larger than the budget.
+            while (size > PREPARED_TEMPLATE_CACHE_SIZE && lru.size() > 1)
+                erase(entries.find(lru.back().key));
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            entries.clear();
+            lru.clear();
+            size = 0;
+        }
+
+    private:
+
+        struct Entry
+        {
+            Key key;
+            std::weak_ptr<GateTemplate> gate_template;
+            PreparedTemplate prepared;
+            std::size_t size;
+        };
+
+        typedef std::list<Entry> lru_list_t;
+
+        void erase(typename std::map<Key, typename lru_list_t::iterator>::iterator found)
+        {
+            size -= found->second->size;
+            lru.erase(found->second);
+            entries.erase(found);
+        }
+
+        std::mutex mutex;
+        std::size_t size = 0;
+
+        // Most recently used first.
+        lru_list_t lru;
+        std::map<Key, typename lru_list_t::iterator> entries;
+    };
+}
+
 //#define USE_MEDIAN_FILTER 2
 //#define USE_GAUSS_FILTER 5
 
@@ -48,6 +176,11 @@ TemplateMatching::TemplateMatching()
     threshold_detection = 0.70;
     max_step_size_search = 3;
     scale_down = 1;
+
+    pyramid_search = false;
+    threshold_pyramid = 0.30;
+    pyramid_top_k = 2;
+    pyramid_min_template_size = 8;
 }
 
 TemplateMatching::~TemplateMatching()
@@ -110,6 +243,13 @@ void TemplateMatching::init(BoundingBox const& bounding_box, Project_shptr proje
     prepare_background_images(sm, bounding_box, get_scaling_factor());
     debug(TM, "Prepare sum tabes.");
     prepare_sum_tables(gs_img_normal, gs_img_scaled);
+
+    pyramid.clear();
+    if (pyramid_search)
+    {
+        debug(TM, "Prepare pyramid.");
+        prepare_pyramid(sm, bounding_box);
+    }
 }
 
 
@@ -203,6 +343,59 @@ void TemplateMatching::prepare_background_images(ScalingManager_shptr sm,
     //save_image("/tmp/xxx2.tif", gs_img_scaled);
 }
 
+void TemplateMatching::prepare_pyramid(ScalingManager_shptr sm, BoundingBox const& bounding_box)
+{
+    // The coarsest level is limited by the largest template.
+    unsigned int max_tmpl_size = 0;
+    for (auto const& tmpl : tmpl_set)
+        max_tmpl_size = std::max(max_tmpl_size, std::min(tmpl->get_width(), tmpl->get_height()));
+
+    for (auto step : sm->get_zoom_steps())
+    {
+        const unsigned int scaling_factor = lrint(step);
+
+        if (scaling_factor <= 1 || max_tmpl_size / scaling_factor < pyramid_min_template_size)
+            continue;
+
+        const ScalingManager<BackgroundImage>::image_map_element img = sm->get_image(scaling_factor);
+        assert(img.second != nullptr);
+
+        BoundingBox scaled_bounding_box = get_scaled_bounding_box(bounding_box, scaling_factor);
+
+        pyramid_level level;
+        level.scale_down = scaling_factor;
+
+        level.gs_img = std::make_shared<TileImage_GS_BYTE>(scaled_bounding_box.get_width(),
+                                                           scaled_bounding_box.get_height());
+        extract_partial_image(level.gs_img, img.second, scaled_bounding_box);
+
+        level.sum_table_single = std::make_shared<TileImage_GS_DOUBLE>(level.gs_img->get_width(),
+                                                                       level.gs_img->get_height());
+        level.sum_table_squared = std::make_shared<TileImage_GS_DOUBLE>(level.gs_img->get_width(),
+                                                                        level.gs_img->get_height());
+        precalc_sum_tables(level.gs_img, level.sum_table_single, level.sum_table_squared);
+
+        debug(TM, "Pyramid level with scaling factor %d.", scaling_factor);
+        pyramid.push_back(level);
+    }
+}
+
+unsigned int TemplateMatching::get_pyramid_levels(GateTemplate_shptr tmpl) const
+{
+    unsigned int levels = 0;
+
+    for (auto const& level : pyramid)
+    {
+        if (tmpl->get_width() / level.scale_down < pyramid_min_template_size ||
+            tmpl->get_height() / level.scale_down < pyramid_min_template_size)
+            break;
+
+        levels++;
+    }
+
+    return levels;
+}
+
 void TemplateMatching::prepare_sum_tables(TileImage_GS_BYTE_shptr gs_img_normal,
                                           TileImage_GS_BYTE_shptr gs_img_scaled)
 {
@@ -276,13 +469,16 @@ void TemplateMatching::run()
             f % tmpl->get_name();
             set_log_message(f.str());
 
-            prepared_template prep_tmpl_img = prepare_template(tmpl, orientation);
+            prepared_template prep_tmpl_img = get_prepared_template(tmpl, orientation);
             //match_single_template(prep_tmpl_img, t_hc, t_det);
 
 
-            std::list<match_found> m = match_single_template(prep_tmpl_img,
-                                                             threshold_hc,
-                                                             threshold_detection);
+            std::list<match_found> m = prep_tmpl_img.pyramid.empty()
+                                           ? match_single_template(prep_tmpl_img,
+                                                                   threshold_hc,
+                                                                   threshold_detection)
+                                           : match_single_template_pyramid(prep_tmpl_img,
+                                                                           threshold_detection);
 
 
             matches.insert(matches.end(), m.begin(), m.end());
@@ -297,15 +493,13 @@ void TemplateMatching::run()
     }
 
 
-    matches.sort(compare_correlation);
+    std::vector<match_found> kept = suppress_overlapping_matches(matches);
 
-    for (const auto& m : matches)
-    {
-        std::cout << "Try to insert gate of type " << m.tmpl->get_name() << " with corr="
-            << m.correlation << " at " << m.x << "," << m.y << std::endl;
-        if (add_gate(m.x, m.y, m.tmpl, m.orientation, m.correlation, m.t_hc))
-            std::cout << "\tInserted gate of type " << m.tmpl->get_name() << std::endl;
-    }
+    debug(TM, "%d of %d matches left after overlap resolution",
+          static_cast<int>(kept.size()), static_cast<int>(matches.size()));
+
+    // Kept matches don't overlap each other, only previously placed gates have to be checked.
+    add_gates(kept);
 
     reset_progress();
 }
@@ -409,9 +603,73 @@ TemplateMatching::prepared_template TemplateMatching::prepare_template(GateTempl
     assert(prep.sum_over_zero_mean_template_normal > 0);
     assert(prep.sum_over_zero_mean_template_scaled > 0);
 
+    // create the templates for the pyramid search
+    const unsigned int pyramid_levels = get_pyramid_levels(tmpl);
+    for (unsigned int i = 0; i < pyramid_levels; i++)
+    {
+        prepared_template::pyramid_template level;
+        level.scale_down = pyramid[i].scale_down;
+
+        unsigned int
+            level_width = w / level.scale_down,
+            level_height = h / level.scale_down;
+
+        auto level_img = std::make_shared<TempImage_GS_BYTE>(level_width, level_height);
+        scale_down_by_power_of_2(level_img, tmpl_img);
+
+        level.zero_mean_template = std::make_shared<TempImage_GS_DOUBLE>(level_width, level_height);
+        level.sum_over_zero_mean_template = subtract_mean(level_img, level.zero_mean_template);
+
+        // A flat template can't be correlated, coarser levels are flat as well.
+        if (level.sum_over_zero_mean_template <= 0)
+            break;
+
+        prep.pyramid.push_back(level);
+    }
+
+    return prep;
+}
+
+
+namespace
+{
+    template <typename PreparedTemplate>
+    PreparedTemplateCache<PreparedTemplate>& get_prepared_template_cache()
+    {
+        static PreparedTemplateCache<PreparedTemplate> cache;
+        return cache;
+    }
+}
+
+TemplateMatching::prepared_template TemplateMatching::get_prepared_template(GateTemplate_shptr tmpl,
+                                                                            Gate::ORIENTATION orientation)
+{
+    auto& cache = get_prepared_template_cache<prepared_template>();
+
+    const Layer::LAYER_TYPE layer_type = layer_matching->get_layer_type();
+
+    typename PreparedTemplateCache<prepared_template>::Key key;
+    key.gate_template = tmpl.get();
+    key.layer_type = layer_type;
+    key.orientation = orientation;
+    key.scale_down = get_scaling_factor();
+    key.pyramid_levels = get_pyramid_levels(tmpl);
+    key.image_version = tmpl->get_image_version(layer_type);
+
+    prepared_template prep;
+    if (cache.get(key, tmpl, prep))
+        return prep;
+
+    prep = prepare_template(tmpl, orientation);
+    cache.add(key, tmpl, prep);
+
     return prep;
 }
 
+void TemplateMatching::clear_prepared_templates()
+{
+    get_prepared_template_cache<prepared_template>().clear();
+}
 
 void TemplateMatching::adjust_step_size(struct search_state& state, double corr_val) const
 {
@@ -439,32 +697,155 @@ TemplateMatching::keep_gate_match(unsigned int x, unsigned int y,
     return hit;
 }
 
-bool TemplateMatching::add_gate(unsigned int x, unsigned int y,
-                                GateTemplate_shptr tmpl,
-                                Gate::ORIENTATION orientation,
-                                double corr_val, double threshold_hc)
+std::vector<TemplateMatching::match_found>
+TemplateMatching::suppress_overlapping_matches(std::list<match_found> const& matches) const
 {
-    if (!layer_insert->exists_type_in_region<Gate>(x, x + tmpl->get_width(),
-                                                   y, y + tmpl->get_height()))
+    std::vector<match_found> sorted(matches.begin(), matches.end());
+    std::stable_sort(sorted.begin(), sorted.end(), compare_correlation);
+
+    std::vector<match_found> kept;
+    if (sorted.empty())
+        return kept;
+
+    // A kept match covers at most four cells.
+    unsigned int cell_size = 1;
+    for (auto const& m : sorted)
+        cell_size = std::max(cell_size, std::max(m.tmpl->get_width(), m.tmpl->get_height()) + 1);
+
+    std::map<std::pair<unsigned int, unsigned int>, std::vector<std::size_t>> grid;
+
+    for (auto const& m : sorted)
     {
-        Gate_shptr gate(new Gate(x, x + tmpl->get_width(),
-                                 y, y + tmpl->get_height(),
-                                 orientation));
+        BoundingBox box(m.x, m.x + m.tmpl->get_width(), m.y, m.y + m.tmpl->get_height());
 
-        char dsc[100];
-        snprintf(dsc, sizeof(dsc), "matched with corr=%.2f t_hc=%.2f", corr_val, threshold_hc);
-        gate->set_description(dsc);
+        const unsigned int
+            min_cell_x = m.x / cell_size,
+            max_cell_x = (m.x + m.tmpl->get_width()) / cell_size,
+            min_cell_y = m.y / cell_size,
+            max_cell_y = (m.y + m.tmpl->get_height()) / cell_size;
 
-        gate->set_gate_template(tmpl);
+        bool overlaps = false;
+
+        for (unsigned int cell_y = min_cell_y; cell_y <= max_cell_y && !overlaps; cell_y++)
+            for (unsigned int cell_x = min_cell_x; cell_x <= max_cell_x && !overlaps; cell_x++)
+            {
+                auto cell = grid.find(std::make_pair(cell_x, cell_y));
+                if (cell == grid.end())
+                    continue;
+
+                for (auto index : cell->second)
+                {
+                    match_found const& other = kept[index];
+                    if (box.intersects(BoundingBox(other.x, other.x + other.tmpl->get_width(),
+                                                   other.y, other.y + other.tmpl->get_height())))
+                    {
+                        overlaps = true;
+                        break;
+                    }
+                }
+            }
 
-        LogicModel_shptr lmodel = project->get_logic_model();
-        lmodel->add_object(layer_insert, gate);
-        lmodel->update_ports(gate);
+        if (overlaps)
+            continue;
 
-        stats.hits++;
-        return true;
+        for (unsigned int cell_y = min_cell_y; cell_y <= max_cell_y; cell_y++)
+            for (unsigned int cell_x = min_cell_x; cell_x <= max_cell_x; cell_x++)
+                grid[std::make_pair(cell_x, cell_y)].push_back(kept.size());
+
+        kept.push_back(m);
+    }
+
+    return kept;
+}
+
+void TemplateMatching::add_gates(std::vector<match_found> const& matches)
+{
+    if (matches.empty())
+        return;
+
+    // Area covered by the matches, and grid cell size (as in suppress_overlapping_matches()).
+    unsigned int cell_size = 1;
+    unsigned int min_x = matches.front().x, max_x = 0, min_y = matches.front().y, max_y = 0;
+    for (auto const& m : matches)
+    {
+        cell_size = std::max(cell_size, std::max(m.tmpl->get_width(), m.tmpl->get_height()) + 1);
+        min_x = std::min(min_x, m.x);
+        min_y = std::min(min_y, m.y);
+        max_x = std::max(max_x, m.x + m.tmpl->get_width());
+        max_y = std::max(max_y, m.y + m.tmpl->get_height());
     }
-    return false;
+
+    // Index the gates placed before the run with a single region query.
+    std::map<std::pair<unsigned int, unsigned int>, std::vector<BoundingBox>> grid;
+
+    for (auto iter = layer_insert->region_begin(min_x, max_x, min_y, max_y); iter != layer_insert->region_end(); ++iter)
+    {
+        if (std::dynamic_pointer_cast<Gate>(*iter) == nullptr)
+            continue;
+
+        BoundingBox const& box = (*iter)->get_bounding_box();
+
+        // Only the part over the matches area is indexed.
+        const unsigned int
+            min_cell_x = static_cast<unsigned int>(std::max(box.get_min_x(), static_cast<float>(min_x))) / cell_size,
+            max_cell_x = static_cast<unsigned int>(std::min(box.get_max_x(), static_cast<float>(max_x))) / cell_size,
+            min_cell_y = static_cast<unsigned int>(std::max(box.get_min_y(), static_cast<float>(min_y))) / cell_size,
+            max_cell_y = static_cast<unsigned int>(std::min(box.get_max_y(), static_cast<float>(max_y))) / cell_size;
+
+        for (unsigned int cell_y = min_cell_y; cell_y <= max_cell_y; cell_y++)
+            for (unsigned int cell_x = min_cell_x; cell_x <= max_cell_x; cell_x++)
+                grid[std::make_pair(cell_x, cell_y)].push_back(box);
+    }
+
+    for (auto const& m : matches)
+    {
+        BoundingBox box(m.x, m.x + m.tmpl->get_width(), m.y, m.y + m.tmpl->get_height());
+
+        bool overlaps = false;
+
+        for (unsigned int cell_y = m.y / cell_size; cell_y <= (m.y + m.tmpl->get_height()) / cell_size && !overlaps; cell_y++)
+            for (unsigned int cell_x = m.x / cell_size; cell_x <= (m.x + m.tmpl->get_width()) / cell_size && !overlaps; cell_x++)
+            {
+                auto cell = grid.find(std::make_pair(cell_x, cell_y));
+                if (cell == grid.end())
+                    continue;
+
+                for (auto const& other : cell->second)
+                {
+                    if (box.intersects(other))
+                    {
+                        overlaps = true;
+                        break;
+                    }
+                }
+            }
+
+        if (!overlaps)
+            create_gate(m.x, m.y, m.tmpl, m.orientation, m.correlation, m.t_hc);
+    }
+}
+
+void TemplateMatching::create_gate(unsigned int x, unsigned int y,
+                                   GateTemplate_shptr tmpl,
+                                   Gate::ORIENTATION orientation,
+                                   double corr_val, double threshold_hc)
+{
+    LogicModel_shptr lmodel = project->get_logic_model();
+
+    Gate_shptr gate = lmodel->create_object<Gate>(x, x + tmpl->get_width(),
+                                                  y, y + tmpl->get_height(),
+                                                  orientation);
+
+    char dsc[100];
+    snprintf(dsc, sizeof(dsc), "matched with corr=%.2f t_hc=%.2f", corr_val, threshold_hc);
+    gate->set_description(dsc);
+
+    gate->set_gate_template(tmpl);
+
+    lmodel->add_object(layer_insert, gate);
+    lmodel->update_ports(gate);
+
+    stats.hits++;
 }
 
 std::list<TemplateMatching::match_found>
@@ -614,6 +995,209 @@ void TemplateMatching::hill_climbing(unsigned int start_x, unsigned int start_y,
 }
 
 
+double TemplateMatching::search_window(unsigned int* x, unsigned int* y, unsigned int radius,
+                                       const TileImage_GS_BYTE_shptr master,
+                                       const TileImage_GS_DOUBLE_shptr summation_table_single,
+                                       const TileImage_GS_DOUBLE_shptr summation_table_squared,
+                                       const TempImage_GS_DOUBLE_shptr zero_mean_template,
+                                       double sum_over_zero_mean_template) const
+{
+    if (master->get_width() < zero_mean_template->get_width() ||
+        master->get_height() < zero_mean_template->get_height())
+        return -1.0;
+
+    // last positions where the template fits into the background
+    const unsigned int
+        last_x = master->get_width() - zero_mean_template->get_width(),
+        last_y = master->get_height() - zero_mean_template->get_height();
+
+    const unsigned int
+        from_x = std::min(*x >= radius ? *x - radius : 0, last_x),
+        from_y = std::min(*y >= radius ? *y - radius : 0, last_y),
+        to_x = std::min(*x + radius, last_x),
+        to_y = std::min(*y + radius, last_y);
+
+    double max_corr = -1.0;
+
+    for (unsigned int _y = from_y; _y <= to_y; _y++)
+        for (unsigned int _x = from_x; _x <= to_x; _x++)
+        {
+            double corr_val = calc_single_xcorr(master,
+                                                summation_table_single,
+                                                summation_table_squared,
+                                                zero_mean_template,
+                                                sum_over_zero_mean_template,
+                                                _x, _y);
+
+            if (corr_val > max_corr)
+            {
+                max_corr = corr_val;
+                *x = _x;
+                *y = _y;
+            }
+        }
+
+    return max_corr;
+}
+
+std::vector<TemplateMatching::pyramid_candidate>
+TemplateMatching::select_candidates(std::vector<pyramid_candidate> candidates,
+                                    unsigned int region_width,
+                                    unsigned int region_height,
+                                    unsigned int min_distance) const
+{
+    std::sort(candidates.begin(), candidates.end(),
+              [](pyramid_candidate const& lhs, pyramid_candidate const& rhs)
+              {
+                  return lhs.correlation > rhs.correlation;
+              });
+
+    std::map<std::pair<unsigned int, unsigned int>, std::vector<pyramid_candidate>> regions;
+    std::vector<pyramid_candidate> selected;
+
+    for (auto const& candidate : candidates)
+    {
+        auto& region = regions[std::make_pair(candidate.x / region_width, candidate.y / region_height)];
+
+        if (region.size() >= pyramid_top_k)
+            continue;
+
+        // Neighbours of a better candidate belong to the same peak.
+        bool is_neighbour = false;
+        for (auto const& other : region)
+        {
+            if (std::max(candidate.x, other.x) - std::min(candidate.x, other.x) <= min_distance &&
+                std::max(candidate.y, other.y) - std::min(candidate.y, other.y) <= min_distance)
+            {
+                is_neighbour = true;
+                break;
+            }
+        }
+
+        if (is_neighbour)
+            continue;
+
+        region.push_back(candidate);
+        selected.push_back(candidate);
+    }
+
+    return selected;
+}
+
+std::list<TemplateMatching::match_found>
+TemplateMatching::match_single_template_pyramid(struct prepared_template& tmpl,
+                                                double threshold_detection)
+{
+    debug(TM, "match_single_template_pyramid(): start screening on coarsest level");
+
+    assert(!tmpl.pyramid.empty());
+    assert(tmpl.pyramid.size() <= pyramid.size());
+
+    const unsigned int
+        tmpl_w = tmpl.tmpl_img_normal->get_width(),
+        tmpl_h = tmpl.tmpl_img_normal->get_height();
+
+    std::list<match_found> matches;
+    std::vector<pyramid_candidate> candidates;
+
+    // Screen all positions on the coarsest level. The step size is one pixel on this level.
+    unsigned int level = tmpl.pyramid.size() - 1;
+    unsigned int scaling_factor = tmpl.pyramid[level].scale_down;
+
+    search_state state;
+    state.x = 1;
+    state.y = 1;
+    state.step_size_search = scaling_factor;
+    state.search_area = bounding_box;
+
+    do
+    {
+        unsigned int
+            x = state.x / scaling_factor,
+            y = state.y / scaling_factor;
+
+        if (x + tmpl.pyramid[level].zero_mean_template->get_width() > pyramid[level].gs_img->get_width() ||
+            y + tmpl.pyramid[level].zero_mean_template->get_height() > pyramid[level].gs_img->get_height())
+            continue;
+
+        double corr_val = calc_single_xcorr(pyramid[level].gs_img,
+                                            pyramid[level].sum_table_single,
+                                            pyramid[level].sum_table_squared,
+                                            tmpl.pyramid[level].zero_mean_template,
+                                            tmpl.pyramid[level].sum_over_zero_mean_template,
+                                            x, y);
+
+        if (corr_val >= threshold_pyramid)
+            candidates.push_back({x * scaling_factor, y * scaling_factor, corr_val});
+    }
+    while (get_next_pos(&state, tmpl) && !is_canceled());
+
+    candidates = select_candidates(candidates, tmpl_w, tmpl_h, scaling_factor);
+
+    debug(TM, "%d candidates on level with scaling factor %d",
+          static_cast<int>(candidates.size()), scaling_factor);
+
+    // Follow the candidates down the pyramid. A pixel on the coarser level covers
+    // the positions up to the scaling factor ratio around it.
+    while (level > 0 && !is_canceled())
+    {
+        const unsigned int radius = scaling_factor / tmpl.pyramid[level - 1].scale_down;
+
+        level--;
+        scaling_factor = tmpl.pyramid[level].scale_down;
+
+        std::vector<pyramid_candidate> refined;
+
+        for (auto const& candidate : candidates)
+        {
+            unsigned int
+                x = candidate.x / scaling_factor,
+                y = candidate.y / scaling_factor;
+
+            double corr_val = search_window(&x, &y, radius,
+                                            pyramid[level].gs_img,
+                                            pyramid[level].sum_table_single,
+                                            pyramid[level].sum_table_squared,
+                                            tmpl.pyramid[level].zero_mean_template,
+                                            tmpl.pyramid[level].sum_over_zero_mean_template);
+
+            if (corr_val >= threshold_pyramid)
+                refined.push_back({x * scaling_factor, y * scaling_factor, corr_val});
+        }
+
+        candidates = select_candidates(refined, tmpl_w, tmpl_h, scaling_factor);
+
+        debug(TM, "%d candidates on level with scaling factor %d",
+              static_cast<int>(candidates.size()), scaling_factor);
+    }
+
+    // Exact correlation at full resolution.
+    for (auto const& candidate : candidates)
+    {
+        if (is_canceled())
+            break;
+
+        unsigned int x = candidate.x, y = candidate.y;
+
+        double corr_val = search_window(&x, &y, scaling_factor,
+                                        gs_img_normal,
+                                        sum_table_single_normal,
+                                        sum_table_squared_normal,
+                                        tmpl.zero_mean_template_normal,
+                                        tmpl.sum_over_zero_mean_template_normal);
+
+        if (corr_val >= threshold_detection)
+        {
+            matches.push_back(keep_gate_match(x + bounding_box.get_min_x(),
+                                              y + bounding_box.get_min_y(),
+                                              tmpl, corr_val, threshold_pyramid));
+        }
+    }
+
+    return matches;
+}
+
+
 double TemplateMatching::calc_single_xcorr(const TileImage_GS_BYTE_shptr master,
                                            const TileImage_GS_DOUBLE_shptr summation_table_single,
                                            const TileImage_GS_DOUBLE_shptr summation_table_squared,
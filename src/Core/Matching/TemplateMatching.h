@@ -27,6 +27,8 @@
 #include "Core/LogicModel/Layer.h"
 #include "Core/Utils/ProgressControl.h"
 
+#include <vector>
+
 namespace degate
 {
     /**
@@ -80,10 +82,44 @@ namespace degate
             double sum_over_zero_mean_template_normal;
             double sum_over_zero_mean_template_scaled;
 
+            /**
+             * Template for one level of the background pyramid.
+             */
+            struct pyramid_template
+            {
+                unsigned int scale_down;
+                TempImage_GS_DOUBLE_shptr zero_mean_template;
+                double sum_over_zero_mean_template;
+            };
+
+            // Finest level first, only filled for the pyramid search.
+            std::vector<pyramid_template> pyramid;
+
             Gate::ORIENTATION orientation;
             GateTemplate_shptr gate_template;
         };
 
+        /**
+         * Background image for one level of the pyramid search.
+         */
+        struct pyramid_level
+        {
+            unsigned int scale_down;
+
+            TileImage_GS_BYTE_shptr gs_img;
+            TileImage_GS_DOUBLE_shptr sum_table_single;
+            TileImage_GS_DOUBLE_shptr sum_table_squared;
+        };
+
+        /**
+         * Candidate position of the pyramid search.
+         */
+        struct pyramid_candidate
+        {
+            unsigned int x, y; // unscaled coordinates in the cropped image
+            double correlation;
+        };
+
 
         struct search_state
         {
@@ -119,6 +155,15 @@ namespace degate
         unsigned int max_step_size_search;
         unsigned int scale_down;
 
+        // params for the pyramid search
+        bool pyramid_search;
+        double threshold_pyramid;
+        unsigned int pyramid_top_k;
+        unsigned int pyramid_min_template_size;
+
+        // background pyramid, finest level first
+        std::vector<pyramid_level> pyramid;
+
         // background images in greyscale
         TileImage_GS_BYTE_shptr gs_img_normal;
         TileImage_GS_BYTE_shptr gs_img_scaled;
@@ -166,6 +211,53 @@ namespace degate
         struct prepared_template prepare_template(GateTemplate_shptr tmpl,
                                                   Gate::ORIENTATION orientation);
 
+        /**
+         * Get a prepared template. Prepared templates are kept in memory between
+         * matching runs, for the version of the template image they were made from.
+         */
+        struct prepared_template get_prepared_template(GateTemplate_shptr tmpl,
+                                                       Gate::ORIENTATION orientation);
+
+        /**
+         * Prepare the background images and summation tables of the pyramid search.
+         */
+        void prepare_pyramid(ScalingManager_shptr sm, BoundingBox const& bounding_box);
+
+        /**
+         * Get the number of pyramid levels on which a template is large enough.
+         */
+        unsigned int get_pyramid_levels(GateTemplate_shptr tmpl) const;
+
+        /**
+         * Look for the highest correlation in a square window around a position.
+         *
+         * @param x Position in \p master and output of the best position.
+         * @param y Position in \p master and output of the best position.
+         * @return Returns the highest correlation value in the window.
+         */
+        double search_window(unsigned int* x, unsigned int* y, unsigned int radius,
+                             const TileImage_GS_BYTE_shptr master,
+                             const TileImage_GS_DOUBLE_shptr summation_table_single,
+                             const TileImage_GS_DOUBLE_shptr summation_table_squared,
+                             const TempImage_GS_DOUBLE_shptr zero_mean_template,
+                             double sum_over_zero_mean_template) const;
+
+        /**
+         * Keep the best candidates of each region. A region has the size of the template.
+         */
+        std::vector<pyramid_candidate> select_candidates(std::vector<pyramid_candidate> candidates,
+                                                         unsigned int region_width,
+                                                         unsigned int region_height,
+                                                         unsigned int min_distance) const;
+
+        /**
+         * Coarse-to-fine search. Candidates are screened on the coarsest pyramid level
+         * the template allows, only the best ones per region are followed down the
+         * levels and the exact correlation is only calculated at full resolution.
+         */
+        std::list<match_found> match_single_template_pyramid(struct prepared_template& tmpl,
+                                                             double threshold_detection);
+
 
         void hill_climbing(unsigned int start_x, unsigned int start_y, double xcorr_val,
                            unsigned int* max_corr_x_out,
@@ -212,10 +304,13 @@ namespace degate
                                  unsigned int local_y) const;
 
 
-        bool add_gate(unsigned int x, unsigned int y,
-                      GateTemplate_shptr tmpl,
-                      Gate::ORIENTATION orientation,
-                      double corr_val = 0, double t_hc = 0);
+        /**
+         * Insert a gate for a match, without any overlap check.
+         */
+        void create_gate(unsigned int x, unsigned int y,
+                         GateTemplate_shptr tmpl,
+                         Gate::ORIENTATION orientation,
+                         double corr_val = 0, double t_hc = 0);
 
         match_found keep_gate_match(unsigned int x, unsigned int y,
                                     struct prepared_template& tmpl,
@@ -223,6 +318,23 @@ namespace degate
 
     protected:
 
+        /**
+         * Resolve overlapping matches of all templates and orientations. Matches are
+         * visited from the highest to the lowest correlation and a match is dropped
+         * if it overlaps an already kept one. Kept matches are indexed in a grid with
+         * the size of the largest template, so that only neighbouring cells are checked.
+         *
+         * @return Returns the kept matches, sorted by decreasing correlation.
+         */
+        std::vector<match_found> suppress_overlapping_matches(std::list<match_found> const& matches) const;
+
+        /**
+         * Insert a gate for each match that doesn't overlap a gate placed before. The
+         * matches must not overlap each other (@see suppress_overlapping_matches). The
+         * placed gates are read with a single region query instead of one per match.
+         */
+        void add_gates(std::vector<match_found> const& matches);
+
         /**
          * Calculate the next position for a template to background matching.
          * @return Returns false if there is no further position.
@@ -287,6 +399,48 @@ namespace degate
          */
         void set_scaling_factor(unsigned int factor) { scale_down = factor; }
 
+        /**
+         * Check if the coarse-to-fine pyramid search is used.
+         */
+        bool get_pyramid_search() const { return pyramid_search; }
+
+        /**
+         * Enable or disable the coarse-to-fine pyramid search. If enabled, the
+         * scaling factor and the hill climbing threshold are not used.
+         */
+        void set_pyramid_search(bool enable) { pyramid_search = enable; }
+
+        /**
+         * Get the correlation threshold for keeping a candidate on a pyramid level.
+         */
+        double get_threshold_pyramid() const { return threshold_pyramid; }
+
+        /**
+         * Set the correlation threshold for keeping a candidate on a pyramid level.
+         */
+        void set_threshold_pyramid(double t) { threshold_pyramid = t; }
+
+        /**
+         * Get the number of candidates per region that are followed down the pyramid.
+         */
+        unsigned int get_pyramid_top_k() const { return pyramid_top_k; }
+
+        /**
+         * Set the number of candidates per region that are followed down the pyramid.
+         */
+        void set_pyramid_top_k(unsigned int k) { pyramid_top_k = k; }
+
+        /**
+         * Get the minimal width and height (in pixel) of a template on a pyramid level.
+         * This limits the coarsest level that is used for a template.
+         */
+        unsigned int get_pyramid_min_template_size() const { return pyramid_min_template_size; }
+
+        /**
+         * Set the minimal width and height (in pixel) of a template on a pyramid level.
+         */
+        void set_pyramid_min_template_size(unsigned int size) { pyramid_min_template_size = size; }
+
 
         /**
          * Run the template matching.
@@ -324,6 +478,11 @@ namespace degate
         {
             return stats.hits;
         }
+
+        /**
+         * Release the prepared templates that are kept between matching runs.
+         */
+        static void clear_prepared_templates();
     };
 
 
@@ -220,7 +220,7 @@ bool ViaMatching::add_via(unsigned int x, unsigned int y,
     if (!layer->exists_type_in_region<Via>(x, x + diameter,
                                            y, y + diameter))
     {
-        Via_shptr via(new Via(x + diameter / 2, y + diameter / 2, diameter, direction));
+        Via_shptr via = lmodel->create_object<Via>(x + diameter / 2, y + diameter / 2, diameter, direction);
 
         char dsc[100];
         snprintf(dsc, sizeof(dsc), "matched with corr=%.2f t_hc=%.2f", corr_val, threshold_hc);
@@ -109,11 +109,11 @@ void WireMatching::run()
     for (auto ls : *line_segments)
     {
         debug(TM, "found wire");
-        Wire_shptr w(new Wire(bounding_box.get_min_x() + ls->get_from_x(),
-                              bounding_box.get_min_y() + ls->get_from_y(),
-                              bounding_box.get_min_x() + ls->get_to_x(),
-                              bounding_box.get_min_y() + ls->get_to_y(),
-                              wire_diameter));
+        Wire_shptr w = lmodel->create_object<Wire>(bounding_box.get_min_x() + ls->get_from_x(),
+                                                   bounding_box.get_min_y() + ls->get_from_y(),
+                                                   bounding_box.get_min_x() + ls->get_to_x(),
+                                                   bounding_box.get_min_y() + ls->get_to_y(),
+                                                   wire_diameter);
 
         lmodel->add_object(layer->get_layer_pos(), w);
     }
@@ -226,6 +226,16 @@ bool Project::is_changed() const
     return changed;
 }
 
+void Project::set_full_save_required(bool state)
+{
+    full_save_required = state;
+}
+
+bool Project::is_full_save_required() const
+{
+    return full_save_required;
+}
+
 time_t Project::get_time_since_last_save() const
 {
     return time(nullptr) - last_persistent_version;
@@ -110,6 +110,7 @@ namespace degate
         IrregularGrid_shptr irregular_vertical_grid;
 
         bool changed;
+        bool full_save_required = false;
         time_t last_persistent_version;
 
         diameter_t default_via_diameter;
@@ -267,6 +268,21 @@ namespace degate
          */
         bool is_changed() const;
 
+        /**
+         * Set if the next save must write all project files.
+         *
+         * This is the case for changes that are not recorded by the change tracking of
+         * the logic model (e.g. the project settings, the layers or the gate library),
+         * that can't be appended to the project journal.
+         * @see ProjectJournal
+         */
+        void set_full_save_required(bool state = true);
+
+        /**
+         * Check if the next save must write all project files.
+         */
+        bool is_full_save_required() const;
+
         /**
          * Get time since last "save".
          * @return Returns the time in seconds since the project change state was set to false.
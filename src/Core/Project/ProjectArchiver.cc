@@ -19,136 +19,772 @@
  *
  */
 
-//#include <zip.h>
 
-#include "Globals.h"
 #include "Core/Project/ProjectArchiver.h"
-#include <list>
-#include <memory>
+#include "Core/Utils/FileSystem.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrent>
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/format.hpp>
 
-/*
-using namespace std;
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <vector>
+
 using namespace degate;
-using namespace boost::filesystem;
 
-void ProjectArchiver::add_single_file(struct zip* zip_archive,
-                                      path const& archive_file,
-                                      path const& base_dir_path,
-                                      path const& file,
-                                      path const& prepend_dir) const
+// Files are processed in batches of at most this size, to bound the memory usage.
+#define ARCHIVER_BATCH_SIZE (256 * 1024 * 1024)
+#define ARCHIVER_BATCH_FILES 1024
+
+// ZIP record signatures.
+#define ZIP_LOCAL_HEADER 0x04034b50
+#define ZIP_CENTRAL_HEADER 0x02014b50
+#define ZIP_END_OF_CENTRAL_DIRECTORY 0x06054b50
+#define ZIP64_END_OF_CENTRAL_DIRECTORY 0x06064b50
+#define ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR 0x07064b50
+
+// ZIP extra fields, the second one is specific to degate ("DG").
+#define ZIP64_EXTRA_FIELD 0x0001
+#define ADLER32_EXTRA_FIELD 0x4744
+
+#define ZIP_STORED 0
+#define ZIP_DEFLATED 8
+#define ZIP_ENCRYPTED_FLAG 0x0001
+#define ZIP_UTF8_FLAG 0x0800
+#define ZIP_DIRECTORY_ATTRIBUTE 0x10
+#define ZIP_VERSION 20
+#define ZIP64_VERSION 45
+#define ZIP_LIMIT_16 0xFFFFu
+#define ZIP_LIMIT_32 0xFFFFFFFFu
+
+namespace
 {
-    assert(zip_archive != nullptr);
-    struct zip_source* source;
+    /**
+     * An archive entry, a directory if the name ends with a slash.
+     */
+    struct Entry
+    {
+        std::string path;
+        std::string name;
+        uint64_t size = 0;
+        uint16_t dos_time = 0;
+        uint16_t dos_date = (1 << 5) | 1;
 
-    path stripped = prepend_dir / strip_path(file, base_dir_path);
+        QByteArray data;
+        uint64_t compressed_size = 0;
+        uint16_t method = ZIP_STORED;
+        uint32_t crc = 0;
+        uint32_t adler = 0;
+        bool has_adler = false;
+        uint64_t offset = 0;
 
-    debug(TM, "Add file %s as %s to zip archive.",
-          file.string().c_str(), stripped.string().c_str());
+        // Set by the worker threads, exceptions are not passed through QtConcurrent.
+        std::string error;
 
-    if ((source = zip_source_file(zip_archive,
-                                  file.string().c_str(), 0, 0)) == nullptr)
+        bool is_directory() const
+        {
+            return !name.empty() && name.back() == '/';
+        }
+    };
+
+    uint32_t crc32(QByteArray const& data)
     {
-        boost::format f("Cannot add file %1% to zip archive %2%: %3%");
-        f % file % archive_file % zip_strerror(zip_archive);
-        throw ZipException(f.str());
+        static const std::array<uint32_t, 256> table = []()
+        {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+
+        uint32_t crc = 0xFFFFFFFFu;
+        for (char byte : data)
+            crc = table[(crc ^ static_cast<uint8_t>(byte)) & 0xFF] ^ (crc >> 8);
+
+        return crc ^ 0xFFFFFFFFu;
     }
 
-    if (zip_add(zip_archive,
-                stripped.string().c_str(),
-                source) < 0)
+    void put16(QByteArray& out, uint16_t value)
     {
-        boost::format f("Cannot add file %1% to zip archive %2%: %3%");
-        f % file % archive_file % zip_strerror(zip_archive);
-        throw ZipException(f.str());
+        for (int i = 0; i < 2; i++)
+            out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
     }
-}
 
+    void put32(QByteArray& out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
 
-void ProjectArchiver::add_directory(struct zip* zip_archive,
-                                    path const& archive_file,
-                                    path const& base_dir_path,
-                                    path const& dir,
-                                    path const& prepend_dir) const
-{
-    directory_iterator end_iter;
+    void put64(QByteArray& out, uint64_t value)
+    {
+        for (int i = 0; i < 8; i++)
+            out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    void put32_big_endian(QByteArray& out, uint32_t value)
+    {
+        for (int i = 3; i >= 0; i--)
+            out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    uint64_t get(const char* data, int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = bytes - 1; i >= 0; i--)
+            value = (value << 8) | static_cast<uint8_t>(data[i]);
+
+        return value;
+    }
+
+    uint16_t get16(const char* data)
+    {
+        return static_cast<uint16_t>(get(data, 2));
+    }
+
+    uint32_t get32(const char* data)
+    {
+        return static_cast<uint32_t>(get(data, 4));
+    }
+
+    uint64_t get64(const char* data)
+    {
+        return get(data, 8);
+    }
 
-    for (directory_iterator iter(dir); iter != end_iter; ++iter)
+    uint32_t get32_big_endian(const char* data)
     {
-        path stripped = prepend_dir / strip_path(iter->path(), base_dir_path);
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+            value = (value << 8) | static_cast<uint8_t>(data[i]);
+
+        return value;
+    }
+
+    void set_dos_time(Entry& entry, std::time_t time)
+    {
+        std::tm* tm = std::localtime(&time);
+
+        // The DOS format starts in 1980.
+        if (tm == nullptr || tm->tm_year < 80)
+            return;
+
+        entry.dos_time = static_cast<uint16_t>((tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec / 2));
+        entry.dos_date = static_cast<uint16_t>(((tm->tm_year - 80) << 9) | ((tm->tm_mon + 1) << 5) | tm->tm_mday);
+    }
 
-        if (is_directory(iter->path()))
+    bool is_scaling_directory(std::string const& name)
+    {
+        const std::string prefix = "scaling_";
+        const std::string suffix = ".dimg";
+
+        return name.size() > prefix.size() + suffix.size() &&
+               name.compare(0, prefix.size(), prefix) == 0 &&
+               name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    void collect_entries(boost::filesystem::path const& dir,
+                         std::string const& prefix,
+                         boost::filesystem::path const& archive_file,
+                         bool exclude_scalings,
+                         std::vector<Entry>& entries)
+    {
+        std::vector<boost::filesystem::path> paths;
+        for (boost::filesystem::directory_iterator iter(dir), end; iter != end; ++iter)
+            paths.push_back(iter->path());
+
+        // Same order for the same project.
+        std::sort(paths.begin(), paths.end());
+
+        for (auto const& path : paths)
         {
-#if BOOST_FILESYSTEM_VERSION==3
-            std::string rel_dir = get_filename_from_path(stripped.native());
-#else
-      std::string rel_dir = get_filename_from_path(stripped.native_file_string());
-#endif
-            std::string pattern = "scaling_";
-            bool skip = rel_dir.length() >= pattern.length() && (rel_dir.compare(0, pattern.length(), pattern) == 0);
+            const std::string filename = path.filename().string();
 
-            if (!skip)
+            Entry entry;
+            entry.path = path.string();
+
+            boost::system::error_code error;
+            set_dos_time(entry, boost::filesystem::last_write_time(path, error));
+
+            if (boost::filesystem::is_directory(path))
             {
-                if (zip_add_dir(zip_archive, stripped.string().c_str()) < 0)
-                {
-                    boost::format f("Cannot add directory %1% to zip archive %2%: %3%");
-                    f % iter->path() % archive_file % zip_strerror(zip_archive);
-                    throw ZipException(f.str());
-                }
+                if (exclude_scalings && is_scaling_directory(filename))
+                    continue;
 
-                add_directory(zip_archive, archive_file, base_dir_path,
-                              iter->path(), // already prefixed with dir
-                              prepend_dir);
+                entry.name = prefix + filename + "/";
+                entries.push_back(entry);
+
+                collect_entries(path, entry.name, archive_file, exclude_scalings, entries);
+            }
+            else if (boost::filesystem::is_regular_file(path))
+            {
+                if (boost::filesystem::equivalent(path, archive_file, error))
+                    continue;
+
+                entry.name = prefix + filename;
+                entry.size = boost::filesystem::file_size(path);
+                entries.push_back(entry);
+            }
+        }
+    }
+
+    void compress_entry(Entry& entry, int compression_level)
+    {
+        if (entry.is_directory())
+            return;
+
+        QFile file(QString::fromStdString(entry.path));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            entry.error = "Can't read the file " + entry.path + ".";
+            return;
+        }
+
+        QByteArray data = file.readAll();
+
+        entry.size = static_cast<uint64_t>(data.size());
+        entry.crc = crc32(data);
+
+        if (compression_level > 0 && !data.isEmpty())
+        {
+            // qCompress() returns the size, a zlib header, the raw deflate stream and an Adler-32 checksum.
+            QByteArray compressed = qCompress(data, compression_level);
+            const qsizetype deflate_size = compressed.size() - 4 - 2 - 4;
+
+            if (deflate_size > 0 && deflate_size < data.size())
+            {
+                entry.adler = get32_big_endian(compressed.constData() + compressed.size() - 4);
+                entry.has_adler = true;
+                entry.method = ZIP_DEFLATED;
+                entry.data = compressed.mid(4 + 2, deflate_size);
+                entry.compressed_size = static_cast<uint64_t>(entry.data.size());
+                return;
             }
         }
+
+        // Not compressible, e.g. already compressed data.
+        entry.method = ZIP_STORED;
+        entry.data = data;
+        entry.compressed_size = entry.size;
+    }
+
+    void extract_entry(Entry& entry)
+    {
+        QByteArray data;
+
+        if (entry.method == ZIP_STORED)
+        {
+            data = entry.data;
+        }
         else
         {
-            add_single_file(zip_archive, archive_file, base_dir_path, iter->path(), prepend_dir);
+            // Rebuild the stream that qUncompress() expects from the raw deflate stream.
+            QByteArray stream;
+            stream.reserve(entry.data.size() + 4 + 2 + 4);
+            put32_big_endian(stream, static_cast<uint32_t>(entry.size));
+            stream.append(static_cast<char>(0x78));
+            stream.append(static_cast<char>(0x9C));
+            stream.append(entry.data);
+            put32_big_endian(stream, entry.adler);
+
+            data = qUncompress(stream);
+        }
+
+        if (static_cast<uint64_t>(data.size()) != entry.size || crc32(data) != entry.crc)
+        {
+            entry.error = "The archive entry " + entry.name + " is corrupt.";
+            return;
+        }
+
+        QFile file(QString::fromStdString(entry.path));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size())
+        {
+            entry.error = "Can't write the file " + entry.path + ".";
+            return;
         }
+
+        entry.data = QByteArray();
+    }
+
+    std::size_t get_batch_end(std::vector<Entry> const& entries, std::size_t begin, bool compressed)
+    {
+        std::size_t end = begin;
+        uint64_t batch_size = 0;
+
+        while (end < entries.size() && end - begin < ARCHIVER_BATCH_FILES)
+        {
+            const uint64_t size = compressed ? entries[end].compressed_size : entries[end].size;
+
+            // A single file larger than a batch is processed alone.
+            if (end > begin && batch_size + size > ARCHIVER_BATCH_SIZE)
+                break;
+
+            batch_size += size;
+            end++;
+        }
+
+        return end;
+    }
+
+    void write_data(QIODevice& file, QByteArray const& data, uint64_t& offset)
+    {
+        if (file.write(data) != data.size())
+            throw ZipException("Can't write the archive.");
+
+        offset += static_cast<uint64_t>(data.size());
+    }
+
+    QByteArray read_data(QFile& file, uint64_t offset, uint64_t size)
+    {
+        if (offset + size > static_cast<uint64_t>(file.size()) || !file.seek(static_cast<qint64>(offset)))
+            throw ZipException("The archive is truncated.");
+
+        QByteArray data = file.read(static_cast<qint64>(size));
+        if (static_cast<uint64_t>(data.size()) != size)
+            throw ZipException("Can't read the archive.");
+
+        return data;
+    }
+
+    bool is_safe_name(std::string const& name)
+    {
+        if (name.empty() || name.front() == '/' || name.find('\\') != std::string::npos ||
+            name.find(':') != std::string::npos)
+            return false;
+
+        std::size_t begin = 0;
+        while (begin < name.size())
+        {
+            std::size_t end = name.find('/', begin);
+            if (end == std::string::npos)
+                end = name.size();
+
+            if (name.compare(begin, end - begin, "..") == 0)
+                return false;
+
+            begin = end + 1;
+        }
+
+        return true;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
 }
 
+ProjectArchiver::ProjectArchiver(int compression_level, bool exclude_scalings)
+    : compression_level(std::max(0, std::min(9, compression_level))),
+      exclude_scalings(exclude_scalings)
+{
+}
 
-void ProjectArchiver::export_data(path const& project_dir,
-                                  path const& archive_file,
-                                  path const& prepend_dir) const
+void ProjectArchiver::export_data(std::string const& project_dir,
+                                  std::string const& archive_file,
+                                  std::string const& prepend_dir)
 {
-    struct zip* zip_archive;
-    int err;
+    if (!is_directory(project_dir))
+        throw InvalidPathException("The project directory does not exist.");
+
+    reset_progress();
+    statistics = Statistics();
+    const auto start = std::chrono::steady_clock::now();
 
-    if ((zip_archive = zip_open(archive_file.string().c_str(), ZIP_CREATE, &err)) == nullptr)
+    std::vector<Entry> entries;
+    std::string prefix;
+
+    if (!prepend_dir.empty())
     {
-        char errstr[1024];
-        zip_error_to_str(errstr, sizeof(errstr), err, errno);
-        throw ZipException(errstr);
+        Entry entry;
+        entry.name = prefix = prepend_dir + "/";
+        set_dos_time(entry, std::time(nullptr));
+        entries.push_back(entry);
     }
 
-    if (zip_add_dir(zip_archive, prepend_dir.string().c_str()) < 0)
+    collect_entries(project_dir, prefix, archive_file, exclude_scalings, entries);
+
+    uint64_t total_size = 0;
+    for (auto const& entry : entries)
+        total_size += entry.size;
+
+    QSaveFile file(QString::fromStdString(archive_file));
+    if (!file.open(QIODevice::WriteOnly))
+        throw InvalidPathException("Can't create the archive " + archive_file + ".");
+
+    uint64_t offset = 0;
+    uint64_t done_size = 0;
+    QByteArray central_directory;
+
+    for (std::size_t begin = 0; begin < entries.size();)
+    {
+        if (is_canceled())
+        {
+            file.cancelWriting();
+            return;
+        }
+
+        const std::size_t end = get_batch_end(entries, begin, false);
+
+        const int level = compression_level;
+        QtConcurrent::blockingMap(entries.begin() + begin, entries.begin() + end, [level](Entry& entry)
+        {
+            compress_entry(entry, level);
+        });
+
+        // Written in order, the archive is the same for the same project.
+        for (std::size_t i = begin; i < end; i++)
+        {
+            Entry& entry = entries[i];
+
+            if (!entry.error.empty())
+                throw ZipException(entry.error);
+
+            entry.offset = offset;
+
+            const bool zip64_sizes = entry.size >= ZIP_LIMIT_32 || entry.compressed_size >= ZIP_LIMIT_32;
+            const bool zip64_offset = entry.offset >= ZIP_LIMIT_32;
+            const uint16_t version = zip64_sizes || zip64_offset ? ZIP64_VERSION : ZIP_VERSION;
+
+            QByteArray adler_field;
+            if (entry.has_adler)
+            {
+                put16(adler_field, ADLER32_EXTRA_FIELD);
+                put16(adler_field, 4);
+                put32(adler_field, entry.adler);
+            }
+
+            // Local header
+            QByteArray local_extra;
+            if (zip64_sizes)
+            {
+                put16(local_extra, ZIP64_EXTRA_FIELD);
+                put16(local_extra, 16);
+                put64(local_extra, entry.size);
+                put64(local_extra, entry.compressed_size);
+            }
+            local_extra.append(adler_field);
+
+            QByteArray header;
+            put32(header, ZIP_LOCAL_HEADER);
+            put16(header, version);
+            put16(header, ZIP_UTF8_FLAG);
+            put16(header, entry.method);
+            put16(header, entry.dos_time);
+            put16(header, entry.dos_date);
+            put32(header, entry.crc);
+            put32(header, zip64_sizes ? ZIP_LIMIT_32 : static_cast<uint32_t>(entry.compressed_size));
+            put32(header, zip64_sizes ? ZIP_LIMIT_32 : static_cast<uint32_t>(entry.size));
+            put16(header, static_cast<uint16_t>(entry.name.size()));
+            put16(header, static_cast<uint16_t>(local_extra.size()));
+            header.append(entry.name.data(), static_cast<qsizetype>(entry.name.size()));
+            header.append(local_extra);
+
+            write_data(file, header, offset);
+            write_data(file, entry.data, offset);
+
+            // Central directory record
+            QByteArray central_extra;
+            if (zip64_sizes || zip64_offset)
+            {
+                put16(central_extra, ZIP64_EXTRA_FIELD);
+                put16(central_extra, static_cast<uint16_t>((zip64_sizes ? 16 : 0) + (zip64_offset ? 8 : 0)));
+                if (zip64_sizes)
+                {
+                    put64(central_extra, entry.size);
+                    put64(central_extra, entry.compressed_size);
+                }
+                if (zip64_offset)
+                    put64(central_extra, entry.offset);
+            }
+            central_extra.append(adler_field);
+
+            put32(central_directory, ZIP_CENTRAL_HEADER);
+            put16(central_directory, version);
+            put16(central_directory, version);
+            put16(central_directory, ZIP_UTF8_FLAG);
+            put16(central_directory, entry.method);
+            put16(central_directory, entry.dos_time);
+            put16(central_directory, entry.dos_date);
+            put32(central_directory, entry.crc);
+            put32(central_directory, zip64_sizes ? ZIP_LIMIT_32 : static_cast<uint32_t>(entry.compressed_size));
+            put32(central_directory, zip64_sizes ? ZIP_LIMIT_32 : static_cast<uint32_t>(entry.size));
+            put16(central_directory, static_cast<uint16_t>(entry.name.size()));
+            put16(central_directory, static_cast<uint16_t>(central_extra.size()));
+            put16(central_directory, 0); // comment
+            put16(central_directory, 0); // disk
+            put16(central_directory, 0); // internal attributes
+            put32(central_directory, entry.is_directory() ? ZIP_DIRECTORY_ATTRIBUTE : 0);
+            put32(central_directory, zip64_offset ? ZIP_LIMIT_32 : static_cast<uint32_t>(entry.offset));
+            central_directory.append(entry.name.data(), static_cast<qsizetype>(entry.name.size()));
+            central_directory.append(central_extra);
+
+            if (!entry.is_directory())
+                statistics.file_count++;
+
+            statistics.uncompressed_bytes += entry.size;
+            statistics.compressed_bytes += entry.compressed_size;
+            done_size += entry.size;
+
+            entry.data = QByteArray();
+        }
+
+        if (total_size > 0)
+            set_progress(static_cast<double>(done_size) / static_cast<double>(total_size));
+
+        begin = end;
+    }
+
+    // End of the central directory
+    const uint64_t count = entries.size();
+    const uint64_t central_directory_offset = offset;
+    const uint64_t central_directory_size = static_cast<uint64_t>(central_directory.size());
+
+    write_data(file, central_directory, offset);
+
+    QByteArray end_records;
+
+    if (count >= ZIP_LIMIT_16 || central_directory_offset >= ZIP_LIMIT_32 || central_directory_size >= ZIP_LIMIT_32)
+    {
+        put32(end_records, ZIP64_END_OF_CENTRAL_DIRECTORY);
+        put64(end_records, 44);
+        put16(end_records, ZIP64_VERSION);
+        put16(end_records, ZIP64_VERSION);
+        put32(end_records, 0);
+        put32(end_records, 0);
+        put64(end_records, count);
+        put64(end_records, count);
+        put64(end_records, central_directory_size);
+        put64(end_records, central_directory_offset);
+
+        put32(end_records, ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR);
+        put32(end_records, 0);
+        put64(end_records, offset);
+        put32(end_records, 1);
+    }
+
+    put32(end_records, ZIP_END_OF_CENTRAL_DIRECTORY);
+    put16(end_records, 0);
+    put16(end_records, 0);
+    put16(end_records, static_cast<uint16_t>(std::min<uint64_t>(count, ZIP_LIMIT_16)));
+    put16(end_records, static_cast<uint16_t>(std::min<uint64_t>(count, ZIP_LIMIT_16)));
+    put32(end_records, static_cast<uint32_t>(std::min<uint64_t>(central_directory_size, ZIP_LIMIT_32)));
+    put32(end_records, static_cast<uint32_t>(std::min<uint64_t>(central_directory_offset, ZIP_LIMIT_32)));
+    put16(end_records, 0);
+
+    write_data(file, end_records, offset);
+
+    if (!file.commit())
+        throw ZipException("Can't write the archive " + archive_file + ".");
+
+    set_progress(1);
+    statistics.seconds = seconds_since(start);
+
+    debug(TM, "Archived %llu files (%llu bytes, %llu compressed) in %.2f s, %.1f MB/s.",
+          static_cast<unsigned long long>(statistics.file_count),
+          static_cast<unsigned long long>(statistics.uncompressed_bytes),
+          static_cast<unsigned long long>(statistics.compressed_bytes),
+          statistics.seconds, statistics.get_throughput() / (1024 * 1024));
+}
+
+void ProjectArchiver::import_data(std::string const& archive_file, std::string const& directory)
+{
+    if (!is_directory(directory))
+        throw InvalidPathException("The directory to extract the archive to does not exist.");
+
+    reset_progress();
+    statistics = Statistics();
+    const auto start = std::chrono::steady_clock::now();
+
+    QFile file(QString::fromStdString(archive_file));
+    if (!file.open(QIODevice::ReadOnly))
+        throw InvalidPathException("Can't open the archive " + archive_file + ".");
+
+    const uint64_t file_size = static_cast<uint64_t>(file.size());
+
+    // The end record is followed by a comment of up to 64 kB and can be preceded by the ZIP64 locator.
+    const uint64_t tail_size = std::min<uint64_t>(file_size, 20 + 22 + ZIP_LIMIT_16);
+    const QByteArray tail = read_data(file, file_size - tail_size, tail_size);
+
+    qsizetype end_record = -1;
+    for (qsizetype i = tail.size() - 22; i >= 0; i--)
     {
-        boost::format f("Cannot add directory %1% to zip archive %2%: %3%");
-        f % prepend_dir % archive_file % zip_strerror(zip_archive);
-        throw ZipException(f.str());
+        if (get32(tail.constData() + i) == ZIP_END_OF_CENTRAL_DIRECTORY)
+        {
+            end_record = i;
+            break;
+        }
     }
 
-    try
+    if (end_record < 0)
+        throw ZipException("The file " + archive_file + " is not a ZIP archive.");
+
+    uint64_t count = get16(tail.constData() + end_record + 10);
+    uint64_t central_directory_size = get32(tail.constData() + end_record + 12);
+    uint64_t central_directory_offset = get32(tail.constData() + end_record + 16);
+
+    if (end_record >= 20 && get32(tail.constData() + end_record - 20) == ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR)
     {
-        add_directory(zip_archive, archive_file, project_dir, project_dir, prepend_dir);
+        const QByteArray record = read_data(file, get64(tail.constData() + end_record - 20 + 8), 56);
+        if (get32(record.constData()) != ZIP64_END_OF_CENTRAL_DIRECTORY)
+            throw ZipException("The ZIP64 end record of the archive is corrupt.");
+
+        count = get64(record.constData() + 32);
+        central_directory_size = get64(record.constData() + 40);
+        central_directory_offset = get64(record.constData() + 48);
     }
-    catch (ZipException const& ex)
+
+    const QByteArray central_directory = read_data(file, central_directory_offset, central_directory_size);
+    const char* const cd = central_directory.constData();
+
+    std::vector<Entry> entries;
+    uint64_t total_size = 0;
+    qsizetype pos = 0;
+
+    for (uint64_t i = 0; i < count; i++)
     {
-        // rethrow exception, but free zip_archive resource first
-        if (zip_archive != nullptr) zip_close(zip_archive);
-        throw;
+        if (pos + 46 > central_directory.size() || get32(cd + pos) != ZIP_CENTRAL_HEADER)
+            throw ZipException("The central directory of the archive is corrupt.");
+
+        const uint16_t flags = get16(cd + pos + 8);
+        const uint16_t name_size = get16(cd + pos + 28);
+        const uint16_t extra_size = get16(cd + pos + 30);
+        const uint16_t comment_size = get16(cd + pos + 32);
+
+        if (pos + 46 + name_size + extra_size + comment_size > central_directory.size())
+            throw ZipException("The central directory of the archive is corrupt.");
+
+        Entry entry;
+        entry.method = get16(cd + pos + 10);
+        entry.crc = get32(cd + pos + 16);
+        entry.compressed_size = get32(cd + pos + 20);
+        entry.size = get32(cd + pos + 24);
+        entry.offset = get32(cd + pos + 42);
+        entry.name = std::string(cd + pos + 46, name_size);
+
+        // Extra fields
+        const char* extra = cd + pos + 46 + name_size;
+        for (uint16_t e = 0; e + 4 <= extra_size;)
+        {
+            const uint16_t id = get16(extra + e);
+            const uint16_t size = get16(extra + e + 2);
+            const char* field = extra + e + 4;
+            const char* field_end = field + std::min<uint16_t>(size, static_cast<uint16_t>(extra_size - e - 4));
+
+            if (id == ZIP64_EXTRA_FIELD)
+            {
+                // Only the values that do not fit in the record, in this order.
+                for (uint64_t* value : {&entry.size, &entry.compressed_size, &entry.offset})
+                {
+                    if (*value == ZIP_LIMIT_32 && field + 8 <= field_end)
+                    {
+                        *value = get64(field);
+                        field += 8;
+                    }
+                }
+            }
+            else if (id == ADLER32_EXTRA_FIELD && size == 4 && field + 4 <= field_end)
+            {
+                entry.adler = get32(field);
+                entry.has_adler = true;
+            }
+
+            e = static_cast<uint16_t>(e + 4 + size);
+        }
+
+        pos += 46 + name_size + extra_size + comment_size;
+
+        if (!is_safe_name(entry.name))
+            throw ZipException("The archive entry " + entry.name + " is outside of the target directory.");
+
+        if ((flags & ZIP_ENCRYPTED_FLAG) != 0)
+            throw ZipException("The archive entry " + entry.name + " is encrypted.");
+
+        if (entry.method != ZIP_STORED && !(entry.method == ZIP_DEFLATED && entry.has_adler))
+            throw ZipException("The archive entry " + entry.name + " was not created by degate and is compressed, "
+                               "only uncompressed entries of such archives can be imported.");
+
+        entry.path = join_pathes(directory, entry.name);
+        total_size += entry.compressed_size;
+
+        entries.push_back(entry);
     }
 
-    if (zip_archive != nullptr && zip_close(zip_archive) < 0)
+    uint64_t done_size = 0;
+
+    for (std::size_t begin = 0; begin < entries.size();)
     {
-        boost::format f("Cannot write zip archive %1%: %2%");
-        f % archive_file % zip_strerror(zip_archive);
-        throw ZipException(f.str());
+        if (is_canceled())
+            return;
+
+        const std::size_t end = get_batch_end(entries, begin, true);
+
+        // Directories and file data are read in order, files are decompressed and written concurrently.
+        for (std::size_t i = begin; i < end; i++)
+        {
+            Entry& entry = entries[i];
+
+            if (entry.is_directory())
+            {
+                boost::filesystem::create_directories(entry.path);
+                continue;
+            }
+
+            boost::filesystem::create_directories(boost::filesystem::path(entry.path).parent_path());
+
+            const QByteArray header = read_data(file, entry.offset, 30);
+            if (get32(header.constData()) != ZIP_LOCAL_HEADER)
+                throw ZipException("The archive entry " + entry.name + " is corrupt.");
+
+            const uint64_t data_offset = entry.offset + 30 + get16(header.constData() + 26) + get16(header.constData() + 28);
+            entry.data = read_data(file, data_offset, entry.compressed_size);
+        }
+
+        QtConcurrent::blockingMap(entries.begin() + begin, entries.begin() + end, [](Entry& entry)
+        {
+            if (!entry.is_directory())
+                extract_entry(entry);
+        });
+
+        for (std::size_t i = begin; i < end; i++)
+        {
+            Entry const& entry = entries[i];
+
+            if (!entry.error.empty())
+                throw ZipException(entry.error);
+
+            if (!entry.is_directory())
+                statistics.file_count++;
+
+            statistics.uncompressed_bytes += entry.size;
+            statistics.compressed_bytes += entry.compressed_size;
+            done_size += entry.compressed_size;
+        }
+
+        if (total_size > 0)
+            set_progress(static_cast<double>(done_size) / static_cast<double>(total_size));
+
+        begin = end;
     }
+
+    set_progress(1);
+    statistics.seconds = seconds_since(start);
+
+    debug(TM, "Extracted %llu files (%llu bytes) in %.2f s, %.1f MB/s.",
+          static_cast<unsigned long long>(statistics.file_count),
+          static_cast<unsigned long long>(statistics.uncompressed_bytes),
+          statistics.seconds, statistics.get_throughput() / (1024 * 1024));
 }
-*/
@@ -19,53 +19,110 @@
  *
  */
 
+
 #ifndef __PROJECTARCHIVER_H__
 #define __PROJECTARCHIVER_H__
 
-#include "Core/Project/Project.h"
+#include "Globals.h"
+#include "Core/Utils/ProgressControl.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
+#include <string>
 
 namespace degate
 {
     /**
-     * Export a project directory as a ZIP archive.
+     * Export a project directory as a ZIP archive and import it back.
+     *
+     * The files are compressed concurrently in batches and written in order. Files
+     * that do not get smaller are stored uncompressed, a compression level of 0
+     * stores all files (e.g. for already compressed tile data).
+     *
+     * The prescaled background images (the scaling_N.dimg directories) can be
+     * excluded, they are created again when the project is opened.
      *
+     * Deflated entries carry the Adler-32 checksum of their zlib stream in an extra
+     * field, therefore only stored entries of archives created by other tools can
+     * be imported.
      */
-
-    /* Dropped archiver/zip support for the moment.
-
-    class ProjectArchiver
+    class ProjectArchiver : public ProgressControl
     {
-    private:
+    public:
 
-        void add_single_file(struct zip* zip_archive,
-                             boost::filesystem::path const& archive_file,
-                             boost::filesystem::path const& base_dir_path,
-                             boost::filesystem::path const& file,
-                             boost::filesystem::path const& prepend_dir) const;
+        /**
+         * Statistics of the last export or import.
+         */
+        struct Statistics
+        {
+            std::size_t file_count = 0;
+            uint64_t uncompressed_bytes = 0;
+            uint64_t compressed_bytes = 0;
+            double seconds = 0;
 
+            /**
+             * Get the throughput in uncompressed bytes per second.
+             */
+            double get_throughput() const
+            {
+                return seconds > 0 ? static_cast<double>(uncompressed_bytes) / seconds : 0;
+            }
+        };
 
-        void add_directory(struct zip* zip_archive,
-                           boost::filesystem::path const& archive_file,
-                           boost::filesystem::path const& base_dir_path,
-                           boost::filesystem::path const& dir,
-                           boost::filesystem::path const& prepend_dir) const;
+        /**
+         * Create an archiver.
+         * @param compression_level : 0 to store all files, 1 (fastest) to 9 (smallest)
+         *   to compress them.
+         * @param exclude_scalings : if true, the scaling_N.dimg directories are not archived.
+         */
+        ProjectArchiver(int compression_level = 6, bool exclude_scalings = true);
 
-    public:
-        ProjectArchiver()
+        ~ProjectArchiver()
         {
         }
 
-        ~ProjectArchiver()
+        /**
+         * Export a project directory as a ZIP archive.
+         * @param project_dir : the project directory.
+         * @param archive_file : the archive to create. It is replaced only if the
+         *   export succeeded and was not canceled.
+         * @param prepend_dir : a directory name in the archive for all files, can be empty.
+         * @exception InvalidPathException
+         * @exception ZipException
+         */
+        void export_data(std::string const& project_dir,
+                         std::string const& archive_file,
+                         std::string const& prepend_dir = "");
+
+        /**
+         * Extract a ZIP archive into a directory. The scaling_N.dimg directories
+         * that are not in the archive are created when the project is opened.
+         * @param archive_file : the archive to extract.
+         * @param directory : the existing directory to extract to.
+         * @exception InvalidPathException
+         * @exception ZipException
+         */
+        void import_data(std::string const& archive_file, std::string const& directory);
+
+        /**
+         * Get the statistics of the last export or import.
+         */
+        Statistics const& get_statistics() const
         {
+            return statistics;
         }
 
-        void export_data(boost::filesystem::path const& project_dir,
-                         boost::filesystem::path const& archive_file,
-                         boost::filesystem::path const& prepend_dir) const;
+    private:
+
+        int compression_level;
+        bool exclude_scalings;
+
+        Statistics statistics;
     };
-    */
+
+    typedef std::shared_ptr<ProjectArchiver> ProjectArchiver_shptr;
 }
 
 #endif
@@ -22,8 +22,10 @@
 #include "Globals.h"
 #include "Core/LogicModel/Layer.h"
 #include "Core/Project/ProjectExporter.h"
+#include "Core/Project/ProjectJournal.h"
 #include "Core/Utils/ObjectIDRewriter.h"
 #include "Core/LogicModel/LogicModelExporter.h"
+#include "Core/LogicModel/LogicModelBinaryExporter.h"
 #include "Core/LogicModel/Gate/GateLibraryExporter.h"
 #include "Core/RuleCheck/RCVBlacklistExporter.h"
 #include "Core/Version.h"
@@ -42,74 +44,105 @@ void ProjectExporter::export_all(std::string const& project_directory, const Pro
                                  std::string const& project_file,
                                  std::string const& lmodel_file,
                                  std::string const& gatelib_file,
-                                 std::string const& rcbl_file)
+                                 std::string const& rcbl_file,
+                                 std::string const& lmodel_binary_file)
 {
     if (!is_directory(project_directory))
     {
         throw InvalidPathException("The path where the project should be exported to is not a directory.");
     }
-    else
-    {
-        ObjectIDRewriter_shptr oid_rewriter(new ObjectIDRewriter(enable_oid_rewrite));
 
-        export_data(join_pathes(project_directory, project_file), prj);
+    export_snapshot(project_directory, *create_snapshot(prj, enable_oid_rewrite),
+                    project_file, lmodel_file, gatelib_file, rcbl_file, lmodel_binary_file);
+}
 
-        LogicModel_shptr lmodel = prj->get_logic_model();
+ProjectSnapshot_shptr ProjectExporter::create_snapshot(const Project_shptr& prj, bool enable_oid_rewrite)
+{
+    if (prj == nullptr) throw InvalidPointerException("Project pointer is nullptr.");
 
-        if (lmodel != nullptr)
-        {
-            LogicModelExporter lm_exporter(oid_rewriter);
-            string lm_filename(join_pathes(project_directory, lmodel_file));
-            lm_exporter.export_data(lm_filename, lmodel);
+    ObjectIDRewriter_shptr oid_rewriter(new ObjectIDRewriter(enable_oid_rewrite));
 
+    auto snapshot = std::make_shared<ProjectSnapshot>();
 
-            RCVBlacklistExporter rcv_exporter(oid_rewriter);
-            rcv_exporter.export_data(join_pathes(project_directory, rcbl_file), prj->get_rcv_blacklist());
+    snapshot->project_document = serialize(prj);
 
-            GateLibrary_shptr glib = lmodel->get_gate_library();
-            if (glib != nullptr)
-            {
-                GateLibraryExporter gl_exporter(oid_rewriter);
-                gl_exporter.export_data(join_pathes(project_directory, gatelib_file), glib);
-            }
+    LogicModel_shptr lmodel = prj->get_logic_model();
+
+    if (lmodel != nullptr)
+    {
+        snapshot->logic_model = std::make_shared<const LogicModelSnapshot>(lmodel, oid_rewriter);
+
+        RCVBlacklistExporter rcv_exporter(oid_rewriter);
+        snapshot->rc_blacklist_document = rcv_exporter.serialize(prj->get_rcv_blacklist());
+
+        GateLibrary_shptr glib = lmodel->get_gate_library();
+        if (glib != nullptr)
+        {
+            GateLibraryExporter gl_exporter(oid_rewriter);
+            snapshot->gate_library = gl_exporter.prepare(glib);
         }
     }
+
+    return snapshot;
 }
 
-void ProjectExporter::export_data(std::string const& filename, const Project_shptr& prj)
+void ProjectExporter::export_snapshot(std::string const& project_directory, ProjectSnapshot const& snapshot,
+                                      std::string const& project_file,
+                                      std::string const& lmodel_file,
+                                      std::string const& gatelib_file,
+                                      std::string const& rcbl_file,
+                                      std::string const& lmodel_binary_file)
 {
-    if (prj == nullptr) throw InvalidPointerException("Project pointer is nullptr.");
+    if (!is_directory(project_directory))
+    {
+        throw InvalidPathException("The path where the project should be exported to is not a directory.");
+    }
 
     try
     {
-        QDomDocument doc;
-
-        QDomProcessingInstruction head = doc.createProcessingInstruction("xml", XML_ENCODING);
-        doc.appendChild(head);
+        write_file(join_pathes(project_directory, project_file), snapshot.project_document);
 
-        QDomElement root_elem = doc.createElement("project");
-        assert(!root_elem.isNull());
+        if (snapshot.logic_model != nullptr)
+        {
+            // The IDs were rewritten when the snapshot was taken.
+            ObjectIDRewriter_shptr oid_rewriter(new ObjectIDRewriter(false));
 
-        set_project_node_attributes(doc, root_elem, prj);
+            LogicModelExporter lm_exporter(oid_rewriter);
+            lm_exporter.export_snapshot(join_pathes(project_directory, lmodel_file), *snapshot.logic_model);
 
-        add_layers(doc, root_elem, prj->get_logic_model(), prj->get_project_directory());
-        add_grids(doc, root_elem, prj);
-        add_colors(doc, root_elem, prj);
-        add_port_colors(doc, root_elem, prj->get_port_color_manager());
+            // Written after the XML file, so that it is newer and preferred at import.
+            if (!lmodel_binary_file.empty())
+            {
+                LogicModelBinaryExporter lm_binary_exporter(oid_rewriter);
+                lm_binary_exporter.export_snapshot(join_pathes(project_directory, lmodel_binary_file),
+                                                   *snapshot.logic_model);
+            }
 
-        doc.appendChild(root_elem);
+            write_file(join_pathes(project_directory, rcbl_file), snapshot.rc_blacklist_document);
 
-        QFile file(QString::fromStdString(filename));
-        if (!file.open(QIODevice::WriteOnly))
-        {
-            throw InvalidPathException("Can't create export file.");
+            if (snapshot.gate_library != nullptr)
+            {
+                GateLibraryExporter gl_exporter(oid_rewriter);
+                gl_exporter.write(join_pathes(project_directory, gatelib_file), *snapshot.gate_library);
+            }
         }
 
-        QTextStream stream(&file);
-        stream.setEncoding(QStringConverter::Utf8);
-        stream << doc.toString();
+        // The project files contain all changes of the journal now.
+        ProjectJournal journal(project_directory);
+        journal.clear();
+    }
+    catch (const std::exception& ex)
+    {
+        std::cout << "Exception caught: " << ex.what() << std::endl;
+        throw;
+    }
+}
 
-        file.close();
+void ProjectExporter::export_data(std::string const& filename, const Project_shptr& prj)
+{
+    try
+    {
+        write_file(filename, serialize(prj));
     }
     catch (const std::exception& ex)
     {
@@ -118,6 +151,30 @@ void ProjectExporter::export_data(std::string const& filename, const Project_shp
     }
 }
 
+QByteArray ProjectExporter::serialize(const Project_shptr& prj)
+{
+    if (prj == nullptr) throw InvalidPointerException("Project pointer is nullptr.");
+
+    QDomDocument doc;
+
+    QDomProcessingInstruction head = doc.createProcessingInstruction("xml", XML_ENCODING);
+    doc.appendChild(head);
+
+    QDomElement root_elem = doc.createElement("project");
+    assert(!root_elem.isNull());
+
+    set_project_node_attributes(doc, root_elem, prj);
+
+    add_layers(doc, root_elem, prj->get_logic_model(), prj->get_project_directory());
+    add_grids(doc, root_elem, prj);
+    add_colors(doc, root_elem, prj);
+    add_port_colors(doc, root_elem, prj->get_port_color_manager());
+
+    doc.appendChild(root_elem);
+
+    return doc.toByteArray();
+}
+
 void ProjectExporter::add_grids(QDomDocument& doc, QDomElement& prj_elem, const Project_shptr& prj)
 {
     QDomElement grids_elem = doc.createElement("grids");
@@ -230,6 +287,9 @@ void ProjectExporter::add_layers(QDomDocument& doc,
         layer_elem.setAttribute("type", QString::fromStdString(layer->get_layer_type_as_string()));
         layer_elem.setAttribute("description", QString::fromStdString(layer->get_description()));
         layer_elem.setAttribute("enabled", QString::fromStdString(layer->is_enabled() ? "true" : "false"));
+        layer_elem.setAttribute("composited", QString::fromStdString(layer->is_composited() ? "true" : "false"));
+        layer_elem.setAttribute("composition-opacity", QString::number(layer->get_composition_opacity()));
+        layer_elem.setAttribute("composition-tint", QString::fromStdString(to_color_string(layer->get_composition_tint())));
 
         if (layer->has_background_image())
         {
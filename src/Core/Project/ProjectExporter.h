@@ -24,6 +24,7 @@
 
 #include "Core/XML/XMLExporter.h"
 #include "Core/Project/Project.h"
+#include "Core/Project/ProjectSnapshot.h"
 
 #include <stdexcept>
 
@@ -70,6 +71,24 @@ namespace degate
         void export_data(std::string const& filename, const Project_shptr& prj);
 
         /**
+         * Build the content of the project file, without writing it.
+         * @exception InvalidPointerException
+         */
+        QByteArray serialize(const Project_shptr& prj);
+
+        /**
+         * Export the project files.
+         *
+         * Besides the XML files, the logic model is written into the binary file
+         * lmodel_binary_file, that is preferred at import if it is up to date. Pass
+         * an empty file name to disable it.
+         *
+         * Each file is written into a temporary file first that replaces the previous
+         * version, so that a crash while saving never leaves a half written file.
+         *
+         * The project journal (see ProjectJournal) is removed, its changes are part of
+         * the written files.
+         *
          * @exception InvalidPathException
          * @exception InvalidPointerException
          * @exception std::runtime_error
@@ -79,7 +98,27 @@ namespace degate
                         std::string const& project_file = "project.xml",
                         std::string const& lmodel_file = "lmodel.xml",
                         std::string const& gatelib_file = "gate_library.xml",
-                        std::string const& rcbl_file = "rc_blacklist.xml");
+                        std::string const& rcbl_file = "rc_blacklist.xml",
+                        std::string const& lmodel_binary_file = "lmodel.bin");
+
+        /**
+         * Take a snapshot of everything export_all() writes. This must be called from
+         * the thread that edits the project.
+         * @exception InvalidPointerException
+         */
+        ProjectSnapshot_shptr create_snapshot(const Project_shptr& prj, bool enable_oid_rewrite = true);
+
+        /**
+         * Write a snapshot of a project, see export_all(). This can be called from any thread.
+         * @exception InvalidPathException
+         * @exception std::runtime_error
+         */
+        void export_snapshot(std::string const& project_directory, ProjectSnapshot const& snapshot,
+                             std::string const& project_file = "project.xml",
+                             std::string const& lmodel_file = "lmodel.xml",
+                             std::string const& gatelib_file = "gate_library.xml",
+                             std::string const& rcbl_file = "rc_blacklist.xml",
+                             std::string const& lmodel_binary_file = "lmodel.bin");
     };
 }
 
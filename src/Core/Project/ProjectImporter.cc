@@ -20,17 +20,24 @@
  */
 
 #include "Core/Project/ProjectImporter.h"
+#include "Core/Project/ProjectJournal.h"
 #include "Core/LogicModel/Gate/GateLibraryImporter.h"
 #include "Core/LogicModel/LogicModelImporter.h"
+#include "Core/LogicModel/LogicModelBinaryImporter.h"
 #include "Core/RuleCheck/RCVBlacklistImporter.h"
 #include "Core/LogicModel/LogicModelHelper.h"
 
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrent>
 #include <QMessageBox>
 
 #include <cerrno>
+#include <exception>
 #include <iostream>
 #include <memory>
+#include <mutex>
 
 #include <stdexcept>
 #include <list>
@@ -48,67 +55,272 @@ std::string ProjectImporter::get_project_filename(std::string const& dir)
 
 Project_shptr ProjectImporter::import_all(std::string const& directory)
 {
-    Project_shptr prj = import(directory);
+    /*
+      The project is loaded in phases. Independent phases run concurrently:
 
-    if (prj != nullptr)
+      gate library ----------------+
+                                   +--> logic model ----+
+      project file --> layers -----+                    +--> rc blacklist, template images
+                         +--> background images --------+
+
+      The gate library is needed to resolve the gate templates of the logic model.
+      Template images are grabbed from the background images, therefore this is done
+      when everything else is loaded.
+    */
+
+    phase_timings.clear();
+
+    QElapsedTimer total_timer;
+    total_timer.start();
+
+    const std::string gate_lib_file(get_basedir(directory) + "/gate_library.xml");
+    const std::string rcbl_file(get_basedir(directory) + "/rc_blacklist.xml");
+
+    // Gate library, in parallel to the project file.
+    GateLibrary_shptr gate_lib;
+    std::exception_ptr gate_lib_error;
+    qint64 gate_lib_time = 0;
+
+    QFuture<void> gate_lib_future = QtConcurrent::run([&]()
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        try
+        {
+            if (file_exists(gate_lib_file))
+            {
+                GateLibraryImporter gl_importer;
+                gate_lib = gl_importer.import(gate_lib_file);
+            }
+            else gate_lib = std::make_shared<GateLibrary>();
+        }
+        catch (...)
+        {
+            gate_lib_error = std::current_exception();
+        }
+
+        gate_lib_time = timer.elapsed();
+    });
+
+    // Project file, the background images of the layers are loaded later.
+    Project_shptr prj;
+
+    try
     {
-        GateLibraryImporter gl_importer;
+        QElapsedTimer timer;
+        timer.start();
 
-        GateLibrary_shptr gate_lib;
+        defer_background_images = true;
+        prj = import(directory);
+        defer_background_images = false;
 
-        std::string gate_lib_file(get_basedir(directory) + "/gate_library.xml");
-        std::string rcbl_file(get_basedir(directory) + "/rc_blacklist.xml");
+        add_phase_timing("project file", timer.elapsed());
+    }
+    catch (...)
+    {
+        defer_background_images = false;
+        pending_background_images.clear();
+        gate_lib_future.waitForFinished();
+        throw;
+    }
+
+    gate_lib_future.waitForFinished();
+    add_phase_timing("gate library", gate_lib_time);
+
+    if (prj == nullptr)
+        return nullptr;
 
-        if (file_exists(gate_lib_file))
-            gate_lib = gl_importer.import(gate_lib_file);
-        else gate_lib = std::make_shared<GateLibrary>();
+    if (gate_lib_error)
+    {
+        pending_background_images.clear();
+        std::rethrow_exception(gate_lib_error);
+    }
 
-        LogicModelImporter lm_importer(prj->get_width(), prj->get_height(), gate_lib);
+    // Logic model, in parallel to the background images.
+    LogicModel_shptr lmodel = prj->get_logic_model();
+    std::exception_ptr lmodel_error;
+    qint64 lmodel_time = 0;
+    bool journal_complete = true;
 
-        lm_importer.import_into(prj->get_logic_model(),
-                                get_basedir(directory) + "/lmodel.xml");
+    QFuture<void> lmodel_future = QtConcurrent::run([&]()
+    {
+        QElapsedTimer timer;
+        timer.start();
 
-        LogicModel_shptr lmodel = prj->get_logic_model();
-        lmodel->set_default_gate_port_diameter(prj->get_default_port_diameter());
+        try
+        {
+            import_logic_model(prj, gate_lib, get_basedir(directory));
+            lmodel->set_default_gate_port_diameter(prj->get_default_port_diameter());
 
-        if (file_exists(rcbl_file))
+            // changes saved after the project files were written
+            ProjectJournal journal(get_basedir(directory));
+            journal_complete = journal.replay(prj);
+        }
+        catch (...)
         {
-            RCVBlacklistImporter rcvbl_importer(lmodel);
-            rcvbl_importer.import_into(rcbl_file, prj->get_rcv_blacklist());
+            lmodel_error = std::current_exception();
         }
 
-        /*
+        lmodel_time = timer.elapsed();
+    });
+
+    try
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        load_background_images(prj);
+
+        add_phase_timing("background images", timer.elapsed());
+    }
+    catch (...)
+    {
+        lmodel_future.waitForFinished();
+        throw;
+    }
+
+    lmodel_future.waitForFinished();
+    add_phase_timing("logic model", lmodel_time);
+
+    if (lmodel_error)
+        std::rethrow_exception(lmodel_error);
+
+    // Some changes of the journal are lost, the project files must be rewritten.
+    if (!journal_complete)
+    {
+        prj->set_changed();
+        prj->set_full_save_required();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (file_exists(rcbl_file))
+    {
+        RCVBlacklistImporter rcvbl_importer(lmodel);
+        rcvbl_importer.import_into(rcbl_file, prj->get_rcv_blacklist());
+    }
+
+    add_phase_timing("rc blacklist", timer.restart());
+
+    /*
       For degate projects that were exported with degate 0.0.6 the gate templates
       were expressed in terms of an image region. This is bad. Here is a part of the fix:
       We have loaded the project with the background images and we have the gate
       library. We iterate over the gate library, extract the template image from the
       background image and put it into the gate library. We do it for the first
       transistor, the first logic and the first metal layer.
-        */
+    */
 
-        debug(TM, "Check if we have template images.");
-        for (auto& iter : *gate_lib)
-        {
-            debug(TM, "Will grab template image for gate template ID: %llu", iter.first);
-            GateTemplate_shptr tmpl = iter.second;
-            assert(tmpl != nullptr);
+    debug(TM, "Check if we have template images.");
+    for (auto& iter : *gate_lib)
+    {
+        debug(TM, "Will grab template image for gate template ID: %llu", iter.first);
+        GateTemplate_shptr tmpl = iter.second;
+        assert(tmpl != nullptr);
 
-            BoundingBox const& bbox = tmpl->get_bounding_box();
-            if (bbox.get_min_x() != 0 && bbox.get_min_y() != 0 &&
-                bbox.get_max_x() != 0 && bbox.get_max_y() != 0)
-            {
-                // a heuristic
-                debug(TM, "Grab template images from the background for template %s.", tmpl->get_name().c_str());
-                grab_template_images(lmodel, tmpl, bbox);
-            }
+        BoundingBox const& bbox = tmpl->get_bounding_box();
+        if (bbox.get_min_x() != 0 && bbox.get_min_y() != 0 &&
+            bbox.get_max_x() != 0 && bbox.get_max_y() != 0)
+        {
+            // a heuristic
+            debug(TM, "Grab template images from the background for template %s.", tmpl->get_name().c_str());
+            grab_template_images(lmodel, tmpl, bbox);
         }
-        debug(TM, "Project loaded.");
-        //prj->print_all(cout);
     }
 
+    add_phase_timing("template images", timer.elapsed());
+    add_phase_timing("total", total_timer.elapsed());
+
+    debug(TM, "Project loaded.");
+    for (auto const& timing : phase_timings)
+        debug(TM, "Loading phase %s: %lld ms.", timing.first.c_str(), static_cast<long long>(timing.second));
+    //prj->print_all(cout);
+
     return prj;
 }
 
+void ProjectImporter::load_background_images(Project_shptr const& prj)
+{
+    std::vector<std::pair<Layer_shptr, std::string>> images;
+    images.swap(pending_background_images);
+
+    // In attached mode, a missing image is asked to the user. This is only possible
+    // from the GUI thread, the images are loaded one after the other in that case.
+    const bool gui_thread = qApp != nullptr && qApp->thread() == QThread::currentThread();
+
+    if (prj->get_project_type() == ProjectType::Attached && gui_thread)
+    {
+        for (auto const& image : images)
+            load_background_image(image.first, image.second, prj);
+
+        return;
+    }
+
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    QtConcurrent::blockingMap(images, [&](std::pair<Layer_shptr, std::string> const& image)
+    {
+        try
+        {
+            load_background_image(image.first, image.second, prj);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    });
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ProjectImporter::add_phase_timing(std::string const& phase, qint64 milliseconds)
+{
+    phase_timings.emplace_back(phase, milliseconds);
+}
+
+ProjectImporter::phase_timings_t const& ProjectImporter::get_phase_timings() const
+{
+    return phase_timings;
+}
+
+void ProjectImporter::import_logic_model(Project_shptr const& prj,
+                                         GateLibrary_shptr const& gate_lib,
+                                         std::string const& directory)
+{
+    const std::string lmodel_file(directory + "/lmodel.xml");
+    const std::string lmodel_binary_file(directory + "/lmodel.bin");
+
+    // The binary file is a cache of the XML file, it is only used if it is up to date.
+    const QFileInfo xml_info(QString::fromStdString(lmodel_file));
+    const QFileInfo binary_info(QString::fromStdString(lmodel_binary_file));
+
+    if (binary_info.exists() && (!xml_info.exists() || binary_info.lastModified() >= xml_info.lastModified()))
+    {
+        try
+        {
+            LogicModelBinaryImporter lm_binary_importer(prj->get_width(), prj->get_height(), gate_lib);
+            lm_binary_importer.import_into(prj->get_logic_model(), lmodel_binary_file);
+
+            debug(TM, "Logic model loaded from %s.", lmodel_binary_file.c_str());
+            return;
+        }
+        catch (InvalidFileFormatException const& ex)
+        {
+            // The logic model was not modified, use the XML file instead.
+            debug(TM, "Can't use the binary logic model: %s", ex.what());
+        }
+    }
+
+    LogicModelImporter lm_importer(prj->get_width(), prj->get_height(), gate_lib);
+    lm_importer.import_into(prj->get_logic_model(), lmodel_file);
+}
+
 Project_shptr ProjectImporter::import(std::string const& directory)
 {
     string filename = get_project_filename(directory);
@@ -202,12 +414,27 @@ void ProjectImporter::parse_layers_element(QDomElement const& layers_elem, const
                 layer_enabled = parse_bool(layer_enabled_str);
             new_layer->set_enabled(layer_enabled);
 
+            // Compositing (optional, older projects don't have it).
+            const std::string layer_composited_str = layer_elem.attribute("composited").toStdString();
+            if (!layer_composited_str.empty())
+                new_layer->set_composited(parse_bool(layer_composited_str));
+
+            if (layer_elem.hasAttribute("composition-opacity"))
+                new_layer->set_composition_opacity(layer_elem.attribute("composition-opacity").toFloat());
+
+            const std::string layer_tint_str = layer_elem.attribute("composition-tint").toStdString();
+            if (!layer_tint_str.empty())
+                new_layer->set_composition_tint(parse_color_string(layer_tint_str));
+
             new_layer->set_description(layer_description);
             new_layer->set_layer_id(layer_id);
 
             lmodel->add_layer(position, new_layer);
 
-            load_background_image(new_layer, image_path, prj);
+            if (defer_background_images)
+                pending_background_images.emplace_back(new_layer, image_path);
+            else
+                load_background_image(new_layer, image_path, prj);
         }
     }
 }
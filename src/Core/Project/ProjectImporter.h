@@ -27,6 +27,9 @@
 #include "Core/XML/XMLImporter.h"
 
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace degate
 {
@@ -40,8 +43,25 @@ namespace degate
      */
     class ProjectImporter : public XMLImporter
     {
+    public:
+
+        /**
+         * Durations in milliseconds of the phases of the last import_all() call.
+         */
+        typedef std::vector<std::pair<std::string, qint64>> phase_timings_t;
+
     private:
 
+        /**
+         * If set, the background images of the layers are not loaded while the project
+         * file is parsed, but collected in pending_background_images.
+         */
+        bool defer_background_images = false;
+        std::vector<std::pair<Layer_shptr, std::string>> pending_background_images;
+
+        phase_timings_t phase_timings;
+
+
         void parse_project_element(const Project_shptr& parent_prj, QDomElement const& project_node);
         void parse_grids_element(QDomElement const& project_node, const Project_shptr& prj);
         void parse_layers_element(QDomElement const& layers_node, const Project_shptr& prj);
@@ -60,6 +80,23 @@ namespace degate
                                    std::string const& image_filename,
                                    const Project_shptr& prj);
 
+        /**
+         * Load the logic model of a project. The binary logic model (lmodel.bin) is
+         * used if it is at least as recent as lmodel.xml, otherwise or if it can't
+         * be used, lmodel.xml is loaded.
+         */
+        void import_logic_model(Project_shptr const& prj,
+                                GateLibrary_shptr const& gate_lib,
+                                std::string const& directory);
+
+        /**
+         * Load the pending background images. The images of the layers are loaded
+         * in parallel.
+         */
+        void load_background_images(Project_shptr const& prj);
+
+        void add_phase_timing(std::string const& phase, qint64 milliseconds);
+
     public:
         ProjectImporter()
         {
@@ -81,12 +118,18 @@ namespace degate
 
         /**
          * Import a complete degate project, including the default gate library and the logic model.
+         * Independent parts of the project are loaded concurrently.
          * @param path The parameter path specifies the project directory
          *             or the path to the project.xml file. It is determined automatically.
          * @exception std::runtime_error If there are parsing problems.
          * @return Returns a pointer to a project object.
          */
         Project_shptr import_all(std::string const& path);
+
+        /**
+         * Get the duration of each phase of the last import_all() call.
+         */
+        phase_timings_t const& get_phase_timings() const;
     };
 }
 
@@ -0,0 +1,170 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Core/Project/ProjectJournal.h"
+#include "Core/LogicModel/LogicModelSnapshot.h"
+#include "Core/LogicModel/LogicModelBinaryExporter.h"
+#include "Core/LogicModel/LogicModelBinaryImporter.h"
+#include "Core/Utils/FileSystem.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace degate;
+
+ProjectJournal::ProjectJournal(std::string const& project_directory, std::string const& journal_file)
+    : filename(join_pathes(project_directory, journal_file))
+{
+}
+
+QByteArray ProjectJournal::create_entry(Project_shptr const& prj)
+{
+    if (prj == nullptr || prj->get_logic_model() == nullptr)
+        throw InvalidPointerException("The project has no logic model.");
+
+    LogicModel_shptr lmodel = prj->get_logic_model();
+
+    if (lmodel->get_changes().empty())
+        return QByteArray();
+
+    LogicModelSnapshot snapshot(lmodel, lmodel->get_changes());
+    lmodel->clear_changes();
+
+    LogicModelBinaryExporter exporter(std::make_shared<ObjectIDRewriter>(false));
+    return exporter.serialize(snapshot);
+}
+
+void ProjectJournal::append(QByteArray const& entry)
+{
+    if (entry.isEmpty())
+        return;
+
+    QFile file(QString::fromStdString(filename));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        throw InvalidPathException("Can't open the project journal.");
+    }
+
+    // Entries are kept aligned to 8 bytes, so that they can be used in place at load.
+    static const char padding[8] = {0};
+    const uint64_t padded_size = (static_cast<uint64_t>(entry.size()) + 7) / 8 * 8;
+
+    bool ok = file.write(reinterpret_cast<const char*>(&padded_size), sizeof(padded_size)) == sizeof(padded_size);
+    ok = ok && file.write(entry) == entry.size();
+    ok = ok && file.write(padding, static_cast<qint64>(padded_size - entry.size())) ==
+        static_cast<qint64>(padded_size - entry.size());
+    ok = ok && file.flush();
+
+    if (!ok)
+    {
+        throw InvalidPathException("Can't write the project journal.");
+    }
+}
+
+bool ProjectJournal::replay(Project_shptr const& prj)
+{
+    if (prj == nullptr || prj->get_logic_model() == nullptr)
+        throw InvalidPointerException("The project has no logic model.");
+
+    if (!exists())
+        return true;
+
+    LogicModel_shptr lmodel = prj->get_logic_model();
+
+    QFile file(QString::fromStdString(filename));
+    if (!file.open(QIODevice::ReadWrite))
+    {
+        throw InvalidPathException("Can't open the project journal.");
+    }
+
+    // Read into 8 bytes words, the records of the entries are used in place.
+    const uint64_t file_size = static_cast<uint64_t>(file.size());
+    std::vector<uint64_t> data(file_size / 8);
+    if (file.read(reinterpret_cast<char*>(data.data()), static_cast<qint64>(data.size() * 8)) !=
+        static_cast<qint64>(data.size() * 8))
+    {
+        throw InvalidPathException("Can't read the project journal.");
+    }
+
+    LogicModelBinaryImporter importer(prj->get_width(), prj->get_height(), lmodel->get_gate_library());
+
+    bool complete = true;
+    uint64_t position = 0; // in words
+    unsigned int entries = 0;
+
+    while (position < data.size())
+    {
+        const uint64_t entry_size = data[position];
+
+        // incomplete entry
+        if (entry_size % 8 != 0 || entry_size / 8 > data.size() - position - 1)
+        {
+            debug(TM, "The project journal ends with an incomplete entry.");
+            break;
+        }
+
+        try
+        {
+            importer.import_changes(lmodel, reinterpret_cast<const char*>(&data[position + 1]), entry_size);
+        }
+        catch (InvalidFileFormatException const& ex)
+        {
+            debug(TM, "Malformed entry in the project journal: %s", ex.what());
+            complete = false;
+            break;
+        }
+
+        position += 1 + entry_size / 8;
+        entries++;
+    }
+
+    // Cut off what can't be used, so that new entries can be appended.
+    if (position * 8 != file_size)
+        file.resize(static_cast<qint64>(position * 8));
+
+    file.close();
+
+    debug(TM, "%u entries of the project journal applied.", entries);
+
+    // the journal is saved
+    lmodel->clear_changes();
+
+    return complete;
+}
+
+void ProjectJournal::clear()
+{
+    QFile::remove(QString::fromStdString(filename));
+}
+
+bool ProjectJournal::exists() const
+{
+    return QFileInfo::exists(QString::fromStdString(filename));
+}
+
+qint64 ProjectJournal::get_size() const
+{
+    return QFileInfo(QString::fromStdString(filename)).size();
+}
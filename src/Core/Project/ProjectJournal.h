@@ -0,0 +1,110 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __PROJECTJOURNAL_H__
+#define __PROJECTJOURNAL_H__
+
+#include "Globals.h"
+#include "Core/Project/Project.h"
+
+#include <QByteArray>
+
+#include <string>
+
+namespace degate
+{
+    /**
+     * The project journal is an append-only file next to the project files, that
+     * records the changes of the logic model since the project files were written.
+     *
+     * Saving the changes into the journal costs time in proportion to the size of
+     * the changes, not to the size of the logic model. Each entry holds the changed
+     * objects and nets in the binary logic model format (see LogicModelBinaryFormat.h),
+     * prefixed with its size. At load, the entries are applied in order on top of the
+     * logic model read from the project files.
+     *
+     * When the project files are written (ProjectExporter), the journal is compacted
+     * into them and removed.
+     *
+     * Object IDs are not rewritten in the journal, therefore the project files must
+     * be written without object ID rewriting while a journal is used.
+     */
+    class ProjectJournal
+    {
+    public:
+
+        /**
+         * Create a journal for a project directory.
+         * @param project_directory The project directory.
+         * @param journal_file The name of the journal file in the project directory.
+         */
+        explicit ProjectJournal(std::string const& project_directory,
+                                std::string const& journal_file = "lmodel.journal");
+
+        /**
+         * Take the changes of the logic model of a project as a journal entry and clear
+         * them in the logic model. This must be called from the thread that edits the project.
+         * @return Returns the entry, that is empty if there is no change.
+         * @exception InvalidPointerException This exception is thrown if the project has no logic model.
+         */
+        static QByteArray create_entry(Project_shptr const& prj);
+
+        /**
+         * Append an entry to the journal. This can be called from any thread.
+         * @exception InvalidPathException This exception is thrown if the journal can't be written.
+         */
+        void append(QByteArray const& entry);
+
+        /**
+         * Apply all entries of the journal to the logic model of a project.
+         *
+         * An incomplete last entry (e.g. the program was stopped while it was written)
+         * is ignored and cut off from the journal, as well as everything after an entry
+         * that is malformed.
+         * @return Returns false if a malformed entry was found, in that case the changes
+         *   recorded after it are lost.
+         * @exception InvalidPointerException This exception is thrown if the project has no logic model.
+         * @exception InvalidPathException This exception is thrown if the journal can't be read.
+         */
+        bool replay(Project_shptr const& prj);
+
+        /**
+         * Remove the journal.
+         */
+        void clear();
+
+        /**
+         * Check if there is a journal.
+         */
+        bool exists() const;
+
+        /**
+         * Get the size of the journal in bytes.
+         */
+        qint64 get_size() const;
+
+    private:
+
+        std::string filename;
+    };
+}
+
+#endif
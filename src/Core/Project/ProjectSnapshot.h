@@ -0,0 +1,61 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __PROJECTSNAPSHOT_H__
+#define __PROJECTSNAPSHOT_H__
+
+#include "Core/LogicModel/LogicModelSnapshot.h"
+#include "Core/LogicModel/Gate/GateLibraryExporter.h"
+
+#include <QByteArray>
+
+#include <memory>
+
+namespace degate
+{
+    /**
+     * An immutable copy of everything that is saved for a project.
+     *
+     * A snapshot is taken by ProjectExporter::create_snapshot() in the thread that edits
+     * the project. It does not reference any mutable object of the project, therefore it
+     * can be written by ProjectExporter::export_snapshot() in a background thread while
+     * the project is edited.
+     */
+    struct ProjectSnapshot
+    {
+        QByteArray project_document;
+        QByteArray rc_blacklist_document;
+
+        /**
+         * The logic model, nullptr if the project has none.
+         */
+        LogicModelSnapshot_shptr logic_model;
+
+        /**
+         * The gate library, nullptr if the project has none.
+         */
+        GateLibraryExporter::ExportData_shptr gate_library;
+    };
+
+    typedef std::shared_ptr<const ProjectSnapshot> ProjectSnapshot_shptr;
+}
+
+#endif
@@ -22,6 +22,8 @@
 #include "ERCNet.h"
 
 #include <memory>
+#include <set>
+#include <vector>
 
 using namespace degate;
 
@@ -36,21 +38,77 @@ void ERCNet::run(LogicModel_shptr lmodel)
 
     if (lmodel == nullptr) return;
 
-    // iterate over nets
+    std::vector<Net_shptr> nets;
+
     for (LogicModel::net_collection::iterator net_iter = lmodel->nets_begin();
          net_iter != lmodel->nets_end(); ++net_iter)
     {
-        check_net(lmodel, (*net_iter).second);
+        nets.push_back((*net_iter).second);
     }
+
+    // check nets in parallel
+    run_sharded(nets, [&](Net_shptr const& net, container_type& violations)
+    {
+        check_net(lmodel, net, violations);
+    });
 }
 
-void ERCNet::check_net(LogicModel_shptr lmodel, Net_shptr net)
+void ERCNet::update(LogicModel_shptr lmodel, LogicModel::ChangeSet const& changes)
+{
+    if (lmodel == nullptr)
+    {
+        clear_rc_violations();
+        return;
+    }
+
+    for (auto object_id : changes.removed_objects)
+        remove_object_violations(object_id);
+
+    std::set<object_id_t> dirty_nets = changes.changed_nets;
+
+    // A changed gate can have other ports or port directions.
+    for (auto object_id : changes.changed_objects)
+    {
+        if (!lmodel->exists_object(object_id))
+            continue;
+
+        if (Gate_shptr gate = std::dynamic_pointer_cast<Gate>(lmodel->get_object(object_id)))
+        {
+            for (Gate::port_const_iterator p_iter = gate->ports_begin();
+                 p_iter != gate->ports_end(); ++p_iter)
+            {
+                if (Net_shptr net = (*p_iter)->get_net())
+                    dirty_nets.insert(net->get_object_id());
+            }
+        }
+    }
+
+    std::vector<Net_shptr> nets;
+
+    for (auto net_id : dirty_nets)
+    {
+        if (lmodel->exists_net(net_id))
+            nets.push_back(lmodel->get_net(net_id));
+        else
+            remove_object_violations(net_id);
+    }
+
+    run_sharded(nets, [&](Net_shptr const& net, container_type& violations)
+    {
+        check_net(lmodel, net, violations);
+    });
+}
+
+void ERCNet::check_net(LogicModel_shptr lmodel, Net_shptr net, container_type& violations) const
 {
     unsigned int
         in_ports = 0,
         out_ports = 0,
         inout_ports = 0;
 
+    // gate ports of the net, looked up once
+    std::vector<GatePort_shptr> gate_ports;
+
     // iterate over all objects from a net
     for (Net::connection_iterator c_iter = net->begin();
          c_iter != net->end(); ++c_iter)
@@ -61,6 +119,8 @@ void ERCNet::check_net(LogicModel_shptr lmodel, Net_shptr net)
 
         if (GatePort_shptr gate_port = std::dynamic_pointer_cast<GatePort>(plo))
         {
+            gate_ports.push_back(gate_port);
+
             assert(gate_port->has_template_port() == true); // can't happen
 
             if (gate_port->has_template_port())
@@ -73,9 +133,9 @@ void ERCNet::check_net(LogicModel_shptr lmodel, Net_shptr net)
                 else if (tmpl_port->is_outport()) out_ports++;
                 else
                 {
-                    add_rc_violation(std::make_shared<RCViolation>(gate_port,
-                                                                   "net.undefined_port_direction",
-                                                                   get_severity()));
+                    violations.push_back(std::make_shared<RCViolation>(gate_port,
+                                                                       "net.undefined_port_direction",
+                                                                       get_severity()));
                 }
             }
         }
@@ -83,29 +143,23 @@ void ERCNet::check_net(LogicModel_shptr lmodel, Net_shptr net)
 
     if ((in_ports > 0 && out_ports == 0) || (out_ports > 1))
     {
-        for (auto c_iter = net->begin();
-             c_iter != net->end(); ++c_iter)
+        for (auto const& gate_port : gate_ports)
         {
-            object_id_t oid = *c_iter;
-            PlacedLogicModelObject_shptr plo = lmodel->get_object(oid);
-            if (GatePort_shptr gate_port = std::dynamic_pointer_cast<GatePort>(plo))
-            {
-                GateTemplatePort_shptr tmpl_port = gate_port->get_template_port();
+            GateTemplatePort_shptr tmpl_port = gate_port->get_template_port();
 
-                if (in_ports > 0 && out_ports == 0)
-                {
-                    add_rc_violation(std::make_shared<RCViolation>(gate_port,
+            if (in_ports > 0 && out_ports == 0)
+            {
+                violations.push_back(std::make_shared<RCViolation>(gate_port,
                                                                    "net.not_feeded",
                                                                    get_severity()));
-                }
-                else if (out_ports > 1)
+            }
+            else if (out_ports > 1)
+            {
+                if (tmpl_port->is_outport())
                 {
-                    if (tmpl_port->is_outport())
-                    {
-                        add_rc_violation(std::make_shared<RCViolation>(gate_port,
+                    violations.push_back(std::make_shared<RCViolation>(gate_port,
                                                                        "net.outputs_connected",
                                                                        get_severity()));
-                    }
                 }
             }
         }
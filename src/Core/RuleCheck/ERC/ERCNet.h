@@ -55,11 +55,16 @@ namespace degate
 
         void run(LogicModel_shptr lmodel);
 
+        /**
+         * Check again the changed nets and the nets of changed gates.
+         */
+        void update(LogicModel_shptr lmodel, LogicModel::ChangeSet const& changes) override;
+
         std::string generate_description(const RCViolation& violation) override;
 
     private:
 
-        void check_net(LogicModel_shptr lmodel, Net_shptr net);
+        void check_net(LogicModel_shptr lmodel, Net_shptr net, container_type& violations) const;
     };
 }
 
@@ -23,6 +23,8 @@
 #include "Core/RuleCheck/RCBase.h"
 
 #include <memory>
+#include <set>
+#include <vector>
 
 
 using namespace degate;
@@ -35,30 +37,160 @@ ERCOpenPorts::ERCOpenPorts()
 void ERCOpenPorts::run(LogicModel_shptr lmodel)
 {
     clear_rc_violations();
+    gates_of_net.clear();
+    nets_of_gate.clear();
 
     if (lmodel == nullptr) return;
 
     // iterate over Gates
     debug(TM, "\tRC: iterate over gates.");
 
+    std::vector<Gate_shptr> gates;
+
     for (LogicModel::gate_collection::iterator g_iter = lmodel->gates_begin();
          g_iter != lmodel->gates_end(); ++g_iter)
     {
-        Gate_shptr gate = g_iter->second;
+        gates.push_back(g_iter->second);
+    }
+
+    // check gates in parallel
+    run_sharded(gates, [&](Gate_shptr const& gate, container_type& violations)
+    {
+        check_gate(gate, violations);
+    });
+
+    for (auto const& gate : gates)
+        remember_nets(gate);
+}
+
+void ERCOpenPorts::update(LogicModel_shptr lmodel, LogicModel::ChangeSet const& changes)
+{
+    if (lmodel == nullptr)
+    {
+        run(lmodel);
+        return;
+    }
+
+    std::set<object_id_t> dirty_gates;
+
+    for (auto object_id : changes.changed_objects)
+        dirty_gates.insert(object_id);
+
+    // Gates that had ports on a changed or removed net.
+    auto add_gates_of_net = [&](object_id_t net_id)
+    {
+        auto found = gates_of_net.find(net_id);
+        if (found != gates_of_net.end())
+            dirty_gates.insert(found->second.begin(), found->second.end());
+    };
 
-        for (Gate::port_const_iterator p_iter = gate->ports_begin();
-             p_iter != gate->ports_end(); ++p_iter)
+    for (auto object_id : changes.removed_objects)
+    {
+        remove_object_violations(object_id);
+        add_gates_of_net(object_id);
+        forget_nets(object_id);
+    }
+
+    // Gates that have ports on a changed net now.
+    for (auto net_id : changes.changed_nets)
+    {
+        add_gates_of_net(net_id);
+
+        if (!lmodel->exists_net(net_id))
+            continue;
+
+        Net_shptr net = lmodel->get_net(net_id);
+        for (Net::connection_iterator c_iter = net->begin(); c_iter != net->end(); ++c_iter)
         {
-            GatePort_shptr port = *p_iter;
-            assert(port != nullptr);
+            if (!lmodel->exists_object(*c_iter))
+                continue;
 
-            Net_shptr net = port->get_net();
-            if (net == nullptr || net->size() <= 1)
+            if (GatePort_shptr port = std::dynamic_pointer_cast<GatePort>(lmodel->get_object(*c_iter)))
             {
-                add_rc_violation(std::make_shared<RCViolation>(port, "open_port", get_severity()));
+                if (Gate_shptr gate = port->get_gate())
+                    dirty_gates.insert(gate->get_object_id());
             }
         }
     }
+
+    std::vector<Gate_shptr> gates;
+
+    for (auto object_id : dirty_gates)
+    {
+        Gate_shptr gate = nullptr;
+        if (lmodel->exists_object(object_id))
+            gate = std::dynamic_pointer_cast<Gate>(lmodel->get_object(object_id));
+
+        if (gate != nullptr)
+            gates.push_back(gate);
+        else
+        {
+            // Not a gate (anymore).
+            remove_object_violations(object_id);
+            forget_nets(object_id);
+        }
+    }
+
+    run_sharded(gates, [&](Gate_shptr const& gate, container_type& violations)
+    {
+        check_gate(gate, violations);
+    });
+
+    for (auto const& gate : gates)
+        remember_nets(gate);
+}
+
+void ERCOpenPorts::check_gate(Gate_shptr gate, container_type& violations) const
+{
+    for (Gate::port_const_iterator p_iter = gate->ports_begin();
+         p_iter != gate->ports_end(); ++p_iter)
+    {
+        GatePort_shptr port = *p_iter;
+        assert(port != nullptr);
+
+        Net_shptr net = port->get_net();
+        if (net == nullptr || net->size() <= 1)
+        {
+            violations.push_back(std::make_shared<RCViolation>(port, "open_port", get_severity()));
+        }
+    }
+}
+
+void ERCOpenPorts::remember_nets(Gate_shptr gate)
+{
+    const object_id_t gate_id = gate->get_object_id();
+
+    forget_nets(gate_id);
+
+    for (Gate::port_const_iterator p_iter = gate->ports_begin();
+         p_iter != gate->ports_end(); ++p_iter)
+    {
+        if (Net_shptr net = (*p_iter)->get_net())
+        {
+            nets_of_gate[gate_id].insert(net->get_object_id());
+            gates_of_net[net->get_object_id()].insert(gate_id);
+        }
+    }
+}
+
+void ERCOpenPorts::forget_nets(object_id_t gate_id)
+{
+    auto found = nets_of_gate.find(gate_id);
+    if (found == nets_of_gate.end())
+        return;
+
+    for (auto net_id : found->second)
+    {
+        auto gates = gates_of_net.find(net_id);
+        if (gates == gates_of_net.end())
+            continue;
+
+        gates->second.erase(gate_id);
+        if (gates->second.empty())
+            gates_of_net.erase(gates);
+    }
+
+    nets_of_gate.erase(found);
 }
 
 std::string ERCOpenPorts::generate_description(const RCViolation& violation)
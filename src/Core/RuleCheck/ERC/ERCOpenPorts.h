@@ -25,6 +25,9 @@
 #include "Core/RuleCheck/RCBase.h"
 #include "Core/LogicModel/LogicModel.h"
 
+#include <map>
+#include <set>
+
 namespace degate
 {
     /**
@@ -41,7 +44,27 @@ namespace degate
 
         void run(LogicModel_shptr lmodel) override;
 
+        /**
+         * Check again the changed gates and the gates connected to changed nets.
+         */
+        void update(LogicModel_shptr lmodel, LogicModel::ChangeSet const& changes) override;
+
         std::string generate_description(const RCViolation& violation) override;
+
+    private:
+
+        void check_gate(Gate_shptr gate, container_type& violations) const;
+
+        /**
+         * Remember the nets of the gate ports, a port that leaves a net can only be
+         * found this way.
+         */
+        void remember_nets(Gate_shptr gate);
+
+        void forget_nets(object_id_t gate_id);
+
+        std::map<object_id_t, std::set<object_id_t>> gates_of_net;
+        std::map<object_id_t, std::set<object_id_t>> nets_of_gate;
     };
 }
 
@@ -24,9 +24,19 @@
 
 #include <memory>
 #include <list>
+#include <map>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <vector>
 #include "Core/LogicModel/LogicModel.h"
 #include "Core/RuleCheck/RCVContainer.h"
 
+#include <QtConcurrent/QtConcurrent>
+
+// Number of items (nets, gates, ...) checked by one task of a parallel rule check.
+#define RC_SHARD_SIZE 1024
+
 namespace degate
 {
     /**
@@ -58,6 +68,9 @@ namespace degate
 
         container_type rc_violations;
 
+        // Violations per checked object (net, gate, ...), see run_sharded().
+        std::map<object_id_t, container_type> object_violations;
+
     public:
 
         /**
@@ -84,6 +97,19 @@ namespace degate
          */
         virtual void run(LogicModel_shptr lmodel) = 0;
 
+        /**
+         * Update the violations after the logic model changed. Only the objects
+         * affected by the changes need to be checked again. The default implementation
+         * runs the whole check.
+         *
+         * @param lmodel : the logic model that was checked with run() before.
+         * @param changes : the changes since the last run() or update().
+         */
+        virtual void update(LogicModel_shptr lmodel, LogicModel::ChangeSet const& changes)
+        {
+            run(lmodel);
+        }
+
         /**
          * Generate the description for a violation regarding the tuple class + object.
          * A violation needs to be unique for that tuple.
@@ -99,7 +125,15 @@ namespace degate
          */
         container_type get_rc_violations() const
         {
-            return rc_violations;
+            container_type violations = rc_violations;
+
+            for (auto const& entry : object_violations)
+            {
+                for (auto const& violation : entry.second)
+                    violations.push_back(violation);
+            }
+
+            return violations;
         }
 
         RC_SEVERITY get_severity() const
@@ -123,6 +157,80 @@ namespace degate
         void clear_rc_violations()
         {
             rc_violations.clear();
+            object_violations.clear();
+        }
+
+        /**
+         * Forget the violations found for a checked object.
+         */
+        void remove_object_violations(object_id_t object_id)
+        {
+            object_violations.erase(object_id);
+        }
+
+        /**
+         * Check items in parallel and add the violations found.
+         *
+         * The violations are stored per item (by object ID) and replace the violations
+         * previously found for the same item, so the method can be used to check all
+         * items or only the items that changed. The items are split in shards of
+         * RC_SHARD_SIZE items that are checked on the thread pool. Violations are
+         * reported in object ID order, independent of the scheduling.
+         *
+         * @param items : the items to check (nets, gates, ...).
+         * @param check : called as check(item, violations) for each item, where violations
+         *                is the container of the item. It must not modify the logic model.
+         */
+        template <typename ItemType, typename CheckFunction>
+        void run_sharded(std::vector<ItemType> const& items, CheckFunction check)
+        {
+            std::vector<container_type> item_violations(items.size());
+
+            const std::size_t shard_count = (items.size() + RC_SHARD_SIZE - 1) / RC_SHARD_SIZE;
+
+            if (shard_count <= 1)
+            {
+                for (std::size_t i = 0; i < items.size(); i++)
+                    check(items[i], item_violations[i]);
+            }
+            else
+            {
+                std::vector<std::size_t> shards(shard_count);
+                std::iota(shards.begin(), shards.end(), 0);
+
+                std::mutex mutex;
+                std::exception_ptr error;
+
+                QtConcurrent::blockingMap(shards, [&](std::size_t const& shard)
+                {
+                    try
+                    {
+                        const std::size_t end = std::min(items.size(), (shard + 1) * RC_SHARD_SIZE);
+
+                        for (std::size_t i = shard * RC_SHARD_SIZE; i < end; i++)
+                            check(items[i], item_violations[i]);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error)
+                            error = std::current_exception();
+                    }
+                });
+
+                if (error)
+                    std::rethrow_exception(error);
+            }
+
+            for (std::size_t i = 0; i < items.size(); i++)
+            {
+                const object_id_t object_id = items[i]->get_object_id();
+
+                if (item_violations[i].size() > 0)
+                    object_violations[object_id] = item_violations[i];
+                else
+                    object_violations.erase(object_id);
+            }
         }
     };
 
@@ -33,36 +33,9 @@ using namespace degate;
 void RCVBlacklistExporter::export_data(std::string const& filename,
                                        RCBase::container_type const& violations)
 {
-    std::string directory = get_basedir(filename);
-
     try
     {
-        QDomDocument doc;
-
-        QDomProcessingInstruction head = doc.createProcessingInstruction("xml", XML_ENCODING);
-        doc.appendChild(head);
-
-        QDomElement root_elem = doc.createElement("rc-blacklist");
-        assert(!root_elem.isNull());
-
-        for (auto rcv : violations)
-        {
-            add_rcv(doc, root_elem, rcv);
-        }
-
-        doc.appendChild(root_elem);
-
-        QFile file(QString::fromStdString(filename));
-        if (!file.open(QIODevice::WriteOnly))
-        {
-            throw InvalidPathException("Can't create export file.");
-        }
-
-        QTextStream stream(&file);
-        stream.setEncoding(QStringConverter::Utf8);
-        stream << doc.toString();
-
-        file.close();
+        write_file(filename, serialize(violations));
     }
     catch (const std::exception& ex)
     {
@@ -71,6 +44,26 @@ void RCVBlacklistExporter::export_data(std::string const& filename,
     }
 }
 
+QByteArray RCVBlacklistExporter::serialize(RCBase::container_type const& violations)
+{
+    QDomDocument doc;
+
+    QDomProcessingInstruction head = doc.createProcessingInstruction("xml", XML_ENCODING);
+    doc.appendChild(head);
+
+    QDomElement root_elem = doc.createElement("rc-blacklist");
+    assert(!root_elem.isNull());
+
+    for (auto rcv : violations)
+    {
+        add_rcv(doc, root_elem, rcv);
+    }
+
+    doc.appendChild(root_elem);
+
+    return doc.toByteArray();
+}
+
 void RCVBlacklistExporter::add_rcv(QDomDocument& doc,
                                    QDomElement& root_elem,
                                    RCViolation_shptr rcv)
@@ -53,6 +53,11 @@ namespace degate
         }
 
         void export_data(std::string const& filename, RCBase::container_type const& violations);
+
+        /**
+         * Build the content of the blacklist file, without writing it.
+         */
+        QByteArray serialize(RCBase::container_type const& violations);
     };
 }
 
@@ -34,6 +34,25 @@ namespace degate
         std::list<RCBase_shptr> checks;
         RCVContainer rc_violations;
 
+        // Changes of the checked logic model since the last check, filled by the logic model.
+        std::shared_ptr<LogicModel::ChangeSet> changes;
+        std::weak_ptr<LogicModel> checked_lmodel;
+
+        void collect_rc_violations()
+        {
+            rc_violations.clear();
+
+            for (auto check : checks)
+            {
+                for (auto violation : check->get_rc_violations())
+                {
+                    rc_violations.push_back(violation);
+                }
+            }
+
+            debug(TM, "found %lu rc violations.", rc_violations.size());
+        }
+
     public:
 
         RuleChecker()
@@ -44,22 +63,63 @@ namespace degate
             }
         }
 
+        /**
+         * Run all checks on the whole logic model.
+         * Changes of the logic model are tracked from now on, see update().
+         */
         void run(LogicModel_shptr lmodel)
         {
             debug(TM, "run RC");
 
-            rc_violations.clear();
+            changes = std::make_shared<LogicModel::ChangeSet>();
+            checked_lmodel = lmodel;
+
+            if (lmodel != nullptr)
+                lmodel->add_change_listener(changes);
 
             for (auto check : checks)
             {
                 check->run(lmodel);
-                for (auto violation : check->get_rc_violations())
-                {
-                    rc_violations.push_back(violation);
-                }
             }
 
-            debug(TM, "found %lu rc violations.", rc_violations.size());
+            collect_rc_violations();
+        }
+
+        /**
+         * Check only the objects that changed since the last run() or update().
+         * If the logic model was not checked before, all checks are run.
+         */
+        void update(LogicModel_shptr lmodel)
+        {
+            if (lmodel == nullptr || changes == nullptr || checked_lmodel.lock() != lmodel)
+            {
+                run(lmodel);
+                return;
+            }
+
+            if (changes->empty())
+                return;
+
+            debug(TM, "update RC");
+
+            // Changes recorded during the update belong to the next one.
+            LogicModel::ChangeSet current_changes = *changes;
+            *changes = LogicModel::ChangeSet();
+
+            for (auto check : checks)
+            {
+                check->update(lmodel, current_changes);
+            }
+
+            collect_rc_violations();
+        }
+
+        /**
+         * Check if the checked logic model changed since the last run() or update().
+         */
+        bool has_changes() const
+        {
+            return changes != nullptr && !changes->empty();
         }
 
         /**
@@ -25,6 +25,9 @@
 #include "Globals.h"
 #include "Core/Image/Image.h"
 
+#include <QByteArray>
+#include <QSaveFile>
+
 #include <stdexcept>
 #include <sstream>
 
@@ -62,6 +65,27 @@ namespace degate
             return std::string(buf);
         }
 
+        /**
+         * Write data into a file. The data is written into a temporary file that replaces
+         * the file at the end, so that a crash while writing never leaves a partial file.
+         * @exception InvalidPathException This exception is thrown if the file can't be written.
+         */
+        static void write_file(std::string const& filename, QByteArray const& data)
+        {
+            QSaveFile file(QString::fromStdString(filename));
+            if (!file.open(QIODevice::WriteOnly))
+            {
+                throw InvalidPathException("Can't create export file.");
+            }
+
+            file.write(data);
+
+            if (!file.commit())
+            {
+                throw InvalidPathException("Can't write export file.");
+            }
+        }
+
     public:
 
         /**
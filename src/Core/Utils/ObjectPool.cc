@@ -0,0 +1,141 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Core/Utils/ObjectPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+using namespace degate;
+
+ObjectPool::ObjectPool(std::string const& name, std::size_t blocks_per_chunk)
+    : name(name),
+      blocks_per_chunk(blocks_per_chunk > 0 ? blocks_per_chunk : 1)
+{
+}
+
+ObjectPool::~ObjectPool()
+{
+    assert(live_objects == 0);
+
+    for (auto chunk : chunks)
+        ::operator delete(chunk);
+}
+
+void ObjectPool::add_chunk()
+{
+    chunks.push_back(static_cast<char*>(::operator new(block_size * blocks_per_chunk)));
+    next_block_in_chunk = 0;
+}
+
+void* ObjectPool::allocate(std::size_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // The first request defines the block size.
+    if (requested_size == 0)
+    {
+        const std::size_t alignment = alignof(std::max_align_t);
+
+        requested_size = size;
+        block_size = std::max(size, sizeof(FreeBlock));
+        block_size = (block_size + alignment - 1) / alignment * alignment;
+    }
+
+    if (size != requested_size)
+    {
+        fallback_allocations++;
+        return ::operator new(size);
+    }
+
+    void* block = nullptr;
+
+    if (free_list != nullptr)
+    {
+        block = free_list;
+        free_list = free_list->next;
+    }
+    else
+    {
+        if (chunks.empty() || next_block_in_chunk == blocks_per_chunk)
+            add_chunk();
+
+        block = chunks.back() + next_block_in_chunk * block_size;
+        next_block_in_chunk++;
+    }
+
+    live_objects++;
+    if (live_objects > peak_objects)
+        peak_objects = live_objects;
+
+    return block;
+}
+
+void ObjectPool::deallocate(void* ptr, std::size_t size)
+{
+    if (ptr == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (size != requested_size)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    auto block = static_cast<FreeBlock*>(ptr);
+    block->next = free_list;
+    free_list = block;
+
+    assert(live_objects > 0);
+    live_objects--;
+}
+
+bool ObjectPool::has_name() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return !name.empty();
+}
+
+void ObjectPool::set_name(std::string const& name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    this->name = name;
+}
+
+ObjectPoolStatistics ObjectPool::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    ObjectPoolStatistics statistics;
+    statistics.name = name;
+    statistics.block_size = block_size;
+    statistics.live_objects = live_objects;
+    statistics.peak_objects = peak_objects;
+    statistics.reserved_bytes = chunks.size() * blocks_per_chunk * block_size;
+    statistics.fallback_allocations = fallback_allocations;
+
+    return statistics;
+}
@@ -0,0 +1,243 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __OBJECTPOOL_H__
+#define __OBJECTPOOL_H__
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+namespace degate
+{
+    /**
+     * @struct ObjectPoolStatistics
+     * @brief Memory usage of an object pool.
+     */
+    struct ObjectPoolStatistics
+    {
+        std::string name;
+        std::size_t block_size = 0;
+        std::size_t live_objects = 0;
+        std::size_t peak_objects = 0;
+        std::size_t reserved_bytes = 0;
+        std::size_t fallback_allocations = 0;
+    };
+
+    /**
+     * @class ObjectPool
+     * @brief Fixed size block allocator.
+     *
+     * Memory is reserved in chunks of blocks_per_chunk blocks and released blocks are
+     * kept in a free list for reuse. Chunks are only returned to the system when the
+     * pool itself is destroyed, therefore objects allocated from the same pool stay
+     * close to each other in memory.
+     *
+     * The block size is fixed by the first allocation. Requests of another size
+     * (e.g. from a rebound allocator) are forwarded to the global operator new.
+     *
+     * This class is thread safe.
+     */
+    class ObjectPool
+    {
+    public:
+
+        /**
+         * Create a new pool.
+         *
+         * @param name : the name of the pool (used for statistics).
+         * @param blocks_per_chunk : the number of blocks reserved at once.
+         */
+        explicit ObjectPool(std::string const& name = "", std::size_t blocks_per_chunk = 1024);
+
+        /**
+         * Release all chunks. All blocks must have been returned before.
+         */
+        ~ObjectPool();
+
+        ObjectPool(ObjectPool const&) = delete;
+        ObjectPool& operator=(ObjectPool const&) = delete;
+
+        /**
+         * Get a block of memory of at least size bytes.
+         *
+         * @exception std::bad_alloc is thrown if the allocation failed.
+         */
+        void* allocate(std::size_t size);
+
+        /**
+         * Return a block of memory obtained with allocate().
+         *
+         * @param ptr : the block to release.
+         * @param size : the size that was passed to allocate().
+         */
+        void deallocate(void* ptr, std::size_t size);
+
+        /**
+         * Check if the pool has a name.
+         */
+        bool has_name() const;
+
+        /**
+         * Set the name of the pool.
+         */
+        void set_name(std::string const& name);
+
+        /**
+         * Get memory statistics.
+         */
+        ObjectPoolStatistics get_statistics() const;
+
+    private:
+
+        /**
+         * A free block is reused to store the free list link.
+         */
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        void add_chunk();
+
+        mutable std::mutex mutex;
+
+        std::string name;
+        std::size_t blocks_per_chunk;
+
+        std::size_t requested_size = 0;
+        std::size_t block_size = 0;
+
+        std::vector<char*> chunks;
+        std::size_t next_block_in_chunk = 0;
+        FreeBlock* free_list = nullptr;
+
+        std::size_t live_objects = 0;
+        std::size_t peak_objects = 0;
+        std::size_t fallback_allocations = 0;
+    };
+
+    typedef std::shared_ptr<ObjectPool> ObjectPool_shptr;
+
+    /**
+     * @class PoolAllocator
+     * @brief Standard allocator that gets its memory from an ObjectPool.
+     *
+     * The allocator keeps a shared pointer to the pool. Used with std::allocate_shared(),
+     * the allocator is stored in the control block of the shared pointer, therefore the
+     * pool lives as long as at least one of its objects is alive.
+     */
+    template <typename T>
+    class PoolAllocator
+    {
+        template <typename U>
+        friend class PoolAllocator;
+
+    public:
+        typedef T value_type;
+
+        explicit PoolAllocator(ObjectPool_shptr pool) : pool(std::move(pool))
+        {
+        }
+
+        template <typename U>
+        PoolAllocator(PoolAllocator<U> const& other) : pool(other.pool)
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(pool->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, std::size_t n)
+        {
+            pool->deallocate(ptr, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(PoolAllocator<U> const& other) const
+        {
+            return pool == other.pool;
+        }
+
+        template <typename U>
+        bool operator!=(PoolAllocator<U> const& other) const
+        {
+            return pool != other.pool;
+        }
+
+    private:
+        ObjectPool_shptr pool;
+    };
+
+    /**
+     * @class ObjectPoolSet
+     * @brief A set of object pools, one per object type.
+     *
+     * This class is thread safe.
+     */
+    class ObjectPoolSet
+    {
+    public:
+
+        /**
+         * Get the pool for objects of type T. The pool is created on first use.
+         */
+        template <typename T>
+        ObjectPool_shptr get_pool()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            ObjectPool_shptr& pool = pools[std::type_index(typeid(T))];
+            if (pool == nullptr)
+                pool = std::make_shared<ObjectPool>();
+
+            return pool;
+        }
+
+        /**
+         * Get memory statistics of all pools.
+         */
+        std::vector<ObjectPoolStatistics> get_statistics() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            std::vector<ObjectPoolStatistics> statistics;
+            for (auto const& entry : pools)
+                statistics.push_back(entry.second->get_statistics());
+
+            return statistics;
+        }
+
+    private:
+        mutable std::mutex mutex;
+        std::map<std::type_index, ObjectPool_shptr> pools;
+    };
+
+    typedef std::shared_ptr<ObjectPoolSet> ObjectPoolSet_shptr;
+}
+
+#endif
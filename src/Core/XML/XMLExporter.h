@@ -25,6 +25,7 @@
 #include "Globals.h"
 #include "Core/Utils/Exporter.h"
 #include <QtXml/QtXml>
+#include <QXmlStreamWriter>
 
 namespace degate
 {
@@ -33,6 +34,21 @@ namespace degate
      */
     class XMLExporter : public Exporter
     {
+    protected:
+
+        /**
+         * Convert a floating point number to an attribute value. The result
+         * is the same as the one of number_to_string() (six significant digits),
+         * without the overhead of a string stream.
+         *
+         * QString::number() always uses the C locale, the decimal separator is
+         * therefore a dot whatever the locale of the user is.
+         */
+        static QString float_to_string(double num)
+        {
+            return QString::number(num, 'g', 6);
+        }
+
     public:
 
         /**
@@ -40,6 +40,17 @@ QDomElement XMLImporter::get_dom_twig(QDomElement const start_node, std::string
     return start_node.elementsByTagName(QString::fromStdString(element_name)).at(0).toElement();
 }
 
+std::string XMLImporter::get_attribute(QXmlStreamAttributes const& attributes,
+                                       std::string const& attribute_str,
+                                       std::string const& default_value) const
+{
+    const QLatin1String attribute_name(attribute_str.c_str(), static_cast<int>(attribute_str.size()));
+
+    if (!attributes.hasAttribute(attribute_name))
+        return default_value;
+
+    return attributes.value(attribute_name).toString().toStdString();
+}
 
 color_t XMLImporter::parse_color_string(std::string const& color_string) const
 {
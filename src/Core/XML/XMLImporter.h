@@ -26,6 +26,7 @@
 #include "Core/Utils/Importer.h"
 
 #include <QtXml/QtXml>
+#include <QXmlStreamReader>
 
 namespace degate
 {
@@ -73,6 +74,44 @@ namespace degate
             else return parse_number<T>(attribute.toStdString());
         }
 
+        /**
+         * Parse an attribute of the current element of a XML stream and convert it to a number.
+         * @exception XMLAttributeMissingException The XML attribute is not present.
+         * @return Returns the number in type T.
+         */
+        template <typename T>
+        T parse_number(QXmlStreamAttributes const& attributes, std::string const& attribute_str) const
+        {
+            const QLatin1String attribute_name(attribute_str.c_str(), static_cast<int>(attribute_str.size()));
+
+            if (!attributes.hasAttribute(attribute_name))
+            {
+                throw XMLAttributeMissingException(std::string("attribute is not present: ") + attribute_str);
+            }
+            else return parse_number<T>(attributes.value(attribute_name).toString().toStdString());
+        }
+
+        /**
+         * Parse an attribute of the current element of a XML stream and convert it to a number.
+         * @return Returns the number in type T. If the XML attribute is not present, the default value is returned.
+         */
+        template <typename T>
+        T parse_number(QXmlStreamAttributes const& attributes, std::string const& attribute_str, T default_value) const
+        {
+            const QLatin1String attribute_name(attribute_str.c_str(), static_cast<int>(attribute_str.size()));
+
+            if (!attributes.hasAttribute(attribute_name)) return default_value;
+            else return parse_number<T>(attributes.value(attribute_name).toString().toStdString());
+        }
+
+        /**
+         * Get an attribute of the current element of a XML stream as string.
+         * @return Returns the attribute value or default_value if the attribute is not present.
+         */
+        std::string get_attribute(QXmlStreamAttributes const& attributes,
+                                  std::string const& attribute_str,
+                                  std::string const& default_value = "") const;
+
         QDomElement get_dom_twig(QDomElement const start_node, std::string const& element_name) const;
 
         /**
@@ -200,6 +200,9 @@ namespace degate
 
 		gate->set_fill_color(fill_color.get_color());
 		gate->set_frame_color(frame_color.get_color());
+
+		// Port directions might have changed.
+		project->get_logic_model()->set_gate_template_changed(gate);
 	}
 
 	void GateEditEntityTab::add_port()
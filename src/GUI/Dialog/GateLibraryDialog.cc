@@ -26,7 +26,7 @@
 namespace degate
 {
     GateLibraryDialog::GateLibraryDialog(QWidget* parent, const Project_shptr& project)
-            : QDialog(parent), project(project), list(parent, project, false)
+            : QDialog(parent), project(project), list(parent, project, false, true)
     {
         setWindowTitle(tr("Gate library"));
         resize(300, 400);
@@ -124,6 +124,14 @@ namespace degate
         QObject::connect(&refresh_button, SIGNAL(clicked()), this, SLOT(run_checks()));
         control_layout.addWidget(&refresh_button, 1, 0);
 
+        // Live checking
+        live_checking_box.setText(tr("Live checking"));
+        live_checking_box.setFocusPolicy(Qt::NoFocus);
+        live_checking_timer.setInterval(1000);
+        QObject::connect(&live_checking_box, SIGNAL(toggled(bool)), this, SLOT(set_live_checking(bool)));
+        QObject::connect(&live_checking_timer, SIGNAL(timeout()), this, SLOT(update_checks()));
+        control_layout.addWidget(&live_checking_box, 2, 1);
+
         // Violations action button
         violations_action_button.setText(tr("Accept selected violation(s)"));
         violations_action_button.setFocusPolicy(Qt::NoFocus);
@@ -182,10 +190,39 @@ namespace degate
     {
         assert(project != nullptr);
 
+        rule_checker.run(project->get_logic_model());
+
+        show_violations();
+    }
+
+    void RuleViolationsDialog::update_checks()
+    {
+        assert(project != nullptr);
+
+        if (!rule_checker.has_changes())
+            return;
+
+        rule_checker.update(project->get_logic_model());
+
+        show_violations();
+    }
+
+    void RuleViolationsDialog::set_live_checking(bool enable)
+    {
+        if (enable)
+        {
+            run_checks();
+            live_checking_timer.start();
+        }
+        else
+            live_checking_timer.stop();
+    }
+
+    void RuleViolationsDialog::show_violations()
+    {
         accepted_violations_tab.clear_violations();
         violations_tab.clear_violations();
 
-        rule_checker.run(project->get_logic_model());
         RCVContainer const& violations = rule_checker.get_rc_violations();
 
         for (auto& v : violations)
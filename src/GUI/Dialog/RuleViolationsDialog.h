@@ -36,6 +36,8 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QLineEdit>
+#include <QCheckBox>
+#include <QTimer>
 
 namespace degate
 {
@@ -130,6 +132,19 @@ namespace degate
          */
         void run_checks();
 
+        /**
+         * Check again the objects that changed since the last check.
+         * Called periodically if live checking is enabled.
+         */
+        void update_checks();
+
+        /**
+         * Enable or disable live checking.
+         *
+         * @param enable : if true, changes of the logic model are checked periodically.
+         */
+        void set_live_checking(bool enable);
+
         /**
          * Accept or reject selected violations regarding the currently active tab.
          */
@@ -163,6 +178,11 @@ namespace degate
         void goto_object(PlacedLogicModelObject_shptr& object);
 
     private:
+        /**
+         * Fill the tabs with the violations of the rule checker.
+         */
+        void show_violations();
+
         Project_shptr project = nullptr;
         QGridLayout layout;
         QTabWidget tabs;
@@ -180,6 +200,10 @@ namespace degate
         QPushButton violations_action_button;
         QPushButton refresh_button;
 
+        // Live checking
+        QCheckBox live_checking_box;
+        QTimer live_checking_timer;
+
         // Filter
         QLabel filter_label;
         QLineEdit filter_edit;
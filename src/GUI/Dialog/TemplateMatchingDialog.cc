@@ -120,6 +120,34 @@ namespace degate
         content_layout.addWidget(&template_matching_type_label, 5, 0);
         content_layout.addWidget(&template_matching_type_edit, 5, 1);
 
+        // Coarse-to-fine pyramid search
+        pyramid_search_label.setText(tr("Coarse-to-fine pyramid search:"));
+        pyramid_search_edit.setChecked(false);
+        content_layout.addWidget(&pyramid_search_label, 6, 0);
+        content_layout.addWidget(&pyramid_search_edit, 6, 1);
+
+        // Threshold to keep a candidate on a pyramid level
+        pyramid_threshold_label.setText(tr("Threshold to keep pyramid candidates:"));
+        pyramid_threshold_edit.set_minimum(0);
+        pyramid_threshold_edit.set_maximum(1);
+        pyramid_threshold_edit.set_single_step(0.01);
+        pyramid_threshold_edit.set_decimals(2);
+        pyramid_threshold_edit.set_value(0.30);
+        content_layout.addWidget(&pyramid_threshold_label, 7, 0);
+        content_layout.addWidget(&pyramid_threshold_edit, 7, 1);
+
+        // Candidates per region followed down the pyramid
+        pyramid_top_k_label.setText(tr("Pyramid candidates per region:"));
+        pyramid_top_k_edit.setMinimum(1);
+        pyramid_top_k_edit.setValue(2);
+        content_layout.addWidget(&pyramid_top_k_label, 8, 0);
+        content_layout.addWidget(&pyramid_top_k_edit, 8, 1);
+
+        QObject::connect(&pyramid_search_edit, &QCheckBox::toggled, &pyramid_threshold_edit, &QWidget::setEnabled);
+        QObject::connect(&pyramid_search_edit, &QCheckBox::toggled, &pyramid_top_k_edit, &QWidget::setEnabled);
+        pyramid_threshold_edit.setEnabled(false);
+        pyramid_top_k_edit.setEnabled(false);
+
         // Button
         run_button.setText("Run");
         QObject::connect(&run_button, SIGNAL(clicked()), this, SLOT(run()));
@@ -182,6 +210,9 @@ namespace degate
         matching->set_threshold_detection(threshold_edit.get_value());
         matching->set_max_step_size(max_step_edit.value());
         matching->set_scaling_factor(image_scale_factor_edit.currentText().toUInt());
+        matching->set_pyramid_search(pyramid_search_edit.isChecked());
+        matching->set_threshold_pyramid(pyramid_threshold_edit.get_value());
+        matching->set_pyramid_top_k(pyramid_top_k_edit.value());
         matching->set_templates(std::list<GateTemplate_shptr>(gate_templates.begin(), gate_templates.end()));
         matching->set_layers(project->get_logic_model()->get_current_layer(),
                              get_first_logic_layer(project->get_logic_model()));
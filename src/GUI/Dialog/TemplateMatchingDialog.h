@@ -31,6 +31,7 @@
 #include <QDialog>
 #include <QGridLayout>
 #include <QLabel>
+#include <QCheckBox>
 #include <QComboBox>
 #include <QPushButton>
 #include <QSpinBox>
@@ -99,6 +100,18 @@ namespace degate
         QLabel    template_matching_type_label;
         QComboBox template_matching_type_edit;
 
+        // Coarse-to-fine pyramid search
+        QLabel    pyramid_search_label;
+        QCheckBox pyramid_search_edit;
+
+        // Pyramid search pruning threshold
+        QLabel             pyramid_threshold_label;
+        DoubleSliderWidget pyramid_threshold_edit;
+
+        // Pyramid search candidates per region
+        QLabel   pyramid_top_k_label;
+        QSpinBox pyramid_top_k_edit;
+
         // Run button
         QHBoxLayout button_layout;
         QPushButton run_button;
@@ -24,8 +24,10 @@
 #include "GUI/Dialog/AboutDialog.h"
 #include "GUI/Dialog/ProgressDialog.h"
 #include "MainWindow.h"
+#include "Core/Project/ProjectJournal.h"
 
 #include <QScreen>
+#include <QtConcurrent/QtConcurrent>
 
 #ifdef SYS_WINDOWS
 #include <windows.h>
@@ -173,6 +175,11 @@ namespace degate
         show_wires_view_action->setChecked(true);
         QObject::connect(show_wires_view_action, SIGNAL(toggled(bool)), workspace, SLOT(show_wires(bool)));
 
+        composite_layers_view_action = view_menu->addAction("");
+        composite_layers_view_action->setCheckable(true);
+        composite_layers_view_action->setChecked(false);
+        QObject::connect(composite_layers_view_action, SIGNAL(toggled(bool)), workspace, SLOT(set_composite_layers(bool)));
+
         view_menu->addSeparator();
 
         grid_configuration_view_action = view_menu->addAction("");
@@ -440,11 +447,13 @@ namespace degate
         reload_texts();
 
         QObject::connect(workspace, SIGNAL(project_changed()), this, SLOT(project_changed()));
+        QObject::connect(workspace, SIGNAL(logic_model_changed()), this, SLOT(logic_model_changed()));
 
         auto_save_timer.setInterval(PREFERENCES_HANDLER.get_preferences().auto_save_interval * 60000);
         auto_save_timer.start();
 
         QObject::connect(&auto_save_timer, SIGNAL(timeout()), this, SLOT(auto_save()));
+        QObject::connect(&auto_save_watcher, SIGNAL(finished()), this, SLOT(on_auto_save_finished()));
 
         QThreadPool::globalInstance()->setMaxThreadCount(Configuration::get_max_concurrent_thread_count());
 
@@ -548,6 +557,7 @@ namespace degate
         show_vias_view_action->setText(tr("Show vias"));
         show_vias_name_view_action->setText(tr("Show vias name"));
         show_wires_view_action->setText(tr("Show wires"));
+        composite_layers_view_action->setText(tr("Composite layers"));
         grid_configuration_view_action->setText(tr("Grid configuration"));
         show_grid_view_action->setText(tr("Show grid"));
         snap_to_grid_view_action->setText(tr("Snap to grid"));
@@ -662,10 +672,16 @@ namespace degate
         if (project == nullptr)
             return;
 
+        wait_for_auto_save();
+
         status_bar.showMessage(tr("Saving project..."));
 
+        // Object IDs are kept, so that they match the IDs of later journal entries.
         ProjectExporter exporter;
-        exporter.export_all(project->get_project_directory(), project);
+        exporter.export_all(project->get_project_directory(), project, false);
+
+        project->get_logic_model()->clear_changes();
+        project->set_full_save_required(false);
 
         status_bar.showMessage(tr("Project saved."), SECOND(DEFAULT_STATUS_MESSAGE_DURATION));
 
@@ -675,6 +691,8 @@ namespace degate
 
     void MainWindow::on_menu_project_close()
     {
+        wait_for_auto_save();
+
         status_bar.showMessage(tr("Closing project..."));
 
         close_sub_windows();
@@ -977,7 +995,7 @@ namespace degate
             workspace->reset_area_selection();
             workspace->update_gates();
 
-            project_changed();
+            logic_model_changed();
         }
         else
         {
@@ -1012,6 +1030,8 @@ namespace degate
         dialog.exec();
 
         workspace->update_gates();
+
+        project_changed();
     }
 
     void MainWindow::on_menu_gate_list()
@@ -1072,9 +1092,13 @@ namespace degate
         AutoNameGates auto_name(project->get_logic_model(), orientation);
         auto_name.run();
 
+        LogicModel_shptr lmodel = project->get_logic_model();
+        for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter)
+            lmodel->set_object_changed(iter->second);
+
         workspace->update_gates();
 
-        project_changed();
+        logic_model_changed();
     }
 
     void MainWindow::on_menu_annotation_create()
@@ -1097,7 +1121,7 @@ namespace degate
             workspace->reset_area_selection();
             workspace->update_annotations();
 
-            project_changed();
+            logic_model_changed();
         }
         else
             new_annotation.reset();
@@ -1113,9 +1137,11 @@ namespace degate
             AnnotationEditDialog dialog(this, o);
             dialog.exec();
 
+            project->get_logic_model()->set_object_changed(o);
+
             workspace->update_annotations();
 
-            project_changed();
+            logic_model_changed();
         }
     }
 
@@ -1149,9 +1175,11 @@ namespace degate
             EMarkerEditDialog dialog(this, o);
             dialog.exec();
 
+            project->get_logic_model()->set_object_changed(o);
+
             workspace->update_emarkers();
 
-            project_changed();
+            logic_model_changed();
         }
     }
 
@@ -1165,9 +1193,11 @@ namespace degate
             ViaEditDialog dialog(this, o, project);
             dialog.exec();
 
+            project->get_logic_model()->set_object_changed(o);
+
             workspace->update_vias();
 
-            project_changed();
+            logic_model_changed();
         }
     }
 
@@ -1191,7 +1221,7 @@ namespace degate
         if (modules_dialog != nullptr)
             modules_dialog->reload();
 
-        project_changed();
+        logic_model_changed();
     }
 
     void MainWindow::on_menu_logic_interconnect_selected_objects()
@@ -1213,7 +1243,7 @@ namespace degate
 
         workspace->update_objects();
 
-        project_changed();
+        logic_model_changed();
     }
 
     void MainWindow::on_menu_logic_isolate_selected_objects()
@@ -1237,7 +1267,7 @@ namespace degate
 
         workspace->update_objects();
 
-        project_changed();
+        logic_model_changed();
     }
 
     void MainWindow::on_menu_logic_move_selected_gates_into_module()
@@ -1274,7 +1304,9 @@ namespace degate
             }
         }
 
-        project_changed();
+        project->get_logic_model()->set_modules_changed();
+
+        logic_model_changed();
     }
 
     void MainWindow::on_menu_logic_inspect_selected_object()
@@ -1348,7 +1380,7 @@ namespace degate
 
         workspace->update_vias();
 
-        project_changed();
+        logic_model_changed();
     }
 
     void MainWindow::on_menu_matching_wire_matching()
@@ -1368,7 +1400,7 @@ namespace degate
 
         workspace->update_wires();
 
-        project_changed();
+        logic_model_changed();
     }
 
     void MainWindow::on_menu_help_open_help()
@@ -1810,7 +1842,7 @@ namespace degate
 
             workspace->update_emarkers();
 
-            project_changed();
+            logic_model_changed();
         }
         else
             new_emarker.reset();
@@ -1836,7 +1868,7 @@ namespace degate
 
             workspace->update_vias();
 
-            project_changed();
+            logic_model_changed();
         }
         else
             new_via.reset();
@@ -1854,6 +1886,16 @@ namespace degate
     }
 
     void MainWindow::project_changed()
+    {
+        if (project == nullptr)
+            return;
+
+        project->set_full_save_required();
+
+        logic_model_changed();
+    }
+
+    void MainWindow::logic_model_changed()
     {
         if (project == nullptr)
             return;
@@ -1871,10 +1913,100 @@ namespace degate
         {
             auto_save_timer.setInterval(PREFERENCES_HANDLER.get_preferences().auto_save_interval * 60000);
 
-            on_menu_project_save();
+            // The previous auto save is still running, try again next time.
+            if (auto_save_watcher.isRunning())
+                return;
+
+            if (!project->is_changed())
+                return;
+
+            status_bar.showMessage(tr("Saving project..."));
+
+            std::string project_directory = project->get_project_directory();
+            ProjectJournal journal(project_directory);
+
+            // The data is taken here, the files are written in the background.
+            if (project->is_full_save_required() || journal.get_size() > MAX_PROJECT_JOURNAL_SIZE)
+            {
+                // Compact the journal into the project files.
+                ProjectExporter exporter;
+                ProjectSnapshot_shptr snapshot = exporter.create_snapshot(project, false);
+
+                project->get_logic_model()->clear_changes();
+                project->set_full_save_required(false);
+
+                auto_save_watcher.setFuture(QtConcurrent::run([snapshot, project_directory]()
+                {
+                    try
+                    {
+                        ProjectExporter exporter;
+                        exporter.export_snapshot(project_directory, *snapshot);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        return QString::fromStdString(e.what());
+                    }
+
+                    return QString();
+                }));
+            }
+            else
+            {
+                // Only the changes of the logic model are saved.
+                QByteArray entry = ProjectJournal::create_entry(project);
+
+                auto_save_watcher.setFuture(QtConcurrent::run([entry, project_directory]()
+                {
+                    try
+                    {
+                        ProjectJournal journal(project_directory);
+                        journal.append(entry);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        return QString::fromStdString(e.what());
+                    }
+
+                    return QString();
+                }));
+            }
+
+            project->set_changed(false);
+            update_window_title();
         }
     }
 
+    void MainWindow::on_auto_save_finished()
+    {
+        QString error = auto_save_watcher.result();
+
+        if (error.isEmpty())
+        {
+            status_bar.showMessage(tr("Project saved."), SECOND(DEFAULT_STATUS_MESSAGE_DURATION));
+            return;
+        }
+
+        status_bar.showMessage(tr("Auto save failed:") + " " + error, SECOND(DEFAULT_STATUS_MESSAGE_DURATION));
+
+        // The changes are not recorded anymore, all project files must be written.
+        if (project != nullptr)
+        {
+            project->set_changed();
+            project->set_full_save_required();
+            update_window_title();
+        }
+    }
+
+    void MainWindow::wait_for_auto_save()
+    {
+        if (!auto_save_watcher.isRunning())
+            return;
+
+        status_bar.showMessage(tr("Waiting for the auto save..."));
+
+        auto_save_watcher.waitForFinished();
+    }
+
     void MainWindow::goto_object(PlacedLogicModelObject_shptr& object)
     {
         if (object == nullptr || project == nullptr)
@@ -1974,6 +2106,8 @@ namespace degate
         // Since the dialog is modeless and not linked to this window, we have to force close.
         close_sub_windows();
 
+        wait_for_auto_save();
+
         QMainWindow::closeEvent(event);
     }
 
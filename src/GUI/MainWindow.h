@@ -53,6 +53,7 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QToolBar>
+#include <QFutureWatcher>
 
 /**
  * This define the default status message duration for the status bar.
@@ -61,6 +62,14 @@
  */
 #define DEFAULT_STATUS_MESSAGE_DURATION 30
 
+/**
+ * If the project journal grows beyond this size (in bytes), the next auto save
+ * compacts it into the project files.
+ *
+ * @see ProjectJournal
+ */
+#define MAX_PROJECT_JOURNAL_SIZE (16 * 1024 * 1024)
+
 namespace degate
 {
 
@@ -396,14 +405,27 @@ namespace degate
 
         /**
          * Call this when the project change (saved version != current version).
+         * All project files will be written on the next save.
          */
         void project_changed();
 
+        /**
+         * Call this when only the logic model changed and the changes are recorded by
+         * the logic model (see LogicModel::get_changes()). The next auto save can
+         * append them to the project journal.
+         */
+        void logic_model_changed();
+
         /**
          * Called when it's time to auto save (linked to the auto_save_timer).
          */
         void auto_save();
 
+        /**
+         * Called when a background auto save finished (linked to the auto_save_watcher).
+         */
+        void on_auto_save_finished();
+
         /**
          * Center view on a specific object.
          *
@@ -440,6 +462,12 @@ namespace degate
          */
         void reload_recent_projects_list();
 
+        /**
+         * Block until the running background auto save (if any) finished.
+         * Call this before writing or closing the project.
+         */
+        void wait_for_auto_save();
+
     private:
         QMenuBar menu_bar;
         QToolBar* tool_bar = nullptr;
@@ -485,6 +513,7 @@ namespace degate
         QAction* show_vias_view_action;
         QAction* show_vias_name_view_action;
         QAction* show_wires_view_action;
+        QAction* composite_layers_view_action;
         QAction* grid_configuration_view_action;
         QAction* show_grid_view_action;
         QAction* snap_to_grid_view_action;
@@ -558,6 +587,9 @@ namespace degate
         // QTimer for auto save
         QTimer auto_save_timer;
 
+        // Background auto save, the result is an error message (empty on success)
+        QFutureWatcher<QString> auto_save_watcher;
+
         /* Dialogs */
         RuleViolationsDialog* rcv_dialog = nullptr;
         ModulesDialog* modules_dialog = nullptr;
@@ -86,9 +86,19 @@ namespace degate
         // Image importer cache size
         preferences.image_importer_cache_size = settings.value("image_importer_cache_size", 256).toUInt();
 
+        // Template image cache size
+        preferences.template_image_cache_size = settings.value("template_image_cache_size", 64).toUInt();
+
+        // Tile texture cache size (GPU memory)
+        preferences.tile_texture_cache_size = settings.value("tile_texture_cache_size", 256).toUInt();
+
         // Max concurrent thread count
         preferences.max_concurrent_thread_count = settings.value("max_concurrent_thread_count", 0).toUInt();
 
+        // Level of detail (workspace pixels per screen pixel)
+        preferences.overlay_lod_scale = settings.value("overlay_lod_scale", 16.0).toFloat();
+        preferences.text_lod_scale = settings.value("text_lod_scale", 4.0).toFloat();
+
 
         load_recent_projects();
     }
@@ -136,7 +146,11 @@ namespace degate
 
         settings.setValue("cache_size", preferences.cache_size);
         settings.setValue("image_importer_cache_size", preferences.image_importer_cache_size);
+        settings.setValue("template_image_cache_size", preferences.template_image_cache_size);
+        settings.setValue("tile_texture_cache_size", preferences.tile_texture_cache_size);
         settings.setValue("max_concurrent_thread_count", preferences.max_concurrent_thread_count);
+        settings.setValue("overlay_lod_scale", preferences.overlay_lod_scale);
+        settings.setValue("text_lod_scale", preferences.text_lod_scale);
     }
 
     void PreferencesHandler::update(const Preferences& updated_preferences)
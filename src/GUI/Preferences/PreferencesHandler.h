@@ -74,7 +74,11 @@ namespace degate
 
         unsigned int cache_size;
         unsigned int image_importer_cache_size;
+        unsigned int template_image_cache_size;
+        unsigned int tile_texture_cache_size;
         unsigned int max_concurrent_thread_count;
+        float        overlay_lod_scale;
+        float        text_lod_scale;
 
     };
 
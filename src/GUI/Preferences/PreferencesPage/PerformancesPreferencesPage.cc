@@ -20,6 +20,7 @@
 */
 
 #include "PerformancesPreferencesPage.h"
+#include "Core/LogicModel/Gate/GateTemplateImageCache.h"
 
 #include "Globals.h"
 
@@ -61,6 +62,33 @@ namespace degate
         image_importer_cache_size_edit.setMinimum(MINIMUM_CACHE_SIZE);
         image_importer_cache_size_edit.setMaximum(std::numeric_limits<int>::max());
         image_importer_cache_size_edit.setValue(PREFERENCES_HANDLER.get_preferences().image_importer_cache_size);
+
+        // Template image cache size spinbox
+        PreferencesPage::add_widget(cache_layout, tr("Gate template image cache size (in Mb):"), &template_image_cache_size_edit);
+        template_image_cache_size_edit.setMinimum(1);
+        template_image_cache_size_edit.setMaximum(std::numeric_limits<int>::max());
+        template_image_cache_size_edit.setValue(PREFERENCES_HANDLER.get_preferences().template_image_cache_size);
+
+        // Tile texture cache size spinbox
+        PreferencesPage::add_widget(cache_layout, tr("Background tile texture cache size (GPU, in Mb):"), &tile_texture_cache_size_edit);
+        tile_texture_cache_size_edit.setMinimum(16);
+        tile_texture_cache_size_edit.setMaximum(std::numeric_limits<int>::max());
+        tile_texture_cache_size_edit.setValue(PREFERENCES_HANDLER.get_preferences().tile_texture_cache_size);
+
+        // Level of detail category
+        auto lod_layout = PreferencesPage::add_category(tr("Level of detail"));
+
+        // Overlay simplification scale
+        PreferencesPage::add_widget(lod_layout, tr("Simplify wires, vias and gates above this zoom out factor:"), &overlay_lod_scale_edit);
+        overlay_lod_scale_edit.setMinimum(1);
+        overlay_lod_scale_edit.setMaximum(1024);
+        overlay_lod_scale_edit.setValue(PREFERENCES_HANDLER.get_preferences().overlay_lod_scale);
+
+        // Text scale
+        PreferencesPage::add_widget(lod_layout, tr("Hide names above this zoom out factor:"), &text_lod_scale_edit);
+        text_lod_scale_edit.setMinimum(1);
+        text_lod_scale_edit.setMaximum(1024);
+        text_lod_scale_edit.setValue(PREFERENCES_HANDLER.get_preferences().text_lod_scale);
     }
 
     void PerformancesPreferencesPage::apply(Preferences& preferences)
@@ -73,6 +101,13 @@ namespace degate
 
         preferences.cache_size = static_cast<unsigned int>(cache_size_edit.value());
         preferences.image_importer_cache_size = static_cast<unsigned int>(image_importer_cache_size_edit.value());
+        preferences.template_image_cache_size = static_cast<unsigned int>(template_image_cache_size_edit.value());
+        preferences.tile_texture_cache_size = static_cast<unsigned int>(tile_texture_cache_size_edit.value());
         preferences.max_concurrent_thread_count = static_cast<unsigned int>(max_concurrent_thread_count_edit.value());
+        preferences.overlay_lod_scale = static_cast<float>(overlay_lod_scale_edit.value());
+        preferences.text_lod_scale = static_cast<float>(text_lod_scale_edit.value());
+
+        // Applied right away.
+        GateTemplateImageCache::get_instance().set_max_size(static_cast<std::size_t>(preferences.template_image_cache_size) * 1024 * 1024);
     }
 }
@@ -26,6 +26,7 @@
 #include "GUI/Preferences/PreferencesPage/PreferencesPage.h"
 
 #include <QSpinBox>
+#include <QDoubleSpinBox>
 
 namespace degate
 {
@@ -59,7 +60,11 @@ namespace degate
         QLabel introduction_label;
         QSpinBox cache_size_edit;
         QSpinBox image_importer_cache_size_edit;
+        QSpinBox template_image_cache_size_edit;
+        QSpinBox tile_texture_cache_size_edit;
         QSpinBox max_concurrent_thread_count_edit;
+        QDoubleSpinBox overlay_lod_scale_edit;
+        QDoubleSpinBox text_lod_scale_edit;
 
     };
 }
@@ -18,14 +18,79 @@
 
 #include "DistanceFieldGenerator.h"
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <vector>
 #include <QtConcurrent/QtConcurrent>
 #include <boost/range/counting_range.hpp>
 
-#define SQUARE_DISTANCE(x1, y1, x2, y2) ((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2))
+// Distance of a pixel that has no edge in the image (squared).
+#define DISTANCE_INFINITY 1e20f
 
 namespace degate
 {
+    namespace
+    {
+        /**
+         * Call a function for each line in [0, count), on the Qt thread pool or not.
+         */
+        void for_each_line(unsigned int count, bool parallel, const std::function<void(const unsigned int&)>& function)
+        {
+            if (!parallel)
+            {
+                for (unsigned int i = 0; i < count; i++)
+                    function(i);
+
+                return;
+            }
+
+            const auto& it = boost::counting_range<unsigned int>(0, count);
+            QtConcurrent::blockingMap(it, function);
+        }
+
+        /**
+         * One dimensional squared euclidean distance transform, in linear time
+         * (Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions").
+         *
+         * @param f : the input function (0 for a feature, DISTANCE_INFINITY otherwise), n values.
+         * @param d : the output (squared distance to the nearest feature), n values.
+         * @param v : temporary buffer, n values.
+         * @param z : temporary buffer, n + 1 values.
+         */
+        void distance_transform(const float* f, float* d, int n, int* v, float* z)
+        {
+            int k = 0;
+            v[0] = 0;
+            z[0] = -DISTANCE_INFINITY;
+            z[1] = DISTANCE_INFINITY;
+
+            // Lower envelope of the parabolas rooted at each sample.
+            for (int q = 1; q < n; q++)
+            {
+                float s = ((f[q] + static_cast<float>(q * q)) - (f[v[k]] + static_cast<float>(v[k] * v[k]))) / static_cast<float>(2 * q - 2 * v[k]);
+                while (s <= z[k])
+                {
+                    k--;
+                    s = ((f[q] + static_cast<float>(q * q)) - (f[v[k]] + static_cast<float>(v[k] * v[k]))) / static_cast<float>(2 * q - 2 * v[k]);
+                }
+
+                k++;
+                v[k] = q;
+                z[k] = s;
+                z[k + 1] = DISTANCE_INFINITY;
+            }
+
+            k = 0;
+            for (int q = 0; q < n; q++)
+            {
+                while (z[k + 1] < static_cast<float>(q))
+                    k++;
+
+                d[q] = static_cast<float>((q - v[k]) * (q - v[k])) + f[v[k]];
+            }
+        }
+    }
 
     DistanceFieldGenerator::DistanceFieldGenerator(float spread, unsigned int scale_factor, unsigned int color)
             : color(color), spread(spread), scale_factor(scale_factor)
@@ -33,7 +98,7 @@ namespace degate
 
     }
 
-    std::shared_ptr<QImage> DistanceFieldGenerator::generate_distance_field(const QImage& input_image) const
+    std::shared_ptr<QImage> DistanceFieldGenerator::generate_distance_field(const QImage& input_image, bool parallel) const
     {
         int input_width = input_image.width();
         int input_height = input_image.height();
@@ -41,63 +106,76 @@ namespace degate
         int                     output_height = input_height / static_cast<int>(scale_factor);
         std::shared_ptr<QImage> out_image     = std::make_shared<QImage>(output_width, output_height, QImage::Format_ARGB32);
 
-        // Create the input matrix.
-        bool** input = new bool*[input_width];
-        for (unsigned int i = 0; i < static_cast<unsigned int>(input_width); i++)
-            input[i] = new bool[input_height];
+        if (output_width <= 0 || output_height <= 0)
+            return out_image;
+
+        // Create the input matrix (row major), to know if a pixel is considered inside or outside.
+        std::vector<unsigned char> input(static_cast<std::size_t>(input_width) * input_height);
 
-        // Fill the bool matrix to know if a pixel is considered inside or outside.
-        std::function<void(const unsigned int& y)> input_function = [&input_image, &input, &input_width](const unsigned int& y)
+        // Squared distance to the nearest inside (resp. outside) pixel, after the column pass.
+        std::vector<float> to_inside(input.size());
+        std::vector<float> to_outside(input.size());
+
+        std::function<void(const unsigned int& y)> input_function = [&input_image, &input, &to_inside, &to_outside, &input_width](const unsigned int& y)
         {
             auto pixels = (QRgb*)(input_image.scanLine(y));
             for (unsigned int x = 0; x < static_cast<unsigned int>(input_width); x++)
             {
-                input[x][y] = (pixels[x] & 0x808080) != 0 && (pixels[x] & 0x80000000) != 0;
+                const std::size_t index = static_cast<std::size_t>(y) * input_width + x;
+
+                input[index] = (pixels[x] & 0x808080) != 0 && (pixels[x] & 0x80000000) != 0;
+                to_inside[index] = input[index] ? 0 : DISTANCE_INFINITY;
+                to_outside[index] = input[index] ? DISTANCE_INFINITY : 0;
             }
         };
 
-        // Multi threaded process
-        const auto& input_it = boost::counting_range<unsigned int>(0, input_height);
-        QtConcurrent::blockingMap(input_it, input_function);
+        for_each_line(input_height, parallel, input_function);
 
-        // Create the output.
-        std::function<void(const unsigned int& y)> output_function = [this, &output_width, &out_image, &input, &input_width, &input_height](const unsigned int& y)
+        // Column pass (all columns).
+        std::function<void(const unsigned int& x)> column_function = [&to_inside, &to_outside, &input_width, &input_height](const unsigned int& x)
         {
+            std::vector<float> f(input_height), d(input_height), z(input_height + 1);
+            std::vector<int> v(input_height);
+
+            for (auto field : {&to_inside, &to_outside})
+            {
+                for (int y = 0; y < input_height; y++)
+                    f[y] = (*field)[static_cast<std::size_t>(y) * input_width + x];
+
+                distance_transform(f.data(), d.data(), input_height, v.data(), z.data());
+
+                for (int y = 0; y < input_height; y++)
+                    (*field)[static_cast<std::size_t>(y) * input_width + x] = d[y];
+            }
+        };
+
+        for_each_line(input_width, parallel, column_function);
+
+        // Row pass, only for rows of sampled pixels, and output.
+        std::function<void(const unsigned int& y)> output_function = [this, &output_width, &out_image, &input, &to_inside, &to_outside, &input_width](const unsigned int& y)
+        {
+            const int center_y = (y * scale_factor) + (scale_factor / 2);
+            const std::size_t row = static_cast<std::size_t>(center_y) * input_width;
+
+            std::vector<float> inside_distances(input_width), outside_distances(input_width), z(input_width + 1);
+            std::vector<int> v(input_width);
+
+            distance_transform(&to_inside[row], inside_distances.data(), input_width, v.data(), z.data());
+            distance_transform(&to_outside[row], outside_distances.data(), input_width, v.data(), z.data());
+
             auto pixels = reinterpret_cast<QRgb*>(out_image->scanLine(y));
             for (unsigned int x = 0; x < static_cast<unsigned int>(output_width); x++)
             {
                 int center_x = (x * scale_factor) + (scale_factor / 2);
-                int center_y = (y * scale_factor) + (scale_factor / 2);
 
 
-                // Signed distance.
+                // Signed distance (to the nearest pixel of the other kind).
 
-                bool base = input[center_x][center_y];
+                bool base = input[row + center_x] != 0;
 
-                int delta = std::ceil(spread);
-                int start_x = std::max<int>(0, center_x - delta);
-                int end_x  = std::min<int>(input_width - 1, center_x + delta);
-                int start_y = std::max<int>(0, center_y - delta);
-                int end_y = std::min<int>(input_height - 1, center_y + delta);
+                float square_distance = base ? outside_distances[center_x] : inside_distances[center_x];
 
-                int closest_square_distance = delta * delta;
-
-                for (int x = start_x; x <= end_x; ++x)
-                {
-                    for (int y = start_y; y <= end_y; ++y)
-                    {
-                        if (base != input[x][y])
-                        {
-                            int distance = SQUARE_DISTANCE(center_x, center_y, x, y);
-                            if (distance < closest_square_distance)
-                            {
-                                closest_square_distance = distance;
-                            }
-                        }
-                    }
-                }
-
-                float signed_distance = (base ? 1 : -1) * std::min<float>(std::sqrt(closest_square_distance), spread);
+                float signed_distance = (base ? 1 : -1) * std::min<float>(std::sqrt(square_distance), spread);
 
 
                 // Distance to RGB.
@@ -111,15 +189,8 @@ namespace degate
             }
         };
 
-        // Multi threaded process
-        const auto& output_it = boost::counting_range<unsigned int>(0, output_height);
-        QtConcurrent::blockingMap(output_it, output_function);
-
-        // Delete the input matrix.
-        for (unsigned int i = 0; i < static_cast<unsigned int>(input_width); i++)
-            delete[] input[i];
-        delete[] input;
+        for_each_line(output_height, parallel, output_function);
 
         return out_image;
     }
-}
\ No newline at end of file
+}
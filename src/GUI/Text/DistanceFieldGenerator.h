@@ -28,6 +28,14 @@
 
 namespace degate
 {
+    /**
+     * @class DistanceFieldGenerator
+     * @brief Generate signed distance field images.
+     *
+     * The distance of each pixel to the nearest edge is computed with an exact euclidean
+     * distance transform in linear time (two separable passes, @see Felzenszwalb and
+     * Huttenlocher, "Distance Transforms of Sampled Functions"), then clamped to the spread.
+     */
     class DistanceFieldGenerator
     {
     public:
@@ -44,10 +52,11 @@ namespace degate
          * Generate an image with signed distance field from an input image.
          *
          * @param input_image : The input image.
+         * @param parallel : If true, lines are processed on the Qt thread pool (set it to false when already called from the pool).
          *
          * @return Returns the signed distance field image from the input image (with a scale_factor downscale).
          */
-        std::shared_ptr<QImage> generate_distance_field(const QImage& input_image) const;
+        std::shared_ptr<QImage> generate_distance_field(const QImage& input_image, bool parallel = true) const;
 
     private:
         unsigned int color = qRgba(255, 255, 255, 255);
@@ -25,24 +25,20 @@
 #include "Core/Utils/DegateExceptions.h"
 #include "Globals.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <tuple>
 #include <QtConcurrent/QtConcurrent>
 #include <QOpenGLFunctions>
+#include <QOpenGLExtraFunctions>
 
 namespace degate
 {
     std::map<QOpenGLContext*, std::shared_ptr<FontContext>> Text::contexts;
     std::vector<std::shared_ptr<FontData>> Text::fonts;
 
-    struct TextVertex2D
-    {
-        QVector2D pos;
-        QVector2D tex_uv;
-        QVector3D color;
-        float alpha;
-        float texture_index;
-    };
-
     FontContext::FontContext(QOpenGLContext* context)
     {
         this->context = context;
@@ -50,19 +46,25 @@ namespace degate
         QOpenGLShader* vshader = new QOpenGLShader(QOpenGLShader::Vertex);
         const char* vsrc =
                 "#version 330 core\n"
+                "in vec2 corner;\n"
                 "in vec2 pos;\n"
+                "in vec2 size;\n"
                 "in vec2 uv;\n"
+                "in vec2 uv_size;\n"
                 "in vec3 color;\n"
                 "in float alpha;\n"
                 "in float texture_index;\n"
                 "uniform mat4 mvp;\n"
+                "uniform float min_height;\n"
                 "out vec2 TexCoords;\n"
                 "out vec4 out_color;\n"
                 "flat out int texture_layer;\n"
                 "void main()\n"
                 "{\n"
-                "    gl_Position = mvp * vec4(pos, 0.0, 1.0);\n"
-                "    TexCoords = uv;\n"
+                "    gl_Position = mvp * vec4(pos + corner * size, 0.0, 1.0);\n"
+                "    if (size.y < min_height)\n"              // Too small to be read: outside of the clip volume
+                "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+                "    TexCoords = uv + corner * uv_size;\n"
                 "	 out_color = vec4(color, alpha);\n"
                 "    texture_layer = int(texture_index);\n"
                 "}\n";
@@ -93,6 +95,14 @@ namespace degate
 
         delete vshader;
         delete fshader;
+
+        // The quad shared by all glyph instances (triangle strip).
+        const QVector2D corners[] = {QVector2D(0, 0), QVector2D(1, 0), QVector2D(0, 1), QVector2D(1, 1)};
+
+        context->functions()->glGenBuffers(1, &quad_vbo);
+        context->functions()->glBindBuffer(GL_ARRAY_BUFFER, quad_vbo);
+        context->functions()->glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        context->functions()->glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
     FontContext::~FontContext()
@@ -102,6 +112,9 @@ namespace degate
             if (context->functions()->glIsTexture(font->font_atlas_texture_array) == GL_TRUE)
                 context->functions()->glDeleteTextures(1, &font->font_atlas_texture_array);
         }
+
+        if (context->functions()->glIsBuffer(quad_vbo) == GL_TRUE)
+            context->functions()->glDeleteBuffers(1, &quad_vbo);
     }
 
     std::shared_ptr<FontContextData> FontContext::get_font(const Font& font)
@@ -132,7 +145,8 @@ namespace degate
     {
         assert(font_context_data != nullptr);
 
-        static unsigned int atlas_count = static_cast<unsigned int>(font_context_data->font_data->font_atlas.size());
+        // The number of atlas in the texture array is kept per font and context (the atlas are shared by all texts).
+        unsigned int& atlas_count = font_context_data->atlas_count;
 
         // If there is no new atlas since last time just add the last glyph (last generated/loaded) to the texture array.
         if (full_reload == false && atlas_count == font_context_data->font_data->font_atlas.size() && context->functions()->glIsTexture(font_context_data->font_atlas_texture_array) == GL_TRUE)
@@ -275,7 +289,40 @@ namespace degate
         return it->second;
     }
 
-    std::shared_ptr<GlyphData> Text::generate_glyph(const std::shared_ptr<FontData>& font_data, const Glyph& glyph)
+    std::shared_ptr<QImage> Text::render_glyph(const std::shared_ptr<FontData>& font_data, const Glyph& glyph, bool parallel)
+    {
+        // Distance field generator
+        DistanceFieldGenerator dfg(font_data->spread * font_data->scale, font_data->scale);
+
+        // Scaled font
+        QFont scaled_font(QString::fromStdString(font_data->font.font_family_name), font_data->font.font_size * font_data->scale);
+        scaled_font.setStyleStrategy(QFont::NoAntialias);
+        QFontMetricsF scaled_font_metric(scaled_font);
+
+        // Glyph image
+        QImage temp_glyph_image(std::ceil(scaled_font_metric.maxWidth() + font_data->padding * 2.0 * font_data->scale), std::ceil(scaled_font_metric.height() + font_data->padding * 2.0 * font_data->scale), QImage::Format_ARGB32);
+
+        // Glyph painter
+        QPainter glyph_painter(&temp_glyph_image);
+        glyph_painter.setBackgroundMode(Qt::TransparentMode);
+        glyph_painter.setCompositionMode (QPainter::CompositionMode_Source);
+        glyph_painter.setPen(qRgba(0, 0, 0, 0));
+        glyph_painter.fillRect(0, 0, temp_glyph_image.width(), temp_glyph_image.height(), Qt::transparent);
+        glyph_painter.setCompositionMode (QPainter::CompositionMode_SourceOver);
+        glyph_painter.setPen(qRgba(255, 255, 255, 255));
+        glyph_painter.setFont(scaled_font);
+
+        // Glyph draw
+        QPointF painter_point(static_cast<qreal>(font_data->padding) * static_cast<qreal>(font_data->scale),
+                              scaled_font_metric.ascent() +
+                              static_cast<qreal>(font_data->padding) * static_cast<qreal>(font_data->scale));
+        glyph_painter.drawText(painter_point, glyph);
+        glyph_painter.end();
+
+        return dfg.generate_distance_field(temp_glyph_image, parallel);
+    }
+
+    std::shared_ptr<GlyphData> Text::add_glyph(const std::shared_ptr<FontData>& font_data, const Glyph& glyph, const std::shared_ptr<QImage>& glyph_image)
     {
         // Font
         QFont qt_font(QString::fromStdString(font_data->font.font_family_name), font_data->font.font_size);
@@ -285,6 +332,7 @@ namespace degate
 
         auto glyph_data = std::make_shared<GlyphData>();
         font_data->glyphs.push_back(glyph_data);
+        font_data->glyph_index[glyph.unicode()] = glyph_data;
 
         glyph_data->glyph = glyph;
         glyph_data->atlas_position = (font_data->glyphs.size() - 1) % font_data->glyph_per_atlas;
@@ -319,34 +367,7 @@ namespace degate
         painter.setPen(qRgba(255, 255, 255, 255));
         painter.setFont(qt_font);
 
-        // Distance field generator
-        DistanceFieldGenerator dfg(font_data->spread * font_data->scale, font_data->scale);
-
-        // Scaled font
-        QFont scaled_font(QString::fromStdString(font_data->font.font_family_name), font_data->font.font_size * font_data->scale);
-        scaled_font.setStyleStrategy(QFont::NoAntialias);
-        QFontMetricsF scaled_font_metric(scaled_font);
-
-        // Glyph image
-        QImage temp_glyph_image(std::ceil(scaled_font_metric.maxWidth() + font_data->padding * 2.0 * font_data->scale), std::ceil(scaled_font_metric.height() + font_data->padding * 2.0 * font_data->scale), QImage::Format_ARGB32);
-
-        // Glyph painter
-        QPainter glyph_painter(&temp_glyph_image);
-        glyph_painter.setBackgroundMode(Qt::TransparentMode);
-        glyph_painter.setCompositionMode (QPainter::CompositionMode_Source);
-        glyph_painter.setPen(qRgba(0, 0, 0, 0));
-        glyph_painter.fillRect(0, 0, temp_glyph_image.width(), temp_glyph_image.height(), Qt::transparent);
-        glyph_painter.setCompositionMode (QPainter::CompositionMode_SourceOver);
-        glyph_painter.setPen(qRgba(255, 255, 255, 255));
-        glyph_painter.setFont(scaled_font);
-
-        // Glyph draw
-        QPointF painter_point(static_cast<qreal>(font_data->padding) * static_cast<qreal>(font_data->scale),
-                              scaled_font_metric.ascent() +
-                              static_cast<qreal>(font_data->padding) * static_cast<qreal>(font_data->scale));
-        glyph_painter.drawText(painter_point, glyph);
-
-        font_data->last_generated_glyph_image = dfg.generate_distance_field(temp_glyph_image);
+        font_data->last_generated_glyph_image = glyph_image;
 
         // Distance field conversion
         QPointF point(static_cast<qreal>(glyph_data->atlas_position % font_data->atlas_glyph_per_line) *
@@ -360,20 +381,50 @@ namespace degate
         return glyph_data;
     }
 
-    std::shared_ptr<GlyphData> Text::get_glyph(const Glyph& glyph)
+    std::shared_ptr<GlyphData> Text::generate_glyph(const std::shared_ptr<FontData>& font_data, const Glyph& glyph)
     {
-        if (font_context_data.lock() == nullptr || font_context_data.lock()->font_data == nullptr)
-            return nullptr;
+        return add_glyph(font_data, glyph, render_glyph(font_data, glyph));
+    }
 
-        for (auto& g : font_context_data.lock()->font_data->glyphs)
+    void Text::generate_glyphs(const std::shared_ptr<FontData>& font_data, const QString& glyphs)
+    {
+        // Only glyphs that don't exist yet (once each).
+        std::vector<Glyph> missing;
+        for (const Glyph& glyph : glyphs)
         {
-            if (g->glyph == glyph)
-                return g;
+            if (font_data->glyph_index.find(glyph.unicode()) == font_data->glyph_index.end() &&
+                std::find(missing.begin(), missing.end(), glyph) == missing.end())
+                missing.push_back(glyph);
         }
 
-        std::shared_ptr<GlyphData> res = generate_glyph(font_context_data.lock()->font_data, glyph);
+        if (missing.empty())
+            return;
+
+        // Distance fields are generated in parallel (one glyph per task), then placed in the atlas in order.
+        std::function<std::shared_ptr<QImage>(const Glyph& glyph)> render_function = [&font_data](const Glyph& glyph)
+        {
+            return render_glyph(font_data, glyph, false);
+        };
+
+        QList<std::shared_ptr<QImage>> images = QtConcurrent::blockingMapped<QList<std::shared_ptr<QImage>>>(missing, render_function);
 
-        font_context->reload_font_context(font_context_data.lock());
+        for (unsigned int i = 0; i < missing.size(); i++)
+            add_glyph(font_data, missing[i], images.at(static_cast<int>(i)));
+    }
+
+    std::shared_ptr<GlyphData> Text::get_glyph(const Glyph& glyph)
+    {
+        auto context_data = font_context_data.lock();
+        if (context_data == nullptr || context_data->font_data == nullptr)
+            return nullptr;
+
+        auto it = context_data->font_data->glyph_index.find(glyph.unicode());
+        if (it != context_data->font_data->glyph_index.end())
+            return it->second;
+
+        std::shared_ptr<GlyphData> res = generate_glyph(context_data->font_data, glyph);
+
+        font_context->reload_font_context(context_data);
 
         return res;
     }
@@ -428,7 +479,7 @@ namespace degate
         res->atlas_width = FONT_ATLAS_SIZE;
         res->atlas_glyph_per_line = std::floor(res->atlas_width / res->glyph_width);
         res->atlas_glyph_per_column = std::floor(res->atlas_height / res->glyph_height);
-        res->glyph_per_atlas = res->atlas_glyph_per_line + res->atlas_glyph_per_column;
+        res->glyph_per_atlas = res->atlas_glyph_per_line * res->atlas_glyph_per_column;
 
         // Create a blank atlas
         std::shared_ptr<QImage> font_image = std::make_shared<QImage>(res->atlas_width, res->atlas_height, QImage::Format_ARGB32);
@@ -438,12 +489,37 @@ namespace degate
         temp_painter.setCompositionMode (QPainter::CompositionMode_Source);
         temp_painter.setPen(qRgba(0, 0, 0, 0));
         temp_painter.fillRect(0, 0, font_image->width(), font_image->height(), Qt::transparent);
+        temp_painter.end();
+
+        // Generate all printable ASCII glyphs at once (in parallel), instead of one by one when drawn.
+        QString ascii_glyphs;
+        for (char16_t c = 0x20; c < 0x7F; c++)
+            ascii_glyphs.append(QChar(c));
+
+        generate_glyphs(res, ascii_glyphs);
 
         fonts.push_back(res);
 
+        // Save it right now, the next start will load it from the cache.
+        try
+        {
+            save_font(res);
+        }
+        catch (const std::exception& e)
+        {
+            debug(TM, "Can't save the font in the cache: %s", e.what());
+        }
+
         return res;
     }
 
+    bool Text::has_current_parameters(const QDomElement& font_elem)
+    {
+        return font_elem.attribute("spread").toFloat() == static_cast<float>(FONT_DFG_SPREAD) &&
+               font_elem.attribute("scale").toFloat() == static_cast<float>(FONT_DFG_SCALE) &&
+               font_elem.attribute("atlas_size").toUInt() == FONT_ATLAS_SIZE;
+    }
+
     void Text::save_fonts_to_cache()
     {
         if (fonts.empty())
@@ -515,7 +591,9 @@ namespace degate
         {
             QDomElement node = list.at(x).toElement();
 
-            if (node.attribute("font_size").toUInt() == font.font_size && node.attribute("font_family_name") == QString::fromStdString(font.font_family_name))
+            if (node.attribute("font_size").toUInt() == font.font_size &&
+                node.attribute("font_family_name") == QString::fromStdString(font.font_family_name) &&
+                has_current_parameters(node))
             {
                 font_elem = node;
                 break;
@@ -571,6 +649,16 @@ namespace degate
         font_data->spread = font_config_file_stream.readLine().toFloat();
         font_data->scale = font_config_file_stream.readLine().toFloat();
         font_data->as_changed = false;
+
+        // Generated with other parameters (the config file was edited).
+        if (font_data->spread != static_cast<float>(FONT_DFG_SPREAD) || font_data->scale != static_cast<float>(FONT_DFG_SCALE) ||
+            font_data->atlas_width != FONT_ATLAS_SIZE || font_data->atlas_height != FONT_ATLAS_SIZE)
+        {
+            config_file.close();
+            font_config_file.close();
+            return nullptr;
+        }
+
         unsigned int glyph_count = font_config_file_stream.readLine().toUInt();
 
         // Font atlas file
@@ -598,6 +686,7 @@ namespace degate
             glyph->atlas_index = font_config_file_stream.readLine().toUInt();
             glyph->atlas = font_data->font_atlas.at(glyph->atlas_index);
             font_data->glyphs.push_back(glyph);
+            font_data->glyph_index[glyph->glyph.unicode()] = glyph;
         }
 
         font_config_file.close();
@@ -658,7 +747,9 @@ namespace degate
                 {
                     QDomElement node = list.at(x).toElement();
 
-                    if (node.attribute("font_size").toUInt() == font_data->font.font_size && node.attribute("font_family_name") == QString::fromStdString(font_data->font.font_family_name))
+                    if (node.attribute("font_size").toUInt() == font_data->font.font_size &&
+                        node.attribute("font_family_name") == QString::fromStdString(font_data->font.font_family_name) &&
+                        has_current_parameters(node))
                     {
                         font_elem = node;
                         break;
@@ -674,14 +765,23 @@ namespace degate
 
         CHECK_PATH(DEGATE_CACHE_PATH)
 
-        std::string font_config_file_path = DEGATE_IN_CACHE(font_data->font.font_family_name + "_" + std::to_string(font_data->font.font_size) + ".fnt");
-        std::string font_atlas_file_path = DEGATE_IN_CACHE(font_data->font.font_family_name + "_" + std::to_string(font_data->font.font_size) + "_");
+        // The cache is keyed by font and generation parameters.
+        std::string font_key = font_data->font.font_family_name + "_" + std::to_string(font_data->font.font_size) + "_" +
+                               std::to_string(static_cast<unsigned int>(font_data->spread)) + "_" +
+                               std::to_string(static_cast<unsigned int>(font_data->scale)) + "_" +
+                               std::to_string(font_data->atlas_width);
+
+        std::string font_config_file_path = DEGATE_IN_CACHE(font_key + ".fnt");
+        std::string font_atlas_file_path = DEGATE_IN_CACHE(font_key + "_");
 
         font_elem.setAttribute("font_size", font_data->font.font_size);
         font_elem.setAttribute("font_family_name", QString::fromStdString(font_data->font.font_family_name));
         font_elem.setAttribute("font_config_file_path", QString::fromStdString(font_config_file_path));
         font_elem.setAttribute("font_atlas_file_path", QString::fromStdString(font_atlas_file_path));
         font_elem.setAttribute("font_atlas_count", QString::number(font_data->font_atlas.size()));
+        font_elem.setAttribute("spread", QString::number(font_data->spread));
+        font_elem.setAttribute("scale", QString::number(font_data->scale));
+        font_elem.setAttribute("atlas_size", QString::number(font_data->atlas_width));
 
         root.appendChild(font_elem);
 
@@ -737,6 +837,7 @@ namespace degate
         for (unsigned int i = 0; i < font_data->font_atlas.size(); i++)
             font_data->font_atlas.at(i)->save(QString::fromStdString(font_atlas_file_path) + QString::number(i + 1) + FONT_ATLAS_EXTENSION);
 
+        font_data->as_changed = false;
     }
 
     Text::Text(QWidget* parent, const std::string& font_family_name, const unsigned font_size) : parent(parent), font(Font{font_size, font_family_name})
@@ -746,8 +847,10 @@ namespace degate
 
     Text::~Text()
     {
-        if (font_context->context->functions()->glIsBuffer(vbo) == GL_TRUE)
-            font_context->context->functions()->glDeleteBuffers(1, &vbo);
+        if (font_context == nullptr || QOpenGLContext::currentContext() == nullptr)
+            return;
+
+        clear_chunks();
 
         if (vao.isCreated())
             vao.destroy();
@@ -758,85 +861,81 @@ namespace degate
         font_context = get_font_context();
         font_context_data = font_context->get_font(font);
 
-        font_context->context->functions()->glGenBuffers(1, &vbo);
         vao.create();
     }
 
     void Text::update(unsigned int total_size)
     {
-        vao.bind();
-        font_context->context->functions()->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        font_context->context->functions()->glBufferData(GL_ARRAY_BUFFER, total_size * 6 * sizeof(TextVertex2D), nullptr, GL_DYNAMIC_DRAW);
-        font_context->context->functions()->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        clear_chunks();
+
+        blocks.clear();
+        glyphs.assign(total_size, TextGlyphInstance());
 
         this->total_size = total_size;
     }
 
     QSizeF Text::add_sub_text(unsigned int offset, float x, float y, const std::string& text, const unsigned int text_size, const QVector3D &color, const float alpha, const bool center_x, const bool center_y, float max_width)
     {
+        auto context_data = font_context_data.lock();
+        if (context_data == nullptr || context_data->font_data == nullptr)
+            return {0, 0};
+
+        const std::shared_ptr<FontData>& font_data = context_data->font_data;
+
         QString string = QString::fromUtf8(text.data(), static_cast<int>(text.size()));
         std::shared_ptr<GlyphData> glyph;
         float size_downscale_factor = 1;
         float size_factor = static_cast<float>(text_size) / static_cast<float>(font.font_size);
 
-        // Max width
-        if (max_width > 0)
+        // Text width (without downscale)
+        float text_width = 0;
+        if (max_width > 0 || center_x == true)
         {
-            float text_width = 0;
             for (Glyph& g : string)
             {
                 glyph = get_glyph(g);
                 text_width += static_cast<float>(glyph->char_advance) * size_factor;
             }
-
-            if (text_width >= max_width)
-                size_downscale_factor = static_cast<float>(max_width) / static_cast<float>(text_width);
         }
 
+        // Max width
+        if (max_width > 0 && text_width >= max_width)
+            size_downscale_factor = static_cast<float>(max_width) / static_cast<float>(text_width);
+
         // Set final size factor
         size_factor *= size_downscale_factor;
         QVector3D final_color = color / 255.0;
-        float padding = font_context_data.lock()->font_data->padding;
+        float padding = font_data->padding;
 
         // Padding adaptation
         x -= padding * size_factor;
 
         // Center x
         if (center_x == true)
-        {
-            float x_offset = 0.f;
-            for (Glyph& g : string)
-            {
-                glyph = get_glyph(g);
-                x_offset += static_cast<float>(glyph->char_advance) * size_factor;
-            }
-
-            x -= x_offset / 2.0;
-        }
+            x -= (text_width * size_downscale_factor) / 2.0;
 
         // Center y
         if (center_y == true)
-            y -= ((font_context_data.lock()->font_data->default_glyph_height + padding) * size_factor) / 2.0;
+            y -= ((font_data->default_glyph_height + padding) * size_factor) / 2.0;
         else
             y -= padding * 2.0f * size_factor;
 
 
-        // Fill vbo
+        // Fill glyph instances (CPU side, chunks are sent when drawn)
 
-        vao.bind();
-        font_context->context->functions()->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-        TextVertex2D temp;
+        TextGlyphInstance temp;
         temp.color = final_color;
         temp.alpha = alpha;
 
-        float atlas_width = static_cast<float>(font_context_data.lock()->font_data->atlas_width);
-        float atlas_height = static_cast<float>(font_context_data.lock()->font_data->atlas_height);
-        unsigned int glyph_per_line = font_context_data.lock()->font_data->atlas_glyph_per_line;
+        float atlas_width = static_cast<float>(font_data->atlas_width);
+        float atlas_height = static_cast<float>(font_data->atlas_height);
+        unsigned int glyph_per_line = font_data->atlas_glyph_per_line;
+        float glyph_height = (static_cast<float>(font_data->default_glyph_height) + padding * 2.0f) * size_factor;
+
+        unsigned int count = std::min(static_cast<unsigned int>(string.size()), total_size - std::min(offset, total_size));
 
         float pixel_size = 0;
-        for (unsigned int i = 0; i < static_cast<unsigned int>(string.size()); i++)
+        for (unsigned int i = 0; i < count; i++)
         {
             glyph = get_glyph(string[i]);
 
@@ -844,78 +943,198 @@ namespace degate
 
             auto char_width = glyph->char_advance;
 
-            QVector2D pos_start(x + pixel_size, y);
-            QVector2D pos_end(pos_start.x() + (char_width + padding * 2.0) * size_factor, pos_start.y() + (static_cast<float>(font_context_data.lock()->font_data->default_glyph_height) + padding * 2.0) * size_factor);
+            temp.pos = QVector2D(x + pixel_size, y);
+            temp.size = QVector2D((char_width + padding * 2.0) * size_factor, glyph_height);
 
-            QVector2D uv_start((glyph->atlas_position % glyph_per_line) * (font_context_data.lock()->font_data->glyph_width) / atlas_width, (static_cast<float>(glyph->atlas_position / glyph_per_line) * (font_context_data.lock()->font_data->glyph_height)) / atlas_height);
-            QVector2D uv_end(uv_start.x() + (char_width + padding * 2.0) / atlas_width, uv_start.y() + (font_context_data.lock()->font_data->glyph_height) / atlas_height);
+            temp.uv = QVector2D((glyph->atlas_position % glyph_per_line) * (font_data->glyph_width) / atlas_width, (static_cast<float>(glyph->atlas_position / glyph_per_line) * (font_data->glyph_height)) / atlas_height);
+            temp.uv_size = QVector2D((char_width + padding * 2.0) / atlas_width, (font_data->glyph_height) / atlas_height);
 
-            temp.pos = QVector2D(pos_start.x(), pos_start.y());
-            temp.tex_uv = QVector2D(uv_start.x(), uv_start.y());
-            font_context->context->functions()->glBufferSubData(GL_ARRAY_BUFFER, offset * 6 * sizeof(TextVertex2D) + i * 6 * sizeof(TextVertex2D) + 0 * sizeof(TextVertex2D), sizeof(TextVertex2D), &temp);
+            glyphs[offset + i] = temp;
 
-            temp.pos = QVector2D(pos_end.x(), pos_start.y());
-            temp.tex_uv = QVector2D(uv_end.x(), uv_start.y());
-            font_context->context->functions()->glBufferSubData(GL_ARRAY_BUFFER, offset * 6 * sizeof(TextVertex2D) + i * 6 * sizeof(TextVertex2D) + 1 * sizeof(TextVertex2D), sizeof(TextVertex2D), &temp);
+            pixel_size += char_width * size_factor;
+        }
 
-            temp.pos = QVector2D(pos_start.x(), pos_end.y());
-            temp.tex_uv = QVector2D(uv_start.x(), uv_end.y());
-            font_context->context->functions()->glBufferSubData(GL_ARRAY_BUFFER, offset * 6 * sizeof(TextVertex2D) + i * 6 * sizeof(TextVertex2D) + 2 * sizeof(TextVertex2D), sizeof(TextVertex2D), &temp);
 
-            temp.pos = QVector2D(pos_start.x(), pos_end.y());
-            temp.tex_uv = QVector2D(uv_start.x(), uv_end.y());
-            font_context->context->functions()->glBufferSubData(GL_ARRAY_BUFFER, offset * 6 * sizeof(TextVertex2D) + i * 6 * sizeof(TextVertex2D) + 3 * sizeof(TextVertex2D), sizeof(TextVertex2D), &temp);
+        // Chunk
 
-            temp.pos = QVector2D(pos_end.x(), pos_start.y());
-            temp.tex_uv = QVector2D(uv_end.x(), uv_start.y());
-            font_context->context->functions()->glBufferSubData(GL_ARRAY_BUFFER, offset * 6 * sizeof(TextVertex2D) + i * 6 * sizeof(TextVertex2D) + 4 * sizeof(TextVertex2D), sizeof(TextVertex2D), &temp);
+        if (count > 0)
+        {
+            BoundingBox bounds(x, x + pixel_size + padding * 2.0f * size_factor, y, y + glyph_height);
 
-            temp.pos = QVector2D(pos_end.x(), pos_end.y());
-            temp.tex_uv = QVector2D(uv_end.x(), uv_end.y());
-            font_context->context->functions()->glBufferSubData(GL_ARRAY_BUFFER, offset * 6 * sizeof(TextVertex2D) + i * 6 * sizeof(TextVertex2D) + 5 * sizeof(TextVertex2D), sizeof(TextVertex2D), &temp);
+            const std::pair<long, long> key(static_cast<long>(std::floor(bounds.get_center_x() / TEXT_CHUNK_SIZE)),
+                                            static_cast<long>(std::floor(bounds.get_center_y() / TEXT_CHUNK_SIZE)));
 
-            pixel_size += char_width * size_factor;
+            auto block = blocks.find(offset);
+
+            // The text at this offset was replaced, and moved to another chunk.
+            if (block != blocks.end() && block->second.chunk != key)
+            {
+                TextChunk& old_chunk = chunks[block->second.chunk];
+                old_chunk.blocks.erase(std::remove(old_chunk.blocks.begin(), old_chunk.blocks.end(), offset), old_chunk.blocks.end());
+                old_chunk.dirty = true;
+            }
+
+            auto chunk = chunks.find(key);
+            if (chunk == chunks.end())
+            {
+                chunk = chunks.insert({key, TextChunk()}).first;
+                chunk->second.bounds = bounds;
+            }
+
+            if (block == blocks.end() || block->second.chunk != key)
+                chunk->second.blocks.push_back(offset);
+
+            chunk->second.bounds.set(std::min(chunk->second.bounds.get_min_x(), bounds.get_min_x()),
+                                     std::max(chunk->second.bounds.get_max_x(), bounds.get_max_x()),
+                                     std::min(chunk->second.bounds.get_min_y(), bounds.get_min_y()),
+                                     std::max(chunk->second.bounds.get_max_y(), bounds.get_max_y()));
+            chunk->second.max_height = std::max(chunk->second.max_height, glyph_height);
+            chunk->second.dirty = true;
+
+            blocks[offset] = TextBlock{count, key};
         }
+        else
+        {
+            // The text at this offset was replaced by an empty one.
+            auto block = blocks.find(offset);
+            if (block != blocks.end())
+            {
+                TextChunk& old_chunk = chunks[block->second.chunk];
+                old_chunk.blocks.erase(std::remove(old_chunk.blocks.begin(), old_chunk.blocks.end(), offset), old_chunk.blocks.end());
+                old_chunk.dirty = true;
 
-        font_context->context->functions()->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+                blocks.erase(block);
+            }
+        }
 
         return {pixel_size,
-                static_cast<qreal>(font_context_data.lock()->font_data->glyph_height) * static_cast<qreal>(size_factor)};
+                static_cast<qreal>(font_data->glyph_height) * static_cast<qreal>(size_factor)};
+    }
+
+    void Text::build_chunk(TextChunk& chunk)
+    {
+        std::vector<TextGlyphInstance> instances;
+
+        for (auto offset : chunk.blocks)
+        {
+            auto block = blocks.find(offset);
+            if (block == blocks.end())
+                continue;
+
+            instances.insert(instances.end(), glyphs.begin() + offset, glyphs.begin() + offset + block->second.count);
+        }
+
+        auto functions = font_context->context->functions();
+
+        if (chunk.vbo == 0)
+            functions->glGenBuffers(1, &chunk.vbo);
+
+        functions->glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+        functions->glBufferData(GL_ARRAY_BUFFER,
+                                instances.size() * sizeof(TextGlyphInstance),
+                                instances.empty() ? nullptr : instances.data(),
+                                GL_STATIC_DRAW);
+        functions->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        chunk.count = instances.size();
+        chunk.dirty = false;
+    }
+
+    void Text::clear_chunks()
+    {
+        if (font_context != nullptr)
+        {
+            for (auto& chunk : chunks)
+            {
+                if (font_context->context->functions()->glIsBuffer(chunk.second.vbo) == GL_TRUE)
+                    font_context->context->functions()->glDeleteBuffers(1, &chunk.second.vbo);
+            }
+        }
+
+        chunks.clear();
     }
 
     void Text::draw(const QMatrix4x4 &projection)
     {
-        font_context->program.bind();
-        font_context->program.setUniformValue("mvp", projection);
+        if (chunks.empty() || font_context_data.lock() == nullptr)
+            return;
+
+        // Visible area and size of a pixel (in projection coordinates).
+        const QMatrix4x4 inverse = projection.inverted();
+        const QPointF first_corner = inverse.map(QPointF(-1, -1));
+        const QPointF second_corner = inverse.map(QPointF(1, 1));
+        const BoundingBox viewport(static_cast<float>(std::min(first_corner.x(), second_corner.x())),
+                                   static_cast<float>(std::max(first_corner.x(), second_corner.x())),
+                                   static_cast<float>(std::min(first_corner.y(), second_corner.y())),
+                                   static_cast<float>(std::max(first_corner.y(), second_corner.y())));
+
+        GLint gl_viewport[4];
+        font_context->context->functions()->glGetIntegerv(GL_VIEWPORT, gl_viewport);
+
+        const float min_height = gl_viewport[3] > 0
+                                 ? TEXT_MIN_PIXEL_SIZE * viewport.get_height() / static_cast<float>(gl_viewport[3])
+                                 : 0.0f;
+
+        auto functions = font_context->context->functions();
+        auto extra_functions = font_context->context->extraFunctions();
+        auto& program = font_context->program;
+
+        program.bind();
+        program.setUniformValue("mvp", projection);
+        program.setUniformValue("min_height", min_height);
 
         vao.bind();
-        font_context->context->functions()->glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-        font_context->program.enableAttributeArray("pos");
-        font_context->program.setAttributeBuffer("pos", GL_FLOAT, 0, 2, sizeof(TextVertex2D));
+        // Per vertex attribute.
+        functions->glBindBuffer(GL_ARRAY_BUFFER, font_context->quad_vbo);
+
+        program.enableAttributeArray("corner");
+        program.setAttributeBuffer("corner", GL_FLOAT, 0, 2, sizeof(QVector2D));
+
+        functions->glBindTexture(GL_TEXTURE_2D_ARRAY, font_context_data.lock()->font_atlas_texture_array);
+
+        // Per instance attributes (name, offset in floats, size).
+        static const std::tuple<const char*, int, int> attributes[] = {std::make_tuple("pos", 0, 2),
+                                                                       std::make_tuple("size", 2, 2),
+                                                                       std::make_tuple("uv", 4, 2),
+                                                                       std::make_tuple("uv_size", 6, 2),
+                                                                       std::make_tuple("color", 8, 3),
+                                                                       std::make_tuple("alpha", 11, 1),
+                                                                       std::make_tuple("texture_index", 12, 1)};
+
+        for (auto& e : chunks)
+        {
+            TextChunk& chunk = e.second;
 
-        font_context->program.enableAttributeArray("uv");
-        font_context->program.setAttributeBuffer("uv", GL_FLOAT, 2 * sizeof(float), 2, sizeof(TextVertex2D));
+            // Out of the viewport, or too small to be read.
+            if (chunk.blocks.empty() || !chunk.bounds.intersects(viewport) || chunk.max_height < min_height)
+                continue;
 
-        font_context->program.enableAttributeArray("color");
-        font_context->program.setAttributeBuffer("color", GL_FLOAT, 4 * sizeof(float), 3, sizeof(TextVertex2D));
+            if (chunk.dirty)
+                build_chunk(chunk);
 
-        font_context->program.enableAttributeArray("alpha");
-        font_context->program.setAttributeBuffer("alpha", GL_FLOAT, 7 * sizeof(float), 1, sizeof(TextVertex2D));
+            if (chunk.count == 0)
+                continue;
 
-        font_context->program.enableAttributeArray("texture_index");
-        font_context->program.setAttributeBuffer("texture_index", GL_FLOAT, 8 * sizeof(float), 1, sizeof(TextVertex2D));
+            functions->glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
 
-        font_context->context->functions()->glBindTexture(GL_TEXTURE_2D_ARRAY, font_context_data.lock()->font_atlas_texture_array);
+            for (auto& attribute : attributes)
+            {
+                const char* name = std::get<0>(attribute);
 
-        font_context->context->functions()->glDrawArrays(GL_TRIANGLES, 0, total_size * 6);
+                program.enableAttributeArray(name);
+                program.setAttributeBuffer(name, GL_FLOAT, std::get<1>(attribute) * sizeof(float), std::get<2>(attribute), sizeof(TextGlyphInstance));
+                extra_functions->glVertexAttribDivisor(program.attributeLocation(name), 1);
+            }
+
+            extra_functions->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(chunk.count));
+        }
 
-        font_context->context->functions()->glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        functions->glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
-        font_context->context->functions()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        functions->glBindBuffer(GL_ARRAY_BUFFER, 0);
         vao.release();
 
-        font_context->program.release();
+        program.release();
     }
 }
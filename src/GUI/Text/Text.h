@@ -22,9 +22,15 @@
 #ifndef __TEXT_H__
 #define __TEXT_H__
 
+#include "Core/Primitive/BoundingBox.h"
+
 #include <QtOpenGL/QtOpenGL>
+#include <QDomElement>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #define FONT_DFG_SPREAD 4.0
 #define FONT_DFG_SCALE 8.0
@@ -37,7 +43,13 @@
 #define FONTS_CONFIG_FILE_NAME "font.config"
 #define FONT_ATLAS_EXTENSION ".png"
 
-#define FONT_FILE_VERSION 2
+#define FONT_FILE_VERSION 3
+
+// Width (and height) of a text chunk (texts are grouped by position to cull them).
+#define TEXT_CHUNK_SIZE 4096.0f
+
+// Glyphs smaller than this height on screen (in pixels) are not drawn.
+#define TEXT_MIN_PIXEL_SIZE 4.0f
 
 namespace degate
 {
@@ -103,6 +115,7 @@ namespace degate
         float scale;                                        /**< The scale of the Distance Field method). */
         std::vector<std::shared_ptr<QImage>> font_atlas;    /**< The font atlas. */
         std::vector<std::shared_ptr<GlyphData>> glyphs;     /**< The list of glyphs. */
+        std::unordered_map<char16_t, std::shared_ptr<GlyphData>> glyph_index; /**< The glyphs by unicode value. */
         bool as_changed = true;                             /**< Tell if the font needs to be saved again (or not, if it didn't change) */
         std::shared_ptr<QImage> last_generated_glyph_image; /**< Store the last generated glyph image (for gpu reload) */
     };
@@ -113,7 +126,8 @@ namespace degate
      struct FontContextData
      {
          std::shared_ptr<FontData> font_data;   /**< The font data of the font */
-         GLuint font_atlas_texture_array;       /**< The associated font atlas OpenGL texture array */
+         GLuint font_atlas_texture_array = 0;   /**< The associated font atlas OpenGL texture array */
+         unsigned int atlas_count = 0;          /**< The number of atlas in the texture array */
      };
 
     /**
@@ -154,10 +168,58 @@ namespace degate
         // The shader program.
         QOpenGLShaderProgram program;
 
+        // The quad shared by all glyph instances (triangle strip).
+        GLuint quad_vbo = 0;
+
         // The context.
         QOpenGLContext* context;
     };
 
+    /**
+     * Per instance data of a glyph quad.
+     */
+    struct TextGlyphInstance
+    {
+        QVector2D pos;          /**< Position of the top left corner. */
+        QVector2D size;         /**< Size of the quad (0 for an unused glyph). */
+        QVector2D uv;           /**< Texture coordinates of the top left corner. */
+        QVector2D uv_size;      /**< Size of the glyph in the atlas (in texture coordinates). */
+        QVector3D color;
+        float alpha;
+        float texture_index;    /**< The atlas of the glyph. */
+    };
+
+    /**
+     * A text added with Text::add_sub_text.
+     */
+    struct TextBlock
+    {
+        unsigned count = 0;                 /**< The number of glyphs. */
+        std::pair<long, long> chunk;        /**< The chunk of the text. */
+    };
+
+    /**
+     * Texts grouped by position, drawn together (with one buffer).
+     */
+    struct TextChunk
+    {
+        BoundingBox bounds;                 /**< The union of the bounds of all texts in the chunk. */
+        std::vector<unsigned> blocks;       /**< The offset of each text in the chunk. */
+        float max_height = 0;               /**< The height of the biggest glyph. */
+        GLuint vbo = 0;
+        std::size_t count = 0;              /**< The number of glyphs in the vbo. */
+        bool dirty = true;                  /**< The vbo must be filled again before drawing. */
+    };
+
+    /**
+     * @class Text
+     * @brief Draw many texts with a Distance Field font.
+     *
+     * All texts of the same font and OpenGL context share the same glyph atlas (@see FontContext).
+     * Each glyph is an instance of a shared quad. Glyphs are assembled on the CPU side and texts
+     * are grouped in chunks (@see TEXT_CHUNK_SIZE): only chunks in the viewport are sent
+     * (when they changed) and drawn. Texts too small to be read are skipped (@see TEXT_MIN_PIXEL_SIZE).
+     */
     class Text
     {
     public:
@@ -208,19 +270,19 @@ namespace degate
         ~Text();
 
         /**
-         * Init OpenGL routine (vbo).
+         * Init OpenGL routine (vao).
          */
         void init();
 
         /**
-         * Update all vbo with a new total size.
+         * Remove all texts and set the new total size.
          *
          * @param total_size : the size of total text to draw.
          */
         void update(unsigned total_size);
 
         /**
-         * Add a new text to the vbo (that will be drawn with others).
+         * Add a new text (that will be drawn with others), or replace the text at offset.
          *
          * @param offset : offset to the first character of the first string.
          * @param x : left bottom corner x coordinate of the first letter.
@@ -238,7 +300,7 @@ namespace degate
         QSizeF add_sub_text(unsigned offset, float x, float y, const std::string& text, unsigned int text_size, const QVector3D& color = QVector3D(255, 255, 255), float alpha = 1, bool center_x = false, bool center_y = false, float max_width = 0);
 
         /**
-         * Draw all text in the vbo.
+         * Draw all visible texts. Changed chunks are sent before.
          *
          * @param projection : the projection matrix to apply.
          */
@@ -264,6 +326,45 @@ namespace degate
          */
         static std::shared_ptr<GlyphData> generate_glyph(const std::shared_ptr<FontData>& font_data, const Glyph& glyph);
 
+        /**
+         * Generate glyphs for a specific font, in parallel (one glyph per task).
+         * Glyphs that already exist are skipped.
+         *
+         * @param font_data : the font.
+         * @param glyphs : the glyphs.
+         */
+        static void generate_glyphs(const std::shared_ptr<FontData>& font_data, const QString& glyphs);
+
+        /**
+         * Draw a glyph and create its distance field image. It doesn't change the font (thread safe).
+         *
+         * @param font_data : the font.
+         * @param glyph : the glyph.
+         * @param parallel : if true, the distance field is generated on the Qt thread pool.
+         *
+         * @return Returns the distance field image of the glyph.
+         */
+        static std::shared_ptr<QImage> render_glyph(const std::shared_ptr<FontData>& font_data, const Glyph& glyph, bool parallel = true);
+
+        /**
+         * Add a rendered glyph to a font (in the last atlas, or a new one if full).
+         *
+         * @param font_data : the font.
+         * @param glyph : the glyph.
+         * @param glyph_image : the distance field image of the glyph (@see render_glyph).
+         *
+         * @return Returns the new glyph data.
+         */
+        static std::shared_ptr<GlyphData> add_glyph(const std::shared_ptr<FontData>& font_data, const Glyph& glyph, const std::shared_ptr<QImage>& glyph_image);
+
+        /**
+         * Check if a font of the cache config file was generated with the current parameters
+         * (spread, scale and atlas size).
+         *
+         * @param font_elem : the font element of the config file.
+         */
+        static bool has_current_parameters(const QDomElement& font_elem);
+
         /**
          * Load a font from the cache.
          *
@@ -289,6 +390,18 @@ namespace degate
          */
         std::shared_ptr<GlyphData> get_glyph(const Glyph& glyph);
 
+        /**
+         * Fill the vbo of a chunk with the glyphs of its texts.
+         *
+         * @param chunk : the chunk to build.
+         */
+        void build_chunk(TextChunk& chunk);
+
+        /**
+         * Delete the vbo of all chunks and remove all chunks.
+         */
+        void clear_chunks();
+
     private:
         // Static map that stores all FontContext (corresponding to OpenGL context).
         static std::map<QOpenGLContext*, std::shared_ptr<FontContext>> contexts;
@@ -298,9 +411,11 @@ namespace degate
 
         std::shared_ptr<FontContext> font_context = nullptr;
         QWidget* parent = nullptr;
-        GLuint vbo = 0;
         QOpenGLVertexArrayObject vao;
         unsigned total_size = 0;
+        std::vector<TextGlyphInstance> glyphs;
+        std::map<unsigned, TextBlock> blocks;
+        std::map<std::pair<long, long>, TextChunk> chunks;
         Font font;
         std::weak_ptr<FontContextData> font_context_data;
     };
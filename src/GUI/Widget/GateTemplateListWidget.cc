@@ -20,13 +20,18 @@
  */
 
 #include "GateTemplateListWidget.h"
+#include "Core/LogicModel/Gate/GateTemplate.h"
+
+#include <QImageReader>
+#include <QPixmap>
 
 #include <utility>
 
 namespace degate
 {
-    GateTemplateListWidget::GateTemplateListWidget(QWidget* parent, Project_shptr project, bool unique_selection)
-            : QTableWidget(parent), project(std::move(project))
+    GateTemplateListWidget::GateTemplateListWidget(QWidget* parent, Project_shptr project, bool unique_selection,
+                                                   bool show_thumbnails)
+            : QTableWidget(parent), project(std::move(project)), show_thumbnails(show_thumbnails)
     {
         setColumnCount(3);
         QStringList list;
@@ -38,6 +43,9 @@ namespace degate
         resizeRowsToContents();
         setSelectionBehavior(SelectRows);
 
+        if (show_thumbnails)
+            setIconSize(QSize(GATE_TEMPLATE_THUMBNAIL_SIZE, GATE_TEMPLATE_THUMBNAIL_SIZE));
+
         if (unique_selection)
             setSelectionMode(SelectionMode::SingleSelection);
         else
@@ -111,6 +119,8 @@ namespace degate
             // Name
             auto name_item = new QTableWidgetItem(QString::fromStdString(gate->get_name()));
             name_item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+            if (show_thumbnails)
+                name_item->setIcon(get_thumbnail(gate));
             setItem(rowCount() - 1, 1, name_item);
 
             // Description
@@ -122,4 +132,58 @@ namespace degate
         resizeColumnsToContents();
         resizeRowsToContents();
     }
+
+    QIcon GateTemplateListWidget::get_thumbnail(GateTemplate_shptr const& gate)
+    {
+        for (auto layer_type : {Layer::LOGIC, Layer::TRANSISTOR, Layer::METAL})
+        {
+            if (!gate->has_image(layer_type))
+                continue;
+
+            const unsigned int version = gate->get_image_version(layer_type);
+
+            const auto key = std::make_pair(gate->get_object_id(), layer_type);
+
+            auto found = thumbnails.find(key);
+            if (found != thumbnails.end() && found->second.first == version)
+                return found->second.second;
+
+            QImage image;
+            const std::string file = gate->get_image_file(layer_type);
+
+            if (!file.empty())
+            {
+                // Read from the file, so that the template image is not loaded.
+                QImageReader reader(QString::fromStdString(file));
+                reader.setScaledSize(reader.size().scaled(GATE_TEMPLATE_THUMBNAIL_SIZE,
+                                                          GATE_TEMPLATE_THUMBNAIL_SIZE,
+                                                          Qt::KeepAspectRatio));
+                image = reader.read();
+            }
+            else
+            {
+                GateTemplateImage_shptr img = gate->get_image(layer_type);
+
+                image = QImage(static_cast<int>(img->get_width()), static_cast<int>(img->get_height()), QImage::Format_ARGB32);
+                for (unsigned int y = 0; y < img->get_height(); y++)
+                {
+                    for (unsigned int x = 0; x < img->get_width(); x++)
+                    {
+                        rgba_pixel_t p = img->get_pixel_as<rgba_pixel_t>(x, y);
+                        image.setPixel(x, y, qRgba(MASK_R(p), MASK_G(p), MASK_B(p), MASK_A(p)));
+                    }
+                }
+
+                image = image.scaled(GATE_TEMPLATE_THUMBNAIL_SIZE, GATE_TEMPLATE_THUMBNAIL_SIZE,
+                                     Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            }
+
+            QIcon thumbnail(QPixmap::fromImage(image));
+            thumbnails[key] = std::make_pair(version, thumbnail);
+
+            return thumbnail;
+        }
+
+        return QIcon();
+    }
 }
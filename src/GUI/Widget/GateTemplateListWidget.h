@@ -24,9 +24,14 @@
 
 #include "Core/Project/Project.h"
 
+#include <QIcon>
 #include <QTableWidget>
+#include <map>
+#include <utility>
 #include <vector>
 
+#define GATE_TEMPLATE_THUMBNAIL_SIZE 48
+
 namespace degate
 {
     /**
@@ -47,8 +52,10 @@ namespace degate
          * @param parent : the parent of the widget.
          * @param project : the current active project.
          * @param unique_selection : if true allow only one selection at a time.
+         * @param show_thumbnails : if true show a thumbnail of the template images.
          */
-        GateTemplateListWidget(QWidget* parent, Project_shptr project, bool unique_selection = true);
+        GateTemplateListWidget(QWidget* parent, Project_shptr project, bool unique_selection = true,
+                               bool show_thumbnails = false);
         ~GateTemplateListWidget() override = default;
 
         /**
@@ -79,7 +86,20 @@ namespace degate
         void update_list();
 
     private:
+
+        /**
+         * Get the thumbnail of a gate template, it is created if needed.
+         *
+         * @param gate : the gate template.
+         * @return Returns the thumbnail or a null icon if the template has no image.
+         */
+        QIcon get_thumbnail(GateTemplate_shptr const& gate);
+
         Project_shptr project;
+        bool show_thumbnails;
+
+        // Thumbnails by template and layer type, with the version of the image they were created from.
+        std::map<std::pair<object_id_t, Layer::LAYER_TYPE>, std::pair<unsigned int, QIcon>> thumbnails;
 
     };
 }
@@ -24,6 +24,7 @@
 #include "Core/Image/ImageHelper.h"
 #include "Core/LogicModel/LogicModelHelper.h"
 #include "GUI/Dialog/ProgressDialog.h"
+#include "GUI/Dialog/ColorPickerDialog.h"
 #include "GUI/Preferences/ThemeManager.h"
 
 #include <memory>
@@ -105,6 +106,52 @@ namespace degate
         state = value;
     }
 
+    LayerTintSelectionButton::LayerTintSelectionButton(QWidget* parent, color_t tint)
+            : QPushButton(parent), tint(tint)
+    {
+        update_button();
+
+        QObject::connect(this, SIGNAL(clicked()), this, SLOT(on_button_clicked()));
+    }
+
+    LayerTintSelectionButton::LayerTintSelectionButton(LayerTintSelectionButton& copy)
+            : QPushButton(copy.parentWidget()), tint(copy.get_tint())
+    {
+        update_button();
+
+        QObject::connect(this, SIGNAL(clicked()), this, SLOT(on_button_clicked()));
+    }
+
+    color_t LayerTintSelectionButton::get_tint() const
+    {
+        return tint;
+    }
+
+    void LayerTintSelectionButton::on_button_clicked()
+    {
+        ColorPickerDialog dialog(this, tint);
+
+        if (dialog.exec() != QDialog::Accepted)
+            return;
+
+        tint = dialog.get_color();
+        update_button();
+    }
+
+    void LayerTintSelectionButton::update_button()
+    {
+        if (MASK_A(tint) == 0)
+        {
+            setStyleSheet("");
+            setText(tr("No tint"));
+        }
+        else
+        {
+            setStyleSheet(QString("background-color: rgba(%1, %2, %3, %4)").arg(MASK_R(tint)).arg(MASK_G(tint)).arg(MASK_B(tint)).arg(MASK_A(tint)));
+            setText(tr("Tint"));
+        }
+    }
+
     LayerTypeSelectionBox::LayerTypeSelectionBox(Layer::LAYER_TYPE type, QWidget* parent)
             : QComboBox(parent), type(type)
     {
@@ -156,13 +203,16 @@ namespace degate
             : QWidget(parent), project(project)
     {
         // List
-        layers.setColumnCount(5);
+        layers.setColumnCount(8);
         QStringList list;
         list.append(tr("ID"));
         list.append(tr("Enable"));
         list.append(tr("Description"));
         list.append(tr("Type"));
         list.append(tr("Background"));
+        list.append(tr("Composite"));
+        list.append(tr("Opacity (%)"));
+        list.append(tr("Tint"));
         layers.setHorizontalHeaderLabels(list);
         layers.setSelectionBehavior(QTableView::SelectRows);
         layers.setSelectionMode(QTableView::SingleSelection);
@@ -222,6 +272,19 @@ namespace degate
                 // Background
                 auto bb = new LayerBackgroundSelectionButton(this, layer);
                 layers.setCellWidget(layers.rowCount() - 1, 4, bb);
+
+                // Composition
+                auto composited = new QTableWidgetItem();
+                composited->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
+                composited->setCheckState(layer->is_composited() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
+                layers.setItem(layers.rowCount() - 1, 5, composited);
+
+                layers.setItem(layers.rowCount() - 1,
+                               6,
+                               new QTableWidgetItem(QString::number(qRound(layer->get_composition_opacity() * 100))));
+
+                auto tb = new LayerTintSelectionButton(this, layer->get_composition_tint());
+                layers.setCellWidget(layers.rowCount() - 1, 7, tb);
             }
         }
 
@@ -302,6 +365,17 @@ namespace degate
         auto bb = new LayerBackgroundSelectionButton(this, nullptr);
         layers.setCellWidget(layers.rowCount() - 1, 4, bb);
 
+        // Composition
+        auto composited = new QTableWidgetItem();
+        composited->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
+        composited->setCheckState(Qt::CheckState::Unchecked);
+        layers.setItem(layers.rowCount() - 1, 5, composited);
+
+        layers.setItem(layers.rowCount() - 1, 6, new QTableWidgetItem("50"));
+
+        auto tb = new LayerTintSelectionButton(this, 0);
+        layers.setCellWidget(layers.rowCount() - 1, 7, tb);
+
         layers.selectRow(layers.rowCount() - 1);
     }
 
@@ -356,6 +430,16 @@ namespace degate
             // Type
             layer->set_layer_type(dynamic_cast<LayerTypeSelectionBox*>(layers.cellWidget(i, 3))->get_layer_type());
 
+            // Composition
+            layer->set_composited(layers.item(i, 5)->checkState() == Qt::CheckState::Checked);
+
+            bool opacity_ok = false;
+            int opacity = layers.item(i, 6)->text().toInt(&opacity_ok);
+            if (opacity_ok)
+                layer->set_composition_opacity(static_cast<float>(opacity) / 100.0f);
+
+            layer->set_composition_tint(dynamic_cast<LayerTintSelectionButton*>(layers.cellWidget(i, 7))->get_tint());
+
             // Image
             LayerBackgroundSelectionButton* background = dynamic_cast<LayerBackgroundSelectionButton*>(layers.cellWidget(i, 4));
 
@@ -472,6 +556,9 @@ namespace degate
             source.description = layers.takeItem(row_index, 2);
             source.type = new LayerTypeSelectionBox(*dynamic_cast<LayerTypeSelectionBox*>(layers.cellWidget(row_index, 3)));
             source.background = new LayerBackgroundSelectionButton(*dynamic_cast<LayerBackgroundSelectionButton*>(layers.cellWidget(row_index, 4)));
+            source.composited = layers.takeItem(row_index, 5);
+            source.opacity = layers.takeItem(row_index, 6);
+            source.tint = new LayerTintSelectionButton(*dynamic_cast<LayerTintSelectionButton*>(layers.cellWidget(row_index, 7)));
 
             // Get destination
             destination.id = layers.takeItem(row_index - 1, 0);
@@ -479,6 +566,9 @@ namespace degate
             destination.description = layers.takeItem(row_index - 1, 2);
             destination.type = new LayerTypeSelectionBox(*dynamic_cast<LayerTypeSelectionBox*>(layers.cellWidget(row_index - 1, 3)));
             destination.background = new LayerBackgroundSelectionButton(*dynamic_cast<LayerBackgroundSelectionButton*>(layers.cellWidget(row_index - 1, 4)));
+            destination.composited = layers.takeItem(row_index - 1, 5);
+            destination.opacity = layers.takeItem(row_index - 1, 6);
+            destination.tint = new LayerTintSelectionButton(*dynamic_cast<LayerTintSelectionButton*>(layers.cellWidget(row_index - 1, 7)));
 
 
             // Set new source
@@ -487,6 +577,9 @@ namespace degate
             layers.setItem(row_index - 1, 2, source.description);
             layers.setCellWidget(row_index - 1, 3, source.type);
             layers.setCellWidget(row_index - 1, 4, source.background);
+            layers.setItem(row_index - 1, 5, source.composited);
+            layers.setItem(row_index - 1, 6, source.opacity);
+            layers.setCellWidget(row_index - 1, 7, source.tint);
 
             // Set new destination
             layers.setItem(row_index, 0, destination.id);
@@ -494,6 +587,9 @@ namespace degate
             layers.setItem(row_index, 2, destination.description);
             layers.setCellWidget(row_index, 3, destination.type);
             layers.setCellWidget(row_index, 4, destination.background);
+            layers.setItem(row_index, 5, destination.composited);
+            layers.setItem(row_index, 6, destination.opacity);
+            layers.setCellWidget(row_index, 7, destination.tint);
 
             layers.selectRow(row_index - 1);
         }
@@ -508,6 +604,9 @@ namespace degate
             source.description = layers.takeItem(row_index, 2);
             source.type = new LayerTypeSelectionBox(*dynamic_cast<LayerTypeSelectionBox*>(layers.cellWidget(row_index, 3)));
             source.background = new LayerBackgroundSelectionButton(*dynamic_cast<LayerBackgroundSelectionButton*>(layers.cellWidget(row_index, 4)));
+            source.composited = layers.takeItem(row_index, 5);
+            source.opacity = layers.takeItem(row_index, 6);
+            source.tint = new LayerTintSelectionButton(*dynamic_cast<LayerTintSelectionButton*>(layers.cellWidget(row_index, 7)));
 
             // Get destination
             destination.id = layers.takeItem(row_index + 1, 0);
@@ -515,6 +614,9 @@ namespace degate
             destination.description = layers.takeItem(row_index + 1, 2);
             destination.type = new LayerTypeSelectionBox(*dynamic_cast<LayerTypeSelectionBox*>(layers.cellWidget(row_index + 1, 3)));
             destination.background = new LayerBackgroundSelectionButton(*dynamic_cast<LayerBackgroundSelectionButton*>(layers.cellWidget(row_index + 1, 4)));
+            destination.composited = layers.takeItem(row_index + 1, 5);
+            destination.opacity = layers.takeItem(row_index + 1, 6);
+            destination.tint = new LayerTintSelectionButton(*dynamic_cast<LayerTintSelectionButton*>(layers.cellWidget(row_index + 1, 7)));
 
 
             // Set new source
@@ -523,6 +625,9 @@ namespace degate
             layers.setItem(row_index + 1, 2, source.description);
             layers.setCellWidget(row_index + 1, 3, source.type);
             layers.setCellWidget(row_index + 1, 4, source.background);
+            layers.setItem(row_index + 1, 5, source.composited);
+            layers.setItem(row_index + 1, 6, source.opacity);
+            layers.setCellWidget(row_index + 1, 7, source.tint);
 
             // Set new destination
             layers.setItem(row_index, 0, destination.id);
@@ -530,6 +635,9 @@ namespace degate
             layers.setItem(row_index, 2, destination.description);
             layers.setCellWidget(row_index, 3, destination.type);
             layers.setCellWidget(row_index, 4, destination.background);
+            layers.setItem(row_index, 5, destination.composited);
+            layers.setItem(row_index, 6, destination.opacity);
+            layers.setCellWidget(row_index, 7, destination.tint);
 
             layers.selectRow(row_index + 1);
         }
@@ -116,6 +116,50 @@ namespace degate
      *
      * @see QComboBox
      */
+    /**
+     * @class LayerTintSelectionButton
+     * @brief Button to select the tint of a layer when layers are composited.
+     *
+     * @see QPushButton
+     */
+    class LayerTintSelectionButton : public QPushButton
+    {
+        Q_OBJECT
+
+    public:
+
+        /**
+         * Create the layer tint selection button.
+         *
+         * @param parent : the parent of the button.
+         * @param tint : the current tint (the alpha channel is the tint strength).
+         */
+        LayerTintSelectionButton(QWidget* parent, color_t tint);
+
+        /**
+         * Create the layer tint selection button from another one (copy).
+         *
+         * @param copy : the other button to copy.
+         */
+        LayerTintSelectionButton(LayerTintSelectionButton& copy);
+        ~LayerTintSelectionButton() override = default;
+
+        /**
+         * Get the selected tint.
+         */
+        color_t get_tint() const;
+
+    private slots:
+
+        void on_button_clicked();
+
+    private:
+        void update_button();
+
+        color_t tint;
+
+    };
+
     class LayerTypeSelectionBox : public QComboBox
     {
         Q_OBJECT
@@ -171,6 +215,9 @@ namespace degate
         QTableWidgetItem* description; /*!< The item representing the description of the layer. */
         LayerTypeSelectionBox* type; /*!< The box representing the type of the layer. */
         LayerBackgroundSelectionButton* background; /*!< The background selection button of the layer. */
+        QTableWidgetItem* composited; /*!< The item representing the composition state of the layer. */
+        QTableWidgetItem* opacity; /*!< The item representing the composition opacity of the layer. */
+        LayerTintSelectionButton* tint; /*!< The composition tint selection button of the layer. */
     };
 
     /**
@@ -21,6 +21,7 @@
 
 #include "WorkspaceBackground.h"
 #include "GUI/Workspace/WorkspaceNotifier.h"
+#include "GUI/Preferences/PreferencesHandler.h"
 
 #include <algorithm>
 
@@ -28,12 +29,6 @@
 
 namespace degate
 {
-    struct BackgroundVertex2D
-    {
-        QVector2D pos;
-        QVector2D texCoord;
-    };
-
     /**
      * Calculate the lower offset to top or left for a tile.
      */
@@ -59,6 +54,12 @@ namespace degate
     {
         WorkspaceNotifier::get_instance().undefine(WorkspaceTarget::WorkspaceBackground);
         free_textures();
+
+        if (QOpenGLContext::currentContext() == nullptr || context == nullptr)
+            return;
+
+        for (auto& slot : slots)
+            context->glDeleteBuffers(1, &slot.pbo);
     }
 
     void WorkspaceBackground::init()
@@ -70,12 +71,18 @@ namespace degate
             "#version 330 core\n"
             "in vec2 pos;\n"
             "in vec2 texCoord;\n"
+            "in vec4 tint;\n"
+            "in float opacity;\n"
             "uniform mat4 mvp;\n"
             "out vec2 texCoord0;\n"
+            "out vec4 tint0;\n"
+            "out float opacity0;\n"
             "void main(void)\n"
             "{\n"
             "    gl_Position = mvp * vec4(pos, 0.0, 1.0);\n"
             "    texCoord0 = texCoord;\n"
+            "    tint0 = tint;\n"
+            "    opacity0 = opacity;\n"
             "}\n";
         vshader->compileSourceCode(vsrc);
 
@@ -84,10 +91,14 @@ namespace degate
             "#version 330 core\n"
             "uniform sampler2D u_texture;\n"
             "in vec2 texCoord0;\n"
+            "in vec4 tint0;\n"
+            "in float opacity0;\n"
             "out vec4 color;\n"
             "void main(void)\n"
             "{\n"
-            "    color = texture(u_texture, texCoord0);\n"
+            "    vec4 image = texture(u_texture, texCoord0);\n"
+            "    float luminance = dot(image.rgb, vec3(0.299, 0.587, 0.114));\n"
+            "    color = vec4(mix(image.rgb, luminance * tint0.rgb, tint0.a), image.a * opacity0);\n"
             "}\n";
         fshader->compileSourceCode(fsrc);
 
@@ -100,61 +111,144 @@ namespace degate
 
         program->link();
 
+        // Pixel buffer objects are part of OpenGL 3.x functions.
+        extra_context = QOpenGLContext::currentContext()->extraFunctions();
+
+        for (auto& slot : slots)
+        {
+            context->glGenBuffers(1, &slot.pbo);
+
+            // A tile is ready, upload it with the next frame.
+            QObject::connect(&slot.watcher, &QFutureWatcher<bool>::finished, [this]()
+            {
+                if (parent != nullptr)
+                    parent->update();
+            });
+        }
+
         WorkspaceNotifier::get_instance().define(WorkspaceTarget::WorkspaceBackground, WorkspaceNotification::Update, std::bind(&WorkspaceBackground::update, this));
     }
 
-    // TODO: Full update on each call, should now what changed and update only what's needed.
-    //       Like save elem and compare, and {min,max}* : compare to know if something need to update.
     void WorkspaceBackground::update()
     {
-        free_textures();
-
         if (project == nullptr)
+        {
+            free_textures();
             return;
+        }
 
         assert(context->glGetError() == GL_NO_ERROR);
 
-        auto smgr = project->get_logic_model()->get_current_layer()->get_scaling_manager();
+        // Drawn layers: the current layer, then composited layers (by position).
+        std::vector<Layer_shptr> layers{project->get_logic_model()->get_current_layer()};
+        if (composite)
+        {
+            for (auto iter = project->get_logic_model()->layers_begin(); iter != project->get_logic_model()->layers_end(); ++iter)
+            {
+                if (*iter != nullptr && *iter != layers.front() && (*iter)->is_composited())
+                    layers.push_back(*iter);
+            }
+        }
 
-        if (smgr == nullptr)
-            return;
+        std::vector<BackgroundLayerView> views;
+        for (auto& layer : layers)
+        {
+            auto smgr = layer->get_scaling_manager();
 
-        auto elem = smgr->get_image(scale);
+            if (smgr == nullptr)
+                continue;
 
-        background_image = elem.second;
-        assert(background_image != nullptr);
+            auto elem = smgr->get_image(scale);
+            assert(elem.second != nullptr);
 
-        float pre_scale = static_cast<float>(elem.first);
+            float pre_scale = static_cast<float>(elem.first);
+            const unsigned int tile_size = elem.second->get_tile_size();
 
-        unsigned int // scaled coordinates
-        min_x = to_lower_tile_offset(std::max<int>(std::floor(viewport_min_x / pre_scale), 0), background_image->get_tile_size()),
-        max_x = to_upper_tile_offset(std::min<int>(std::max<int>(std::ceil(viewport_max_x / pre_scale), 0), std::ceil(project->get_logic_model()->get_width() / pre_scale)), background_image->get_tile_size()),
-        min_y = to_lower_tile_offset(std::max<int>(std::floor(viewport_min_y) / pre_scale, 0), background_image->get_tile_size()),
-        max_y = to_upper_tile_offset(std::min<int>(std::max<int>(std::ceil(viewport_max_y / pre_scale), 0), std::ceil(project->get_logic_model()->get_height() / pre_scale)), background_image->get_tile_size());
+            BackgroundLayerView view;
+            view.layer = layer->get_layer_id();
+            view.scaling_manager = smgr;
+            view.image = elem.second;
+            view.scaling = pre_scale;
+            view.opacity = view.layer == layers.front()->get_layer_id() ? 1.0f : layer->get_composition_opacity();
+            view.tint = view.layer == layers.front()->get_layer_id() ? 0 : layer->get_composition_tint();
 
-        tile_count = std::ceil((max_x - min_x) / static_cast<float>(background_image->get_tile_size())) *
-                     std::ceil((max_y - min_y) / static_cast<float>(background_image->get_tile_size()));
+            // Scaled coordinates.
+            view.min_x = to_lower_tile_offset(std::max<int>(std::floor(viewport_min_x / pre_scale), 0), tile_size);
+            view.max_x = to_upper_tile_offset(std::min<int>(std::max<int>(std::ceil(viewport_max_x / pre_scale), 0), std::ceil(project->get_logic_model()->get_width() / pre_scale)), tile_size);
+            view.min_y = to_lower_tile_offset(std::max<int>(std::floor(viewport_min_y) / pre_scale, 0), tile_size);
+            view.max_y = to_upper_tile_offset(std::min<int>(std::max<int>(std::ceil(viewport_max_y / pre_scale), 0), std::ceil(project->get_logic_model()->get_height() / pre_scale)), tile_size);
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            views.push_back(view);
+        }
 
-        context->glBufferData(GL_ARRAY_BUFFER, tile_count * 6 * sizeof(BackgroundVertex2D), nullptr, GL_STATIC_DRAW);
+        if (views.empty())
+        {
+            visible_layers.clear();
+            pending_tiles.clear();
+            background_textures.clear();
+            return;
+        }
 
-        unsigned index = 0;
-        for (unsigned int x = min_x; x < max_x; x += background_image->get_tile_size())
+        background_image = views.front().image;
+
+        // Same visible tiles, with all of them available: nothing to do.
+        if (!visible_missing && views == visible_layers)
+            return;
+
+        visible_layers = views;
+        visible_missing = false;
+
+        update_count++;
+
+        pending_tiles.clear();
+        std::vector<BackgroundTileRequest> placeholders;
+
+        for (auto& view : visible_layers)
         {
-            for (unsigned int y = min_y; y < max_y; y += background_image->get_tile_size())
+            const unsigned int tile_size = view.image->get_tile_size();
+
+            // The coarser scaling level, streamed first to be used as placeholder.
+            auto coarser = view.scaling_manager->get_image(view.scaling * 2);
+            const bool has_coarser = static_cast<float>(coarser.first) == view.scaling * 2;
+
+            for (unsigned int x = view.min_x; x < view.max_x; x += tile_size)
             {
-                background_textures.push_back(create_background_tile(x, y, elem.first, index));
+                for (unsigned int y = view.min_y; y < view.max_y; y += tile_size)
+                {
+                    BackgroundTileKey key{view.layer, view.scaling, x, y};
+                    view.tiles.push_back(key);
+
+                    if (get_tile_texture(key, view.image) != 0 || is_streaming(key))
+                        continue;
+
+                    pending_tiles.push_back({key, view.image});
+                    visible_missing = true;
+
+                    if (!has_coarser)
+                        continue;
+
+                    BackgroundTileKey coarser_key{key.layer,
+                                                  static_cast<float>(coarser.first),
+                                                  to_lower_tile_offset(x / 2, coarser.second->get_tile_size()),
+                                                  to_lower_tile_offset(y / 2, coarser.second->get_tile_size())};
+
+                    if (get_tile_texture(coarser_key, coarser.second) != 0 || is_streaming(coarser_key))
+                        continue;
+
+                    auto found = std::find_if(placeholders.begin(), placeholders.end(), [&](const BackgroundTileRequest& request)
+                    {
+                        return request.key == coarser_key;
+                    });
 
-                index++;
+                    if (found == placeholders.end())
+                        placeholders.push_back({coarser_key, coarser.second});
+                }
             }
         }
 
-        assert(index == tile_count);
+        pending_tiles.insert(pending_tiles.begin(), placeholders.begin(), placeholders.end());
 
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        draw_list_dirty = true;
 
         assert(context->glGetError() == GL_NO_ERROR);
 
@@ -176,6 +270,11 @@ namespace degate
         if (project == nullptr)
             return;
 
+        stream();
+
+        if (draw_list_dirty)
+            build_draw_list();
+
         program->bind();
 
         program->setUniformValue("mvp", projection);
@@ -189,6 +288,12 @@ namespace degate
         program->enableAttributeArray("texCoord");
         program->setAttributeBuffer("texCoord", GL_FLOAT, 2 * sizeof(float), 2, sizeof(BackgroundVertex2D));
 
+        program->enableAttributeArray("tint");
+        program->setAttributeBuffer("tint", GL_FLOAT, 4 * sizeof(float), 4, sizeof(BackgroundVertex2D));
+
+        program->enableAttributeArray("opacity");
+        program->setAttributeBuffer("opacity", GL_FLOAT, 8 * sizeof(float), 1, sizeof(BackgroundVertex2D));
+
         unsigned index = 0;
         for (auto& e : background_textures)
         {
@@ -208,12 +313,28 @@ namespace degate
 
     void WorkspaceBackground::free_textures()
     {
-        if (background_textures.empty())
+        if (context == nullptr)
             return;
 
-        context->glDeleteTextures(static_cast<GLsizei>(background_textures.size()), &background_textures[0]);
+        stop_streaming();
 
+        pending_tiles.clear();
+        visible_layers.clear();
         background_textures.clear();
+        visible_missing = false;
+
+        if (tile_textures.empty())
+            return;
+
+        for (auto& e : tile_textures)
+            context->glDeleteTextures(1, &e.second.texture);
+
+        tile_textures.clear();
+    }
+
+    void WorkspaceBackground::set_composite(bool value)
+    {
+        composite = value;
     }
 
     void WorkspaceBackground::update_viewport(float min_x, float max_x, float min_y, float max_y, float width, float height)
@@ -231,91 +352,357 @@ namespace degate
         update();
     }
 
-    GLuint WorkspaceBackground::create_background_tile(unsigned x, unsigned y, float pre_scaling, unsigned index)
+    GLuint WorkspaceBackground::get_tile_texture(const BackgroundTileKey& key, const BackgroundImage_shptr& image)
     {
-        assert(project != nullptr);
-        assert(background_image != nullptr);
+        auto found = tile_textures.find(key);
+        if (found == tile_textures.end())
+            return 0;
 
-        auto data = background_image->data(x, y);
+        // Created from another image of the layer (the layer image was changed).
+        if (found->second.image.lock() != image)
+            return 0;
 
-        assert(data != nullptr);
+        found->second.last_used = update_count;
 
-        const unsigned int tile_width = background_image->get_tile_size();
+        return found->second.texture;
+    }
 
-        // Real pixel coordinates
-        float min_x = (static_cast<float>(x)) * pre_scaling;
-        float min_y = (static_cast<float>(y)) * pre_scaling;
-        float max_x = min_x + static_cast<float>(tile_width) * pre_scaling;
-        float max_y = min_y + static_cast<float>(tile_width) * pre_scaling;
+    bool WorkspaceBackground::is_streaming(const BackgroundTileKey& key) const
+    {
+        for (auto& slot : slots)
+        {
+            if (slot.busy && slot.request.key == key)
+                return true;
+        }
 
+        return false;
+    }
 
-        // Texture
+    void WorkspaceBackground::stream()
+    {
+        if (extra_context == nullptr)
+            return;
 
-        GLuint texture = 0;
+        // Upload ready tiles, under the frame budget.
+        std::size_t uploaded = 0;
+        bool remaining = false;
+        for (auto& slot : slots)
+        {
+            if (!slot.busy || !(slot.copied || slot.watcher.isFinished()))
+                continue;
 
-        context->glGenTextures(1, &texture);
-        assert(context->glGetError() == GL_NO_ERROR);
+            if (uploaded >= BACKGROUND_UPLOAD_BUDGET)
+            {
+                remaining = true;
+                break;
+            }
 
-        context->glBindTexture(GL_TEXTURE_2D, texture);
-        assert(context->glGetError() == GL_NO_ERROR);
+            uploaded += upload(slot);
+        }
 
-        context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        assert(context->glGetError() == GL_NO_ERROR);
+        // Start streaming pending tiles in free slots.
+        for (auto& slot : slots)
+        {
+            if (slot.busy)
+                continue;
 
-        context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        assert(context->glGetError() == GL_NO_ERROR);
+            while (!pending_tiles.empty())
+            {
+                auto request = pending_tiles.front();
+                pending_tiles.pop_front();
 
-        context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        assert(context->glGetError() == GL_NO_ERROR);
+                if (dispatch(slot, request))
+                    break;
+            }
 
-        context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        assert(context->glGetError() == GL_NO_ERROR);
+            if (slot.busy && slot.copied)
+                remaining = true;
+        }
 
-        //context->glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE);
-        assert(context->glGetError() == GL_NO_ERROR);
+        // Ready tiles left for the next frame.
+        if (remaining && parent != nullptr)
+            parent->update();
+    }
 
-        context->glTexImage2D(GL_TEXTURE_2D,
-                     0, // level
-                     GL_RGBA, // BGRA,
-                     tile_width, tile_width,
-                     0, // border
-                     GL_RGBA,
-                     GL_UNSIGNED_BYTE,
-                     data);
-        assert(context->glGetError() == GL_NO_ERROR);
+    bool WorkspaceBackground::dispatch(BackgroundStreamingSlot& slot, const BackgroundTileRequest& request)
+    {
+        assert(!slot.busy);
 
-        context->glBindTexture(GL_TEXTURE_2D, 0);
+        auto image = request.image;
+        const unsigned int x = request.key.x;
+        const unsigned int y = request.key.y;
 
+        if (get_tile_texture(request.key, image) != 0)
+            return false;
 
-        // Vertices
+        // With async loading, the tile cache loads the tile itself and asks for a background update once done
+        // (the tile is still missing, so it will be requested again).
+        if (image->is_async() && !image->is_loaded(x, y))
+            return false;
 
-        BackgroundVertex2D temp;
+        const std::size_t size = static_cast<std::size_t>(image->get_tile_size()) * image->get_tile_size() * sizeof(rgba_pixel_t);
 
-        temp.pos = QVector2D(min_x, min_y);
-        temp.texCoord = QVector2D(0, 0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(BackgroundVertex2D) + 0 * sizeof(BackgroundVertex2D), sizeof(BackgroundVertex2D), &temp);
+        extra_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+        extra_context->glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        void* buffer = extra_context->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        extra_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-        temp.pos = QVector2D(max_x, min_y);
-        temp.texCoord = QVector2D(1, 0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(BackgroundVertex2D) + 1 * sizeof(BackgroundVertex2D), sizeof(BackgroundVertex2D), &temp);
+        if (buffer == nullptr)
+        {
+            debug(TM, "Can't map a pixel buffer object to stream a background tile.");
+            return false;
+        }
 
-        temp.pos = QVector2D(min_x, max_y);
-        temp.texCoord = QVector2D(0, 1);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(BackgroundVertex2D) + 2 * sizeof(BackgroundVertex2D), sizeof(BackgroundVertex2D), &temp);
+        slot.busy = true;
+        slot.request = request;
 
-        temp.pos = QVector2D(max_x, min_y);
-        temp.texCoord = QVector2D(1, 0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(BackgroundVertex2D) + 3 * sizeof(BackgroundVertex2D), sizeof(BackgroundVertex2D), &temp);
+        if (image->is_async())
+        {
+            // Already in memory, no need for a worker.
+            image->raw_copy(buffer, x, y);
+            slot.copied = true;
+        }
+        else
+        {
+            slot.copied = false;
+            slot.watcher.setFuture(QtConcurrent::run([image, buffer, x, y]()
+            {
+                return image->fetch_raw_copy(buffer, x, y);
+            }));
+        }
+
+        return true;
+    }
+
+    std::size_t WorkspaceBackground::upload(BackgroundStreamingSlot& slot)
+    {
+        assert(slot.busy);
+
+        const bool available = slot.copied || slot.watcher.result();
+        const auto& key = slot.request.key;
+        const auto& image = slot.request.image;
+        const unsigned int tile_width = image->get_tile_size();
+
+        extra_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+        extra_context->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        std::size_t size = 0;
+
+        if (available)
+        {
+            auto& tile = tile_textures[key];
+
+            if (tile.texture == 0)
+            {
+                context->glGenTextures(1, &tile.texture);
+                context->glBindTexture(GL_TEXTURE_2D, tile.texture);
+
+                context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            }
+            else
+            {
+                context->glBindTexture(GL_TEXTURE_2D, tile.texture);
+            }
+
+            // Source data comes from the bound pixel buffer object (offset 0).
+            context->glTexImage2D(GL_TEXTURE_2D,
+                                  0, // level
+                                  GL_RGBA, // BGRA,
+                                  tile_width, tile_width,
+                                  0, // border
+                                  GL_RGBA,
+                                  GL_UNSIGNED_BYTE,
+                                  nullptr);
+            assert(context->glGetError() == GL_NO_ERROR);
+
+            context->glBindTexture(GL_TEXTURE_2D, 0);
+
+            tile.image = image;
+            tile.last_used = update_count;
+
+            size = static_cast<std::size_t>(tile_width) * tile_width * sizeof(rgba_pixel_t);
+            draw_list_dirty = true;
+        }
+        else
+        {
+            // Removed from the tile cache while loading, try again later.
+            pending_tiles.push_back(slot.request);
+        }
+
+        extra_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        slot.busy = false;
+        slot.copied = false;
+        slot.request = BackgroundTileRequest();
+
+        return size;
+    }
+
+    void WorkspaceBackground::stop_streaming()
+    {
+        if (extra_context == nullptr)
+            return;
+
+        for (auto& slot : slots)
+        {
+            if (!slot.busy)
+                continue;
+
+            // The worker writes in the mapped buffer.
+            slot.watcher.waitForFinished();
+
+            extra_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+            extra_context->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            extra_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            slot.busy = false;
+            slot.copied = false;
+            slot.request = BackgroundTileRequest();
+        }
+    }
 
-        temp.pos = QVector2D(min_x, max_y);
-        temp.texCoord = QVector2D(0, 1);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(BackgroundVertex2D) + 4 * sizeof(BackgroundVertex2D), sizeof(BackgroundVertex2D), &temp);
+    void WorkspaceBackground::build_draw_list()
+    {
+        draw_list_dirty = false;
+
+        struct DrawnTile
+        {
+            GLuint texture;
+            QVector2D min, max;             // Real pixel coordinates.
+            QVector2D tex_min, tex_max;     // Texture coordinates.
+            QVector4D tint;
+            float opacity;
+        };
 
-        temp.pos = QVector2D(max_x, max_y);
-        temp.texCoord = QVector2D(1, 1);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(BackgroundVertex2D) + 5 * sizeof(BackgroundVertex2D), sizeof(BackgroundVertex2D), &temp);
+        std::vector<DrawnTile> drawn_tiles;
 
+        for (auto& view : visible_layers)
+        {
+            const QVector4D tint(MASK_R(view.tint) / 255.0, MASK_G(view.tint) / 255.0, MASK_B(view.tint) / 255.0, MASK_A(view.tint) / 255.0);
+
+            for (auto& key : view.tiles)
+            {
+                const float tile_width = static_cast<float>(view.image->get_tile_size());
+
+                DrawnTile tile;
+                tile.min = QVector2D(key.x * key.scaling, key.y * key.scaling);
+                tile.max = tile.min + QVector2D(tile_width * key.scaling, tile_width * key.scaling);
+                tile.tex_min = QVector2D(0, 0);
+                tile.tex_max = QVector2D(1, 1);
+                tile.tint = tint;
+                tile.opacity = view.opacity;
+                tile.texture = get_tile_texture(key, view.image);
+
+                // Placeholder: the part of a coarser tile covering the same area.
+                for (float level = key.scaling * 2; tile.texture == 0; level *= 2)
+                {
+                    auto coarser = view.scaling_manager->get_image(level);
+                    if (static_cast<float>(coarser.first) != level)
+                        break;
+
+                    const float coarser_tile_width = static_cast<float>(coarser.second->get_tile_size());
+
+                    // Scaled coordinates in the coarser image.
+                    const float x = key.x * key.scaling / level;
+                    const float y = key.y * key.scaling / level;
+
+                    BackgroundTileKey coarser_key{key.layer,
+                                                  level,
+                                                  to_lower_tile_offset(static_cast<unsigned int>(x), coarser.second->get_tile_size()),
+                                                  to_lower_tile_offset(static_cast<unsigned int>(y), coarser.second->get_tile_size())};
+
+                    tile.texture = get_tile_texture(coarser_key, coarser.second);
+
+                    const QVector2D offset((x - coarser_key.x) / coarser_tile_width, (y - coarser_key.y) / coarser_tile_width);
+                    const float extent = tile_width * key.scaling / level / coarser_tile_width;
+
+                    tile.tex_min = offset;
+                    tile.tex_max = offset + QVector2D(extent, extent);
+                }
+
+                if (tile.texture != 0)
+                    drawn_tiles.push_back(tile);
+            }
+        }
+
+        // All drawn textures were marked as used.
+        evict_textures();
+
+        background_textures.clear();
+        vertices.resize(drawn_tiles.size() * 6);
 
-        return texture;
+        unsigned index = 0;
+        for (auto& tile : drawn_tiles)
+        {
+            background_textures.push_back(tile.texture);
+
+            BackgroundVertex2D temp;
+            temp.tint = tile.tint;
+            temp.opacity = tile.opacity;
+
+            BackgroundVertex2D* out = vertices.data(index * 6);
+
+            temp.pos = QVector2D(tile.min.x(), tile.min.y());
+            temp.texCoord = QVector2D(tile.tex_min.x(), tile.tex_min.y());
+            out[0] = temp;
+
+            temp.pos = QVector2D(tile.max.x(), tile.min.y());
+            temp.texCoord = QVector2D(tile.tex_max.x(), tile.tex_min.y());
+            out[1] = temp;
+            out[3] = temp;
+
+            temp.pos = QVector2D(tile.min.x(), tile.max.y());
+            temp.texCoord = QVector2D(tile.tex_min.x(), tile.tex_max.y());
+            out[2] = temp;
+            out[4] = temp;
+
+            temp.pos = QVector2D(tile.max.x(), tile.max.y());
+            temp.texCoord = QVector2D(tile.tex_max.x(), tile.tex_max.y());
+            out[5] = temp;
+
+            index++;
+        }
+
+        vao.bind();
+        vertices.upload(context, vbo);
+        vao.release();
+    }
+
+    void WorkspaceBackground::evict_textures()
+    {
+        if (background_image == nullptr)
+            return;
+
+        const std::size_t tile_width = background_image->get_tile_size();
+        const std::size_t tile_memory = tile_width * tile_width * 4;
+        const std::size_t budget = static_cast<std::size_t>(PREFERENCES_HANDLER.get_preferences().tile_texture_cache_size) * 1024 * 1024;
+
+        if (tile_textures.size() * tile_memory <= budget)
+            return;
+
+        // Oldest first, visible tiles (used by this update) are never evicted.
+        std::vector<std::map<BackgroundTileKey, BackgroundTileTexture>::iterator> candidates;
+        for (auto it = tile_textures.begin(); it != tile_textures.end(); ++it)
+        {
+            if (it->second.last_used != update_count)
+                candidates.push_back(it);
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+        {
+            return a->second.last_used < b->second.last_used;
+        });
+
+        for (auto& it : candidates)
+        {
+            if (tile_textures.size() * tile_memory <= budget)
+                break;
+
+            context->glDeleteTextures(1, &it->second.texture);
+            tile_textures.erase(it);
+        }
     }
 }
@@ -23,17 +23,121 @@
 #define __WORKSPACEBACKGROUND_H__
 
 #include "WorkspaceElement.h"
+#include "WorkspaceVertexBuffer.h"
 
+#include <deque>
+#include <map>
+#include <tuple>
 #include <vector>
 
 #include <QFuture>
 
+// Number of tiles streamed at the same time (one pixel buffer object each).
+#define BACKGROUND_STREAMING_SLOTS 8
+
+// Max amount of tile data sent to the GPU per frame (in bytes), at least one tile is sent.
+#define BACKGROUND_UPLOAD_BUDGET (16 * 1024 * 1024)
+
 namespace degate
 {
+    struct BackgroundVertex2D
+    {
+        QVector2D pos;
+        QVector2D texCoord;
+        QVector4D tint;     // Tint color, the alpha channel is the strength of the tint.
+        float opacity;
+    };
+
+    /**
+     * Identify a background tile texture.
+     */
+    struct BackgroundTileKey
+    {
+        layer_id_t layer;   /**< The layer of the tile. */
+        float scaling;      /**< The scaling level of the image (@see ScalingManager). */
+        unsigned int x;     /**< The x coordinate of the tile in the scaled image. */
+        unsigned int y;     /**< The y coordinate of the tile in the scaled image. */
+
+        inline bool operator<(const BackgroundTileKey& key) const
+        {
+            return std::tie(layer, scaling, x, y) < std::tie(key.layer, key.scaling, key.x, key.y);
+        }
+
+        inline bool operator==(const BackgroundTileKey& key) const
+        {
+            return std::tie(layer, scaling, x, y) == std::tie(key.layer, key.scaling, key.x, key.y);
+        }
+    };
+
+    /**
+     * A background tile texture kept on the GPU.
+     */
+    struct BackgroundTileTexture
+    {
+        GLuint texture = 0;
+        std::weak_ptr<BackgroundImage> image;   /**< The image used to create the texture. */
+        unsigned long last_used = 0;            /**< The last update where the tile was visible. */
+    };
+
+    /**
+     * The visible tiles of a drawn layer.
+     */
+    struct BackgroundLayerView
+    {
+        layer_id_t layer = 0;
+        ScalingManager_shptr scaling_manager = nullptr;
+        BackgroundImage_shptr image = nullptr;  /**< The image at the current scaling level. */
+        float scaling = 1;
+        float opacity = 1;
+        color_t tint = 0;
+        unsigned int min_x = 0, max_x = 0, min_y = 0, max_y = 0;    /**< Scaled coordinates of visible tiles. */
+        std::vector<BackgroundTileKey> tiles;
+
+        /**
+         * Check if two views show the same tiles, in the same way.
+         */
+        inline bool operator==(const BackgroundLayerView& view) const
+        {
+            return std::tie(layer, scaling_manager, image, scaling, opacity, tint, min_x, max_x, min_y, max_y) ==
+                   std::tie(view.layer, view.scaling_manager, view.image, view.scaling, view.opacity, view.tint, view.min_x, view.max_x, view.min_y, view.max_y);
+        }
+    };
+
+    /**
+     * A background tile waiting to be streamed.
+     */
+    struct BackgroundTileRequest
+    {
+        BackgroundTileKey key;
+        BackgroundImage_shptr image;
+    };
+
+    /**
+     * A pixel buffer object used to stream a tile.
+     */
+    struct BackgroundStreamingSlot
+    {
+        GLuint pbo = 0;
+        bool busy = false;                  /**< The pbo is mapped and filled with the request tile. */
+        bool copied = false;                /**< True if the tile was copied without worker. */
+        BackgroundTileRequest request;
+        QFutureWatcher<bool> watcher;       /**< The worker filling the pbo (sync loading only). */
+    };
 
     /**
      * @class WorkspaceBackground
      * @brief Draw the current layer image (as background).
+     *
+     * Tile textures are kept in a cache (per layer and scaling level) when the viewport
+     * changes: only newly visible tiles are uploaded. The least recently visible tiles
+     * are destroyed when the cache exceeds the size set in the preferences.
+     *
+     * Missing tiles are streamed: they are loaded by worker threads into pixel buffer
+     * objects and sent to the GPU during the next frames (@see BACKGROUND_UPLOAD_BUDGET).
+     * Until then, a tile of a coarser scaling level is drawn in place.
+     *
+     * With layers composition, tiles of composited layers are drawn over the current
+     * layer ones with the layer opacity and tint (@see Layer::set_composited).
      */
     class WorkspaceBackground : public WorkspaceElement
     {
@@ -54,22 +158,29 @@ namespace degate
         void init() override;
 
         /**
-         * Update the background (all textures are reloaded).
+         * Update the background (missing visible tiles are requested).
          */
         void update() override;
 
         /**
-         * Draw the background (all tiles will be draw).
+         * Draw the background (all tiles will be draw). Streamed tiles are uploaded first.
          *
          * @param projection : the projection matrix to apply.
          */
         void draw(const QMatrix4x4& projection) override;
 
         /**
-         * Destroy all OpenGL textures.
+         * Destroy all OpenGL textures (including cached ones) and stop streaming.
          */
         void free_textures();
 
+        /**
+         * Enable or disable layers composition.
+         *
+         * @param value : if true, composited layers are drawn over the current layer.
+         */
+        void set_composite(bool value);
+
         /**
          * Update the viewport.
          *
@@ -84,26 +195,76 @@ namespace degate
 
     private:
         /**
-         * Create a background tile (OpenGL texture and vertices).
+         * Get the cached texture of a tile.
+         *
+         * @param key : the tile key.
+         * @param image : the current image of the tile scaling level.
+         *
+         * @return Returns the OpenGL texture ID of the tile, 0 if not cached.
+         */
+        GLuint get_tile_texture(const BackgroundTileKey& key, const BackgroundImage_shptr& image);
+
+        /**
+         * Check if a tile is being streamed.
+         */
+        bool is_streaming(const BackgroundTileKey& key) const;
+
+        /**
+         * Upload the streamed tiles (under the frame budget) and start streaming pending tiles.
+         */
+        void stream();
+
+        /**
+         * Start streaming a tile in a free slot.
          *
-         * @param x
-         * @param y
-         * @param pre_scaling : scaling of the image.
-         * @param index : index of the tile.
+         * @return Returns false if the slot wasn't used.
+         */
+        bool dispatch(BackgroundStreamingSlot& slot, const BackgroundTileRequest& request);
+
+        /**
+         * Send the content of a slot to the tile texture and release the slot.
          *
-         * @return Returns the OpenGL texture ID of the tile.
+         * @return Returns the number of bytes sent.
+         */
+        std::size_t upload(BackgroundStreamingSlot& slot);
+
+        /**
+         * Wait for all workers and release all slots.
+         */
+        void stop_streaming();
+
+        /**
+         * Create the vertices of the visible tiles (or of their placeholders).
+         */
+        void build_draw_list();
+
+        /**
+         * Destroy least recently visible textures until the cache size is respected.
          */
-        GLuint create_background_tile(unsigned int x, unsigned int y, float pre_scaling, unsigned index);
+        void evict_textures();
+
+        std::vector<GLuint> background_textures; // Drawn tiles (owned by tile_textures).
+        std::map<BackgroundTileKey, BackgroundTileTexture> tile_textures;
+        WorkspaceVertexBuffer<BackgroundVertex2D> vertices;
+        unsigned long update_count = 0;
+        bool draw_list_dirty = false;
+
+        // Streaming.
+        QOpenGLExtraFunctions* extra_context = nullptr;
+        BackgroundStreamingSlot slots[BACKGROUND_STREAMING_SLOTS];
+        std::deque<BackgroundTileRequest> pending_tiles;
+
+        // Visible tiles of the last update, per drawn layer.
+        std::vector<BackgroundLayerView> visible_layers;
+        bool visible_missing = false;
+        bool composite = false;
 
-        std::vector<GLuint> background_textures;
         BackgroundImage_shptr background_image = nullptr;
 
         float scale = 1;
         float viewport_min_x = 0, viewport_min_y = 0, viewport_max_x = 0, viewport_max_y = 0;
         float virtual_width = 0, virtual_height = 0;
 
-        unsigned int tile_count = 0;
-
         QFutureWatcher<void> future;
     };
 }
@@ -0,0 +1,319 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __WORKSPACECHUNKS_H__
+#define __WORKSPACECHUNKS_H__
+
+#include "Core/Primitive/BoundingBox.h"
+#include "Core/LogicModel/Layer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Width (and height) of a chunk, in background tiles.
+#define WORKSPACE_CHUNK_TILES 4
+
+// Memory that built chunks of one workspace element can use on the GPU (in bytes).
+#define WORKSPACE_CHUNK_MEMORY_BUDGET (64 * 1024 * 1024)
+
+namespace degate
+{
+    /**
+     * Get the chunk size for a layer, aligned with the tile grid of its background image.
+     *
+     * @param layer : the layer.
+     *
+     * @return Returns the width (and height) of a chunk.
+     */
+    inline float get_chunk_size(Layer_shptr const& layer)
+    {
+        unsigned int tile_size = 1024;
+
+        if (layer != nullptr && layer->has_background_image())
+            tile_size = layer->get_image()->get_tile_size();
+
+        return static_cast<float>(tile_size * WORKSPACE_CHUNK_TILES);
+    }
+
+    /**
+     * @class WorkspaceChunks
+     * @brief Spatial partition of workspace objects, with one set of OpenGL buffers per chunk.
+     *
+     * Objects are grouped by the square (of chunk_size) that contains the center of their
+     * bounding box. The bounds of a chunk are the union of the bounding boxes of its objects.
+     *
+     * Chunk buffers (ChunkData) are built lazily when a chunk becomes visible for the first
+     * time. Chunks outside of the viewport are not drawn, and the least recently drawn ones
+     * are released when the memory budget is exceeded.
+     *
+     * When zoomed out, chunks are built in simplified mode (a few coverage cells instead of
+     * all objects). Switching mode rebuilds visible chunks.
+     *
+     * The index of each object (@see PlacedLogicModelObject::set_index) is set to its position
+     * in the object list given to set_objects.
+     */
+    template <typename ObjectType, typename ChunkData>
+    class WorkspaceChunks
+    {
+    public:
+        typedef std::shared_ptr<ObjectType> object_shptr;
+
+        struct Chunk
+        {
+            BoundingBox bounds;
+            std::vector<object_shptr> objects;
+            ChunkData data;
+            bool built = false;
+            bool simplified = false; // Built as coverage cells (@see WorkspaceCoverage) instead of objects.
+            std::size_t memory = 0;
+            unsigned long last_frame = 0;
+        };
+
+        /**
+         * Replace all objects. The buffers of all chunks must have been released before (@see clear).
+         *
+         * @param objects : the new objects.
+         * @param chunk_size : the width (and height) of a chunk.
+         */
+        void set_objects(std::vector<object_shptr> const& objects, float chunk_size)
+        {
+            assert(memory == 0);
+
+            this->chunk_size = chunk_size;
+
+            chunks.clear();
+            locations.resize(objects.size());
+
+            std::map<std::pair<long, long>, unsigned> cells;
+
+            for (unsigned index = 0; index < objects.size(); index++)
+            {
+                auto& object = objects[index];
+                BoundingBox const& bb = object->get_bounding_box();
+
+                const std::pair<long, long> cell(static_cast<long>(std::floor(bb.get_center_x() / chunk_size)),
+                                                 static_cast<long>(std::floor(bb.get_center_y() / chunk_size)));
+
+                auto it = cells.find(cell);
+                if (it == cells.end())
+                {
+                    it = cells.insert({cell, static_cast<unsigned>(chunks.size())}).first;
+
+                    chunks.emplace_back();
+                    chunks.back().bounds = bb;
+                }
+
+                Chunk& chunk = chunks[it->second];
+                extend(chunk.bounds, bb);
+
+                locations[index] = {it->second, static_cast<unsigned>(chunk.objects.size())};
+                chunk.objects.push_back(object);
+
+                object->set_index(index);
+            }
+        }
+
+        /**
+         * Get the number of objects.
+         */
+        inline std::size_t size() const
+        {
+            return locations.size();
+        }
+
+        /**
+         * Get the width (and height) of the chunk grid cells.
+         */
+        inline float get_chunk_width() const
+        {
+            return chunk_size;
+        }
+
+        /**
+         * Get the chunk of an object, and the position of the object in this chunk.
+         *
+         * @param index : the index of the object.
+         * @param offset : the position of the object in the returned chunk.
+         *
+         * @return Returns the chunk, or nullptr if the index is not valid.
+         */
+        Chunk* get_chunk(unsigned index, unsigned& offset)
+        {
+            if (index >= locations.size())
+                return nullptr;
+
+            offset = locations[index].second;
+            return &chunks[locations[index].first];
+        }
+
+        /**
+         * Extend the bounds of the chunk of an object (if the object moved or grew).
+         *
+         * @param index : the index of the object.
+         */
+        void update_bounds(unsigned index)
+        {
+            unsigned offset = 0;
+            Chunk* chunk = get_chunk(index, offset);
+
+            if (chunk != nullptr)
+                extend(chunk->bounds, chunk->objects[offset]->get_bounding_box());
+        }
+
+        /**
+         * Release the buffers of the chunk of an object, it will be rebuilt when it becomes
+         * visible (e.g. a simplified chunk, whose coverage cells can't be updated in place).
+         *
+         * @param index : the index of the object.
+         * @param release : called as release(chunk) if the chunk is built.
+         */
+        template <typename Release>
+        void invalidate(unsigned index, Release release)
+        {
+            unsigned offset = 0;
+            Chunk* chunk = get_chunk(index, offset);
+
+            if (chunk != nullptr)
+                release_chunk(*chunk, release);
+        }
+
+        /**
+         * Draw all chunks that intersect the viewport.
+         *
+         * @param viewport : the visible area.
+         * @param simplified : if true, chunks are built in simplified mode (chunk.simplified is set before build is called).
+         * @param build : called as build(chunk) for visible chunks that are not built, returns the used memory.
+         * @param draw : called as draw(chunk) for visible chunks.
+         * @param release : called as release(chunk) for chunks evicted to stay within the memory budget.
+         */
+        template <typename Build, typename Draw, typename Release>
+        void draw(BoundingBox const& viewport, bool simplified, Build build, Draw draw, Release release)
+        {
+            frame++;
+
+            for (auto& chunk : chunks)
+            {
+                if (!chunk.bounds.intersects(viewport))
+                    continue;
+
+                if (chunk.built && chunk.simplified != simplified)
+                    release_chunk(chunk, release);
+
+                if (!chunk.built)
+                {
+                    chunk.simplified = simplified;
+                    chunk.memory = build(chunk);
+                    chunk.built = true;
+                    memory += chunk.memory;
+                }
+
+                chunk.last_frame = frame;
+                draw(chunk);
+            }
+
+            if (memory > WORKSPACE_CHUNK_MEMORY_BUDGET)
+                evict(release);
+        }
+
+        /**
+         * Release the buffers of all chunks.
+         *
+         * @param release : called as release(chunk) for each built chunk.
+         */
+        template <typename Release>
+        void clear(Release release)
+        {
+            for (auto& chunk : chunks)
+                release_chunk(chunk, release);
+
+            memory = 0;
+        }
+
+    private:
+
+        static void extend(BoundingBox& bounds, BoundingBox const& bb)
+        {
+            bounds.set(std::min(bounds.get_min_x(), bb.get_min_x()),
+                       std::max(bounds.get_max_x(), bb.get_max_x()),
+                       std::min(bounds.get_min_y(), bb.get_min_y()),
+                       std::max(bounds.get_max_y(), bb.get_max_y()));
+        }
+
+        template <typename Release>
+        void release_chunk(Chunk& chunk, Release release)
+        {
+            if (!chunk.built)
+                return;
+
+            release(chunk);
+
+            chunk.data = ChunkData();
+            chunk.built = false;
+            memory -= std::min(memory, chunk.memory);
+            chunk.memory = 0;
+        }
+
+        /**
+         * Release the least recently drawn chunks until the memory budget is respected.
+         * Chunks drawn in the current frame are kept.
+         */
+        template <typename Release>
+        void evict(Release release)
+        {
+            std::vector<Chunk*> candidates;
+            for (auto& chunk : chunks)
+            {
+                if (chunk.built && chunk.last_frame != frame)
+                    candidates.push_back(&chunk);
+            }
+
+            std::sort(candidates.begin(), candidates.end(), [](Chunk const* a, Chunk const* b)
+            {
+                return a->last_frame < b->last_frame;
+            });
+
+            for (auto chunk : candidates)
+            {
+                if (memory <= WORKSPACE_CHUNK_MEMORY_BUDGET)
+                    break;
+
+                release_chunk(*chunk, release);
+            }
+        }
+
+        std::vector<Chunk> chunks;
+        std::vector<std::pair<unsigned, unsigned>> locations; // Object index -> {chunk, offset}.
+
+        float chunk_size = 1;
+
+        std::size_t memory = 0;
+        unsigned long frame = 0;
+    };
+}
+
+#endif //__WORKSPACECHUNKS_H__
@@ -0,0 +1,115 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "WorkspaceCoverage.h"
+#include "Core/Image/Image.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace degate
+{
+    WorkspaceCoverage::WorkspaceCoverage(BoundingBox const& bounds, float cell_size)
+            : min_x(bounds.get_min_x()),
+              min_y(bounds.get_min_y()),
+              cell_size(std::max(cell_size, 1.0f))
+    {
+        width = std::max(1u, static_cast<unsigned>(std::ceil(bounds.get_width() / this->cell_size)));
+        height = std::max(1u, static_cast<unsigned>(std::ceil(bounds.get_height() / this->cell_size)));
+
+        cells.resize(width * height);
+    }
+
+    void WorkspaceCoverage::add_box(BoundingBox const& box, color_t color)
+    {
+        const int first_x = static_cast<int>(std::floor((box.get_min_x() - min_x) / cell_size));
+        const int last_x = static_cast<int>(std::floor((box.get_max_x() - min_x) / cell_size));
+        const int first_y = static_cast<int>(std::floor((box.get_min_y() - min_y) / cell_size));
+        const int last_y = static_cast<int>(std::floor((box.get_max_y() - min_y) / cell_size));
+
+        for (int y = first_y; y <= last_y; y++)
+        {
+            const float cell_min_y = min_y + y * cell_size;
+            const float overlap_y = std::min(box.get_max_y(), cell_min_y + cell_size) - std::max(box.get_min_y(), cell_min_y);
+
+            for (int x = first_x; x <= last_x; x++)
+            {
+                const float cell_min_x = min_x + x * cell_size;
+                const float overlap_x = std::min(box.get_max_x(), cell_min_x + cell_size) - std::max(box.get_min_x(), cell_min_x);
+
+                // Degenerated boxes (points) still count.
+                add(x, y, std::max(overlap_x, 1.0f) * std::max(overlap_y, 1.0f), color);
+            }
+        }
+    }
+
+    void WorkspaceCoverage::add_line(float from_x, float from_y, float to_x, float to_y, float width, color_t color)
+    {
+        const float length = std::hypot(to_x - from_x, to_y - from_y);
+
+        // Sample the line twice per cell, each sample carries a part of the line area.
+        const unsigned samples = static_cast<unsigned>(std::ceil(2 * length / cell_size)) + 1;
+        const float area = std::max(length, 1.0f) * std::max(width, 1.0f) / static_cast<float>(samples);
+
+        for (unsigned i = 0; i < samples; i++)
+        {
+            const float t = samples == 1 ? 0.5f : static_cast<float>(i) / static_cast<float>(samples - 1);
+
+            add(static_cast<int>(std::floor((from_x + t * (to_x - from_x) - min_x) / cell_size)),
+                static_cast<int>(std::floor((from_y + t * (to_y - from_y) - min_y) / cell_size)),
+                area,
+                color);
+        }
+    }
+
+    std::size_t WorkspaceCoverage::get_cells_count() const
+    {
+        return std::count_if(cells.begin(), cells.end(), [](Cell const& cell) { return cell.area > 0; });
+    }
+
+    void WorkspaceCoverage::add(int x, int y, float area, color_t color)
+    {
+        if (x < 0 || y < 0 || x >= static_cast<int>(width) || y >= static_cast<int>(height) || area <= 0)
+            return;
+
+        Cell& cell = cells[y * width + x];
+
+        cell.area += area;
+        cell.r += area * MASK_R(color);
+        cell.g += area * MASK_G(color);
+        cell.b += area * MASK_B(color);
+        cell.a += area * MASK_A(color);
+    }
+
+    color_t WorkspaceCoverage::get_color(Cell const& cell) const
+    {
+        const float coverage = std::min(1.0f, cell.area / (cell_size * cell_size));
+        const float opacity = std::max(coverage, WORKSPACE_COVERAGE_MIN_OPACITY);
+
+        const auto r = static_cast<color_t>(cell.r / cell.area);
+        const auto g = static_cast<color_t>(cell.g / cell.area);
+        const auto b = static_cast<color_t>(cell.b / cell.area);
+        const auto a = static_cast<color_t>(cell.a / cell.area * opacity);
+
+        return MERGE_CHANNELS(r, g, b, a);
+    }
+}
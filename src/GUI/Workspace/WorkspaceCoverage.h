@@ -0,0 +1,128 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __WORKSPACECOVERAGE_H__
+#define __WORKSPACECOVERAGE_H__
+
+#include "Globals.h"
+#include "Core/Primitive/BoundingBox.h"
+
+#include <vector>
+
+// Number of coverage cells on each side of a chunk (@see WorkspaceChunks).
+#define WORKSPACE_COVERAGE_CELLS 32
+
+// Minimal opacity factor of a non empty coverage cell, to keep isolated objects visible.
+#define WORKSPACE_COVERAGE_MIN_OPACITY 0.2f
+
+namespace degate
+{
+    /**
+     * @class WorkspaceCoverage
+     * @brief Aggregate many objects in a coarse grid of colored cells.
+     *
+     * Used to draw a simplified version of the workspace overlays when zoomed out. Each
+     * cell gets the average color of the objects that cover it (weighted by the covered
+     * area), and an opacity that grows with the covered fraction of the cell.
+     */
+    class WorkspaceCoverage
+    {
+    public:
+
+        /**
+         * Create an empty coverage grid.
+         *
+         * @param bounds : the area covered by the grid.
+         * @param cell_size : the width (and height) of a cell.
+         */
+        WorkspaceCoverage(BoundingBox const& bounds, float cell_size);
+
+        /**
+         * Add a rectangular object.
+         *
+         * @param box : the bounding box of the object.
+         * @param color : the color of the object.
+         */
+        void add_box(BoundingBox const& box, color_t color);
+
+        /**
+         * Add a line object (like a wire).
+         *
+         * @param from_x : the x coordinate of the first point.
+         * @param from_y : the y coordinate of the first point.
+         * @param to_x : the x coordinate of the second point.
+         * @param to_y : the y coordinate of the second point.
+         * @param width : the width of the line.
+         * @param color : the color of the line.
+         */
+        void add_line(float from_x, float from_y, float to_x, float to_y, float width, color_t color);
+
+        /**
+         * Get the number of non empty cells.
+         */
+        std::size_t get_cells_count() const;
+
+        /**
+         * Call a function for each non empty cell.
+         *
+         * @param function : called as function(cell_bounding_box, cell_color).
+         */
+        template <typename Function>
+        void for_each_cell(Function function) const
+        {
+            for (unsigned y = 0; y < height; y++)
+            {
+                for (unsigned x = 0; x < width; x++)
+                {
+                    Cell const& cell = cells[y * width + x];
+
+                    if (cell.area <= 0)
+                        continue;
+
+                    BoundingBox box(min_x + x * cell_size,
+                                    min_x + (x + 1) * cell_size,
+                                    min_y + y * cell_size,
+                                    min_y + (y + 1) * cell_size);
+
+                    function(box, get_color(cell));
+                }
+            }
+        }
+
+    private:
+        struct Cell
+        {
+            float area = 0;
+            float r = 0, g = 0, b = 0, a = 0; // Channels weighted by area.
+        };
+
+        void add(int x, int y, float area, color_t color);
+        color_t get_color(Cell const& cell) const;
+
+        float min_x, min_y;
+        float cell_size;
+        unsigned width, height;
+        std::vector<Cell> cells;
+    };
+}
+
+#endif //__WORKSPACECOVERAGE_H__
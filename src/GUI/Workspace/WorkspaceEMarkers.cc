@@ -25,13 +25,6 @@
 
 namespace degate
 {
-    struct EMarkersVertex2D
-    {
-        QVector2D pos;
-        QVector3D color;
-        float alpha;
-    };
-
     WorkspaceEMarkers::WorkspaceEMarkers(QWidget *parent) : WorkspaceElement(parent), text(parent)
     {
 
@@ -47,41 +40,7 @@ namespace degate
         WorkspaceElement::init();
 
         text.init();
-
-        QOpenGLShader* vshader = new QOpenGLShader(QOpenGLShader::Vertex);
-        const char* vsrc =
-                "#version 330 core\n"
-                "in vec2 pos;\n"
-                "in vec3 color;\n"
-                "in float alpha;\n"
-                "uniform mat4 mvp;\n"
-                "out vec4 out_color;\n"
-                "void main(void)\n"
-                "{\n"
-                "    gl_Position = mvp * vec4(pos, 0.0, 1.0);\n"
-                "    out_color = vec4(color, alpha);\n"
-                "}\n";
-        vshader->compileSourceCode(vsrc);
-
-        QOpenGLShader* fshader = new QOpenGLShader(QOpenGLShader::Fragment);
-        const char* fsrc =
-                "#version 330 core\n"
-                "in vec4 out_color;\n"
-                "out vec4 color;\n"
-                "void main(void)\n"
-                "{\n"
-                "    color = out_color;\n"
-                "}\n";
-        fshader->compileSourceCode(fsrc);
-
-        program = new QOpenGLShaderProgram;
-        program->addShader(vshader);
-        program->addShader(fshader);
-
-        program->link();
-
-        delete vshader;
-        delete fshader;
+        shapes.init();
     }
 
     void WorkspaceEMarkers::update()
@@ -110,26 +69,27 @@ namespace degate
         if (emarkers_count == 0)
             return;
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-        context->glBufferData(GL_ARRAY_BUFFER, emarkers_count * 6 * sizeof(EMarkersVertex2D), nullptr, GL_STATIC_DRAW);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        // Assemble all instances on the CPU side, then send them at once.
+        shapes.resize(emarkers_count);
 
         unsigned text_size = 0;
 
         unsigned index = 0;
         for (auto& e : emarkers)
         {
-            create_emarker(e, index);
             e->set_index(index);
 
             text_size += static_cast<unsigned int>(e->get_name().length());
             index++;
         }
 
+        for_each_index(emarkers.size(), [&](std::size_t i)
+        {
+            create_emarker(emarkers[i], static_cast<unsigned>(i));
+        });
+
+        shapes.upload();
+
         text.update(text_size);
 
         unsigned text_offset = 0;
@@ -148,10 +108,11 @@ namespace degate
 
     void WorkspaceEMarkers::update(EMarker_shptr &emarker)
     {
-        if (emarker == nullptr)
+        if (emarker == nullptr || emarker->get_index() >= shapes.size())
             return;
 
         create_emarker(emarker, emarker->get_index());
+        shapes.set_dirty(emarker->get_index());
     }
 
     void WorkspaceEMarkers::draw(const QMatrix4x4 &projection)
@@ -159,28 +120,7 @@ namespace degate
         if (project == nullptr || emarkers_count == 0)
             return;
 
-        program->bind();
-
-        program->setUniformValue("mvp", projection);
-
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-        program->enableAttributeArray("pos");
-        program->setAttributeBuffer("pos", GL_FLOAT, 0, 2, sizeof(EMarkersVertex2D));
-
-        program->enableAttributeArray("color");
-        program->setAttributeBuffer("color", GL_FLOAT, 2 * sizeof(float), 3, sizeof(EMarkersVertex2D));
-
-        program->enableAttributeArray("alpha");
-        program->setAttributeBuffer("alpha", GL_FLOAT, 5 * sizeof(float), 1, sizeof(EMarkersVertex2D));
-
-        context->glDrawArrays(GL_TRIANGLES, 0, emarkers_count * 6);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
-
-        program->release();
+        shapes.draw(projection);
     }
 
     void WorkspaceEMarkers::draw_name(const QMatrix4x4 &projection)
@@ -191,43 +131,17 @@ namespace degate
         text.draw(projection);
     }
 
-    void WorkspaceEMarkers::create_emarker(EMarker_shptr &emarker, unsigned int index)
+    void WorkspaceEMarkers::create_emarker(EMarker_shptr const& emarker, unsigned int index)
     {
         if (emarker == nullptr)
             return;
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-        // Vertices and colors
+        // Color
 
         color_t color = emarker->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_EMARKER) : emarker->get_fill_color();
 
         color = highlight_color_by_state(color, emarker->get_highlighted());
 
-        EMarkersVertex2D temp;
-        temp.color = QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0);
-        temp.alpha = MASK_A(color) / 255.0;
-
-        temp.pos = QVector2D(emarker->get_x() - emarker->get_diameter() / 2.0, emarker->get_y() - emarker->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(EMarkersVertex2D) + 0 * sizeof(EMarkersVertex2D), sizeof(EMarkersVertex2D), &temp);
-
-        temp.pos = QVector2D(emarker->get_x() + emarker->get_diameter() / 2.0, emarker->get_y() - emarker->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(EMarkersVertex2D) + 1 * sizeof(EMarkersVertex2D), sizeof(EMarkersVertex2D), &temp);
-
-        temp.pos = QVector2D(emarker->get_x() + emarker->get_diameter() / 2.0, emarker->get_y() + emarker->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(EMarkersVertex2D) + 2 * sizeof(EMarkersVertex2D), sizeof(EMarkersVertex2D), &temp);
-
-        temp.pos = QVector2D(emarker->get_x() - emarker->get_diameter() / 2.0, emarker->get_y() - emarker->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(EMarkersVertex2D) + 4 * sizeof(EMarkersVertex2D), sizeof(EMarkersVertex2D), &temp);
-
-        temp.pos = QVector2D(emarker->get_x() - emarker->get_diameter() / 2.0, emarker->get_y() + emarker->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(EMarkersVertex2D) + 3 * sizeof(EMarkersVertex2D), sizeof(EMarkersVertex2D), &temp);
-
-        temp.pos = QVector2D(emarker->get_x() + emarker->get_diameter() / 2.0, emarker->get_y() + emarker->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(EMarkersVertex2D) + 5 * sizeof(EMarkersVertex2D), sizeof(EMarkersVertex2D), &temp);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        shapes.set_instance(index, emarker->get_x(), emarker->get_y(), emarker->get_diameter(), color, SHAPE_SQUARE);
     }
 }
\ No newline at end of file
@@ -23,6 +23,7 @@
 #define __WORKSPACEEMARKERS_H__
 
 #include "GUI/Workspace/WorkspaceElement.h"
+#include "GUI/Workspace/WorkspaceShapes.h"
 #include "Core/LogicModel/EMarker/EMarker.h"
 #include "GUI/Text/Text.h"
 
@@ -33,7 +34,7 @@ namespace degate
      * @class WorkspaceEMarkers
      * @brief Prepare and draw all emarkers of the active layer on the workspace.
      *
-     * The parent vbo buffer will store all squares.
+     * All emarkers are drawn with a single instanced draw call (@see WorkspaceShapes).
      *
      * @see WorkspaceElement
      */
@@ -62,6 +63,7 @@ namespace degate
 
         /**
          * Update a specific emarker (update buffers).
+         * The instance is sent with the next draw call.
          *
          * @warning Call the update() function before.
          *
@@ -85,12 +87,14 @@ namespace degate
 
     private:
         /**
-         * Create an emarker in OpenGL buffers.
+         * Create an emarker instance.
          *
          * @param emarker : the emarker object.
-         * @param index : the index of the annotation for OpenGL buffers.
+         * @param index : the index of the emarker for OpenGL buffers.
          */
-        void create_emarker(EMarker_shptr& emarker, unsigned index);
+        void create_emarker(EMarker_shptr const& emarker, unsigned index);
+
+        WorkspaceShapes shapes;
 
         Text text;
         unsigned emarkers_count = 0;
@@ -25,13 +25,6 @@
 
 namespace degate
 {
-    struct GatesVertex2D
-    {
-        QVector2D pos;
-        QVector3D color;
-        float alpha;
-    };
-
     WorkspaceGates::WorkspaceGates(QWidget* parent)
             : WorkspaceElement(parent),
               gate_template_name_text(parent),
@@ -43,9 +36,6 @@ namespace degate
     {
         if (context->glIsBuffer(line_vbo) == GL_TRUE)
             context->glDeleteBuffers(1, &line_vbo);
-
-        if (context->glIsBuffer(port_vbo) == GL_TRUE)
-            context->glDeleteBuffers(1, &port_vbo);
     }
 
     void WorkspaceGates::init()
@@ -54,6 +44,7 @@ namespace degate
 
         gate_template_name_text.init();
         port_name_text.init();
+        ports.init();
 
         QOpenGLShader* vshader = new QOpenGLShader(QOpenGLShader::Vertex);
         const char* vsrc =
@@ -91,7 +82,6 @@ namespace degate
         delete fshader;
 
         context->glGenBuffers(1, &line_vbo);
-        context->glGenBuffers(1, &port_vbo);
 
         context->glEnable(GL_LINE_SMOOTH);
     }
@@ -103,27 +93,24 @@ namespace degate
 
         assert(context->glGetError() == GL_NO_ERROR);
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-        context->glBufferData(GL_ARRAY_BUFFER, project->get_logic_model()->get_gates_count() * 6 * sizeof(GatesVertex2D), nullptr, GL_STATIC_DRAW);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, line_vbo);
-
-        context->glBufferData(GL_ARRAY_BUFFER, project->get_logic_model()->get_gates_count() * 8 * sizeof(GatesVertex2D), nullptr, GL_STATIC_DRAW);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-
         unsigned gate_template_name_text_size = 0;
         unsigned port_name_text_size = 0;
         ports_count = 0;
 
+        // Gates are stored in a map, keep them in a vector with the index of their first port.
+        std::vector<Gate_shptr> gates;
+        std::vector<unsigned> ports_indices;
+        gates.reserve(project->get_logic_model()->get_gates_count());
+        ports_indices.reserve(project->get_logic_model()->get_gates_count());
+
         unsigned index = 0;
         for (LogicModel::gate_collection::iterator iter = project->get_logic_model()->gates_begin(); iter != project->get_logic_model()->gates_end(); ++iter)
         {
-            create_gate(iter->second, index);
             iter->second->set_index(index);
 
+            gates.push_back(iter->second);
+            ports_indices.push_back(ports_count);
+
             gate_template_name_text_size += static_cast<unsigned int>(iter->second->get_gate_template()->get_name().length());
 
             if (!iter->second->get_name().empty())
@@ -139,19 +126,29 @@ namespace degate
             index++;
         }
 
-        gate_template_name_text.update(gate_template_name_text_size);
-        port_name_text.update(port_name_text_size);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, port_vbo);
+        // Assemble all vertices on the CPU side, then send them at once.
+        gate_vertices.resize(gates.size() * 6);
+        line_vertices.resize(gates.size() * 8);
+        ports.resize(ports_count);
 
-        context->glBufferData(GL_ARRAY_BUFFER, ports_count * 9 * sizeof(GatesVertex2D), nullptr, GL_STATIC_DRAW);
+        for_each_index(gates.size(), [&](std::size_t i)
+        {
+            create_gate(gates[i], static_cast<unsigned>(i));
+            create_ports(gates[i], ports_indices[i]);
+        });
 
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        vao.bind();
+        gate_vertices.upload(context, vbo);
+        line_vertices.upload(context, line_vbo);
         vao.release();
 
+        ports.upload();
+
+        gate_template_name_text.update(gate_template_name_text_size);
+        port_name_text.update(port_name_text_size);
+
         unsigned gate_template_name_text_offset = 0;
         unsigned port_name_text_offset = 0;
-        unsigned ports_index = 0;
 
         for (auto iter = project->get_logic_model()->gates_begin(); iter != project->get_logic_model()->gates_end(); ++iter)
         {
@@ -171,15 +168,11 @@ namespace degate
                                                  false,
                                                  iter->second->get_max_x() - iter->second->get_min_x() - TEXT_PADDING * 2);
 
-            create_ports(iter->second, ports_index);
-
             gate_template_name_text_offset += static_cast<unsigned int>(iter->second->get_gate_template()->get_name().length());
 
             if (!iter->second->get_name().empty())
                 gate_template_name_text_offset += static_cast<unsigned int>(iter->second->get_name().length()) + 3;
 
-            ports_index += iter->second->get_ports_number();
-
             for (auto port_iter = iter->second->ports_begin(); port_iter != iter->second->ports_end(); ++port_iter)
             {
                 unsigned x = (*port_iter)->get_x();
@@ -203,10 +196,17 @@ namespace degate
 
     void WorkspaceGates::update(Gate_shptr& gate)
     {
-        if (gate == nullptr)
+        if (gate == nullptr || (gate->get_index() + 1) * 6 > gate_vertices.size())
             return;
 
         create_gate(gate, gate->get_index());
+        gate_vertices.set_dirty(gate->get_index() * 6, 6);
+        line_vertices.set_dirty(gate->get_index() * 8, 8);
+    }
+
+    void WorkspaceGates::set_simplified(bool value)
+    {
+        simplified = value;
     }
 
     void WorkspaceGates::draw(const QMatrix4x4& projection)
@@ -214,6 +214,10 @@ namespace degate
         if (project == nullptr || project->get_logic_model()->get_gates_count() == 0)
             return;
 
+        // Send gates updated since the last frame.
+        gate_vertices.flush(context, vbo);
+        line_vertices.flush(context, line_vbo);
+
         program->bind();
 
         program->setUniformValue("mvp", projection);
@@ -232,6 +236,17 @@ namespace degate
 
         context->glDrawArrays(GL_TRIANGLES, 0, project->get_logic_model()->get_gates_count() * 6);
 
+        // Outlines are lost in the fill when zoomed out.
+        if (simplified)
+        {
+            context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+            vao.release();
+
+            program->release();
+
+            return;
+        }
+
         context->glBindBuffer(GL_ARRAY_BUFFER, line_vbo);
 
         program->enableAttributeArray("pos");
@@ -264,28 +279,7 @@ namespace degate
         if (project == nullptr || project->get_logic_model()->get_gates_count() == 0)
             return;
 
-        program->bind();
-
-        program->setUniformValue("mvp", projection);
-
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, port_vbo);
-
-        program->enableAttributeArray("pos");
-        program->setAttributeBuffer("pos", GL_FLOAT, 0, 2, sizeof(GatesVertex2D));
-
-        program->enableAttributeArray("color");
-        program->setAttributeBuffer("color", GL_FLOAT, 2 * sizeof(float), 3, sizeof(GatesVertex2D));
-
-        program->enableAttributeArray("alpha");
-        program->setAttributeBuffer("alpha", GL_FLOAT, 5 * sizeof(float), 1, sizeof(GatesVertex2D));
-
-        context->glDrawArrays(GL_TRIANGLES, 0, ports_count * 9);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
-
-        program->release();
+        ports.draw(projection);
     }
 
     void WorkspaceGates::draw_ports_name(const QMatrix4x4& projection)
@@ -296,14 +290,12 @@ namespace degate
         port_name_text.draw(projection);
     }
 
-    void WorkspaceGates::create_gate(Gate_shptr& gate, unsigned index)
+    void WorkspaceGates::create_gate(Gate_shptr const& gate, unsigned index)
     {
         if (gate == nullptr)
             return;
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
+        GatesVertex2D* out = gate_vertices.data(index * 6);
 
         // Vertices and colors
 
@@ -316,22 +308,22 @@ namespace degate
         temp.alpha = MASK_A(color) / 255.0;
 
         temp.pos = QVector2D(gate->get_min_x(), gate->get_min_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(GatesVertex2D) + 0 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[0] = temp;
 
         temp.pos = QVector2D(gate->get_max_x(), gate->get_min_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(GatesVertex2D) + 1 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[1] = temp;
 
         temp.pos = QVector2D(gate->get_min_x(), gate->get_max_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(GatesVertex2D) + 2 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[2] = temp;
 
         temp.pos = QVector2D(gate->get_max_x(), gate->get_min_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(GatesVertex2D) + 4 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[4] = temp;
 
         temp.pos = QVector2D(gate->get_min_x(), gate->get_max_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(GatesVertex2D) + 3 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[3] = temp;
 
         temp.pos = QVector2D(gate->get_max_x(), gate->get_max_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(GatesVertex2D) + 5 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[5] = temp;
 
 
         // Lines
@@ -340,224 +332,78 @@ namespace degate
 
         color = highlight_color_by_state(color, gate->get_highlighted());
 
-        context->glBindBuffer(GL_ARRAY_BUFFER, line_vbo);
+        out = line_vertices.data(index * 8);
 
         temp.color = QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0);
         temp.alpha = MASK_A(color) / 255.0;
 
         temp.pos = QVector2D(gate->get_min_x(), gate->get_min_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 8 * sizeof(GatesVertex2D) + 0 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[0] = temp;
 
         temp.pos = QVector2D(gate->get_max_x(), gate->get_min_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 8 * sizeof(GatesVertex2D) + 1 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[1] = temp;
 
         temp.pos = QVector2D(gate->get_min_x(), gate->get_min_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 8 * sizeof(GatesVertex2D) + 2 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[2] = temp;
 
         temp.pos = QVector2D(gate->get_min_x(), gate->get_max_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 8 * sizeof(GatesVertex2D) + 3 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[3] = temp;
 
         temp.pos = QVector2D(gate->get_max_x(), gate->get_min_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 8 * sizeof(GatesVertex2D) + 4 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[4] = temp;
 
         temp.pos = QVector2D(gate->get_max_x(), gate->get_max_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 8 * sizeof(GatesVertex2D) + 5 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[5] = temp;
 
         temp.pos = QVector2D(gate->get_min_x(), gate->get_max_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 8 * sizeof(GatesVertex2D) + 6 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        out[6] = temp;
 
         temp.pos = QVector2D(gate->get_max_x(), gate->get_max_y());
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 8 * sizeof(GatesVertex2D) + 7 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        out[7] = temp;
     }
 
-    void draw_port_in_out(QOpenGLFunctions* context, float x, float y, unsigned size, QVector3D color, float alpha, unsigned offset)
-    {
-        GatesVertex2D temp;
-
-        temp.color = color;
-        temp.alpha = alpha;
-
-        int mid = size / 2.0;
-
-        temp.pos = QVector2D(x - mid, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 0 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x - mid, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 1 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x + mid, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 2 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x + mid, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 3 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x, y);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 4 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x + mid, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 5 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x, y);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 6 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x + mid, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 7 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x - mid, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 8 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-    }
-
-    void draw_port_in(QOpenGLFunctions* context, float x, float y, unsigned size, QVector3D color, float alpha, unsigned offset)
+    void WorkspaceGates::update(GatePort_shptr& port)
     {
-        GatesVertex2D temp;
-
-        temp.color = color;
-        temp.alpha = alpha;
-
-        int mid = size / 2.0;
-
-        temp.pos = QVector2D(x - mid, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 0 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x + mid, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 1 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x, y);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 2 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x + mid, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 3 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x + mid, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 4 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x, y);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 5 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x + mid, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 6 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x - mid, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 7 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        if (port == nullptr || port->get_index() >= ports.size())
+            return;
 
-        temp.pos = QVector2D(x, y);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 8 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        create_port(port, port->get_index());
+        ports.set_dirty(port->get_index());
     }
 
-    void draw_port_out(QOpenGLFunctions* context, float x, float y, unsigned size, QVector3D color, float alpha, unsigned offset)
+    void WorkspaceGates::create_ports(Gate_shptr const& gate, unsigned index)
     {
-        GatesVertex2D temp;
-
-        temp.color = color;
-        temp.alpha = alpha;
-
-        int mid = size / 2.0;
-
-        temp.pos = QVector2D(x - mid, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 0 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 1 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 2 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x - mid, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 3 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x - mid, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 4 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 5 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
-
-        temp.pos = QVector2D(x, y - mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 6 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+        for (Gate::port_iterator iter = gate->ports_begin(); iter != gate->ports_end(); ++iter)
+        {
+            create_port(*iter, index);
 
-        temp.pos = QVector2D(x + mid, y);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 7 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+            (*iter)->set_index(index);
 
-        temp.pos = QVector2D(x, y + mid);
-        context->glBufferSubData(GL_ARRAY_BUFFER, offset * 9 * sizeof(GatesVertex2D) + 8 * sizeof(GatesVertex2D), sizeof(GatesVertex2D), &temp);
+            index++;
+        }
     }
 
-    void WorkspaceGates::update(GatePort_shptr& port)
+    void WorkspaceGates::create_port(GatePort_shptr const& port, unsigned index)
     {
-        if (port == nullptr)
-            return;
-
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, port_vbo);
-
         GateTemplatePort_shptr tmpl_port = port->get_template_port();
         color_t color = tmpl_port->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_GATE_PORT) : tmpl_port->get_fill_color();
 
         color = highlight_color_by_state(color, port->get_highlighted());
 
+        WorkspaceShape shape;
         switch (tmpl_port->get_port_type())
         {
-            case GateTemplatePort::PORT_TYPE_UNDEFINED:
-                draw_port_in_out(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, port->get_index());
-                break;
             case GateTemplatePort::PORT_TYPE_IN:
-                draw_port_in(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, port->get_index());
+                shape = SHAPE_PORT_IN;
                 break;
             case GateTemplatePort::PORT_TYPE_OUT:
-                draw_port_out(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, port->get_index());
-                break;
-            case GateTemplatePort::PORT_TYPE_INOUT:
-                draw_port_in_out(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, port->get_index());
+                shape = SHAPE_PORT_OUT;
                 break;
             default:
-                draw_port_in_out(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, port->get_index());
+                shape = SHAPE_SQUARE;
                 break;
         }
 
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
-    }
-
-    void WorkspaceGates::create_ports(Gate_shptr& gate, unsigned index)
-    {
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, port_vbo);
-
-        for (Gate::port_iterator iter = gate->ports_begin(); iter != gate->ports_end(); ++iter)
-        {
-            GatePort_shptr port = *iter;
-            GateTemplatePort_shptr tmpl_port = port->get_template_port();
-            color_t color = tmpl_port->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_GATE_PORT) : tmpl_port->get_fill_color();
-
-            color = highlight_color_by_state(color, port->get_highlighted());
-
-            switch (tmpl_port->get_port_type())
-            {
-                case GateTemplatePort::PORT_TYPE_UNDEFINED:
-                    draw_port_in_out(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, index);
-                    break;
-                case GateTemplatePort::PORT_TYPE_IN:
-                    draw_port_in(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, index);
-                    break;
-                case GateTemplatePort::PORT_TYPE_OUT:
-                    draw_port_out(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, index);
-                    break;
-                case GateTemplatePort::PORT_TYPE_INOUT:
-                    draw_port_in_out(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, index);
-                    break;
-                default:
-                    draw_port_in_out(context, port->get_x(), port->get_y(), port->get_diameter(), QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0), MASK_A(color) / 255.0, index);
-                    break;
-            }
-
-            port->set_index(index);
-
-            index++;
-        }
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        ports.set_instance(index, port->get_x(), port->get_y(), port->get_diameter(), color, shape);
     }
-}
+}
\ No newline at end of file
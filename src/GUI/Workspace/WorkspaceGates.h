@@ -23,10 +23,17 @@
 #define __WORKSPACEGATES_H__
 
 #include "WorkspaceElement.h"
+#include "WorkspaceShapes.h"
 #include "GUI/Text/Text.h"
 
 namespace degate
 {
+    struct GatesVertex2D
+    {
+        QVector2D pos;
+        QVector3D color;
+        float alpha;
+    };
 
     /**
      * @class WorkspaceGates
@@ -35,7 +42,7 @@ namespace degate
      * This will prepare all OpenGL things (buffers, shaders...) to draw all gates on the workspace.
      * One gate is composed of a square, an outline, a top-left aligned text, ports and ports name.
      *
-     * The parent vbo buffer will store all squares, the line_vbo buffer will store all outlines and the port_vbo buffer will store all ports.
+     * The parent vbo buffer will store all squares, the line_vbo buffer will store all outlines and ports are drawn with a single instanced draw call (@see WorkspaceShapes).
      *
      * @see WorkspaceElement
      */
@@ -64,6 +71,7 @@ namespace degate
 
         /**
          * Update a specific gate.
+         * The vbos are updated with the next draw call.
          *
          * @param gate : the gate object.
          */
@@ -71,11 +79,19 @@ namespace degate
 
         /**
          * Update a specific port.
+         * The instance is sent with the next draw_ports call.
          *
          * @param port : the port object.
          */
         void update(GatePort_shptr& port);
 
+        /**
+         * Set the level of detail. If simplified, gate outlines are not drawn.
+         *
+         * @param value : true to draw the simplified version.
+         */
+        void set_simplified(bool value);
+
         /**
          * Draw all gates.
          *
@@ -106,26 +122,38 @@ namespace degate
 
     private:
         /**
-         * Create a gate in OpenGL buffers.
+         * Create a gate in the vertex buffers.
          *
          * @param gate : the gate object.
          * @param index : the index of the gate for OpenGL buffers.
          */
-        void create_gate(Gate_shptr& gate, unsigned index);
+        void create_gate(Gate_shptr const& gate, unsigned index);
 
         /**
-         * Create all ports of a specific gate in OpenGL buffers.
+         * Create all port instances of a specific gate.
          *
          * @param gate : the gate object.
-         * @param index : the index of the gate for OpenGL buffers.
+         * @param index : the index of the first port of the gate for OpenGL buffers.
          */
-        void create_ports(Gate_shptr& gate, unsigned index);
+        void create_ports(Gate_shptr const& gate, unsigned index);
+
+        /**
+         * Create a port instance.
+         *
+         * @param port : the port object.
+         * @param index : the index of the port for OpenGL buffers.
+         */
+        void create_port(GatePort_shptr const& port, unsigned index);
 
         Text gate_template_name_text;
         Text port_name_text;
         GLuint line_vbo = 0;
-        GLuint port_vbo = 0;
         unsigned ports_count = 0;
+        bool simplified = false;
+
+        WorkspaceVertexBuffer<GatesVertex2D> gate_vertices;
+        WorkspaceVertexBuffer<GatesVertex2D> line_vertices;
+        WorkspaceShapes ports;
 
     };
 }
@@ -0,0 +1,404 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "WorkspacePicking.h"
+#include "Core/LogicModel/LogicModelHelper.h"
+
+namespace degate
+{
+    WorkspacePicking::WorkspacePicking(QWidget* parent) : WorkspaceElement(parent)
+    {
+    }
+
+    WorkspacePicking::~WorkspacePicking()
+    {
+        if (QOpenGLContext::currentContext() == nullptr || extra_context == nullptr)
+            return;
+
+        if (framebuffer != 0)
+            extra_context->glDeleteFramebuffers(1, &framebuffer);
+
+        if (texture != 0)
+            extra_context->glDeleteTextures(1, &texture);
+    }
+
+    void WorkspacePicking::init()
+    {
+        WorkspaceElement::init();
+
+        // Integer attributes and render targets are part of OpenGL 3.3 (like the shaders below).
+        extra_context = QOpenGLContext::currentContext()->extraFunctions();
+
+        QOpenGLShader* vshader = new QOpenGLShader(QOpenGLShader::Vertex);
+        const char* vsrc =
+                "#version 330 core\n"
+                "in vec2 pos;\n"
+                "in vec2 local;\n"
+                "in float disc;\n"
+                "in uint id;\n"
+                "uniform mat4 mvp;\n"
+                "out vec2 local_pos;\n"
+                "flat out int out_disc;\n"
+                "flat out uint out_id;\n"
+                "void main(void)\n"
+                "{\n"
+                "    gl_Position = mvp * vec4(pos, 0.0, 1.0);\n"
+                "    local_pos = local;\n"
+                "    out_disc = int(disc + 0.5);\n"
+                "    out_id = id;\n"
+                "}\n";
+        vshader->compileSourceCode(vsrc);
+
+        QOpenGLShader* fshader = new QOpenGLShader(QOpenGLShader::Fragment);
+        const char* fsrc =
+                "#version 330 core\n"
+                "in vec2 local_pos;\n"
+                "flat in int out_disc;\n"
+                "flat in uint out_id;\n"
+                "out uint id;\n"
+                "void main(void)\n"
+                "{\n"
+                "    if (out_disc == 1 && dot(local_pos, local_pos) > 1.0)\n"
+                "        discard;\n"
+                "    id = out_id;\n"
+                "}\n";
+        fshader->compileSourceCode(fsrc);
+
+        program = new QOpenGLShaderProgram;
+        program->addShader(vshader);
+        program->addShader(fshader);
+
+        program->link();
+
+        delete vshader;
+        delete fshader;
+    }
+
+    void WorkspacePicking::update()
+    {
+        dirty = true;
+    }
+
+    void WorkspacePicking::viewport_update(const BoundingBox& viewport, const QMatrix4x4& projection, int width, int height)
+    {
+        this->viewport = viewport;
+        this->viewport_projection = projection;
+        this->width = width;
+        this->height = height;
+
+        dirty = true;
+    }
+
+    void WorkspacePicking::set_ignored(bool annotations, bool gates, bool ports, bool emarkers, bool vias, bool wires)
+    {
+        if (ignore_annotations == annotations && ignore_gates == gates && ignore_ports == ports &&
+            ignore_emarkers == emarkers && ignore_vias == vias && ignore_wires == wires)
+            return;
+
+        ignore_annotations = annotations;
+        ignore_gates = gates;
+        ignore_ports = ports;
+        ignore_emarkers = emarkers;
+        ignore_vias = vias;
+        ignore_wires = wires;
+
+        dirty = true;
+    }
+
+    void WorkspacePicking::clear()
+    {
+        objects.clear();
+        vertices.resize(0);
+
+        dirty = true;
+    }
+
+    void WorkspacePicking::set_quad(std::size_t index, const QVector2D corners[4], bool disc)
+    {
+        static const QVector2D local[4] = {QVector2D(-1, -1), QVector2D(1, -1), QVector2D(1, 1), QVector2D(-1, 1)};
+        static const unsigned int indices[6] = {0, 1, 2, 0, 2, 3};
+
+        const auto id = static_cast<GLuint>(index + 1);
+
+        for (unsigned int i = 0; i < 6; i++)
+        {
+            PickingVertex2D* vertex = vertices.data(index * 6 + i);
+
+            vertex->pos = corners[indices[i]];
+            vertex->local = local[indices[i]];
+            vertex->disc = disc ? 1.0f : 0.0f;
+            vertex->id = id;
+        }
+    }
+
+    void WorkspacePicking::set_object(std::size_t index)
+    {
+        const PlacedLogicModelObject_shptr& object = objects[index];
+
+        // Same shapes as the in_shape() functions.
+        if (auto circle = std::dynamic_pointer_cast<Circle>(object))
+        {
+            const float x = circle->get_x();
+            const float y = circle->get_y();
+            const float radius = static_cast<float>(circle->get_diameter());
+
+            const QVector2D corners[4] = {QVector2D(x - radius, y - radius), QVector2D(x + radius, y - radius),
+                                          QVector2D(x + radius, y + radius), QVector2D(x - radius, y + radius)};
+            set_quad(index, corners, true);
+
+            return;
+        }
+
+        auto line = std::dynamic_pointer_cast<Line>(object);
+        if (line != nullptr && !line->is_vertical() && !line->is_horizontal())
+        {
+            const QVector2D from(line->get_from_x(), line->get_from_y());
+            const QVector2D to(line->get_to_x(), line->get_to_y());
+
+            const QVector2D direction = (to - from).normalized();
+            const QVector2D normal = QVector2D(-direction.y(), direction.x()) * (static_cast<float>(line->get_diameter()) / 2.0f);
+
+            const QVector2D corners[4] = {from - normal, to - normal, to + normal, from + normal};
+            set_quad(index, corners, false);
+
+            return;
+        }
+
+        const BoundingBox& bb = object->get_bounding_box();
+
+        const QVector2D corners[4] = {QVector2D(bb.get_min_x(), bb.get_min_y()), QVector2D(bb.get_max_x(), bb.get_min_y()),
+                                      QVector2D(bb.get_max_x(), bb.get_max_y()), QVector2D(bb.get_min_x(), bb.get_max_y())};
+        set_quad(index, corners, false);
+    }
+
+    void WorkspacePicking::build()
+    {
+        objects.clear();
+        vertices.resize(0);
+
+        if (project == nullptr)
+            return;
+
+        Layer_shptr current_layer = project->get_logic_model()->get_current_layer();
+        if (current_layer == nullptr)
+            return;
+
+        Layer_shptr logic_layer = nullptr;
+        try
+        {
+            logic_layer = get_first_logic_layer(project->get_logic_model());
+        }
+        catch (CollectionLookupException const&)
+        {
+        }
+
+        if (logic_layer == current_layer)
+            logic_layer = nullptr;
+
+        // Visible objects by drawing order (the last drawn has the priority).
+        std::vector<PlacedLogicModelObject_shptr> wires, annotations, gates, emarkers, vias, ports;
+
+        for (Layer::qt_region_iterator iter = current_layer->region_begin(viewport); iter != current_layer->region_end(); ++iter)
+        {
+            PlacedLogicModelObject_shptr object = *iter;
+
+            if (std::dynamic_pointer_cast<GatePort>(object) != nullptr)
+            {
+                if (!ignore_ports)
+                    ports.push_back(object);
+            }
+            else if (std::dynamic_pointer_cast<Via>(object) != nullptr)
+            {
+                if (!ignore_vias)
+                    vias.push_back(object);
+            }
+            else if (std::dynamic_pointer_cast<EMarker>(object) != nullptr)
+            {
+                if (!ignore_emarkers)
+                    emarkers.push_back(object);
+            }
+            else if (std::dynamic_pointer_cast<Gate>(object) != nullptr)
+            {
+                if (!ignore_gates)
+                    gates.push_back(object);
+            }
+            else if (std::dynamic_pointer_cast<Annotation>(object) != nullptr)
+            {
+                if (!ignore_annotations)
+                    annotations.push_back(object);
+            }
+            else if (std::dynamic_pointer_cast<Wire>(object) != nullptr)
+            {
+                if (!ignore_wires)
+                    wires.push_back(object);
+            }
+        }
+
+        // Gates and ports of the logic layer are above gates (resp. ports) of the current layer,
+        // vias and emarkers of the current layer are above gates of the logic layer.
+        std::vector<PlacedLogicModelObject_shptr> logic_gates, logic_ports;
+
+        if (logic_layer != nullptr)
+        {
+            for (Layer::qt_region_iterator iter = logic_layer->region_begin(viewport); iter != logic_layer->region_end(); ++iter)
+            {
+                PlacedLogicModelObject_shptr object = *iter;
+
+                if (std::dynamic_pointer_cast<GatePort>(object) != nullptr)
+                {
+                    if (!ignore_ports)
+                        logic_ports.push_back(object);
+                }
+                else if (std::dynamic_pointer_cast<Gate>(object) != nullptr)
+                {
+                    if (!ignore_gates)
+                        logic_gates.push_back(object);
+                }
+            }
+        }
+
+        for (auto list : {&wires, &annotations, &gates, &logic_gates, &emarkers, &vias, &ports, &logic_ports})
+            objects.insert(objects.end(), list->begin(), list->end());
+
+        // Two triangles per object.
+        vertices.resize(objects.size() * 6);
+        for_each_index(objects.size(), [this](std::size_t index)
+        {
+            set_object(index);
+        });
+
+        vao.bind();
+        vertices.upload(context, vbo);
+        vao.release();
+    }
+
+    void WorkspacePicking::resize_framebuffer()
+    {
+        if (framebuffer != 0 && framebuffer_width == width && framebuffer_height == height)
+            return;
+
+        if (framebuffer == 0)
+            extra_context->glGenFramebuffers(1, &framebuffer);
+
+        if (texture == 0)
+            extra_context->glGenTextures(1, &texture);
+
+        framebuffer_width = width;
+        framebuffer_height = height;
+
+        extra_context->glBindTexture(GL_TEXTURE_2D, texture);
+        extra_context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        extra_context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        extra_context->glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        extra_context->glBindTexture(GL_TEXTURE_2D, 0);
+
+        extra_context->glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        extra_context->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+        if (extra_context->glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            debug(TM, "The picking framebuffer is incomplete.");
+    }
+
+    void WorkspacePicking::draw(const QMatrix4x4& projection)
+    {
+        if (!dirty || program == nullptr || width <= 0 || height <= 0)
+            return;
+
+        build();
+
+        // Keep the widget framebuffer and viewport.
+        GLint previous_framebuffer = 0;
+        GLint previous_viewport[4];
+        extra_context->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+        extra_context->glGetIntegerv(GL_VIEWPORT, previous_viewport);
+
+        resize_framebuffer();
+
+        extra_context->glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        extra_context->glViewport(0, 0, width, height);
+
+        const GLuint no_object = 0;
+        extra_context->glClearBufferuiv(GL_COLOR, 0, &no_object);
+
+        if (vertices.size() > 0)
+        {
+            program->bind();
+            program->setUniformValue("mvp", projection);
+
+            vao.bind();
+            extra_context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+            program->enableAttributeArray("pos");
+            program->setAttributeBuffer("pos", GL_FLOAT, 0, 2, sizeof(PickingVertex2D));
+
+            program->enableAttributeArray("local");
+            program->setAttributeBuffer("local", GL_FLOAT, 2 * sizeof(float), 2, sizeof(PickingVertex2D));
+
+            program->enableAttributeArray("disc");
+            program->setAttributeBuffer("disc", GL_FLOAT, 4 * sizeof(float), 1, sizeof(PickingVertex2D));
+
+            // Object indices must not go through a float conversion.
+            const GLint id_location = program->attributeLocation("id");
+            program->enableAttributeArray(id_location);
+            extra_context->glVertexAttribIPointer(id_location, 1, GL_UNSIGNED_INT, sizeof(PickingVertex2D),
+                                                  reinterpret_cast<const void*>(5 * sizeof(float)));
+
+            extra_context->glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+
+            extra_context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+            vao.release();
+
+            program->release();
+        }
+
+        extra_context->glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous_framebuffer));
+        extra_context->glViewport(previous_viewport[0], previous_viewport[1], previous_viewport[2], previous_viewport[3]);
+
+        dirty = false;
+    }
+
+    PlacedLogicModelObject_shptr WorkspacePicking::pick(int x, int y)
+    {
+        if (project == nullptr || x < 0 || y < 0 || x >= width || y >= height)
+            return nullptr;
+
+        draw(viewport_projection);
+
+        if (framebuffer == 0)
+            return nullptr;
+
+        GLint previous_framebuffer = 0;
+        extra_context->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous_framebuffer);
+
+        // The first row of the framebuffer is the bottom of the render area.
+        GLuint id = 0;
+        extra_context->glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        extra_context->glReadBuffer(GL_COLOR_ATTACHMENT0);
+        extra_context->glReadPixels(x, height - 1 - y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, &id);
+        extra_context->glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(previous_framebuffer));
+
+        if (id == 0 || id > objects.size())
+            return nullptr;
+
+        return objects[id - 1];
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __WORKSPACEPICKING_H__
+#define __WORKSPACEPICKING_H__
+
+#include "WorkspaceElement.h"
+#include "WorkspaceVertexBuffer.h"
+#include "Core/LogicModel/LogicModel.h"
+
+#include <QOpenGLExtraFunctions>
+
+#include <vector>
+
+namespace degate
+{
+    /**
+     * Vertex of the picking pass: a triangle of an object shape.
+     */
+    struct PickingVertex2D
+    {
+        QVector2D pos;
+        QVector2D local;    // Position in [-1, 1] in the quad of a disc.
+        float disc;         // 1 if the quad is a disc, 0 otherwise.
+        GLuint id;          // Index of the object + 1 (0 is no object).
+    };
+
+    /**
+     * @class WorkspacePicking
+     * @brief Find the object under a point with an ID buffer.
+     *
+     * Visible objects are drawn with their index in an offscreen integer framebuffer
+     * (the ID buffer), in the same order as the priority of Layer::get_object_at_position
+     * (wires, annotations, gates, emarkers, vias then ports). Objects of the current layer
+     * and gates and ports of the first logic layer are drawn.
+     *
+     * The ID buffer is redrawn only when needed: after an update (objects changed) or a
+     * viewport change, and only on the next pick. Picking is then a single pixel read.
+     */
+    class WorkspacePicking : public WorkspaceElement
+    {
+    public:
+
+        /**
+         * Create a workspace picking element.
+         * This will only set the parent, real creation will start with init function.
+         *
+         * @param parent : the parent widget pointer.
+         */
+        explicit WorkspacePicking(QWidget* parent);
+        ~WorkspacePicking();
+
+        /**
+         * Init the OpenGL routine (shaders, vbo). The framebuffer is created on first draw.
+         */
+        void init() override;
+
+        /**
+         * Objects changed, the ID buffer will be redrawn on the next pick.
+         */
+        void update() override;
+
+        /**
+         * Redraw the ID buffer if needed, the current framebuffer and viewport are restored.
+         *
+         * @param projection : the projection matrix to apply.
+         */
+        void draw(const QMatrix4x4& projection) override;
+
+        /**
+         * Update the viewport.
+         *
+         * @param viewport : the visible area (in project coordinates).
+         * @param projection : the projection matrix of the viewport.
+         * @param width : the width of the render area (in pixels).
+         * @param height : the height of the render area (in pixels).
+         */
+        void viewport_update(const BoundingBox& viewport, const QMatrix4x4& projection, int width, int height);
+
+        /**
+         * Set the object types that can't be picked (hidden objects).
+         */
+        void set_ignored(bool annotations, bool gates, bool ports, bool emarkers, bool vias, bool wires);
+
+        /**
+         * Get the object under a point of the render area.
+         *
+         * @param x : the x coordinate (in pixels, from the left).
+         * @param y : the y coordinate (in pixels, from the top).
+         *
+         * @return Returns the object, nullptr if there is no object.
+         */
+        PlacedLogicModelObject_shptr pick(int x, int y);
+
+        /**
+         * Release all objects and framebuffer (e.g. before a project change).
+         */
+        void clear();
+
+    private:
+        /**
+         * Collect the visible objects and create their vertices.
+         */
+        void build();
+
+        /**
+         * Create the framebuffer and its integer texture if the size changed.
+         */
+        void resize_framebuffer();
+
+        /**
+         * Set the vertices of an object (the object index is its ID - 1).
+         */
+        void set_object(std::size_t index);
+
+        /**
+         * Set the two triangles of an object.
+         *
+         * @param index : the index of the object.
+         * @param corners : the corners of the quad (in order around the quad).
+         * @param disc : if true, only the disc inscribed in the quad is drawn.
+         */
+        void set_quad(std::size_t index, const QVector2D corners[4], bool disc);
+
+        QOpenGLExtraFunctions* extra_context = nullptr;
+
+        GLuint framebuffer = 0;
+        GLuint texture = 0;
+        int framebuffer_width = 0, framebuffer_height = 0;
+
+        WorkspaceVertexBuffer<PickingVertex2D> vertices;
+        std::vector<PlacedLogicModelObject_shptr> objects;
+        bool dirty = true;
+
+        BoundingBox viewport;
+        QMatrix4x4 viewport_projection;
+        int width = 0, height = 0;
+
+        bool ignore_annotations = false;
+        bool ignore_gates = false;
+        bool ignore_ports = false;
+        bool ignore_emarkers = false;
+        bool ignore_vias = false;
+        bool ignore_wires = false;
+    };
+}
+
+#endif //__WORKSPACEPICKING_H__
@@ -25,6 +25,8 @@
 #include "GUI/Preferences/PreferencesHandler.h"
 #include "GUI/Workspace/WorkspaceNotifier.h"
 
+#include <algorithm>
+
 namespace degate
 {
 
@@ -36,6 +38,7 @@ namespace degate
               emarkers(this),
               vias(this),
               wires(this),
+              picking(this),
               selection_tool(this),
               wire_tool(this),
               regular_grid(this)
@@ -77,6 +80,9 @@ namespace degate
         emarkers.update();
         vias.update();
         wires.update();
+        picking.update();
+
+        update_composited_layers();
 
 		update();
 	}
@@ -92,6 +98,9 @@ namespace degate
         emarkers.update();
         vias.update();
         wires.update();
+        picking.update();
+
+        update_composited_layers();
 
         update();
     }
@@ -124,6 +133,8 @@ namespace degate
             wires.update();
         }
 
+        picking.update();
+
         update();
     }
 
@@ -134,6 +145,8 @@ namespace degate
         if (project == nullptr)
             return;
 
+        // The layer image changed, cached tiles are outdated.
+        background.free_textures();
         background.update();
 
         update();
@@ -147,6 +160,7 @@ namespace degate
             return;
 
         gates.update();
+        picking.update();
 
         update();
     }
@@ -159,6 +173,7 @@ namespace degate
             return;
 
         annotations.update();
+        picking.update();
 
         update();
     }
@@ -171,6 +186,7 @@ namespace degate
             return;
 
         emarkers.update();
+        picking.update();
 
         update();
     }
@@ -183,6 +199,7 @@ namespace degate
             return;
 
         vias.update();
+        picking.update();
 
         update();
     }
@@ -195,6 +212,7 @@ namespace degate
             return;
 
         wires.update();
+        picking.update();
 
         update();
     }
@@ -225,15 +243,25 @@ namespace degate
         emarkers.set_project(new_project);
         vias.set_project(new_project);
         wires.set_project(new_project);
+        picking.set_project(new_project);
         selection_tool.set_project(new_project);
         wire_tool.set_project(new_project);
         regular_grid.set_project(new_project);
 
         makeCurrent();
 
+        background.free_textures();
+
         regular_grid.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
         regular_grid.update();
 
+        vias.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
+        wires.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
+
+        // Composited layers elements and picked objects belong to the previous project.
+        composited_layers.clear();
+        picking.clear();
+
         // Reset scale
         scale = 1.0;
 
@@ -414,6 +442,23 @@ namespace degate
         update();
     }
 
+    void WorkspaceRenderer::set_composite_layers(bool value)
+    {
+        composite_layers = value;
+
+        makeCurrent();
+
+        background.set_composite(value);
+
+        if (project != nullptr)
+        {
+            background.update();
+            update_composited_layers();
+        }
+
+        update();
+    }
+
     void WorkspaceRenderer::show_grid(bool value)
     {
         draw_grid = value;
@@ -448,6 +493,8 @@ namespace degate
         makeCurrent();
 
         // Delete opengl objects here
+        composited_layers.clear();
+        picking.clear();
         Text::delete_context();
     }
 
@@ -476,6 +523,7 @@ namespace degate
         vias.init();
 		selection_tool.init();
 		wires.init();
+        picking.init();
         wire_tool.init();
         regular_grid.init();
 
@@ -500,39 +548,68 @@ namespace degate
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+		// Level of detail: when zoomed out, overlays are simplified and names are hidden.
+		const auto& preferences = PREFERENCES_HANDLER.get_preferences();
+		const bool simplified = scale > preferences.overlay_lod_scale;
+		const bool show_names = scale <= preferences.text_lod_scale;
+
+		wires.set_simplified(simplified);
+		vias.set_simplified(simplified);
+		gates.set_simplified(simplified);
+
 		background.draw(projection);
 
+		// Composited layers overlays, drawn under the current layer ones.
+		for (auto& composited_layer : composited_layers)
+		{
+		    const float opacity = composited_layer->layer->get_composition_opacity();
+
+		    if (draw_wires)
+		    {
+		        composited_layer->wires.set_simplified(simplified);
+		        composited_layer->wires.set_opacity(opacity);
+		        composited_layer->wires.draw(projection);
+		    }
+
+		    if (draw_vias)
+		    {
+		        composited_layer->vias.set_simplified(simplified);
+		        composited_layer->vias.set_opacity(opacity);
+		        composited_layer->vias.draw(projection);
+		    }
+		}
+
 		if (draw_wires)
 		    wires.draw(projection);
 
 		if (draw_annotations)
 			annotations.draw(projection);
 
-		if (draw_annotations_name)
+		if (draw_annotations_name && show_names)
 			annotations.draw_name(projection);
 
 		if (draw_gates)
 			gates.draw(projection);
 
-		if (draw_gates_name)
+		if (draw_gates_name && show_names)
 			gates.draw_gates_name(projection);
 
-		if (draw_ports)
+		if (draw_ports && !simplified)
 			gates.draw_ports(projection);
 
-		if (draw_ports_name)
+		if (draw_ports_name && show_names)
 			gates.draw_ports_name(projection);
 
         if (draw_emarkers)
             emarkers.draw(projection);
 
-        if (draw_emarkers_name)
+        if (draw_emarkers_name && show_names)
             emarkers.draw_name(projection);
 
         if (draw_vias)
             vias.draw(projection);
 
-        if (draw_vias_name)
+        if (draw_vias_name && show_names)
             vias.draw_name(projection);
 
         if (current_tool == WorkspaceTool::AREA_SELECTION)
@@ -612,10 +689,93 @@ namespace degate
                 wires.update(wire);
             }
         }
+        else
+        {
+            for (auto& composited_layer : composited_layers)
+            {
+                if (composited_layer->layer != object->get_layer())
+                    continue;
+
+                if (Via_shptr via = std::dynamic_pointer_cast<Via>(object))
+                    composited_layer->vias.update(via);
+                else if (Wire_shptr wire = std::dynamic_pointer_cast<Wire>(object))
+                    composited_layer->wires.update(wire);
+            }
+        }
 
         update();
     }
 
+    void WorkspaceRenderer::update_composited_layers()
+    {
+        if (!composite_layers || project == nullptr)
+        {
+            composited_layers.clear();
+            return;
+        }
+
+        makeCurrent();
+
+        auto logic_model = project->get_logic_model();
+        auto current_layer = logic_model->get_current_layer();
+
+        // Keep existing elements (already filled) of still composited layers, by position.
+        std::vector<std::unique_ptr<WorkspaceCompositedLayer>> new_composited_layers;
+        for (auto iter = logic_model->layers_begin(); iter != logic_model->layers_end(); ++iter)
+        {
+            Layer_shptr layer = *iter;
+            if (layer == nullptr || layer == current_layer || !layer->is_composited())
+                continue;
+
+            auto existing = std::find_if(composited_layers.begin(), composited_layers.end(),
+                                         [&layer](const std::unique_ptr<WorkspaceCompositedLayer>& composited_layer)
+                                         {
+                                             return composited_layer != nullptr && composited_layer->layer == layer;
+                                         });
+
+            if (existing != composited_layers.end())
+            {
+                new_composited_layers.push_back(std::move(*existing));
+                continue;
+            }
+
+            auto composited_layer = std::make_unique<WorkspaceCompositedLayer>(this);
+            composited_layer->layer = layer;
+
+            composited_layer->wires.init();
+            composited_layer->wires.set_project(project);
+            composited_layer->wires.set_layer(layer);
+            composited_layer->wires.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
+
+            composited_layer->vias.init();
+            composited_layer->vias.set_project(project);
+            composited_layer->vias.set_layer(layer);
+            composited_layer->vias.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
+
+            new_composited_layers.push_back(std::move(composited_layer));
+        }
+
+        // Remaining elements are destroyed with the context current.
+        composited_layers = std::move(new_composited_layers);
+
+        for (auto& composited_layer : composited_layers)
+        {
+            composited_layer->wires.update();
+            composited_layer->vias.update();
+        }
+    }
+
+    PlacedLogicModelObject_shptr WorkspaceRenderer::pick_object_under_mouse()
+    {
+        makeCurrent();
+
+        picking.set_ignored(!draw_annotations, !draw_gates, !draw_ports, !draw_emarkers, !draw_vias, !draw_wires);
+
+        const QPointF pos = get_widget_mouse_position() * devicePixelRatioF();
+
+        return picking.pick(static_cast<int>(pos.x()), static_cast<int>(pos.y()));
+    }
+
     void WorkspaceRenderer::center_view(QPointF point)
     {
         set_projection(NO_ZOOM, point.x(), point.y());
@@ -637,11 +797,27 @@ namespace degate
 
         regular_grid.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
 
+        // Only chunks of wires and vias in the viewport are drawn.
+        vias.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
+        wires.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
+
+        for (auto& composited_layer : composited_layers)
+        {
+            composited_layer->vias.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
+            composited_layer->wires.viewport_update(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y));
+        }
+
         if (draw_grid)
             regular_grid.update();
 
 		projection.setToIdentity();
 		projection.ortho(viewport_min_x, viewport_max_x, viewport_max_y, viewport_min_y, -1, 1);
+
+        // The ID buffer has the size of the render area in device pixels.
+        picking.viewport_update(get_safe_bounding_box(BoundingBox(viewport_min_x, viewport_max_x, viewport_min_y, viewport_max_y)),
+                                projection,
+                                static_cast<int>(width() * devicePixelRatioF()),
+                                static_cast<int>(height() * devicePixelRatioF()));
 	}
 
 	void WorkspaceRenderer::mousePressEvent(QMouseEvent* event)
@@ -653,7 +829,10 @@ namespace degate
 		mouse_last_pos = get_opengl_mouse_position();
 
 		if (event->button() == Qt::LeftButton)
+		{
 			setCursor(Qt::ClosedHandCursor);
+			hovering_object = false;
+		}
 
         // Area selection + CTRL
         if (event->button() == Qt::RightButton &&
@@ -671,7 +850,10 @@ namespace degate
 		QOpenGLWidget::mouseReleaseEvent(event);
 
 		if (event->button() == Qt::LeftButton)
+		{
 			setCursor(Qt::CrossCursor);
+			hovering_object = false;
+		}
 
 		// Selection
 		if (event->button() == Qt::LeftButton && !mouse_moved)
@@ -679,53 +861,8 @@ namespace degate
 			if (project == nullptr)
 				return;
 
-			QPointF pos = get_opengl_mouse_position();
-
-			LogicModel_shptr lmodel = project->get_logic_model();
-			Layer_shptr layer = lmodel->get_current_layer();
-            PlacedLogicModelObject_shptr plo = layer->get_object_at_position(pos.x(),
-                                                                             pos.y(),
-                                                                             0,
-                                                                             !draw_annotations,
-                                                                             !draw_gates,
-                                                                             !draw_ports,
-                                                                             !draw_emarkers,
-                                                                             !draw_vias,
-                                                                             !draw_wires);
-
-			// Check if there is a gate or gate port on the logic layer
-            try
-            {
-                PlacedLogicModelObject_shptr logic_plo;
-                layer = get_first_logic_layer(lmodel);
-                logic_plo = layer->get_object_at_position(pos.x(),
-                                                          pos.y(),
-                                                          0,
-                                                          true,
-                                                          !draw_gates,
-                                                          !draw_ports,
-                                                          true,
-                                                          true,
-                                                          true);
-
-                if (plo == nullptr)
-                {
-                    plo = logic_plo;
-                }
-                else if (std::dynamic_pointer_cast<GatePort>(logic_plo) != nullptr)
-                {
-                    plo = logic_plo;
-                }
-                else if (std::dynamic_pointer_cast<Via>(plo) == nullptr &&
-                         std::dynamic_pointer_cast<EMarker>(plo) == nullptr &&
-                         std::dynamic_pointer_cast<Gate>(logic_plo) != nullptr)
-                {
-                    plo = logic_plo;
-                }
-            }
-            catch (CollectionLookupException const&)
-            {
-            }
+			// Same priorities as Layer::get_object_at_position, plus gates and ports of the logic layer.
+			PlacedLogicModelObject_shptr plo = pick_object_under_mouse();
 
             // If no CTRL reset selection (single selection)
 			if (!selected_objects.empty() && !QApplication::keyboardModifiers().testFlag(Qt::ControlModifier))
@@ -770,7 +907,7 @@ namespace degate
 
             last_created_wire = new_wire;
 
-            emit project_changed();
+            emit logic_model_changed();
 
             update_wires();
         }
@@ -893,6 +1030,17 @@ namespace degate
             update();
         }
 
+		// Hover feedback
+		if (event->buttons() == Qt::NoButton && project != nullptr)
+		{
+		    const bool hovering = pick_object_under_mouse() != nullptr;
+
+		    if (hovering != hovering_object)
+		        setCursor(hovering ? Qt::PointingHandCursor : Qt::CrossCursor);
+
+		    hovering_object = hovering;
+		}
+
 		// Mouse coords signal
 		emit mouse_coords_changed(get_opengl_mouse_position().x(), get_opengl_mouse_position().y());
 	}
@@ -1005,38 +1153,48 @@ namespace degate
 					AnnotationEditDialog dialog(this, annotation);
 					dialog.exec();
 
+					project->get_logic_model()->set_object_changed(annotation);
+
                     makeCurrent();
 					annotations.update();
 					update();
 
-                    emit project_changed();
+                    emit logic_model_changed();
 				}
                 else if (EMarker_shptr emarker = std::dynamic_pointer_cast<EMarker>(plo))
                 {
                     EMarkerEditDialog dialog(this, emarker);
                     dialog.exec();
 
+                    project->get_logic_model()->set_object_changed(emarker);
+
                     makeCurrent();
                     emarkers.update();
                     update();
 
-                    emit project_changed();
+                    emit logic_model_changed();
                 }
                 else if (Via_shptr via = std::dynamic_pointer_cast<Via>(plo))
                 {
                     ViaEditDialog dialog(this, via, project);
                     dialog.exec();
 
+                    project->get_logic_model()->set_object_changed(via);
+
                     makeCurrent();
                     vias.update();
                     update();
 
-                    emit project_changed();
+                    emit logic_model_changed();
                 }
+
+                // Edited objects may have changed (e.g. gate ports).
+                picking.update();
 			}
 		}
 
 		setCursor(Qt::CrossCursor);
+		hovering_object = false;
 	}
 
 	void WorkspaceRenderer::zoom_in()
@@ -38,11 +38,14 @@
 #include "GUI/Workspace/WorkspaceWires.h"
 #include "GUI/Workspace/WorkspaceWireTool.h"
 #include "GUI/Workspace/WorkspaceRegularGrid.h"
+#include "GUI/Workspace/WorkspacePicking.h"
 
 #include <QtOpenGL/QtOpenGL>
 #include <QtOpenGLWidgets/QtOpenGLWidgets>
 #include <list>
+#include <memory>
 #include <tuple>
+#include <vector>
 
 /**
  * This define the zoom out factor (zoom *= zoom_out).
@@ -67,6 +70,21 @@
 
 namespace degate
 {
+    /**
+     * @struct WorkspaceCompositedLayer
+     * @brief Wires and vias of a layer composited over the current layer.
+     */
+    struct WorkspaceCompositedLayer
+    {
+        explicit WorkspaceCompositedLayer(QWidget* parent) : wires(parent), vias(parent)
+        {
+        }
+
+        Layer_shptr layer = nullptr;
+        WorkspaceWires wires;
+        WorkspaceVias vias;
+    };
+
     /**
      * List of usable workspace tools.
      */
@@ -363,6 +381,13 @@ namespace degate
          */
         void show_wires(bool value);
 
+        /**
+         * Draw composited layers over the current layer or not (@see Layer::set_composited).
+         *
+         * @param value : if true then composited layers will be drawn, not otherwise.
+         */
+        void set_composite_layers(bool value);
+
         /**
          * Show the grid or not.
          *
@@ -426,6 +451,12 @@ namespace degate
          */
         void project_changed();
 
+        /**
+         * Signal emitted when the logic model changed and the changes are recorded
+         * by the logic model (see LogicModel::get_changes()).
+         */
+        void logic_model_changed();
+
     protected:
         /**
          * Get a safe position regarding project size (0 <= position <= max project size).
@@ -448,6 +479,19 @@ namespace degate
         BoundingBox get_safe_bounding_box(BoundingBox bounding_box) const;
 
     private:
+        /**
+         * Create, update or remove the composited layers elements regarding the current
+         * layer and the composited layers of the project.
+         */
+        void update_composited_layers();
+
+        /**
+         * Get the object under the mouse, with the ID buffer (@see WorkspacePicking).
+         *
+         * @return Returns the object, nullptr if there is no object.
+         */
+        PlacedLogicModelObject_shptr pick_object_under_mouse();
+
         // General
         Project_shptr project = nullptr;
         bool initialized = false;
@@ -483,6 +527,14 @@ namespace degate
         // Wires
         WorkspaceWires wires;
 
+        // Object picking (ID buffer)
+        WorkspacePicking picking;
+        bool hovering_object = false;
+
+        // Composited layers (wires and vias of other layers, drawn over the background)
+        std::vector<std::unique_ptr<WorkspaceCompositedLayer>> composited_layers;
+        bool composite_layers = false;
+
         // Selection tool
         WorkspaceSelectionTool selection_tool;
 
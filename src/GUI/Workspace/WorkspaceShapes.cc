@@ -0,0 +1,222 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "WorkspaceShapes.h"
+#include "Core/Image/Image.h"
+
+namespace degate
+{
+    WorkspaceShapes::~WorkspaceShapes()
+    {
+        if (program != nullptr)
+            delete program;
+
+        if (QOpenGLContext::currentContext() == nullptr || context == nullptr)
+            return;
+
+        if (context->glIsBuffer(quad_vbo) == GL_TRUE)
+            context->glDeleteBuffers(1, &quad_vbo);
+
+        if (context->glIsBuffer(instance_vbo) == GL_TRUE)
+            context->glDeleteBuffers(1, &instance_vbo);
+
+        if (vao.isCreated())
+            vao.destroy();
+    }
+
+    void WorkspaceShapes::init()
+    {
+        // Instanced draw calls are part of OpenGL 3.3 (like the shaders below).
+        context = QOpenGLContext::currentContext()->extraFunctions();
+
+        context->glGenBuffers(1, &quad_vbo);
+        context->glGenBuffers(1, &instance_vbo);
+        vao.create();
+
+        QOpenGLShader* vshader = new QOpenGLShader(QOpenGLShader::Vertex);
+        const char* vsrc =
+                "#version 330 core\n"
+                "in vec2 corner;\n"
+                "in vec2 pos;\n"
+                "in float size;\n"
+                "in vec3 color;\n"
+                "in float alpha;\n"
+                "in float shape;\n"
+                "uniform mat4 mvp;\n"
+                "out vec2 local_pos;\n"
+                "out vec4 out_color;\n"
+                "flat out int out_shape;\n"
+                "void main(void)\n"
+                "{\n"
+                "    gl_Position = mvp * vec4(pos + corner * size / 2.0, 0.0, 1.0);\n"
+                "    local_pos = corner;\n"
+                "    out_color = vec4(color, alpha);\n"
+                "    out_shape = int(shape + 0.5);\n"
+                "}\n";
+        vshader->compileSourceCode(vsrc);
+
+        // local_pos is in [-1, 1], the y axis goes down.
+        QOpenGLShader* fshader = new QOpenGLShader(QOpenGLShader::Fragment);
+        const char* fsrc =
+                "#version 330 core\n"
+                "in vec2 local_pos;\n"
+                "in vec4 out_color;\n"
+                "flat in int out_shape;\n"
+                "uniform float opacity;\n"
+                "out vec4 color;\n"
+                "void main(void)\n"
+                "{\n"
+                "    float u = local_pos.x;\n"
+                "    float v = local_pos.y;\n"
+                "    if (out_shape == 1 && abs(u) < 0.5 && abs(v) < 0.5)\n"
+                "        discard;\n"
+                "    if (out_shape == 2 && u < -abs(v))\n"
+                "        discard;\n"
+                "    if (out_shape == 3 && u > 0.0 && u + abs(v) > 1.0)\n"
+                "        discard;\n"
+                "    color = vec4(out_color.rgb, out_color.a * opacity);\n"
+                "}\n";
+        fshader->compileSourceCode(fsrc);
+
+        program = new QOpenGLShaderProgram;
+        program->addShader(vshader);
+        program->addShader(fshader);
+
+        program->link();
+
+        delete vshader;
+        delete fshader;
+
+        // The quad shared by all instances (triangle strip).
+        const QVector2D corners[] = {QVector2D(-1, -1), QVector2D(1, -1), QVector2D(-1, 1), QVector2D(1, 1)};
+
+        vao.bind();
+        context->glBindBuffer(GL_ARRAY_BUFFER, quad_vbo);
+        context->glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        vao.release();
+    }
+
+    void WorkspaceShapes::resize(std::size_t size)
+    {
+        instances.resize(size);
+    }
+
+    void WorkspaceShapes::set_instance(std::size_t index, float x, float y, float size, color_t color, WorkspaceShape shape)
+    {
+        set_instance(instances, index, x, y, size, color, shape);
+    }
+
+    void WorkspaceShapes::set_instance(WorkspaceVertexBuffer<ShapeInstance2D>& instances,
+                                       std::size_t index,
+                                       float x,
+                                       float y,
+                                       float size,
+                                       color_t color,
+                                       WorkspaceShape shape)
+    {
+        ShapeInstance2D* instance = instances.data(index);
+
+        instance->pos = QVector2D(x, y);
+        instance->size = size;
+        instance->color = QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0);
+        instance->alpha = MASK_A(color) / 255.0;
+        instance->shape = static_cast<float>(shape);
+    }
+
+    void WorkspaceShapes::set_dirty(std::size_t index)
+    {
+        instances.set_dirty(index, 1);
+    }
+
+    void WorkspaceShapes::upload()
+    {
+        vao.bind();
+        instances.upload(context, instance_vbo);
+        vao.release();
+    }
+
+    void WorkspaceShapes::draw(const QMatrix4x4& projection)
+    {
+        if (instances.size() == 0)
+            return;
+
+        // Send instances updated since the last frame.
+        instances.flush(context, instance_vbo);
+
+        draw_instances(projection, instance_vbo, instances.size());
+    }
+
+    void WorkspaceShapes::set_opacity(float value)
+    {
+        opacity = value;
+    }
+
+    void WorkspaceShapes::draw_instances(const QMatrix4x4& projection, GLuint instance_vbo, std::size_t count)
+    {
+        if (count == 0)
+            return;
+
+        program->bind();
+
+        program->setUniformValue("mvp", projection);
+        program->setUniformValue("opacity", opacity);
+
+        vao.bind();
+
+        // Per vertex attribute.
+        context->glBindBuffer(GL_ARRAY_BUFFER, quad_vbo);
+
+        program->enableAttributeArray("corner");
+        program->setAttributeBuffer("corner", GL_FLOAT, 0, 2, sizeof(QVector2D));
+
+        // Per instance attributes.
+        context->glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+
+        program->enableAttributeArray("pos");
+        program->setAttributeBuffer("pos", GL_FLOAT, 0, 2, sizeof(ShapeInstance2D));
+        context->glVertexAttribDivisor(program->attributeLocation("pos"), 1);
+
+        program->enableAttributeArray("size");
+        program->setAttributeBuffer("size", GL_FLOAT, 2 * sizeof(float), 1, sizeof(ShapeInstance2D));
+        context->glVertexAttribDivisor(program->attributeLocation("size"), 1);
+
+        program->enableAttributeArray("color");
+        program->setAttributeBuffer("color", GL_FLOAT, 3 * sizeof(float), 3, sizeof(ShapeInstance2D));
+        context->glVertexAttribDivisor(program->attributeLocation("color"), 1);
+
+        program->enableAttributeArray("alpha");
+        program->setAttributeBuffer("alpha", GL_FLOAT, 6 * sizeof(float), 1, sizeof(ShapeInstance2D));
+        context->glVertexAttribDivisor(program->attributeLocation("alpha"), 1);
+
+        program->enableAttributeArray("shape");
+        program->setAttributeBuffer("shape", GL_FLOAT, 7 * sizeof(float), 1, sizeof(ShapeInstance2D));
+        context->glVertexAttribDivisor(program->attributeLocation("shape"), 1);
+
+        context->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+
+        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        vao.release();
+
+        program->release();
+    }
+}
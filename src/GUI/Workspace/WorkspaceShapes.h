@@ -0,0 +1,176 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __WORKSPACESHAPES_H__
+#define __WORKSPACESHAPES_H__
+
+#include "Globals.h"
+#include "GUI/Workspace/WorkspaceVertexBuffer.h"
+
+#include <QtOpenGL/QtOpenGL>
+#include <QOpenGLExtraFunctions>
+
+namespace degate
+{
+    /**
+     * Shapes that can be drawn by WorkspaceShapes.
+     * Each shape fits in a square of the instance size, centered on the instance position.
+     */
+    enum WorkspaceShape
+    {
+        SHAPE_SQUARE = 0,   /**< A filled square (emarker, undefined or in/out port). */
+        SHAPE_VIA = 1,      /**< A square with a square hole of half size. */
+        SHAPE_PORT_IN = 2,  /**< A square with a notch on the left side. */
+        SHAPE_PORT_OUT = 3  /**< A square with an arrow head on the right side. */
+    };
+
+    /**
+     * Per instance data of a shape.
+     */
+    struct ShapeInstance2D
+    {
+        QVector2D pos;
+        float size;
+        QVector3D color;
+        float alpha;
+        float shape;
+    };
+
+    /**
+     * @class WorkspaceShapes
+     * @brief Draw many small shapes with a single instanced draw call.
+     *
+     * One shape is a quad (shared by all instances) and a ShapeInstance2D. The outline of
+     * the shape is computed in the fragment shader, so only one instance is stored per
+     * object instead of all its triangles.
+     *
+     * Like Text, it has its own vao and buffers and must be initialized in the OpenGL
+     * context where it will be drawn.
+     */
+    class WorkspaceShapes
+    {
+    public:
+
+        WorkspaceShapes() = default;
+        ~WorkspaceShapes();
+
+        /**
+         * Init all OpenGL routine (buffers, shaders...) in the current context.
+         */
+        void init();
+
+        /**
+         * Set the number of instances. All instances are reset.
+         *
+         * @param size : the new number of instances.
+         */
+        void resize(std::size_t size);
+
+        /**
+         * Get the number of instances.
+         */
+        inline std::size_t size() const
+        {
+            return instances.size();
+        }
+
+        /**
+         * Set an instance. The instance is sent with the next upload or draw call.
+         *
+         * @warning Can be called from multiple threads, for different instances.
+         *
+         * @param index : the index of the instance.
+         * @param x : the x coordinate of the center of the shape.
+         * @param y : the y coordinate of the center of the shape.
+         * @param size : the width (and height) of the shape.
+         * @param color : the color of the shape.
+         * @param shape : the shape.
+         */
+        void set_instance(std::size_t index, float x, float y, float size, color_t color, WorkspaceShape shape);
+
+        /**
+         * Set an instance of an external instance buffer (@see draw_instances).
+         *
+         * @param instances : the instance buffer.
+         * @param index : the index of the instance.
+         * @param x : the x coordinate of the center of the shape.
+         * @param y : the y coordinate of the center of the shape.
+         * @param size : the width (and height) of the shape.
+         * @param color : the color of the shape.
+         * @param shape : the shape.
+         */
+        static void set_instance(WorkspaceVertexBuffer<ShapeInstance2D>& instances,
+                                 std::size_t index,
+                                 float x,
+                                 float y,
+                                 float size,
+                                 color_t color,
+                                 WorkspaceShape shape);
+
+        /**
+         * Mark an instance as modified after set_instance, outside of a full upload.
+         *
+         * @param index : the index of the instance.
+         */
+        void set_dirty(std::size_t index);
+
+        /**
+         * Send all instances.
+         */
+        void upload();
+
+        /**
+         * Draw all instances (modified instances are sent before).
+         *
+         * @param projection : the projection matrix to apply.
+         */
+        void draw(const QMatrix4x4& projection);
+
+        /**
+         * Draw instances stored in another vbo, with the shader of this object.
+         *
+         * @param projection : the projection matrix to apply.
+         * @param instance_vbo : the vbo of the instances (filled with ShapeInstance2D).
+         * @param count : the number of instances.
+         */
+        void draw_instances(const QMatrix4x4& projection, GLuint instance_vbo, std::size_t count);
+
+        /**
+         * Set the opacity applied to all instances (e.g. for composited layers).
+         *
+         * @param value : the opacity, 1 by default.
+         */
+        void set_opacity(float value);
+
+    private:
+        QOpenGLExtraFunctions* context = nullptr;
+        QOpenGLShaderProgram* program = nullptr;
+        QOpenGLVertexArrayObject vao;
+        GLuint quad_vbo = 0;
+        GLuint instance_vbo = 0;
+        float opacity = 1;
+
+        WorkspaceVertexBuffer<ShapeInstance2D> instances;
+    };
+}
+
+#endif //__WORKSPACESHAPES_H__
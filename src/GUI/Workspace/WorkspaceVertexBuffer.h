@@ -0,0 +1,183 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __WORKSPACEVERTEXBUFFER_H__
+#define __WORKSPACEVERTEXBUFFER_H__
+
+#include <QtOpenGL/QtOpenGL>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <vector>
+
+// Number of objects assembled by one task of a parallel buffer update.
+#define WORKSPACE_ASSEMBLY_CHUNK_SIZE 4096
+
+namespace degate
+{
+    /**
+     * Call a function for each index in [0, count). Large ranges are split in chunks
+     * that run on the Qt thread pool. The function must only write its own vertices.
+     *
+     * @param count : the number of indices.
+     * @param function : called as function(index).
+     */
+    template <typename Function>
+    void for_each_index(std::size_t count, Function function)
+    {
+        if (count <= WORKSPACE_ASSEMBLY_CHUNK_SIZE)
+        {
+            for (std::size_t i = 0; i < count; i++)
+                function(i);
+
+            return;
+        }
+
+        std::vector<std::size_t> chunks((count + WORKSPACE_ASSEMBLY_CHUNK_SIZE - 1) / WORKSPACE_ASSEMBLY_CHUNK_SIZE);
+        std::iota(chunks.begin(), chunks.end(), 0);
+
+        QtConcurrent::blockingMap(chunks, [&](std::size_t const& chunk)
+        {
+            const std::size_t end = std::min(count, (chunk + 1) * WORKSPACE_ASSEMBLY_CHUNK_SIZE);
+
+            for (std::size_t i = chunk * WORKSPACE_ASSEMBLY_CHUNK_SIZE; i < end; i++)
+                function(i);
+        });
+    }
+
+    /**
+     * @class WorkspaceVertexBuffer
+     * @brief CPU side copy of the vertices of a vbo.
+     *
+     * Vertices are assembled in a contiguous array and sent with a single call: upload()
+     * replaces the whole vbo and flush() only sends the range modified since the last
+     * upload or flush (@see set_dirty). Workspace elements flush once per frame, before drawing.
+     */
+    template <typename VertexType>
+    class WorkspaceVertexBuffer
+    {
+    public:
+
+        /**
+         * Set the number of vertices. All vertices are reset.
+         *
+         * @param size : the new number of vertices.
+         */
+        void resize(std::size_t size)
+        {
+            vertices.assign(size, VertexType());
+            dirty_begin = dirty_end = 0;
+        }
+
+        /**
+         * Get the number of vertices.
+         */
+        std::size_t size() const
+        {
+            return vertices.size();
+        }
+
+        /**
+         * Get the vertices starting at an index.
+         *
+         * @param index : the index of the first vertex.
+         */
+        VertexType* data(std::size_t index = 0)
+        {
+            assert(index < vertices.size());
+            return vertices.data() + index;
+        }
+
+        /**
+         * Mark vertices as modified, they will be sent with the next flush.
+         *
+         * @param first : the index of the first modified vertex.
+         * @param count : the number of modified vertices.
+         */
+        void set_dirty(std::size_t first, std::size_t count)
+        {
+            if (count == 0)
+                return;
+
+            if (dirty_begin == dirty_end)
+            {
+                dirty_begin = first;
+                dirty_end = first + count;
+            }
+            else
+            {
+                dirty_begin = std::min(dirty_begin, first);
+                dirty_end = std::max(dirty_end, first + count);
+            }
+        }
+
+        /**
+         * Replace the whole content of a vbo with the vertices.
+         *
+         * @param context : the OpenGL functions of the current context.
+         * @param vbo : the vbo to fill.
+         */
+        void upload(QOpenGLFunctions* context, GLuint vbo)
+        {
+            context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            context->glBufferData(GL_ARRAY_BUFFER,
+                                  vertices.size() * sizeof(VertexType),
+                                  vertices.empty() ? nullptr : vertices.data(),
+                                  GL_STATIC_DRAW);
+            context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            dirty_begin = dirty_end = 0;
+        }
+
+        /**
+         * Send the modified vertices to a vbo that was filled with upload() before.
+         *
+         * @param context : the OpenGL functions of the current context.
+         * @param vbo : the vbo to update.
+         */
+        void flush(QOpenGLFunctions* context, GLuint vbo)
+        {
+            if (dirty_begin == dirty_end)
+                return;
+
+            context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            context->glBufferSubData(GL_ARRAY_BUFFER,
+                                     dirty_begin * sizeof(VertexType),
+                                     (dirty_end - dirty_begin) * sizeof(VertexType),
+                                     vertices.data() + dirty_begin);
+            context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            dirty_begin = dirty_end = 0;
+        }
+
+    private:
+        std::vector<VertexType> vertices;
+
+        // Modified range [dirty_begin, dirty_end).
+        std::size_t dirty_begin = 0;
+        std::size_t dirty_end = 0;
+    };
+}
+
+#endif //__WORKSPACEVERTEXBUFFER_H__
@@ -20,18 +20,12 @@
  */
 
 #include "WorkspaceVias.h"
+#include "WorkspaceCoverage.h"
 
 #define TEXT_PADDING 2
 
 namespace degate
 {
-    struct ViasVertex2D
-    {
-        QVector2D pos;
-        QVector3D color;
-        float alpha;
-    };
-
     WorkspaceVias::WorkspaceVias(QWidget *parent) : WorkspaceElement(parent), text(parent)
     {
 
@@ -39,7 +33,10 @@ namespace degate
 
     WorkspaceVias::~WorkspaceVias()
     {
+        if (QOpenGLContext::currentContext() == nullptr || context == nullptr)
+            return;
 
+        chunks.clear(std::bind(&WorkspaceVias::release_chunk, this, std::placeholders::_1));
     }
 
     void WorkspaceVias::init()
@@ -47,41 +44,7 @@ namespace degate
         WorkspaceElement::init();
 
         text.init();
-
-        QOpenGLShader* vshader = new QOpenGLShader(QOpenGLShader::Vertex);
-        const char* vsrc =
-                "#version 330 core\n"
-                "in vec2 pos;\n"
-                "in vec3 color;\n"
-                "in float alpha;\n"
-                "uniform mat4 mvp;\n"
-                "out vec4 out_color;\n"
-                "void main(void)\n"
-                "{\n"
-                "    gl_Position = mvp * vec4(pos, 0.0, 1.0);\n"
-                "    out_color = vec4(color, alpha);\n"
-                "}\n";
-        vshader->compileSourceCode(vsrc);
-
-        QOpenGLShader* fshader = new QOpenGLShader(QOpenGLShader::Fragment);
-        const char* fsrc =
-                "#version 330 core\n"
-                "in vec4 out_color;\n"
-                "out vec4 color;\n"
-                "void main(void)\n"
-                "{\n"
-                "    color = out_color;\n"
-                "}\n";
-        fshader->compileSourceCode(fsrc);
-
-        program = new QOpenGLShaderProgram;
-        program->addShader(vshader);
-        program->addShader(fshader);
-
-        program->link();
-
-        delete vshader;
-        delete fshader;
+        shapes.init();
     }
 
     void WorkspaceVias::update()
@@ -91,12 +54,15 @@ namespace degate
 
         assert(context->glGetError() == GL_NO_ERROR);
 
-        Layer_shptr layer = project->get_logic_model()->get_current_layer();
+        chunks.clear(std::bind(&WorkspaceVias::release_chunk, this, std::placeholders::_1));
+        vias_count = 0;
+
+        Layer_shptr layer = this->layer != nullptr ? this->layer : project->get_logic_model()->get_current_layer();
 
         if (layer == nullptr)
             return;
 
-        // Keep only emarkers of the active layer.
+        // Keep only vias of the layer.
         std::vector<Via_shptr> vias;
         for (Layer::object_iterator iter = layer->objects_begin(); iter != layer->objects_end(); ++iter)
         {
@@ -107,28 +73,15 @@ namespace degate
         }
         vias_count = static_cast<unsigned int>(vias.size());
 
+        // Chunks are built when they become visible (@see draw).
+        chunks.set_objects(vias, get_chunk_size(layer));
+
         if (vias_count == 0)
             return;
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-        context->glBufferData(GL_ARRAY_BUFFER, vias_count * 24 * sizeof(ViasVertex2D), nullptr, GL_STATIC_DRAW);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
-
         unsigned text_size = 0;
-
-        unsigned index = 0;
         for (auto& e : vias)
-        {
-            create_via(e, index);
-            e->set_index(index);
-
             text_size += static_cast<unsigned int>(e->get_name().length());
-            index++;
-        }
 
         text.update(text_size);
 
@@ -140,7 +93,6 @@ namespace degate
             text.add_sub_text(text_offset, x, y, e->get_name(), 5, QVector3D(255, 255, 255), 1, true, false);
 
             text_offset += static_cast<unsigned int>(e->get_name().length());
-            index++;
         }
 
         assert(context->glGetError() == GL_NO_ERROR);
@@ -151,160 +103,140 @@ namespace degate
         if (via == nullptr)
             return;
 
-        create_via(via, via->get_index());
-    }
+        unsigned offset = 0;
+        auto chunk = chunks.get_chunk(via->get_index(), offset);
 
-    void WorkspaceVias::draw(const QMatrix4x4& projection)
-    {
-        if (project == nullptr || vias_count == 0)
+        if (chunk == nullptr || chunk->objects[offset] != via)
             return;
 
-        program->bind();
-
-        program->setUniformValue("mvp", projection);
+        chunks.update_bounds(via->get_index());
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        // Not built chunks will read the via when they become visible.
+        if (!chunk->built)
+            return;
 
-        program->enableAttributeArray("pos");
-        program->setAttributeBuffer("pos", GL_FLOAT, 0, 2, sizeof(ViasVertex2D));
+        // Coverage cells mix several vias, rebuild the chunk.
+        if (chunk->simplified)
+        {
+            chunks.invalidate(via->get_index(), std::bind(&WorkspaceVias::release_chunk, this, std::placeholders::_1));
+            return;
+        }
 
-        program->enableAttributeArray("color");
-        program->setAttributeBuffer("color", GL_FLOAT, 2 * sizeof(float), 3, sizeof(ViasVertex2D));
+        create_via(via, chunk->data.instances, offset);
+        chunk->data.instances.set_dirty(offset, 1);
+    }
 
-        program->enableAttributeArray("alpha");
-        program->setAttributeBuffer("alpha", GL_FLOAT, 5 * sizeof(float), 1, sizeof(ViasVertex2D));
+    void WorkspaceVias::viewport_update(const BoundingBox& viewport)
+    {
+        this->viewport = viewport;
+    }
 
-        context->glDrawArrays(GL_TRIANGLES, 0, vias_count * 24);
+    void WorkspaceVias::set_simplified(bool value)
+    {
+        simplified = value;
+    }
 
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+    void WorkspaceVias::set_layer(Layer_shptr const& layer)
+    {
+        this->layer = layer;
+    }
 
-        program->release();
+    void WorkspaceVias::set_opacity(float value)
+    {
+        shapes.set_opacity(value);
     }
 
-    void WorkspaceVias::draw_name(const QMatrix4x4 &projection)
+    void WorkspaceVias::draw(const QMatrix4x4& projection)
     {
         if (project == nullptr || vias_count == 0)
             return;
 
-        text.draw(projection);
+        chunks.draw(viewport,
+                    simplified,
+                    std::bind(&WorkspaceVias::build_chunk, this, std::placeholders::_1),
+                    std::bind(&WorkspaceVias::draw_chunk, this, std::placeholders::_1, std::cref(projection)),
+                    std::bind(&WorkspaceVias::release_chunk, this, std::placeholders::_1));
     }
 
-    void WorkspaceVias::create_via(Via_shptr &via, unsigned int index)
+    std::size_t WorkspaceVias::build_chunk(WorkspaceChunks<Via, ViasChunk>::Chunk& chunk)
     {
-        if (via == nullptr)
-            return;
-
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        auto& instances = chunk.data.instances;
 
-        const float hole_radius = via->get_diameter() / 4.0;
+        if (chunk.simplified)
+        {
+            // Zoomed out: draw coverage cells instead of vias.
+            WorkspaceCoverage coverage(chunk.bounds, chunks.get_chunk_width() / WORKSPACE_COVERAGE_CELLS);
 
-        // Vertices and colors
+            for (auto& via : chunk.objects)
+                coverage.add_box(via->get_bounding_box(), get_via_color(via));
 
-        color_t color;
+            instances.resize(coverage.get_cells_count());
 
-        if (via->get_direction() == Via::DIRECTION_UP)
-            color = via->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_VIA_UP) : via->get_fill_color();
-        else if (via->get_direction() == Via::DIRECTION_DOWN)
-            color = via->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_VIA_DOWN) : via->get_fill_color();
+            unsigned index = 0;
+            coverage.for_each_cell([&](BoundingBox const& cell, color_t color)
+            {
+                WorkspaceShapes::set_instance(instances, index, cell.get_center_x(), cell.get_center_y(), cell.get_width(), color, SHAPE_SQUARE);
+                index++;
+            });
+        }
         else
-            color = via->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_EMARKER) : via->get_fill_color();
-
-        color = highlight_color_by_state(color, via->get_highlighted());
-
-        ViasVertex2D temp;
-        temp.color = QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0);
-        temp.alpha = MASK_A(color) / 255.0;
-
-
-        // Rect 1
-
-        temp.pos = QVector2D(via->get_x() - via->get_diameter() / 2.0, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 0 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 1 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() - via->get_diameter() / 2.0, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 2 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 3 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() - via->get_diameter() / 2.0, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 4 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 5 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-
-        // Rect 2
-
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 6 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 7 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() - hole_radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 8 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() - hole_radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 9 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 10 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() - hole_radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 11 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-
-
-        // Rect 3
-
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 12 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() + via->get_diameter() / 2.0, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 13 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
-
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 14 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+        {
+            // Assemble all instances on the CPU side, then send them at once.
+            instances.resize(chunk.objects.size());
 
-        temp.pos = QVector2D(via->get_x() + via->get_diameter() / 2.0, via->get_y() - via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 15 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+            for_each_index(chunk.objects.size(), [&](std::size_t i)
+            {
+                create_via(chunk.objects[i], instances, static_cast<unsigned>(i));
+            });
+        }
 
-        temp.pos = QVector2D(via->get_x() + via->get_diameter() / 2.0, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 16 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+        context->glGenBuffers(1, &chunk.data.vbo);
+        instances.upload(context, chunk.data.vbo);
 
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 17 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+        return instances.size() * sizeof(ShapeInstance2D);
+    }
 
+    void WorkspaceVias::draw_chunk(WorkspaceChunks<Via, ViasChunk>::Chunk& chunk, const QMatrix4x4& projection)
+    {
+        // Send vias updated since the last frame.
+        chunk.data.instances.flush(context, chunk.data.vbo);
 
+        shapes.draw_instances(projection, chunk.data.vbo, chunk.data.instances.size());
+    }
 
-        // Rect 4
+    void WorkspaceVias::release_chunk(WorkspaceChunks<Via, ViasChunk>::Chunk& chunk)
+    {
+        if (context->glIsBuffer(chunk.data.vbo) == GL_TRUE)
+            context->glDeleteBuffers(1, &chunk.data.vbo);
+    }
 
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() + hole_radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 18 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+    void WorkspaceVias::draw_name(const QMatrix4x4 &projection)
+    {
+        if (project == nullptr || vias_count == 0)
+            return;
 
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 19 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+        text.draw(projection);
+    }
 
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() + hole_radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 20 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+    color_t WorkspaceVias::get_via_color(Via_shptr const& via) const
+    {
+        color_t color;
 
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() + hole_radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 21 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+        if (via->get_direction() == Via::DIRECTION_UP)
+            color = via->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_VIA_UP) : via->get_fill_color();
+        else if (via->get_direction() == Via::DIRECTION_DOWN)
+            color = via->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_VIA_DOWN) : via->get_fill_color();
+        else
+            color = via->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_EMARKER) : via->get_fill_color();
 
-        temp.pos = QVector2D(via->get_x() + hole_radius, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 22 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+        return highlight_color_by_state(color, via->get_highlighted());
+    }
 
-        temp.pos = QVector2D(via->get_x() - hole_radius, via->get_y() + via->get_diameter() / 2.0);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 24 * sizeof(ViasVertex2D) + 23 * sizeof(ViasVertex2D), sizeof(ViasVertex2D), &temp);
+    void WorkspaceVias::create_via(Via_shptr const& via, WorkspaceVertexBuffer<ShapeInstance2D>& instances, unsigned int index)
+    {
+        if (via == nullptr)
+            return;
 
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        WorkspaceShapes::set_instance(instances, index, via->get_x(), via->get_y(), via->get_diameter(), get_via_color(via), SHAPE_VIA);
     }
 }
\ No newline at end of file
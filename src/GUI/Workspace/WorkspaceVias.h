@@ -23,16 +23,29 @@
 #define __WORKSPACEVIAS_H__
 
 #include "GUI/Workspace/WorkspaceElement.h"
+#include "GUI/Workspace/WorkspaceShapes.h"
+#include "GUI/Workspace/WorkspaceChunks.h"
 #include "Core/LogicModel/Via/Via.h"
 #include "GUI/Text/Text.h"
 
 namespace degate
 {
+    /**
+     * OpenGL buffers of a chunk of vias (@see WorkspaceChunks).
+     */
+    struct ViasChunk
+    {
+        GLuint vbo = 0;
+        WorkspaceVertexBuffer<ShapeInstance2D> instances;
+    };
+
     /**
      * @class WorkspaceVias
      * @brief Prepare and draw all vias of the active layer on the workspace.
      *
-     * The parent vbo buffer will store all squares.
+     * Vias are split in spatial chunks (@see WorkspaceChunks), each one with its own instance
+     * buffer drawn with a single instanced draw call (@see WorkspaceShapes).
+     * Only chunks that intersect the viewport are built and drawn.
      *
      * @see WorkspaceElement
      */
@@ -61,6 +74,7 @@ namespace degate
 
         /**
          * Update a specific via (update buffers).
+         * The instance is sent with the next draw call.
          *
          * @warning Call the update() function before.
          *
@@ -69,7 +83,36 @@ namespace degate
         void update(Via_shptr& via);
 
         /**
-         * Draw all vias (draw the square and outline buffers).
+         * Update the viewport (used to select visible chunks).
+         *
+         * @param viewport : the new viewport bounding box.
+         */
+        void viewport_update(const BoundingBox& viewport);
+
+        /**
+         * Set the level of detail. If simplified, visible chunks are drawn as coverage
+         * cells instead of individual vias (@see WorkspaceCoverage).
+         *
+         * @param value : true to draw the simplified version.
+         */
+        void set_simplified(bool value);
+
+        /**
+         * Set the layer of the drawn vias.
+         *
+         * @param layer : the layer, if null the current layer is used.
+         */
+        void set_layer(Layer_shptr const& layer);
+
+        /**
+         * Set the opacity of the drawn vias (used for layers composition).
+         *
+         * @param value : the opacity, between 0 and 1.
+         */
+        void set_opacity(float value);
+
+        /**
+         * Draw all visible vias (draw the square and outline buffers).
          *
          * @param projection : the projection matrix to apply.
          */
@@ -84,12 +127,42 @@ namespace degate
 
     private:
         /**
-         * Create an via in OpenGL buffers.
+         * Create an via instance.
          *
          * @param via : the via object.
-         * @param index : the index of the annotation for OpenGL buffers.
+         * @param instances : the instance buffer of the chunk of the via.
+         * @param index : the index of the via in its chunk.
+         */
+        void create_via(Via_shptr const& via, WorkspaceVertexBuffer<ShapeInstance2D>& instances, unsigned index);
+
+        /**
+         * Get the color of a via (from its direction, with highlighting).
+         */
+        color_t get_via_color(Via_shptr const& via) const;
+
+        /**
+         * Fill the buffers of a chunk.
+         *
+         * @return Returns the memory used by the chunk (in bytes).
          */
-        void create_via(Via_shptr& via, unsigned index);
+        std::size_t build_chunk(WorkspaceChunks<Via, ViasChunk>::Chunk& chunk);
+
+        /**
+         * Draw a chunk.
+         */
+        void draw_chunk(WorkspaceChunks<Via, ViasChunk>::Chunk& chunk, const QMatrix4x4& projection);
+
+        /**
+         * Release the buffers of a chunk.
+         */
+        void release_chunk(WorkspaceChunks<Via, ViasChunk>::Chunk& chunk);
+
+        WorkspaceShapes shapes;
+        WorkspaceChunks<Via, ViasChunk> chunks;
+        BoundingBox viewport;
+        bool simplified = false;
+
+        Layer_shptr layer = nullptr; // If null, the current layer.
 
         Text text;
         unsigned vias_count = 0;
@@ -20,16 +20,10 @@
  */
 
 #include "WorkspaceWires.h"
+#include "WorkspaceCoverage.h"
 
 namespace degate
 {
-    struct WiresVertex2D
-    {
-        QVector2D pos;
-        QVector3D color;
-        float alpha;
-    };
-
     WorkspaceWires::WorkspaceWires(QWidget *parent) : WorkspaceElement(parent)
     {
 
@@ -37,7 +31,10 @@ namespace degate
 
     WorkspaceWires::~WorkspaceWires()
     {
+        if (QOpenGLContext::currentContext() == nullptr || context == nullptr)
+            return;
 
+        chunks.clear(std::bind(&WorkspaceWires::release_chunk, this, std::placeholders::_1));
     }
 
     void WorkspaceWires::init()
@@ -63,10 +60,11 @@ namespace degate
         const char* fsrc =
                 "#version 330 core\n"
                 "in vec4 out_color;\n"
+                "uniform float opacity;\n"
                 "out vec4 color;\n"
                 "void main(void)\n"
                 "{\n"
-                "    color = out_color;\n"
+                "    color = vec4(out_color.rgb, out_color.a * opacity);\n"
                 "}\n";
         fshader->compileSourceCode(fsrc);
 
@@ -87,12 +85,15 @@ namespace degate
 
         assert(context->glGetError() == GL_NO_ERROR);
 
-        Layer_shptr layer = project->get_logic_model()->get_current_layer();
+        chunks.clear(std::bind(&WorkspaceWires::release_chunk, this, std::placeholders::_1));
+        wires_count = 0;
+
+        Layer_shptr layer = this->layer != nullptr ? this->layer : project->get_logic_model()->get_current_layer();
 
         if (layer == nullptr)
             return;
 
-        // Keep only wires of the active layer.
+        // Keep only wires of the layer.
         std::vector<Wire_shptr> wires;
         for (Layer::object_iterator iter = layer->objects_begin(); iter != layer->objects_end(); ++iter)
         {
@@ -103,34 +104,58 @@ namespace degate
         }
         wires_count = static_cast<unsigned int>(wires.size());
 
-        if (wires_count == 0)
+        // Chunks are built when they become visible (@see draw).
+        chunks.set_objects(wires, get_chunk_size(layer));
+
+        assert(context->glGetError() == GL_NO_ERROR);
+    }
+
+    void WorkspaceWires::update(Wire_shptr &wire)
+    {
+        if (wire == nullptr)
             return;
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        unsigned offset = 0;
+        auto chunk = chunks.get_chunk(wire->get_index(), offset);
 
-        context->glBufferData(GL_ARRAY_BUFFER, wires_count * 6 * sizeof(WiresVertex2D), nullptr, GL_STATIC_DRAW);
+        if (chunk == nullptr || chunk->objects[offset] != wire)
+            return;
 
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        chunks.update_bounds(wire->get_index());
 
-        unsigned index = 0;
-        for (auto& e : wires)
+        // Not built chunks will read the wire when they become visible.
+        if (!chunk->built)
+            return;
+
+        // Coverage cells mix several wires, rebuild the chunk.
+        if (chunk->simplified)
         {
-            create_wire(e, index);
-            e->set_index(index);
-            index++;
+            chunks.invalidate(wire->get_index(), std::bind(&WorkspaceWires::release_chunk, this, std::placeholders::_1));
+            return;
         }
 
-        assert(context->glGetError() == GL_NO_ERROR);
+        create_wire(wire, chunk->data.vertices, offset);
+        chunk->data.vertices.set_dirty(offset * 6, 6);
     }
 
-    void WorkspaceWires::update(Wire_shptr &wire)
+    void WorkspaceWires::viewport_update(const BoundingBox& viewport)
     {
-        if (wire == nullptr)
-            return;
+        this->viewport = viewport;
+    }
+
+    void WorkspaceWires::set_simplified(bool value)
+    {
+        simplified = value;
+    }
 
-        create_wire(wire, wire->get_index());
+    void WorkspaceWires::set_layer(Layer_shptr const& layer)
+    {
+        this->layer = layer;
+    }
+
+    void WorkspaceWires::set_opacity(float value)
+    {
+        opacity = value;
     }
 
     void WorkspaceWires::draw(const QMatrix4x4 &projection)
@@ -141,9 +166,85 @@ namespace degate
         program->bind();
 
         program->setUniformValue("mvp", projection);
+        program->setUniformValue("opacity", opacity);
 
         vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+        chunks.draw(viewport,
+                    simplified,
+                    std::bind(&WorkspaceWires::build_chunk, this, std::placeholders::_1),
+                    std::bind(&WorkspaceWires::draw_chunk, this, std::placeholders::_1),
+                    std::bind(&WorkspaceWires::release_chunk, this, std::placeholders::_1));
+
+        vao.release();
+
+        program->release();
+    }
+
+    std::size_t WorkspaceWires::build_chunk(WorkspaceChunks<Wire, WiresChunk>::Chunk& chunk)
+    {
+        auto& vertices = chunk.data.vertices;
+
+        if (chunk.simplified)
+        {
+            // Zoomed out: draw coverage cells instead of wires.
+            WorkspaceCoverage coverage(chunk.bounds, chunks.get_chunk_width() / WORKSPACE_COVERAGE_CELLS);
+
+            for (auto& wire : chunk.objects)
+                coverage.add_line(wire->get_from_x(), wire->get_from_y(), wire->get_to_x(), wire->get_to_y(), wire->get_diameter(), get_wire_color(wire));
+
+            vertices.resize(coverage.get_cells_count() * 6);
+
+            unsigned index = 0;
+            coverage.for_each_cell([&](BoundingBox const& cell, color_t color)
+            {
+                WiresVertex2D temp;
+                temp.color = QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0);
+                temp.alpha = MASK_A(color) / 255.0;
+
+                WiresVertex2D* out = vertices.data(index * 6);
+
+                temp.pos = QVector2D(cell.get_min_x(), cell.get_min_y());
+                out[0] = temp;
+                out[3] = temp;
+
+                temp.pos = QVector2D(cell.get_max_x(), cell.get_min_y());
+                out[1] = temp;
+
+                temp.pos = QVector2D(cell.get_max_x(), cell.get_max_y());
+                out[2] = temp;
+                out[4] = temp;
+
+                temp.pos = QVector2D(cell.get_min_x(), cell.get_max_y());
+                out[5] = temp;
+
+                index++;
+            });
+        }
+        else
+        {
+
+            // Assemble all vertices on the CPU side, then send them at once.
+            vertices.resize(chunk.objects.size() * 6);
+
+            for_each_index(chunk.objects.size(), [&](std::size_t i)
+            {
+                create_wire(chunk.objects[i], vertices, static_cast<unsigned>(i));
+            });
+        }
+
+        context->glGenBuffers(1, &chunk.data.vbo);
+        vertices.upload(context, chunk.data.vbo);
+
+        return vertices.size() * sizeof(WiresVertex2D);
+    }
+
+    void WorkspaceWires::draw_chunk(WorkspaceChunks<Wire, WiresChunk>::Chunk& chunk)
+    {
+        // Send wires updated since the last frame.
+        chunk.data.vertices.flush(context, chunk.data.vbo);
+
+        context->glBindBuffer(GL_ARRAY_BUFFER, chunk.data.vbo);
 
         program->enableAttributeArray("pos");
         program->setAttributeBuffer("pos", GL_FLOAT, 0, 2, sizeof(WiresVertex2D));
@@ -154,27 +255,34 @@ namespace degate
         program->enableAttributeArray("alpha");
         program->setAttributeBuffer("alpha", GL_FLOAT, 5 * sizeof(float), 1, sizeof(WiresVertex2D));
 
-        context->glDrawArrays(GL_TRIANGLES, 0, wires_count * 6);
+        context->glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(chunk.data.vertices.size()));
 
         context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+    }
 
-        program->release();
+    void WorkspaceWires::release_chunk(WorkspaceChunks<Wire, WiresChunk>::Chunk& chunk)
+    {
+        if (context->glIsBuffer(chunk.data.vbo) == GL_TRUE)
+            context->glDeleteBuffers(1, &chunk.data.vbo);
     }
 
-    void WorkspaceWires::create_wire(Wire_shptr &wire, unsigned int index)
+    color_t WorkspaceWires::get_wire_color(Wire_shptr const& wire) const
+    {
+        color_t color = wire->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_EMARKER) : wire->get_fill_color();
+
+        return highlight_color_by_state(color, wire->get_highlighted());
+    }
+
+    void WorkspaceWires::create_wire(Wire_shptr const& wire, WorkspaceVertexBuffer<WiresVertex2D>& vertices, unsigned int index)
     {
         if (wire == nullptr)
             return;
 
-        vao.bind();
-        context->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        WiresVertex2D* out = vertices.data(index * 6);
 
         // Vertices and colors
 
-        color_t color = wire->get_fill_color() == 0 ? project->get_default_color(DEFAULT_COLOR_EMARKER) : wire->get_fill_color();
-
-        color = highlight_color_by_state(color, wire->get_highlighted());
+        color_t color = get_wire_color(wire);
 
         WiresVertex2D temp;
         temp.color = QVector3D(MASK_R(color) / 255.0, MASK_G(color) / 255.0, MASK_B(color) / 255.0);
@@ -192,24 +300,21 @@ namespace degate
         perpendicular_vector.normalize();
 
         temp.pos = QVector2D(from_x + perpendicular_vector.x() * radius, from_y + perpendicular_vector.y() * radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(WiresVertex2D) + 0 * sizeof(WiresVertex2D), sizeof(WiresVertex2D), &temp);
+        out[0] = temp;
 
         temp.pos = QVector2D(from_x - perpendicular_vector.x() * radius, from_y - perpendicular_vector.y() * radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(WiresVertex2D) + 1 * sizeof(WiresVertex2D), sizeof(WiresVertex2D), &temp);
+        out[1] = temp;
 
         temp.pos = QVector2D(to_x + perpendicular_vector.x() * radius, to_y + perpendicular_vector.y() * radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(WiresVertex2D) + 2 * sizeof(WiresVertex2D), sizeof(WiresVertex2D), &temp);
+        out[2] = temp;
 
         temp.pos = QVector2D(to_x + perpendicular_vector.x() * radius, to_y + perpendicular_vector.y() * radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(WiresVertex2D) + 4 * sizeof(WiresVertex2D), sizeof(WiresVertex2D), &temp);
+        out[4] = temp;
 
         temp.pos = QVector2D(to_x - perpendicular_vector.x() * radius, to_y - perpendicular_vector.y() * radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(WiresVertex2D) + 3 * sizeof(WiresVertex2D), sizeof(WiresVertex2D), &temp);
+        out[3] = temp;
 
         temp.pos = QVector2D(from_x - perpendicular_vector.x() * radius, from_y - perpendicular_vector.y() * radius);
-        context->glBufferSubData(GL_ARRAY_BUFFER, index * 6 * sizeof(WiresVertex2D) + 5 * sizeof(WiresVertex2D), sizeof(WiresVertex2D), &temp);
-
-        context->glBindBuffer(GL_ARRAY_BUFFER, 0);
-        vao.release();
+        out[5] = temp;
     }
 }
\ No newline at end of file
@@ -23,17 +23,35 @@
 #define __WORKSPACEWIRES_H__
 
 #include "GUI/Workspace/WorkspaceElement.h"
+#include "GUI/Workspace/WorkspaceVertexBuffer.h"
+#include "GUI/Workspace/WorkspaceChunks.h"
 #include "Core/LogicModel/Wire/Wire.h"
 #include "GUI/Text/Text.h"
 
 namespace degate
 {
+    struct WiresVertex2D
+    {
+        QVector2D pos;
+        QVector3D color;
+        float alpha;
+    };
+
+    /**
+     * OpenGL buffers of a chunk of wires (@see WorkspaceChunks).
+     */
+    struct WiresChunk
+    {
+        GLuint vbo = 0;
+        WorkspaceVertexBuffer<WiresVertex2D> vertices;
+    };
 
     /**
      * @class WorkspaceEMarkers
      * @brief Prepare and draw all wires of the active layer on the workspace.
      *
-     * The parent vbo buffer will store all squares.
+     * Wires are split in spatial chunks (@see WorkspaceChunks), each one with its own vbo.
+     * Only chunks that intersect the viewport are built and drawn.
      *
      * @see WorkspaceElement
      */
@@ -62,6 +80,7 @@ namespace degate
 
         /**
          * Update a specific wire (update buffers).
+         * The vbo is updated with the next draw call.
          *
          * @warning Call the update() function before.
          *
@@ -70,7 +89,36 @@ namespace degate
         void update(Wire_shptr& wire);
 
         /**
-         * Draw all wires (draw the square and outline buffers).
+         * Update the viewport (used to select visible chunks).
+         *
+         * @param viewport : the new viewport bounding box.
+         */
+        void viewport_update(const BoundingBox& viewport);
+
+        /**
+         * Set the level of detail. If simplified, visible chunks are drawn as coverage
+         * cells instead of individual wires (@see WorkspaceCoverage).
+         *
+         * @param value : true to draw the simplified version.
+         */
+        void set_simplified(bool value);
+
+        /**
+         * Set the layer of the drawn wires.
+         *
+         * @param layer : the layer, if null the current layer is used.
+         */
+        void set_layer(Layer_shptr const& layer);
+
+        /**
+         * Set the opacity of the drawn wires (used for layers composition).
+         *
+         * @param value : the opacity, between 0 and 1.
+         */
+        void set_opacity(float value);
+
+        /**
+         * Draw all visible wires (draw the square and outline buffers).
          *
          * @param projection : the projection matrix to apply.
          */
@@ -79,12 +127,42 @@ namespace degate
 
     private:
         /**
-         * Create an wire in OpenGL buffers.
+         * Create an wire in a vertex buffer.
          *
          * @param wire : the wire object.
-         * @param index : the index of the annotation for OpenGL buffers.
+         * @param vertices : the vertex buffer of the chunk of the wire.
+         * @param index : the index of the wire in its chunk.
+         */
+        void create_wire(Wire_shptr const& wire, WorkspaceVertexBuffer<WiresVertex2D>& vertices, unsigned index);
+
+        /**
+         * Get the color of a wire (with highlighting).
          */
-        void create_wire(Wire_shptr& wire, unsigned index);
+        color_t get_wire_color(Wire_shptr const& wire) const;
+
+        /**
+         * Fill the buffers of a chunk.
+         *
+         * @return Returns the memory used by the chunk (in bytes).
+         */
+        std::size_t build_chunk(WorkspaceChunks<Wire, WiresChunk>::Chunk& chunk);
+
+        /**
+         * Draw a chunk (the program and the vao must be bound).
+         */
+        void draw_chunk(WorkspaceChunks<Wire, WiresChunk>::Chunk& chunk);
+
+        /**
+         * Release the buffers of a chunk.
+         */
+        void release_chunk(WorkspaceChunks<Wire, WiresChunk>::Chunk& chunk);
+
+        WorkspaceChunks<Wire, WiresChunk> chunks;
+        BoundingBox viewport;
+        bool simplified = false;
+
+        Layer_shptr layer = nullptr; // If null, the current layer.
+        float opacity = 1;
 
         unsigned wires_count = 0;
 
@@ -24,7 +24,10 @@
 #include "Core/LogicModel/Gate/GateLibrary.h"
 #include "Core/LogicModel/Gate/GateTemplate.h"
 #include "Core/LogicModel/Gate/GateTemplatePort.h"
+#include "Core/Image/Manipulation/ImageManipulation.h"
+#include "Core/Utils/FileSystem.h"
 
+#include <fstream>
 #include <memory>
 
 #include "catch.hpp"
@@ -61,4 +64,66 @@ TEST_CASE("Gate library exporter", "[GateLibraryExporter]")
      */
     GateLibraryImporter reimporter;
     GateLibrary_shptr glib2(reimporter.import(filename));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Gate library exporter skips unmodified images", "[GateLibraryExporter]")
+{
+    GateLibraryImporter importer;
+    GateLibrary_shptr glib(importer.import("tests_files/test_project/gate_library.xml"));
+    REQUIRE(glib != nullptr);
+
+    GateTemplate_shptr tmpl;
+    for (GateLibrary::template_iterator iter = glib->begin(); iter != glib->end(); ++iter)
+    {
+        if (!iter->second->get_image_layer_types().empty())
+        {
+            tmpl = iter->second;
+            break;
+        }
+    }
+    REQUIRE(tmpl != nullptr);
+
+    Layer::LAYER_TYPE layer_type = tmpl->get_image_layer_types().front();
+    REQUIRE(!tmpl->get_image_file(layer_type).empty());
+
+    std::string directory = create_temp_directory();
+    std::string filename = join_pathes(directory, "gate_library.xml");
+
+    /*
+     * A new directory gets all images.
+     */
+    GateLibraryExporter exporter(std::make_shared<ObjectIDRewriter>(false));
+    exporter.export_data(filename, glib);
+
+    std::string image_file = tmpl->get_image_file(layer_type);
+    REQUIRE(get_basedir(image_file) == get_basedir(filename));
+    REQUIRE(file_exists(image_file));
+    REQUIRE(!file_exists(image_file + ".tmp"));
+
+    REQUIRE(boost::filesystem::file_size(image_file) > 0);
+
+    GateTemplateImage_shptr img = tmpl->get_image(layer_type);
+    REQUIRE(img != nullptr);
+
+    /*
+     * An unmodified image is not written again.
+     */
+    std::ofstream(image_file, std::ios::trunc).close();
+
+    exporter.export_data(filename, glib);
+    REQUIRE(boost::filesystem::file_size(image_file) == 0);
+
+    /*
+     * A modified image is written again.
+     */
+    GateTemplateImage_shptr new_img = std::make_shared<GateTemplateImage>(img->get_width(), img->get_height());
+    copy_image<GateTemplateImage, GateTemplateImage>(new_img, img);
+    tmpl->set_image(layer_type, new_img);
+    REQUIRE(tmpl->get_image_file(layer_type).empty());
+
+    exporter.export_data(filename, glib);
+    REQUIRE(boost::filesystem::file_size(image_file) > 0);
+    REQUIRE(tmpl->get_image_file(layer_type) == image_file);
+
+    remove_directory(directory);
+}
@@ -24,8 +24,11 @@
 #include "Core/LogicModel/Gate/GateLibrary.h"
 #include "Core/LogicModel/Gate/GateTemplate.h"
 #include "Core/LogicModel/Gate/GateTemplatePort.h"
+#include "Core/LogicModel/Gate/GateTemplateImageCache.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "catch.hpp"
 
@@ -68,4 +71,48 @@ TEST_CASE("Gate library importer", "[GateLibraryImporter]")
     }
 
     REQUIRE(i > 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Gate template images are loaded on demand", "[GateLibraryImporter]")
+{
+    GateTemplateImageCache& cache = GateTemplateImageCache::get_instance();
+    const std::size_t max_size = cache.get_max_size();
+    cache.clear();
+
+    GateLibraryImporter importer;
+    GateLibrary_shptr glib(importer.import("tests_files/test_project/gate_library.xml"));
+    REQUIRE(glib != nullptr);
+
+    // Nothing is loaded at import.
+    REQUIRE(cache.get_size() == 0);
+
+    std::vector<std::pair<GateTemplate_shptr, Layer::LAYER_TYPE>> images;
+    for (auto iter = glib->begin(); iter != glib->end(); ++iter)
+        for (Layer::LAYER_TYPE layer_type : iter->second->get_image_layer_types())
+            images.emplace_back(iter->second, layer_type);
+
+    REQUIRE(images.size() > 1);
+
+    GateTemplateImage_shptr first = images[0].first->get_image(images[0].second);
+    REQUIRE(first != nullptr);
+    REQUIRE(cache.get_size() > 0);
+
+    // While it is used, the same image is returned.
+    REQUIRE(images[0].first->get_image(images[0].second) == first);
+
+    // With no budget, only the last used image stays in the cache.
+    cache.set_max_size(0);
+
+    std::weak_ptr<GateTemplateImage> weak_first = first;
+    first.reset();
+
+    GateTemplateImage_shptr second = images[1].first->get_image(images[1].second);
+    REQUIRE(second != nullptr);
+    REQUIRE(weak_first.expired());
+
+    // And it is loaded again when needed.
+    REQUIRE(images[0].first->get_image(images[0].second) != nullptr);
+
+    cache.set_max_size(max_size);
+    cache.clear();
+}
@@ -26,6 +26,8 @@
 
 #include "catch.hpp"
 
+#include <vector>
+
 using namespace degate;
 
 TEST_CASE("Test rgba in memory", "[ImageTests]")
@@ -116,6 +118,16 @@ TEST_CASE("Test image reader", "[ImageTests]")
 
     TileImage_RGBA_shptr img = read_image(tiff_reader,10 /* tiles of size 1024x1024 */);
 
+    // Sync loading: tiles are never temporary.
+    REQUIRE(img->is_loaded(0, 0) == true);
+
+    // Copy for worker threads: same data as the working tile.
+    std::vector<rgba_pixel_t> tile(img->get_tile_size() * img->get_tile_size());
+    std::vector<rgba_pixel_t> fetched(img->get_tile_size() * img->get_tile_size());
+    img->raw_copy(tile.data(), 0, 0);
+    REQUIRE(img->fetch_raw_copy(fetched.data(), 0, 0) == true);
+    REQUIRE(tile == fetched);
+
     std::string tiff_out("degate_image_test.tif");
 
     if (file_exists(tiff_out)) remove_file(tiff_out);
@@ -57,3 +57,36 @@ TEST_CASE("Test import", "[LogicModelImporter]")
     LogicModel_shptr lmodel2(lm_importer.import(filename, ProjectType::Normal));
     REQUIRE(lmodel2 != nullptr);
 }
+
+TEST_CASE("Test import content", "[LogicModelImporter]")
+{
+    GateLibraryImporter gate_library_importer;
+    GateLibrary_shptr glib(gate_library_importer.import("tests_files/test_project/gate_library.xml"));
+    REQUIRE(glib != nullptr);
+
+    LogicModelImporter lm_importer(500, 500, glib);
+    LogicModel_shptr lmodel(lm_importer.import("tests_files/test_project/lmodel.xml", ProjectType::Normal));
+    REQUIRE(lmodel != nullptr);
+
+    REQUIRE(lmodel->get_gates_count() == 1);
+    REQUIRE(lmodel->get_vias_count() == 0);
+    REQUIRE(lmodel->get_annotations_count() == 0);
+
+    Gate_shptr gate = std::dynamic_pointer_cast<Gate>(lmodel->get_object(1));
+    REQUIRE(gate != nullptr);
+    REQUIRE(gate->get_name() == "test_gate_1");
+    REQUIRE(gate->get_orientation() == Gate::ORIENTATION_NORMAL);
+    REQUIRE(gate->get_min_x() == Approx(14.86));
+    REQUIRE(gate->get_max_y() == Approx(60.048));
+    REQUIRE(gate->has_template());
+    REQUIRE(gate->get_ports_number() == 2);
+
+    REQUIRE(std::dynamic_pointer_cast<GatePort>(lmodel->get_object(2)) != nullptr);
+    REQUIRE(std::dynamic_pointer_cast<GatePort>(lmodel->get_object(4)) != nullptr);
+
+    Module_shptr main_module = lmodel->get_main_module();
+    REQUIRE(main_module != nullptr);
+    REQUIRE(main_module->get_object_id() == 5);
+    REQUIRE(std::distance(main_module->gates_begin(), main_module->gates_end()) == 1);
+    REQUIRE(*main_module->gates_begin() == gate);
+}
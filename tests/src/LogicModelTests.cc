@@ -22,6 +22,9 @@
 #include "Core/LogicModel/Wire/Wire.h"
 #include "Core/LogicModel/LogicModel.h"
 
+#include <set>
+#include <string>
+
 #include "catch.hpp"
 
 using namespace degate;
@@ -68,6 +71,29 @@ TEST_CASE("Test add layer", "[LogicModel]")
     lmodel->remove_layer(3);
 }
 
+TEST_CASE("Test layer composition", "[LogicModel]")
+{
+    Layer_shptr layer = std::make_shared<Layer>(BoundingBox(100, 100), ProjectType::Normal);
+
+    REQUIRE(layer->is_composited() == false);
+    REQUIRE(layer->get_composition_tint() == 0);
+
+    layer->set_composited(true);
+    layer->set_composition_opacity(2.0f);
+    REQUIRE(layer->get_composition_opacity() == 1.0f);
+
+    layer->set_composition_opacity(-1.0f);
+    REQUIRE(layer->get_composition_opacity() == 0.0f);
+
+    layer->set_composition_opacity(0.25f);
+    layer->set_composition_tint(MERGE_CHANNELS(255, 0, 0, 255));
+
+    auto clone = std::dynamic_pointer_cast<Layer>(layer->clone_shallow());
+    REQUIRE(clone->is_composited() == true);
+    REQUIRE(clone->get_composition_opacity() == 0.25f);
+    REQUIRE(clone->get_composition_tint() == MERGE_CHANNELS(255, 0, 0, 255));
+}
+
 TEST_CASE("Test add and retrieve placed logic model", "[LogicModel]")
 {
     LogicModel_shptr lmodel(new LogicModel(100, 100, ProjectType::Normal));
@@ -125,4 +151,80 @@ TEST_CASE("Test add and retrieve wire", "[LogicModel]")
     }
 
     REQUIRE(i > 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test pooled object creation", "[LogicModel]")
+{
+    LogicModel_shptr lmodel(new LogicModel(100, 100, ProjectType::Normal));
+
+    for(int j = 0; j < 2000; j++)
+    {
+        Wire_shptr w = lmodel->create_object<Wire>(20, 21, 30, 31, 5);
+        REQUIRE(w != nullptr);
+        REQUIRE(w->has_valid_object_id() == false);
+
+        lmodel->add_object(0, w);
+        REQUIRE(lmodel->get_object(w->get_object_id()) == w);
+    }
+
+    Via_shptr v = lmodel->create_object<Via>(10, 10, 5, Via::DIRECTION_UP);
+    lmodel->add_object(0, v);
+
+    auto statistics = lmodel->get_object_pool_statistics();
+    REQUIRE(statistics.size() == 2);
+
+    std::size_t live_objects = 0;
+    std::set<std::string> names;
+    for (auto const& entry : statistics)
+    {
+        REQUIRE(entry.block_size > 0);
+        REQUIRE(entry.reserved_bytes >= entry.live_objects * entry.block_size);
+        live_objects += entry.live_objects;
+        names.insert(entry.name);
+    }
+    REQUIRE(live_objects == 2001);
+
+    // Pool names are not translated.
+    REQUIRE(names == std::set<std::string>{"Wire", "Via"});
+
+    // Objects must stay valid after the destruction of the logic model.
+    lmodel.reset();
+    REQUIRE(v->get_x() == 10);
+}
+
+TEST_CASE("Test change listeners", "[LogicModel]")
+{
+    LogicModel_shptr lmodel(new LogicModel(100, 100, ProjectType::Normal));
+
+    auto listener = std::make_shared<LogicModel::ChangeSet>();
+    lmodel->add_change_listener(listener);
+
+    Wire_shptr w(new Wire(20, 21, 30, 31, 5));
+    lmodel->add_object(0, w);
+
+    REQUIRE(listener->changed_objects.count(w->get_object_id()) == 1);
+
+    // Clearing the own change set doesn't affect listeners.
+    lmodel->clear_changes();
+    REQUIRE(lmodel->get_changes().empty());
+    REQUIRE(listener->changed_objects.count(w->get_object_id()) == 1);
+
+    lmodel->remove_object(w);
+    REQUIRE(listener->changed_objects.count(w->get_object_id()) == 0);
+    REQUIRE(listener->removed_objects.count(w->get_object_id()) == 1);
+
+    // Released listeners are not filled anymore, they are removed on the next change.
+    auto other_listener = std::make_shared<LogicModel::ChangeSet>();
+    lmodel->add_change_listener(other_listener);
+    REQUIRE(lmodel->get_change_listeners_count() == 2);
+
+    std::weak_ptr<LogicModel::ChangeSet> released_listener = listener;
+    listener.reset();
+    REQUIRE(released_listener.expired());
+
+    Wire_shptr w2(new Wire(20, 21, 30, 31, 5));
+    lmodel->add_object(0, w2);
+    REQUIRE(lmodel->get_change_listeners_count() == 1);
+    REQUIRE(other_listener->changed_objects.count(w2->get_object_id()) == 1);
+    REQUIRE(lmodel->get_changes().changed_objects.size() == 1);
+}
@@ -0,0 +1,126 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "Core/Project/ProjectArchiver.h"
+#include "Core/Utils/FileSystem.h"
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+#include "catch.hpp"
+
+using namespace degate;
+
+static void write_test_file(std::string const& path, std::string const& content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+static std::string read_test_file(std::string const& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("Project archiver", "[ProjectArchiver]")
+{
+    /*
+     * A small project: a compressible file, an incompressible tile, an empty file and a scaling directory.
+     */
+    std::string project_dir = create_temp_directory();
+    std::string layer_dir = join_pathes(project_dir, "layer_0.dimg");
+    std::string scaling_dir = join_pathes(layer_dir, "scaling_2.dimg");
+    create_directory(layer_dir);
+    create_directory(scaling_dir);
+
+    std::string text;
+    for (int i = 0; i < 1000; i++)
+        text += "<gate id=\"" + std::to_string(i) + "\"/>\n";
+
+    std::string tile(64 * 1024, '\0');
+    std::mt19937 generator(42);
+    for (auto& c : tile)
+        c = static_cast<char>(generator() & 0xFF);
+
+    write_test_file(join_pathes(project_dir, "project.xml"), text);
+    write_test_file(join_pathes(project_dir, "empty.xml"), "");
+    write_test_file(join_pathes(layer_dir, "0_0.dat"), tile);
+    write_test_file(join_pathes(scaling_dir, "0_0.dat"), tile.substr(0, 1024));
+
+    std::string archive_dir = create_temp_directory();
+    std::string archive_file = join_pathes(archive_dir, "project.zip");
+
+    for (int compression_level : {0, 6})
+    {
+        /*
+         * Export
+         */
+        ProjectArchiver archiver(compression_level, true);
+        archiver.export_data(project_dir, archive_file, "project");
+
+        REQUIRE(file_exists(archive_file));
+        REQUIRE(archiver.get_statistics().file_count == 3);
+        REQUIRE(archiver.get_statistics().uncompressed_bytes == text.size() + tile.size());
+
+        if (compression_level == 0)
+            REQUIRE(archiver.get_statistics().compressed_bytes == archiver.get_statistics().uncompressed_bytes);
+        else
+            REQUIRE(archiver.get_statistics().compressed_bytes < text.size() + tile.size());
+
+        /*
+         * Import
+         */
+        std::string import_dir = create_temp_directory();
+        archiver.import_data(archive_file, import_dir);
+
+        REQUIRE(archiver.get_statistics().file_count == 3);
+
+        std::string imported_project = join_pathes(import_dir, "project");
+        REQUIRE(read_test_file(join_pathes(imported_project, "project.xml")) == text);
+        REQUIRE(read_test_file(join_pathes(imported_project, "layer_0.dimg/0_0.dat")) == tile);
+        REQUIRE(file_exists(join_pathes(imported_project, "empty.xml")));
+        REQUIRE(read_test_file(join_pathes(imported_project, "empty.xml")).empty());
+
+        // Created again when the project is opened.
+        REQUIRE(!file_exists(join_pathes(imported_project, "layer_0.dimg/scaling_2.dimg")));
+
+        remove_directory(import_dir);
+    }
+
+    /*
+     * Scalings can be kept.
+     */
+    ProjectArchiver archiver(6, false);
+    archiver.export_data(project_dir, archive_file);
+    REQUIRE(archiver.get_statistics().file_count == 4);
+
+    std::string import_dir = create_temp_directory();
+    archiver.import_data(archive_file, import_dir);
+    REQUIRE(read_test_file(join_pathes(import_dir, "layer_0.dimg/scaling_2.dimg/0_0.dat")) == tile.substr(0, 1024));
+
+    remove_directory(import_dir);
+    remove_directory(archive_dir);
+    remove_directory(project_dir);
+}
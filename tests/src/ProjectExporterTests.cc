@@ -22,6 +22,16 @@
 #include "Core/Project/ProjectImporter.h"
 #include "Core/Project/ProjectExporter.h"
 #include "Core/Project/Project.h"
+#include "Core/LogicModel/LogicModelExporter.h"
+#include "Core/LogicModel/LogicModelImporter.h"
+#include "Core/LogicModel/LogicModelBinaryExporter.h"
+#include "Core/LogicModel/LogicModelBinaryImporter.h"
+#include "Core/LogicModel/LogicModelBinaryFormat.h"
+#include "TestProject.h"
+
+#include <clocale>
+#include <cstring>
+#include <string>
 
 #include "catch.hpp"
 
@@ -42,6 +52,212 @@ TEST_CASE("Test project export", "[ProjectExporter]")
     /*
      * export project data
      */
+    const std::string directory = copy_test_project();
+
     ProjectExporter exporter;
-    REQUIRE_NOTHROW(exporter.export_all("tests_files/test_project", prj));
-}
\ No newline at end of file
+    REQUIRE_NOTHROW(exporter.export_all(directory, prj));
+
+    remove_directory(directory);
+}
+
+TEST_CASE("Test logic model export", "[ProjectExporter]")
+{
+    ProjectImporter importer;
+    Project_shptr prj(importer.import_all("tests_files/test_project/project.xml"));
+    REQUIRE(prj != nullptr);
+
+    LogicModel_shptr lmodel = prj->get_logic_model();
+    REQUIRE(lmodel != nullptr);
+
+    /*
+     * Export the logic model without object ID rewriting and import it again
+     */
+    LogicModelExporter exporter(std::make_shared<ObjectIDRewriter>(false));
+    REQUIRE_NOTHROW(exporter.export_data("tests_files/lmodel_export.xml", lmodel));
+
+    LogicModelImporter lm_importer(prj->get_width(), prj->get_height(), lmodel->get_gate_library());
+    LogicModel_shptr lmodel2(lm_importer.import("tests_files/lmodel_export.xml", ProjectType::Normal));
+    REQUIRE(lmodel2 != nullptr);
+
+    REQUIRE(lmodel2->get_gates_count() == lmodel->get_gates_count());
+    REQUIRE(lmodel2->get_vias_count() == lmodel->get_vias_count());
+    REQUIRE(lmodel2->get_wires_count() == lmodel->get_wires_count());
+    REQUIRE(lmodel2->get_emarkers_count() == lmodel->get_emarkers_count());
+    REQUIRE(lmodel2->get_annotations_count() == lmodel->get_annotations_count());
+
+    for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter)
+    {
+        Gate_shptr gate = std::dynamic_pointer_cast<Gate>(lmodel2->get_object(iter->first));
+        REQUIRE(gate != nullptr);
+        REQUIRE(gate->get_name() == iter->second->get_name());
+        REQUIRE(gate->get_min_x() == Approx(iter->second->get_min_x()));
+        REQUIRE(gate->get_max_y() == Approx(iter->second->get_max_y()));
+        REQUIRE(gate->get_ports_number() == iter->second->get_ports_number());
+    }
+
+    REQUIRE(lmodel2->get_main_module()->get_object_id() == lmodel->get_main_module()->get_object_id());
+}
+
+TEST_CASE("Test logic model export with a decimal comma locale", "[ProjectExporter]")
+{
+    ProjectImporter importer;
+    Project_shptr prj(importer.import_all("tests_files/test_project/project.xml"));
+    REQUIRE(prj != nullptr);
+
+    LogicModel_shptr lmodel = prj->get_logic_model();
+    REQUIRE(lmodel != nullptr);
+
+    Wire_shptr wire = std::make_shared<Wire>(10.25f, 20.5f, 30.75f, 40.125f, 5);
+    lmodel->add_object(0, wire);
+
+    /*
+     * Switch to a locale that uses a comma as decimal separator (if one is installed),
+     * the previous locale is restored when leaving the test (even on failure).
+     */
+    struct LocaleRestorer
+    {
+        std::string previous = setlocale(LC_NUMERIC, nullptr);
+        ~LocaleRestorer() { setlocale(LC_NUMERIC, previous.c_str()); }
+    } locale_restorer;
+
+    const char* locale = nullptr;
+    for (const char* name : {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "de_DE", "fr_FR"})
+    {
+        locale = setlocale(LC_NUMERIC, name);
+        if (locale != nullptr)
+            break;
+    }
+
+    if (locale == nullptr)
+        WARN("No decimal comma locale is installed, the export is only checked with the current locale.");
+
+    LogicModelExporter exporter(std::make_shared<ObjectIDRewriter>(false));
+    REQUIRE_NOTHROW(exporter.export_data("tests_files/lmodel_export_locale.xml", lmodel));
+
+    LogicModelImporter lm_importer(prj->get_width(), prj->get_height(), lmodel->get_gate_library());
+    LogicModel_shptr lmodel2(lm_importer.import("tests_files/lmodel_export_locale.xml", ProjectType::Normal));
+    REQUIRE(lmodel2 != nullptr);
+
+    Wire_shptr wire2 = std::dynamic_pointer_cast<Wire>(lmodel2->get_object(wire->get_object_id()));
+    REQUIRE(wire2 != nullptr);
+    REQUIRE(wire2->get_from_x() == Approx(10.25f));
+    REQUIRE(wire2->get_from_y() == Approx(20.5f));
+    REQUIRE(wire2->get_to_x() == Approx(30.75f));
+    REQUIRE(wire2->get_to_y() == Approx(40.125f));
+
+    QFile::remove("tests_files/lmodel_export_locale.xml");
+}
+
+TEST_CASE("Test binary logic model export", "[ProjectExporter]")
+{
+    ProjectImporter importer;
+    Project_shptr prj(importer.import_all("tests_files/test_project/project.xml"));
+    REQUIRE(prj != nullptr);
+
+    LogicModel_shptr lmodel = prj->get_logic_model();
+    REQUIRE(lmodel != nullptr);
+
+    LogicModelBinaryExporter exporter(std::make_shared<ObjectIDRewriter>(false));
+    REQUIRE_NOTHROW(exporter.export_data("tests_files/lmodel_export.bin", lmodel));
+
+    LogicModelBinaryImporter lm_importer(prj->get_width(), prj->get_height(), lmodel->get_gate_library());
+    LogicModel_shptr lmodel2(lm_importer.import("tests_files/lmodel_export.bin", ProjectType::Normal));
+    REQUIRE(lmodel2 != nullptr);
+
+    REQUIRE(lmodel2->get_gates_count() == lmodel->get_gates_count());
+    REQUIRE(lmodel2->get_vias_count() == lmodel->get_vias_count());
+    REQUIRE(lmodel2->get_wires_count() == lmodel->get_wires_count());
+    REQUIRE(lmodel2->get_emarkers_count() == lmodel->get_emarkers_count());
+    REQUIRE(lmodel2->get_annotations_count() == lmodel->get_annotations_count());
+
+    for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter)
+    {
+        Gate_shptr gate = std::dynamic_pointer_cast<Gate>(lmodel2->get_object(iter->first));
+        REQUIRE(gate != nullptr);
+        REQUIRE(gate->get_name() == iter->second->get_name());
+        REQUIRE(gate->get_min_x() == iter->second->get_min_x());
+        REQUIRE(gate->get_max_y() == iter->second->get_max_y());
+        REQUIRE(gate->get_ports_number() == iter->second->get_ports_number());
+    }
+
+    REQUIRE(lmodel2->get_main_module()->get_object_id() == lmodel->get_main_module()->get_object_id());
+
+    /*
+     * A truncated file must be rejected without touching the logic model
+     */
+    QFile file("tests_files/lmodel_export.bin");
+    REQUIRE(file.open(QIODevice::ReadWrite));
+    REQUIRE(file.resize(file.size() - 1));
+    file.close();
+
+    LogicModel_shptr lmodel3 = std::make_shared<LogicModel>(prj->get_width(), prj->get_height(), ProjectType::Normal);
+    REQUIRE_THROWS_AS(lm_importer.import_into(lmodel3, "tests_files/lmodel_export.bin"), InvalidFileFormatException);
+    REQUIRE(lmodel3->get_gates_count() == 0);
+
+    /*
+     * A reference to an unknown object must be rejected without touching the logic model
+     */
+    REQUIRE_NOTHROW(exporter.export_data("tests_files/lmodel_export.bin", lmodel));
+
+    REQUIRE(file.open(QIODevice::ReadWrite));
+    QByteArray data = file.readAll();
+
+    const auto* header = reinterpret_cast<const lmodel_binary::FileHeader*>(data.constData());
+    const auto* directory = reinterpret_cast<const lmodel_binary::TableEntry*>(data.constData() + sizeof(lmodel_binary::FileHeader));
+
+    bool corrupted = false;
+    for (uint32_t i = 0; i < header->table_count && !corrupted; i++)
+    {
+        if ((directory[i].table_id == lmodel_binary::TABLE_NET_CONNECTIONS || directory[i].table_id == lmodel_binary::TABLE_MODULE_CELLS) &&
+            directory[i].count > 0)
+        {
+            const uint64_t unknown_id = 0xFFFFFFFFFFFF;
+            memcpy(data.data() + directory[i].offset, &unknown_id, sizeof(unknown_id));
+            corrupted = true;
+        }
+    }
+    REQUIRE(corrupted);
+
+    REQUIRE(file.seek(0));
+    REQUIRE(file.write(data) == data.size());
+    file.close();
+
+    LogicModel_shptr lmodel4 = std::make_shared<LogicModel>(prj->get_width(), prj->get_height(), ProjectType::Normal);
+    REQUIRE_THROWS_AS(lm_importer.import_into(lmodel4, "tests_files/lmodel_export.bin"), InvalidFileFormatException);
+    REQUIRE(lmodel4->get_gates_count() == 0);
+}
+
+TEST_CASE("Test project snapshot export", "[ProjectExporter]")
+{
+    const std::string directory = copy_test_project();
+
+    ProjectImporter importer;
+    Project_shptr prj(importer.import_all(directory));
+    REQUIRE(prj != nullptr);
+
+    LogicModel_shptr lmodel = prj->get_logic_model();
+    REQUIRE(lmodel != nullptr);
+    REQUIRE(lmodel->get_gates_count() > 0);
+
+    const auto gates_count = lmodel->get_gates_count();
+
+    ProjectExporter exporter;
+    ProjectSnapshot_shptr snapshot = exporter.create_snapshot(prj);
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->logic_model != nullptr);
+    REQUIRE(snapshot->gate_library != nullptr);
+
+    /*
+     * Changes made after the snapshot was taken are not saved
+     */
+    lmodel->remove_object(lmodel->gates_begin()->second);
+    REQUIRE(lmodel->get_gates_count() == gates_count - 1);
+
+    REQUIRE_NOTHROW(exporter.export_snapshot(directory, *snapshot));
+
+    Project_shptr prj2(importer.import_all(directory));
+    REQUIRE(prj2 != nullptr);
+    REQUIRE(prj2->get_logic_model()->get_gates_count() == gates_count);
+
+    remove_directory(directory);
+}
@@ -21,8 +21,10 @@
 
 #include "Core/Project/ProjectImporter.h"
 #include "Core/Project/ProjectExporter.h"
+#include "Core/Project/ProjectJournal.h"
 #include "Core/Project/Project.h"
 #include "Core/LogicModel/LogicModelHelper.h"
+#include "TestProject.h"
 
 #include "catch.hpp"
 
@@ -64,6 +66,11 @@ TEST_CASE("Test project import all", "[ProjectImporter]")
 
     Layer_shptr layer = get_first_logic_layer(lmodel);
     REQUIRE(layer != nullptr);
+    REQUIRE(layer->has_background_image());
+
+    ProjectImporter::phase_timings_t const& timings = importer.get_phase_timings();
+    REQUIRE(!timings.empty());
+    REQUIRE(timings.back().first == "total");
 }
 
 TEST_CASE("Test project import all new format", "[ProjectImporter]")
@@ -88,10 +95,11 @@ TEST_CASE("Test project import all new format", "[ProjectImporter]")
         REQUIRE(gate_tmpl != nullptr);
 
         int i = 0;
-        for (auto img_iter = gate_tmpl->images_begin(); img_iter != gate_tmpl->images_end(); ++img_iter, i++)
+        for (Layer::LAYER_TYPE layer_type : gate_tmpl->get_image_layer_types())
         {
-            GateTemplateImage_shptr img = (*img_iter).second;
+            GateTemplateImage_shptr img = gate_tmpl->get_image(layer_type);
             REQUIRE(img != nullptr);
+            i++;
         }
         REQUIRE(i > 0);
     }
@@ -110,4 +118,102 @@ TEST_CASE("Test get object at", "[ProjectImporter]")
 
     REQUIRE(plo != nullptr);
     REQUIRE(plo->get_name() == "test_gate_1");
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test project journal", "[ProjectImporter]")
+{
+    const std::string directory = copy_test_project();
+
+    ProjectImporter importer;
+    ProjectExporter exporter;
+    ProjectJournal journal(directory);
+
+    Project_shptr prj(importer.import_all(directory));
+    REQUIRE(prj != nullptr);
+
+    LogicModel_shptr lmodel = prj->get_logic_model();
+    REQUIRE(lmodel->get_changes().empty());
+    REQUIRE(lmodel->get_gates_count() > 0);
+
+    const auto wires_count = lmodel->get_wires_count();
+    Gate_shptr gate = lmodel->gates_begin()->second;
+    const std::string gate_name = gate->get_name();
+
+    // Write the project files without object ID rewriting, the journal refers to the IDs in memory.
+    REQUIRE_NOTHROW(exporter.export_all(directory, prj, false));
+    REQUIRE(!journal.exists());
+
+    /*
+     * First entry: two connected wires and a renamed gate
+     */
+    Wire_shptr wire1 = std::make_shared<Wire>(10, 10, 50, 10, 5);
+    Wire_shptr wire2 = std::make_shared<Wire>(50, 10, 50, 50, 5);
+    lmodel->add_object(0, wire1);
+    lmodel->add_object(0, wire2);
+    connect_objects(lmodel, std::dynamic_pointer_cast<ConnectedLogicModelObject>(wire1),
+                    std::dynamic_pointer_cast<ConnectedLogicModelObject>(wire2));
+
+    gate->set_name("journal");
+    lmodel->set_object_changed(gate);
+
+    QByteArray entry = ProjectJournal::create_entry(prj);
+    REQUIRE(!entry.isEmpty());
+    REQUIRE(lmodel->get_changes().empty());
+
+    REQUIRE_NOTHROW(journal.append(entry));
+    REQUIRE(journal.exists());
+
+    Project_shptr prj2(importer.import_all(directory));
+    LogicModel_shptr lmodel2 = prj2->get_logic_model();
+    REQUIRE(lmodel2->get_changes().empty());
+    REQUIRE(lmodel2->get_wires_count() == wires_count + 2);
+    REQUIRE(lmodel2->get_gates_count() == lmodel->get_gates_count());
+    REQUIRE(lmodel2->get_object(gate->get_object_id())->get_name() == "journal");
+
+    Wire_shptr loaded_wire1 = std::dynamic_pointer_cast<Wire>(lmodel2->get_object(wire1->get_object_id()));
+    Wire_shptr loaded_wire2 = std::dynamic_pointer_cast<Wire>(lmodel2->get_object(wire2->get_object_id()));
+    REQUIRE(loaded_wire1 != nullptr);
+    REQUIRE(loaded_wire2 != nullptr);
+    REQUIRE(loaded_wire1->get_net() != nullptr);
+    REQUIRE(loaded_wire1->get_net() == loaded_wire2->get_net());
+
+    /*
+     * Second entry: a removed wire
+     */
+    lmodel->remove_object(wire2);
+    REQUIRE_NOTHROW(journal.append(ProjectJournal::create_entry(prj)));
+
+    Project_shptr prj3(importer.import_all(directory));
+    LogicModel_shptr lmodel3 = prj3->get_logic_model();
+    REQUIRE(lmodel3->get_wires_count() == wires_count + 1);
+    REQUIRE(lmodel3->exists_object(wire1->get_object_id()));
+    REQUIRE(!lmodel3->exists_object(wire2->get_object_id()));
+
+    /*
+     * An incomplete last entry is ignored
+     */
+    const qint64 journal_size = journal.get_size();
+    wire1->set_name("lost");
+    lmodel->set_object_changed(wire1);
+    REQUIRE_NOTHROW(journal.append(ProjectJournal::create_entry(prj)));
+
+    QFile file(QString::fromStdString(directory + "/lmodel.journal"));
+    REQUIRE(file.resize(journal_size + 16));
+
+    Project_shptr prj4(importer.import_all(directory));
+    REQUIRE(prj4->get_logic_model()->get_object(wire1->get_object_id())->get_name().empty());
+    REQUIRE(journal.get_size() == journal_size);
+
+    /*
+     * Writing the project files compacts the journal
+     */
+    lmodel->remove_object(wire1);
+    gate->set_name(gate_name);
+    REQUIRE_NOTHROW(exporter.export_all(directory, prj));
+    REQUIRE(!journal.exists());
+
+    Project_shptr prj5(importer.import_all(directory));
+    REQUIRE(prj5->get_logic_model()->get_wires_count() == wires_count);
+
+    remove_directory(directory);
+}
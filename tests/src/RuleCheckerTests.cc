@@ -0,0 +1,250 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Core/LogicModel/LogicModel.h"
+#include "Core/LogicModel/LogicModelHelper.h"
+#include "Core/RuleCheck/RuleChecker.h"
+
+#include <QThreadPool>
+
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace degate;
+
+namespace
+{
+    GatePort_shptr get_port(Gate_shptr gate, GateTemplatePort_shptr template_port)
+    {
+        for (Gate::port_iterator iter = gate->ports_begin(); iter != gate->ports_end(); ++iter)
+        {
+            if ((*iter)->get_template_port() == template_port)
+                return *iter;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Build a logic model with a chain of inverters, the output of each inverter
+     * is connected to the input of the next one with a wire.
+     */
+    LogicModel_shptr create_inverter_chain(unsigned int count, GateTemplate_shptr& inverter)
+    {
+        LogicModel_shptr lmodel = std::make_shared<LogicModel>(100 * count + 100, 100, ProjectType::Normal);
+        lmodel->add_layer(0);
+
+        inverter = std::make_shared<GateTemplate>(10, 10);
+        lmodel->add_gate_template(inverter);
+
+        GateTemplatePort_shptr in = std::make_shared<GateTemplatePort>(1, 5, GateTemplatePort::PORT_TYPE_IN);
+        in->set_object_id(lmodel->get_new_object_id());
+        inverter->add_template_port(in);
+
+        GateTemplatePort_shptr out = std::make_shared<GateTemplatePort>(9, 5, GateTemplatePort::PORT_TYPE_OUT);
+        out->set_object_id(lmodel->get_new_object_id());
+        inverter->add_template_port(out);
+
+        Gate_shptr previous = nullptr;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            const float x = static_cast<float>(100 * i);
+
+            Gate_shptr gate = std::make_shared<Gate>(x, x + 10, 0, 10, Gate::ORIENTATION_NORMAL);
+            gate->set_gate_template(inverter);
+            lmodel->add_object(0, gate);
+            lmodel->update_ports(gate);
+
+            if (previous != nullptr)
+            {
+                Wire_shptr wire = std::make_shared<Wire>(x - 91, 5, x + 1, 5, 1);
+                lmodel->add_object(0, wire);
+
+                connect_objects(lmodel, get_port(previous, out), wire);
+                connect_objects(lmodel, wire, get_port(gate, in));
+            }
+
+            previous = gate;
+        }
+
+        return lmodel;
+    }
+
+    GateTemplatePort_shptr get_template_port(GateTemplate_shptr gate_template, GateTemplatePort::PORT_TYPE type)
+    {
+        for (auto iter = gate_template->ports_begin(); iter != gate_template->ports_end(); ++iter)
+        {
+            if ((*iter)->get_port_type() == type)
+                return *iter;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Get the violations of a rule checker as (violation class, object ID) pairs, in the reported order.
+     */
+    std::vector<std::pair<std::string, object_id_t>> get_violations(RuleChecker const& checker)
+    {
+        std::vector<std::pair<std::string, object_id_t>> violations;
+
+        for (auto const& violation : checker.get_rc_violations())
+            violations.emplace_back(violation->get_rc_violation_class(), violation->get_object()->get_object_id());
+
+        return violations;
+    }
+
+    /**
+     * Update the rule checker after a change and compare the result with a check of the whole logic model.
+     * The checks are shared by all rule checkers (see ERCRegister), the full check therefore runs after
+     * the incremental result was read.
+     */
+    void require_same_violations_as_run(RuleChecker& checker, LogicModel_shptr lmodel)
+    {
+        REQUIRE(checker.has_changes());
+
+        checker.update(lmodel);
+        auto updated = get_violations(checker);
+
+        RuleChecker full_checker;
+        full_checker.run(lmodel);
+
+        REQUIRE(updated == get_violations(full_checker));
+    }
+}
+
+TEST_CASE("Test rule checker update", "[RuleChecker]")
+{
+    GateTemplate_shptr inverter;
+    LogicModel_shptr lmodel = create_inverter_chain(4, inverter);
+
+    GateTemplatePort_shptr in = get_template_port(inverter, GateTemplatePort::PORT_TYPE_IN);
+    GateTemplatePort_shptr out = get_template_port(inverter, GateTemplatePort::PORT_TYPE_OUT);
+
+    std::vector<Gate_shptr> gates;
+    for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter)
+        gates.push_back(iter->second);
+
+    REQUIRE(gates.size() == 4);
+
+    RuleChecker checker;
+    checker.run(lmodel);
+
+    // The input of the first inverter and the output of the last one are open.
+    REQUIRE(get_violations(checker).size() == 2);
+
+    SECTION("Add and remove a wire")
+    {
+        Wire_shptr wire = std::make_shared<Wire>(1, 5, 1, 50, 1);
+        lmodel->add_object(0, wire);
+        connect_objects(lmodel, get_port(gates[0], in), wire);
+
+        require_same_violations_as_run(checker, lmodel);
+
+        lmodel->remove_object(wire);
+
+        require_same_violations_as_run(checker, lmodel);
+    }
+
+    SECTION("Move a port out of a net")
+    {
+        std::list<ConnectedLogicModelObject_shptr> ports = {get_port(gates[2], in)};
+        isolate_objects(lmodel, ports.begin(), ports.end());
+
+        require_same_violations_as_run(checker, lmodel);
+
+        ConnectedLogicModelObject_shptr port = get_port(gates[2], in);
+        ConnectedLogicModelObject_shptr driver = get_port(gates[0], out);
+        connect_objects(lmodel, port, driver);
+
+        require_same_violations_as_run(checker, lmodel);
+    }
+
+    SECTION("Remove a gate")
+    {
+        lmodel->remove_object(gates[1]);
+
+        require_same_violations_as_run(checker, lmodel);
+    }
+
+    SECTION("Change a gate template")
+    {
+        in->set_port_type(GateTemplatePort::PORT_TYPE_OUT);
+        lmodel->set_gate_template_changed(inverter);
+
+        require_same_violations_as_run(checker, lmodel);
+
+        in->set_port_type(GateTemplatePort::PORT_TYPE_UNDEFINED);
+        lmodel->set_gate_template_changed(inverter);
+
+        require_same_violations_as_run(checker, lmodel);
+    }
+}
+
+TEST_CASE("Test sharded rule check", "[RuleChecker]")
+{
+    // More nets and gates than RC_SHARD_SIZE, so that the checks run in several shards.
+    const unsigned int count = 3 * RC_SHARD_SIZE;
+
+    GateTemplate_shptr inverter;
+    LogicModel_shptr lmodel = create_inverter_chain(count, inverter);
+
+    GateTemplatePort_shptr in = get_template_port(inverter, GateTemplatePort::PORT_TYPE_IN);
+
+    // Open some inputs in each shard.
+    std::list<ConnectedLogicModelObject_shptr> ports;
+    unsigned int index = 0;
+    for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter, ++index)
+    {
+        if (index > 0 && index % 7 == 0)
+            ports.push_back(get_port(iter->second, in));
+    }
+
+    isolate_objects(lmodel, ports.begin(), ports.end());
+
+    // Sequential result, with a single thread in the pool.
+    QThreadPool* pool = QThreadPool::globalInstance();
+    const int max_thread_count = pool->maxThreadCount();
+
+    pool->setMaxThreadCount(1);
+
+    RuleChecker sequential_checker;
+    sequential_checker.run(lmodel);
+    auto sequential = get_violations(sequential_checker);
+
+    pool->setMaxThreadCount(max_thread_count);
+
+    // The open inputs, the input of the first inverter and the output of the last one.
+    REQUIRE(sequential.size() == ports.size() + 2);
+
+    for (unsigned int i = 0; i < 5; i++)
+    {
+        RuleChecker checker;
+        checker.run(lmodel);
+
+        REQUIRE(get_violations(checker) == sequential);
+    }
+}
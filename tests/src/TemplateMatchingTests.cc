@@ -0,0 +1,248 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Core/Matching/TemplateMatching.h"
+#include "Core/Project/Project.h"
+
+#include <cstdint>
+#include <list>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace degate;
+
+namespace
+{
+    /**
+     * Template matching with access to the steps of a run.
+     */
+    class TestTemplateMatching : public TemplateMatchingNormal
+    {
+    public:
+
+        using TemplateMatching::suppress_overlapping_matches;
+        using TemplateMatching::add_gates;
+
+        void set_project(Project_shptr project)
+        {
+            this->project = project;
+        }
+    };
+
+    TemplateMatching::match_found make_match(unsigned int x, unsigned int y, GateTemplate_shptr tmpl, double correlation)
+    {
+        TemplateMatching::match_found match;
+        match.x = x;
+        match.y = y;
+        match.tmpl = tmpl;
+        match.orientation = Gate::ORIENTATION_NORMAL;
+        match.correlation = correlation;
+        match.t_hc = 0;
+
+        return match;
+    }
+
+    /**
+     * Get the positions (upper left corners) of the gates of a logic model.
+     */
+    std::set<std::pair<unsigned int, unsigned int>> get_gate_positions(LogicModel_shptr lmodel)
+    {
+        std::set<std::pair<unsigned int, unsigned int>> positions;
+
+        for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter)
+            positions.emplace(static_cast<unsigned int>(iter->second->get_min_x()),
+                              static_cast<unsigned int>(iter->second->get_min_y()));
+
+        return positions;
+    }
+
+    /**
+     * Pseudo random value for a position, the same on each run.
+     */
+    unsigned int noise(unsigned int x, unsigned int y, unsigned int seed)
+    {
+        uint32_t h = x * 73856093u ^ y * 19349663u ^ seed * 83492791u;
+        h ^= h >> 13;
+        h *= 0x5bd1e995u;
+        h ^= h >> 15;
+
+        return h;
+    }
+
+    rgba_pixel_t grey(unsigned int value)
+    {
+        return MERGE_CHANNELS(value, value, value, 255u);
+    }
+
+    /**
+     * A project with a synthetic background image, where a gate template was placed
+     * at known positions over a slightly noisy background.
+     */
+    struct MatchingProject
+    {
+        Project_shptr project;
+        Layer_shptr layer;
+        GateTemplate_shptr tmpl;
+        BoundingBox search_area;
+        std::set<std::pair<unsigned int, unsigned int>> positions;
+    };
+
+    MatchingProject create_matching_project(unsigned int image_size)
+    {
+        const unsigned int tmpl_size = 32;
+        const unsigned int area_size = 320;
+
+        MatchingProject mp;
+        mp.project = std::make_shared<Project>(image_size, image_size);
+        mp.search_area = BoundingBox(0, area_size - 1, 0, area_size - 1);
+
+        // Positions are aligned to the template blocks on all pyramid levels.
+        mp.positions = {{48, 64}, {160, 40}, {96, 176}, {232, 216}};
+
+        LogicModel_shptr lmodel = mp.project->get_logic_model();
+        lmodel->add_layer(0);
+        mp.layer = lmodel->get_layer(0);
+        mp.layer->set_layer_type(Layer::LOGIC);
+
+        // The template is made of blocks of 8x8 pixels.
+        GateTemplateImage_shptr tmpl_img = std::make_shared<GateTemplateImage>(tmpl_size, tmpl_size);
+        for (unsigned int y = 0; y < tmpl_size; y++)
+            for (unsigned int x = 0; x < tmpl_size; x++)
+                tmpl_img->set_pixel(x, y, grey(noise(x / 8, y / 8, 1) % 256));
+
+        mp.tmpl = std::make_shared<GateTemplate>(tmpl_size, tmpl_size);
+        mp.tmpl->set_image(Layer::LOGIC, tmpl_img);
+        lmodel->add_gate_template(mp.tmpl);
+
+        // A temporary image, the scaled images are created in its directory as well.
+        BackgroundImage_shptr img = std::make_shared<BackgroundImage>(image_size, image_size);
+
+        // The pyramid levels are made from a slightly larger area.
+        for (unsigned int y = 0; y < area_size + 64; y++)
+            for (unsigned int x = 0; x < area_size + 64; x++)
+                img->set_pixel(x, y, grey(120 + noise(x, y, 2) % 16));
+
+        for (auto const& position : mp.positions)
+            for (unsigned int y = 0; y < tmpl_size; y++)
+                for (unsigned int x = 0; x < tmpl_size; x++)
+                    img->set_pixel(position.first + x, position.second + y, tmpl_img->get_pixel(x, y));
+
+        mp.layer->set_image(img);
+
+        return mp;
+    }
+
+    /**
+     * Run a template matching on a project and return the positions of the inserted gates.
+     * The gates are removed afterwards.
+     */
+    std::set<std::pair<unsigned int, unsigned int>> match(MatchingProject const& mp, bool pyramid_search)
+    {
+        TemplateMatchingNormal matching;
+        matching.set_pyramid_search(pyramid_search);
+        matching.set_templates({mp.tmpl});
+        matching.set_orientations({Gate::ORIENTATION_NORMAL});
+        matching.set_layers(mp.layer, mp.layer);
+        matching.init(mp.search_area, mp.project);
+        matching.run();
+
+        LogicModel_shptr lmodel = mp.project->get_logic_model();
+        std::set<std::pair<unsigned int, unsigned int>> positions = get_gate_positions(lmodel);
+
+        std::vector<Gate_shptr> gates;
+        for (auto iter = lmodel->gates_begin(); iter != lmodel->gates_end(); ++iter)
+            gates.push_back(iter->second);
+
+        for (auto const& gate : gates)
+            lmodel->remove_object(gate);
+
+        return positions;
+    }
+}
+
+TEST_CASE("Test overlapping matches", "[TemplateMatching]")
+{
+    Project_shptr project = std::make_shared<Project>(500, 500);
+    LogicModel_shptr lmodel = project->get_logic_model();
+    lmodel->add_layer(0);
+    Layer_shptr layer = lmodel->get_layer(0);
+
+    GateTemplate_shptr tmpl = std::make_shared<GateTemplate>(10, 10);
+
+    std::list<TemplateMatching::match_found> matches = {
+        make_match(10, 10, tmpl, 0.80),   // overlaps the best match
+        make_match(14, 12, tmpl, 0.95),   // best match
+        make_match(20, 18, tmpl, 0.90),   // overlaps the best match
+        make_match(60, 10, tmpl, 0.75),   // alone
+        make_match(100, 100, tmpl, 0.85), // alone, but over a gate placed before
+        make_match(105, 105, tmpl, 0.70)  // overlaps the previous one
+    };
+
+    TestTemplateMatching matching;
+    std::vector<TemplateMatching::match_found> kept = matching.suppress_overlapping_matches(matches);
+
+    // Kept matches are sorted by decreasing correlation.
+    REQUIRE(kept.size() == 3);
+    REQUIRE(kept[0].x == 14);
+    REQUIRE(kept[0].y == 12);
+    REQUIRE(kept[1].x == 100);
+    REQUIRE(kept[1].y == 100);
+    REQUIRE(kept[2].x == 60);
+    REQUIRE(kept[2].y == 10);
+
+    /*
+     * Insert the kept matches, a gate was placed before over one of them.
+     */
+    Gate_shptr placed = std::make_shared<Gate>(95, 105, 95, 105, Gate::ORIENTATION_NORMAL);
+    lmodel->add_object(0, placed);
+
+    matching.set_project(project);
+    matching.set_layers(layer, layer);
+    matching.add_gates(kept);
+
+    std::set<std::pair<unsigned int, unsigned int>> expected = {{95, 95}, {14, 12}, {60, 10}};
+    REQUIRE(get_gate_positions(lmodel) == expected);
+}
+
+TEST_CASE("Test cached template matching", "[TemplateMatching]")
+{
+    MatchingProject mp = create_matching_project(400);
+
+    // The first run prepares the template, the second one uses the prepared template.
+    TemplateMatching::clear_prepared_templates();
+
+    REQUIRE(match(mp, false) == mp.positions);
+    REQUIRE(match(mp, false) == mp.positions);
+}
+
+TEST_CASE("Test pyramid template matching", "[TemplateMatching]")
+{
+    // The background image is large enough to get a pyramid level (see ScalingManager).
+    MatchingProject mp = create_matching_project(2176);
+
+    std::set<std::pair<unsigned int, unsigned int>> full_resolution = match(mp, false);
+    REQUIRE(full_resolution == mp.positions);
+
+    REQUIRE(match(mp, true) == full_resolution);
+}
@@ -0,0 +1,57 @@
+/**
+ * This file is part of the IC reverse engineering tool Degate.
+ *
+ * Copyright 2008, 2009, 2010 by Martin Schobert
+ * Copyright 2019-2020 Dorian Bachelot
+ *
+ * Degate is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * Degate is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with degate. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __TESTPROJECT_H__
+#define __TESTPROJECT_H__
+
+#include "Core/Utils/FileSystem.h"
+
+#include <QFile>
+
+#include <string>
+
+namespace degate
+{
+    /**
+     * Copy the files of the test project (tests_files/test_project) to a new temporary
+     * directory. Tests that write project files (lmodel.bin, lmodel.journal...) work on
+     * the copy, so that the other tests always load the original project.
+     *
+     * @return Returns the path of the copy, remove it with remove_directory().
+     */
+    inline std::string copy_test_project()
+    {
+        const std::string source("tests_files/test_project");
+        const std::string directory = create_temp_directory();
+
+        for (auto const& file : read_directory(source))
+        {
+            const std::string path = join_pathes(source, file);
+
+            if (is_file(path))
+                QFile::copy(QString::fromStdString(path), QString::fromStdString(join_pathes(directory, file)));
+        }
+
+        return directory;
+    }
+}
+
+#endif